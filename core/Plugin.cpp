@@ -3,11 +3,40 @@
 // Affiliation: Institute of Software, Chinese Academy of Sciences
 
 #include "Plugin.h"
+#include <array>
 
 namespace Fleet::DataManager::Core {
+/**
+ * @brief 线程持有的服务调用记录
+ * @details 每个线程一份，首次调用时分配，之后登记和结束调用只对固定的槽做原子操作，不加锁也不分配内存。
+ * 只有所属线程向空槽写入插件，句柄可能移动到其他线程释放，释放时只把槽清空。
+ * 槽用完后的调用只计数，此时无法区分插件，判断是否持有调用时保守地视为持有
+ */
+struct ThreadPins {
+    /// 每个线程可以单独记录的调用数量
+    static constexpr size_t SlotCount = 16;
+    /// 该线程持有调用的插件，每个调用占一个槽，空槽为nullptr
+    std::array<std::atomic<const Plugin *>, SlotCount> slots{};
+    /// 槽用完后登记的调用数量
+    std::atomic<int> overflow{0};
+};
+
+namespace {
+/**
+ * @brief 获取当前线程的服务调用记录
+ * @return 当前线程的服务调用记录
+ */
+const std::shared_ptr<ThreadPins> &CurrentThreadPins() {
+    thread_local std::shared_ptr<ThreadPins> pins = std::make_shared<ThreadPins>();
+    return pins;
+}
+} // namespace
+
 Plugin::Plugin() {
     this->handle = nullptr;
     this->plugin = nullptr;
+    this->inFlightCalls = 0;
+    this->draining = false;
     this->newPluginFunction = nullptr;
     this->deletePluginFunction = nullptr;
     this->dependencyList.clear();
@@ -57,6 +86,62 @@ void Plugin::SetDescription(std::string description) {
     this->description = std::move(description);
 }
 
+std::mutex &Plugin::GetInstantiateMutex() {
+    return this->instantiateMutex;
+}
+
+std::shared_ptr<ThreadPins> Plugin::BeginCall() {
+    this->inFlightCalls.fetch_add(1);
+    const auto &owner = CurrentThreadPins();
+    for (auto &slot : owner->slots) {
+        // 只有所属线程写入非空值，空槽不会被其他线程占用
+        if (slot.load(std::memory_order_relaxed) == nullptr) {
+            slot.store(this, std::memory_order_relaxed);
+            return owner;
+        }
+    }
+    owner->overflow.fetch_add(1, std::memory_order_relaxed);
+    return owner;
+}
+
+void Plugin::EndCall(const std::shared_ptr<ThreadPins> &owner) {
+    bool found = false;
+    for (auto &slot : owner->slots) {
+        const Plugin *expected = this;
+        if (slot.compare_exchange_strong(expected, nullptr, std::memory_order_relaxed)) {
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        owner->overflow.fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (this->inFlightCalls.fetch_sub(1) == 1 && this->draining.load()) {
+        std::lock_guard<std::mutex> lock(this->drainMutex);
+        this->drainCondition.notify_all();
+    }
+}
+
+bool Plugin::IsPinnedByCurrentThread() const {
+    const auto &pins = CurrentThreadPins();
+    if (pins->overflow.load(std::memory_order_relaxed) > 0) {
+        return true;
+    }
+    for (const auto &slot : pins->slots) {
+        if (slot.load(std::memory_order_relaxed) == this) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Plugin::WaitForCalls() {
+    this->draining.store(true);
+    std::unique_lock<std::mutex> lock(this->drainMutex);
+    this->drainCondition.wait(lock, [this] { return this->inFlightCalls.load() == 0; });
+    this->draining.store(false);
+}
+
 void *Plugin::NewPlugin() {
     return this->newPluginFunction();
 }
@@ -74,11 +159,11 @@ void Plugin::SetDeletePluginFunction(Plugin::DeletePluginFunction deletePluginFu
 }
 
 PluginBase *Plugin::GetPlugin() {
-    return this->plugin;
+    return this->plugin.load(std::memory_order_acquire);
 }
 
 void Plugin::SetPlugin(PluginBase *plugin) {
-    this->plugin = plugin;
+    this->plugin.store(plugin, std::memory_order_release);
 }
 
 const std::vector<std::string> &Plugin::GetDependencyList() {
@@ -121,7 +206,8 @@ void Plugin::SetConflictList(const std::vector<std::string> &conflictList) {
 
 void Plugin::From(const std::shared_ptr<Plugin> &another) {
     this->handle = another->handle;
-    this->plugin = another->plugin;
+    this->plugin.store(another->plugin.load(std::memory_order_acquire),
+                       std::memory_order_release);
     this->path = another->path;
     this->name = another->name;
     this->version = another->version;
@@ -9,18 +9,22 @@
 #ifndef FLEET_DATA_MANAGER_CORE_PLUGIN_H
 #define FLEET_DATA_MANAGER_CORE_PLUGIN_H
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "PluginBase.h"
+#include "ServiceHandle.h"
 
 namespace Fleet::DataManager::Core {
 /**
  * @brief 插件元数据管理类
- * @details 存储插件的基本信息、依赖关系和生命周期管理函数
+ * @details 存储插件的基本信息、依赖关系和生命周期管理函数，并统计进行中的服务调用
  */
-class Plugin {
+class Plugin : public ServicePin {
   public:
     /// 插件实例创建函数指针类型
     typedef void *(*NewPluginFunction)();
@@ -120,6 +124,41 @@ class Plugin {
      */
     void SetPlugin(PluginBase *plugin);
 
+    /**
+     * @brief 获取插件实例化互斥锁
+     * @details 延迟加载模式下用于保证并发首次使用时插件只被实例化一次
+     * @return 插件实例化互斥锁引用
+     */
+    std::mutex &GetInstantiateMutex();
+
+    /**
+     * @brief 登记一次进行中的服务调用
+     * @details 与EndCall配对使用，插件实例在所有进行中的调用结束前不会被销毁。
+     * 调用同时记在当前线程的固定槽上，用于识别线程在自身持有的调用中重载或卸载插件，
+     * 除线程首次调用时分配记录外不加锁、不分配内存
+     * @return 当前线程的调用记录，结束调用时传给EndCall
+     */
+    std::shared_ptr<ThreadPins> BeginCall();
+
+    /**
+     * @brief 结束一次进行中的服务调用
+     * @param[in] owner BeginCall返回的线程记录，可以在其他线程结束调用
+     */
+    void EndCall(const std::shared_ptr<ThreadPins> &owner) override;
+
+    /**
+     * @brief 判断当前线程是否持有该插件的进行中调用
+     * @details 为true时在当前线程上等待调用排空会永远阻塞。当前线程同时持有的调用过多时保守地返回true
+     * @return 当前线程持有调用返回true，否则返回false
+     */
+    bool IsPinnedByCurrentThread() const;
+
+    /**
+     * @brief 等待所有进行中的服务调用结束
+     * @details 调用前插件应已从注册表中摘除，保证不会再有新的调用进入
+     */
+    void WaitForCalls();
+
     /**
      * @brief 创建插件实例
      * @return 新创建的插件实例指针
@@ -191,8 +230,23 @@ class Plugin {
     /// 插件句柄，动态插件为dlopen返回值，静态插件为nullptr
     void *handle;
 
-    /// 插件实例指针
-    PluginBase *plugin;
+    /// 插件实例指针，延迟加载模式下首次使用前为nullptr
+    std::atomic<PluginBase *> plugin;
+
+    /// 插件实例化互斥锁，保护延迟加载时的NewPlugin/Initialize过程
+    std::mutex instantiateMutex;
+
+    /// 进行中的服务调用数量
+    std::atomic<int> inFlightCalls;
+
+    /// 是否有线程正在等待调用排空，仅此时EndCall才需要加锁通知
+    std::atomic<bool> draining;
+
+    /// 保护调用排空等待的互斥锁
+    std::mutex drainMutex;
+
+    /// 调用排空时用于通知等待线程的条件变量
+    std::condition_variable drainCondition;
 
     /// 插件文件路径
     std::string path;
@@ -95,6 +95,10 @@ void *PluginContextImpl::GetService(const std::string &pluginName) {
     return this->pluginManager->GetService(pluginName);
 }
 
+ServiceHandle PluginContextImpl::AcquireService(const std::string &pluginName) {
+    return this->pluginManager->AcquireService(pluginName);
+}
+
 const std::string &PluginContextImpl::GetBaseDirectory() {
     return this->baseDirectory;
 }
@@ -110,4 +114,12 @@ const std::string &PluginContextImpl::GetLogDirectory() {
 const std::string &PluginContextImpl::GetDatabaseDirectory() {
     return this->databaseDirectory;
 }
+
+MemoryPool &PluginContextImpl::GetMemoryPool() {
+    return MemoryPool::Global();
+}
+
+Executor &PluginContextImpl::GetExecutor() {
+    return Executor::Global();
+}
 } // namespace Fleet::DataManager::Core
\ No newline at end of file
@@ -55,6 +55,13 @@ class PluginContextImpl : public PluginContext {
      */
     void *GetService(const std::string &pluginName) override;
 
+    /**
+     * @brief 获取指定插件的服务句柄
+     * @param[in] pluginName 插件名称
+     * @return 服务句柄
+     */
+    ServiceHandle AcquireService(const std::string &pluginName) override;
+
     /**
      * @brief 获取基础目录路径
      * @return 基础目录路径字符串
@@ -79,6 +86,18 @@ class PluginContextImpl : public PluginContext {
      */
     const std::string &GetDatabaseDirectory() override;
 
+    /**
+     * @brief 获取内存池
+     * @return 进程内共享的内存池引用
+     */
+    MemoryPool &GetMemoryPool() override;
+
+    /**
+     * @brief 获取共享执行器
+     * @return 进程内共享的执行器引用
+     */
+    Executor &GetExecutor() override;
+
   private:
     /// 插件管理器指针，用于服务查找
     PluginManager *pluginManager;
@@ -9,17 +9,40 @@
 #include "PluginManager.h"
 
 namespace Fleet::DataManager::Core {
-PluginManager::PluginManager(uuid_t nodeId, const std::string &baseDirectory) {
+namespace {
+/**
+ * @brief 获取当前线程正在执行Initialize的插件及其实例
+ * @return 插件对象到插件实例的列表，按进入Initialize的顺序排列
+ */
+std::vector<std::pair<const Plugin *, PluginBase *>> &InitializingPlugins() {
+    thread_local std::vector<std::pair<const Plugin *, PluginBase *>> plugins;
+    return plugins;
+}
+} // namespace
+
+PluginManager::PluginManager(uuid_t nodeId, const std::string &baseDirectory)
+    : reaperStopping(false) {
     this->pluginContext = std::make_shared<PluginContextImpl>(this, nodeId, baseDirectory);
     this->pluginContext->LogTrace(SOURCE_LOCATION, "调用");
     this->pluginMap.clear();
     this->pluginList.clear();
     this->parameters.clear();
+    this->registry.store(new std::map<std::string, std::shared_ptr<Plugin>>(),
+                         std::memory_order_release);
     this->pluginContext->LogTrace(SOURCE_LOCATION, "返回");
 }
 
 PluginManager::~PluginManager() {
     this->pluginContext->LogTrace(SOURCE_LOCATION, "调用");
+    {
+        std::lock_guard<std::mutex> lock(this->reaperMutex);
+        this->reaperStopping = true;
+    }
+    this->reaperCondition.notify_all();
+    if (this->reaper.joinable()) {
+        this->reaper.join();
+    }
+    delete this->registry.exchange(nullptr, std::memory_order_acq_rel);
     this->pluginContext->LogTrace(SOURCE_LOCATION, "返回");
 }
 
@@ -29,6 +52,7 @@ void PluginManager::SetParameter(const std::string &key, const std::string &valu
 
 bool PluginManager::LoadAnAvailablePlugin(std::vector<std::shared_ptr<Plugin>> &toLoad) {
     this->pluginContext->LogTrace(SOURCE_LOCATION, "调用");
+    std::lock_guard<std::recursive_mutex> lifecycleLock(this->lifecycleMutex);
     int i = 0;
     for (i = 0; i < (int) toLoad.size(); i++) {
         if (this->HasNoConflict(toLoad[i]) && this->AllDependencyLoaded(toLoad[i])) {
@@ -66,12 +90,12 @@ bool PluginManager::CheckAndInitializePlugin(const std::shared_ptr<Plugin> &plug
                                       plugin->GetPath().c_str(), dependency.c_str());
         return false;
     }
-    this->DoInitializePlugin(plugin);
-    return true;
+    return this->DoInitializePlugin(plugin);
 }
 
 bool PluginManager::LoadPlugin(const std::string &path) {
     this->pluginContext->LogInfo(SOURCE_LOCATION, "加载插件 {}", path.c_str());
+    std::lock_guard<std::recursive_mutex> lifecycleLock(this->lifecycleMutex);
     auto plugin = std::make_shared<Plugin>();
     if (this->GetPluginLoader()->LoadPlugin(path, plugin)) {
         if (!this->CheckAndInitializePlugin(plugin)) {
@@ -118,9 +142,10 @@ bool PluginManager::HasNoDependency(const std::shared_ptr<Plugin> &plugin) {
 }
 
 bool PluginManager::UnloadPlugin(const std::string &pluginName) {
+    std::lock_guard<std::recursive_mutex> lifecycleLock(this->lifecycleMutex);
     auto iter = this->pluginMap.find(pluginName);
     if (iter != this->pluginMap.end()) {
-        auto plugin = this->pluginMap[pluginName];
+        auto plugin = iter->second;
         return this->DoDestroyPlugin(plugin);
     } else {
         this->pluginContext->LogError(SOURCE_LOCATION, "未找到插件 {}",
@@ -130,6 +155,7 @@ bool PluginManager::UnloadPlugin(const std::string &pluginName) {
 }
 
 bool PluginManager::UnloadAllPlugins() {
+    std::lock_guard<std::recursive_mutex> lifecycleLock(this->lifecycleMutex);
     bool success = true;
     std::vector<std::shared_ptr<Plugin>> toRemove;
     toRemove.reserve(this->pluginList.size());
@@ -145,49 +171,165 @@ bool PluginManager::UnloadAllPlugins() {
         success = success && this->DoDestroyPlugin(plugin);
     }
 
+    // 热重载时因被依赖而保留的旧实例, 在依赖它的插件全部卸载后销毁
+    std::vector<std::shared_ptr<Plugin>> retired;
+    retired.swap(this->retiredPlugins);
+    std::reverse(retired.begin(), retired.end());
+    for (const auto &plugin : retired) {
+        success = this->RetirePlugin(plugin) && success;
+    }
+
     return success;
 }
 
-void PluginManager::DoInitializePlugin(const std::shared_ptr<Plugin> &plugin) {
-    PluginBase *pluginPointer = (PluginBase *) plugin->NewPlugin();
-    plugin->SetPlugin(pluginPointer);
+bool PluginManager::DoInitializePlugin(const std::shared_ptr<Plugin> &plugin) {
+    std::lock_guard<std::recursive_mutex> lifecycleLock(this->lifecycleMutex);
+    std::shared_ptr<Plugin> previous;
     auto iter = this->pluginMap.find(plugin->GetName());
     if (iter != this->pluginMap.end()) {
+        previous = iter->second;
         this->pluginContext->LogInfo(SOURCE_LOCATION,
-                                     "插件 {} 已加载, 正在卸载前一个插件实例",
-                                     plugin->GetName().c_str());
-        auto previous = this->pluginMap[plugin->GetName()];
-        this->DoDestroyPlugin(previous);
+                                     "插件 {} 已加载, 正在初始化新实例以替换前一个插件实例",
+                                     plugin->GetName());
     }
-    this->pluginList.push_back(plugin);
+
+    bool lazy = this->IsLazyLoadEnabled() &&
+                (previous == nullptr || previous->GetPlugin() == nullptr);
+    if (!lazy && previous != nullptr) {
+        // 前一个实例已在服务时, 新实例必须先完成初始化, 旧实例在此期间继续处理请求,
+        // 新实例在Initialize中获取自身服务时得到的是前一个实例
+        if (this->InstantiatePlugin(plugin) == nullptr) {
+            this->pluginContext->LogError(SOURCE_LOCATION,
+                                          "插件 {} 初始化失败, 未注册新实例", plugin->GetName());
+            return false;
+        }
+    } else if (!lazy) {
+        // 首次加载时先注册再初始化, 插件在Initialize中可以获取自身及依赖它的插件的服务
+        auto *pluginPointer = (PluginBase *) plugin->NewPlugin();
+        if (pluginPointer == nullptr) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "无法创建插件 {} 的实例",
+                                          plugin->GetName());
+            return false;
+        }
+        plugin->SetPlugin(pluginPointer);
+    }
+
     this->pluginMap[plugin->GetName()] = plugin;
-    plugin->GetPlugin()->Initialize(this->GetPluginContext(), this->parameters);
+    if (previous != nullptr) {
+        std::replace(this->pluginList.begin(), this->pluginList.end(), previous, plugin);
+    } else {
+        this->pluginList.push_back(plugin);
+    }
+    this->PublishRegistry();
+
+    if (lazy) {
+        this->pluginContext->LogInfo(SOURCE_LOCATION,
+                                     "插件 {} 版本 {} ({}) 已注册, 将在首次使用时初始化",
+                                     plugin->GetName(), plugin->GetVersion(),
+                                     plugin->GetDescription());
+    } else if (previous == nullptr) {
+        plugin->GetPlugin()->Initialize(this->GetPluginContext(), this->parameters);
+        this->pluginContext->LogInfo(SOURCE_LOCATION, "插件 {} 版本 {} ({}) 已初始化",
+                                     plugin->GetName(), plugin->GetVersion(),
+                                     plugin->GetDescription());
+    }
+
+    if (previous != nullptr) {
+        if (this->HasNoDependency(previous)) {
+            this->pluginContext->LogInfo(SOURCE_LOCATION,
+                                         "插件 {} 已切换到新实例, 等待前一个插件实例的调用结束",
+                                         plugin->GetName());
+            this->RetirePlugin(previous);
+        } else {
+            // 依赖它的插件可能仍持有旧实例的服务指针, 旧实例保留到全部插件卸载时
+            this->pluginContext->LogWarn(SOURCE_LOCATION,
+                                         "插件 {} 被其他插件依赖, 前一个插件实例将在卸载全部插件时销毁",
+                                         plugin->GetName());
+            this->retiredPlugins.push_back(previous);
+        }
+    }
+    return true;
+}
+
+bool PluginManager::IsLazyLoadEnabled() const {
+    auto iter = this->parameters.find("core.lazyLoad");
+    return iter != this->parameters.end() && iter->second == "true";
+}
+
+PluginBase *PluginManager::InstantiatePlugin(const std::shared_ptr<Plugin> &plugin) {
+    PluginBase *pluginPointer = plugin->GetPlugin();
+    if (pluginPointer != nullptr) {
+        return pluginPointer;
+    }
+    // 插件在自身的Initialize中直接或经由其他插件获取自身服务, 再次加实例化互斥锁会死锁
+    auto &initializing = InitializingPlugins();
+    for (const auto &[pending, pendingPointer] : initializing) {
+        if (pending == plugin.get()) {
+            return pendingPointer;
+        }
+    }
+    std::lock_guard<std::mutex> lock(plugin->GetInstantiateMutex());
+    pluginPointer = plugin->GetPlugin();
+    if (pluginPointer != nullptr) {
+        return pluginPointer;
+    }
+    pluginPointer = (PluginBase *) plugin->NewPlugin();
+    if (pluginPointer == nullptr) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "无法创建插件 {} 的实例",
+                                      plugin->GetName());
+        return nullptr;
+    }
+    initializing.emplace_back(plugin.get(), pluginPointer);
+    pluginPointer->Initialize(this->GetPluginContext(), this->parameters);
+    initializing.pop_back();
+    // 初始化完成后再发布实例指针, 并发的首次调用不会看到未初始化的插件
+    plugin->SetPlugin(pluginPointer);
     this->pluginContext->LogInfo(SOURCE_LOCATION, "插件 {} 版本 {} ({}) 已初始化",
                                  plugin->GetName(), plugin->GetVersion(), plugin->GetDescription());
+    return pluginPointer;
 }
 
-void *PluginManager::GetService(const std::string &pluginName) {
-    auto iter = this->pluginMap.find(pluginName);
-    if (iter != this->pluginMap.end()) {
-        auto plugin = this->pluginMap[pluginName];
-        return plugin->GetPlugin()->GetService();
-    } else {
-        this->pluginContext->LogError(SOURCE_LOCATION, "未找到插件 {}", pluginName);
-        return nullptr;
+ServiceHandle PluginManager::AcquireService(const std::string &pluginName) {
+    std::shared_ptr<Plugin> plugin;
+    std::shared_ptr<ThreadPins> owner;
+    unsigned token = this->registryEpoch.Enter();
+    const auto *snapshot = this->registry.load(std::memory_order_seq_cst);
+    auto iter = snapshot->find(pluginName);
+    if (iter != snapshot->end()) {
+        plugin = iter->second;
+        // 在读端临界区内登记调用, 写端发布新快照后的宽限期保证等待排空时不会漏掉本次调用
+        owner = plugin->BeginCall();
+    }
+    this->registryEpoch.Leave(token);
+    if (plugin == nullptr) {
+        // 卸载与重新加载之间的查找未命中属于正常情况
+        this->pluginContext->LogDebug(SOURCE_LOCATION, "未找到插件 {}", pluginName);
+        return ServiceHandle();
     }
+    ServiceHandle handle(plugin, std::move(owner));
+    auto *pluginPointer = this->InstantiatePlugin(plugin);
+    if (pluginPointer != nullptr) {
+        handle.Set(pluginPointer->GetService());
+    }
+    return handle;
+}
+
+void *PluginManager::GetService(const std::string &pluginName) {
+    return this->AcquireService(pluginName).Get();
 }
 
 bool PluginManager::DoDestroyPlugin(const std::shared_ptr<Plugin> &plugin) {
+    std::lock_guard<std::recursive_mutex> lifecycleLock(this->lifecycleMutex);
     if (this->HasNoDependency(plugin)) {
-        this->pluginContext->LogInfo(SOURCE_LOCATION, "插件 {} 版本 {} ({}) 已销毁",
-                                     plugin->GetName(), plugin->GetVersion(),
-                                     plugin->GetDescription());
-        this->pluginMap.erase(plugin->GetName());
+        auto iter = this->pluginMap.find(plugin->GetName());
+        if (iter != this->pluginMap.end() && iter->second == plugin) {
+            this->pluginMap.erase(iter);
+        }
         this->pluginList.erase(
             std::remove(this->pluginList.begin(), this->pluginList.end(), plugin),
             this->pluginList.end());
-        plugin->DeletePlugin();
-        return this->GetPluginLoader()->UnloadPlugin(plugin);
+        this->PublishRegistry();
+        return this->RetirePlugin(plugin);
     } else {
         this->pluginContext->LogError(SOURCE_LOCATION,
                                       "无法卸载插件 {} ({}), 请先卸载所有依赖它的插件",
@@ -196,6 +338,69 @@ bool PluginManager::DoDestroyPlugin(const std::shared_ptr<Plugin> &plugin) {
     }
 }
 
+void PluginManager::PublishRegistry() {
+    auto *next = new std::map<std::string, std::shared_ptr<Plugin>>(this->pluginMap);
+    const auto *previous = this->registry.exchange(next, std::memory_order_seq_cst);
+    this->registryEpoch.Synchronize();
+    delete previous;
+}
+
+bool PluginManager::RetirePlugin(const std::shared_ptr<Plugin> &plugin) {
+    if (plugin->IsPinnedByCurrentThread()) {
+        // 在该插件自身的调用中重载或卸载它, 本线程的句柄要等返回后才释放
+        this->pluginContext->LogWarn(SOURCE_LOCATION,
+                                     "当前线程持有插件 {} 的调用, 前一个插件实例交给后台回收",
+                                     plugin->GetName());
+        std::lock_guard<std::mutex> lock(this->reaperMutex);
+        if (!this->reaper.joinable()) {
+            this->reaper = std::thread([this]() { this->ReaperLoop(); });
+        }
+        this->reaperQueue.emplace_back(plugin, this->GetPluginLoader());
+        this->reaperCondition.notify_one();
+        return true;
+    }
+    plugin->WaitForCalls();
+    return this->DestroyRetiredPlugin(plugin, this->GetPluginLoader());
+}
+
+bool PluginManager::DestroyRetiredPlugin(const std::shared_ptr<Plugin> &plugin,
+                                         const std::shared_ptr<PluginLoader> &loader) {
+    {
+        // 延迟加载且从未使用过的插件没有实例, 无需销毁
+        std::lock_guard<std::mutex> lock(plugin->GetInstantiateMutex());
+        if (plugin->GetPlugin() != nullptr) {
+            plugin->DeletePlugin();
+            plugin->SetPlugin(nullptr);
+        }
+    }
+    this->pluginContext->LogInfo(SOURCE_LOCATION, "插件 {} 版本 {} ({}) 已销毁",
+                                 plugin->GetName(), plugin->GetVersion(),
+                                 plugin->GetDescription());
+    return loader->UnloadPlugin(plugin);
+}
+
+void PluginManager::ReaperLoop() {
+    std::unique_lock<std::mutex> lock(this->reaperMutex);
+    while (true) {
+        this->reaperCondition.wait(lock, [this]() {
+            return this->reaperStopping || !this->reaperQueue.empty();
+        });
+        // 停止时仍处理完队列, 保证每个旧实例都被销毁
+        if (this->reaperQueue.empty()) {
+            return;
+        }
+        auto [plugin, loader] = this->reaperQueue.front();
+        this->reaperQueue.pop_front();
+        lock.unlock();
+        plugin->WaitForCalls();
+        {
+            std::lock_guard<std::recursive_mutex> lifecycleLock(this->lifecycleMutex);
+            this->DestroyRetiredPlugin(plugin, loader);
+        }
+        lock.lock();
+    }
+}
+
 std::shared_ptr<PluginContext> PluginManager::GetPluginContext() const {
     return this->pluginContext;
 }
@@ -11,8 +11,16 @@
 
 #include "PluginBase.h"
 #include "PluginLoader.h"
+#include "ReaderEpoch.h"
+#include "ServiceHandle.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <uuid/uuid.h>
 #include <vector>
 
@@ -75,9 +83,21 @@ class PluginManager {
      * @brief 获取指定插件提供的服务接口
      * @param[in] pluginName 插件名称
      * @return 服务接口指针，未找到返回nullptr
+     * @deprecated 返回前已结束调用登记，指针在插件被重载或卸载后失效，仅用于检查插件是否存在；
+     * 数据路径上调用服务应使用AcquireService
      */
     void *GetService(const std::string &pluginName);
 
+    /**
+     * @brief 获取指定插件的服务句柄
+     * @details 句柄存活期间插件实例不会被销毁，热重载会切换到新实例并等待句柄释放后再销毁旧实例。
+     * 持有句柄的线程重载或卸载同一插件时不等待，旧实例由后台回收线程在句柄释放后销毁。
+     * 查找读取注册表快照，调用登记在线程的固定槽上，插件已实例化时不加锁、不分配内存
+     * @param[in] pluginName 插件名称
+     * @return 服务句柄，未找到插件时句柄内的服务接口指针为nullptr
+     */
+    ServiceHandle AcquireService(const std::string &pluginName);
+
     /**
      * @brief 获取插件上下文对象
      * @return 插件上下文共享指针
@@ -99,9 +119,13 @@ class PluginManager {
 
     /**
      * @brief 执行插件初始化操作
+     * @details 参数core.lazyLoad为true时仅注册插件，实例化和初始化推迟到首次获取服务时；
+     * 否则首次加载时先注册插件再执行初始化。
+     * 同名插件已加载时执行热重载：新实例初始化完成后原子切换，旧实例在进行中的调用结束后销毁
      * @param[in] plugin 待初始化的插件对象
+     * @return 初始化成功返回true，失败返回false
      */
-    void DoInitializePlugin(const std::shared_ptr<Plugin> &plugin);
+    bool DoInitializePlugin(const std::shared_ptr<Plugin> &plugin);
 
   protected:
     /// 插件管理器配置参数映射表
@@ -121,10 +145,36 @@ class PluginManager {
     /// 已加载插件的有序列表，按加载顺序排列
     std::vector<std::shared_ptr<Plugin>> pluginList;
 
-    /// 插件名称到插件对象的映射表，用于快速查找
+    /// 插件名称到插件对象的映射表，由写端在生命周期互斥锁内维护
     std::map<std::string, std::shared_ptr<Plugin>> pluginMap;
 
-    
+    /// 热重载时因被其他插件依赖而暂缓销毁的旧插件实例
+    std::vector<std::shared_ptr<Plugin>> retiredPlugins;
+
+    /// 插件生命周期互斥锁，串行化加载、卸载和重载操作
+    std::recursive_mutex lifecycleMutex;
+
+    /// 插件名称到插件对象的只读快照，供服务查找无锁读取，写端修改pluginMap后整体替换
+    std::atomic<const std::map<std::string, std::shared_ptr<Plugin>> *> registry;
+
+    /// 注册表快照的读端纪元，用于回收被替换的快照
+    ReaderEpoch registryEpoch;
+
+    /// 因当前线程持有其调用而无法就地销毁、等待后台回收的插件及其加载器，
+    /// 保存加载器使析构时仍能卸载插件
+    std::deque<std::pair<std::shared_ptr<Plugin>, std::shared_ptr<PluginLoader>>> reaperQueue;
+
+    /// 互斥锁，保护reaperQueue和reaperStopping
+    std::mutex reaperMutex;
+
+    /// 后台回收线程的条件变量
+    std::condition_variable reaperCondition;
+
+    /// 后台回收线程是否停止
+    bool reaperStopping;
+
+    /// 后台回收线程，首次需要时启动
+    std::thread reaper;
 
     /**
      * @brief 执行插件销毁操作
@@ -133,6 +183,49 @@ class PluginManager {
      */
     bool DoDestroyPlugin(const std::shared_ptr<Plugin> &plugin);
 
+    /**
+     * @brief 判断是否启用了延迟加载模式
+     * @return 参数core.lazyLoad为true时返回true，否则返回false
+     */
+    bool IsLazyLoadEnabled() const;
+
+    /**
+     * @brief 实例化并初始化插件，已实例化的插件直接返回
+     * @details 使用双重检查加锁，保证并发首次使用时NewPlugin和Initialize只执行一次。
+     * 插件在自身的Initialize中再次获取自身服务时，返回正在初始化的实例而不再加锁
+     * @param[in] plugin 待实例化的插件对象
+     * @return 插件实例，创建失败返回nullptr
+     */
+    PluginBase *InstantiatePlugin(const std::shared_ptr<Plugin> &plugin);
+
+    /**
+     * @brief 根据pluginMap发布新的注册表快照
+     * @details 等待读取旧快照的服务查找全部结束后释放旧快照，需持有生命周期互斥锁调用
+     */
+    void PublishRegistry();
+
+    /**
+     * @brief 等待插件进行中的调用结束后销毁插件实例并卸载插件
+     * @details 当前线程持有该插件的调用时，等待会永远阻塞，改为交给后台回收线程
+     * @param[in] plugin 已从注册表中摘除的插件对象
+     * @return 卸载成功或已交给后台回收返回true，失败返回false
+     */
+    bool RetirePlugin(const std::shared_ptr<Plugin> &plugin);
+
+    /**
+     * @brief 销毁插件实例并卸载插件，调用方已等待进行中的调用结束
+     * @param[in] plugin 已从注册表中摘除的插件对象
+     * @param[in] loader 加载该插件的加载器
+     * @return 卸载成功返回true，失败返回false
+     */
+    bool DestroyRetiredPlugin(const std::shared_ptr<Plugin> &plugin,
+                              const std::shared_ptr<PluginLoader> &loader);
+
+    /**
+     * @brief 后台回收线程的主循环，逐个等待插件调用结束后销毁
+     */
+    void ReaperLoop();
+
     /**
      * @brief 检查插件是否与已加载插件存在冲突
      * @param[in] plugin 待检查的插件对象
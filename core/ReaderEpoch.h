@@ -0,0 +1,123 @@
+/**
+ * @file ReaderEpoch.h
+ * @brief 读端纪元计数器
+ * @details 为读多写少的共享数据提供无锁读端临界区和写端宽限期等待，用于安全回收被替换的只读快照
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-06-29
+ */
+
+#ifndef FLEET_DATA_MANAGER_CORE_READER_EPOCH_H
+#define FLEET_DATA_MANAGER_CORE_READER_EPOCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+
+namespace Fleet::DataManager::Core {
+/**
+ * @brief 读端纪元计数器类
+ * @details 读端进入临界区时在当前纪元的计数槽上加一、退出时减一，只有两次原子操作，不会阻塞也不会重试。
+ * 计数槽按线程分散到独立缓存行，避免读端之间的伪共享。
+ * 写端替换共享数据后调用Synchronize，两次翻转纪元并等待旧纪元计数归零，
+ * 返回后所有可能看到旧数据的读端都已退出临界区，旧数据可以安全释放
+ */
+class ReaderEpoch {
+  public:
+    /**
+     * @brief 构造读端纪元计数器
+     */
+    ReaderEpoch() : epoch(0) {
+        for (auto &slot : this->slots) {
+            slot.count[0].store(0, std::memory_order_relaxed);
+            slot.count[1].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    ReaderEpoch(const ReaderEpoch &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    ReaderEpoch &operator=(const ReaderEpoch &) = delete;
+
+    /**
+     * @brief 进入读端临界区
+     * @return 读端令牌，退出临界区时传给Leave
+     */
+    unsigned Enter() {
+        unsigned index = SlotIndex();
+        unsigned current = this->epoch.load(std::memory_order_acquire) & 1;
+        // 顺序一致的计数与写端翻转纪元后的检查构成Dekker式同步, 保证写端不会漏掉本读端
+        this->slots[index].count[current].fetch_add(1, std::memory_order_seq_cst);
+        return (index << 1) | current;
+    }
+
+    /**
+     * @brief 退出读端临界区
+     * @param[in] token Enter返回的读端令牌
+     */
+    void Leave(unsigned token) {
+        this->slots[token >> 1].count[token & 1].fetch_sub(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 等待宽限期结束
+     * @details 调用前已经发布的修改，在返回后对所有新进入的读端可见，且此前进入的读端均已退出。
+     * 多个写端需由调用方串行化
+     */
+    void Synchronize() {
+        for (int i = 0; i < 2; i++) {
+            unsigned previous = this->epoch.fetch_add(1, std::memory_order_seq_cst) & 1;
+            while (this->ActiveReaders(previous) != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+  private:
+    /// 计数槽数量
+    static constexpr std::size_t SlotCount = 16;
+
+    /**
+     * @brief 计数槽，每个槽独占一条缓存行
+     */
+    struct alignas(64) Slot {
+        /// 两个纪元各自的进行中读端数量
+        std::atomic<long> count[2];
+    };
+
+    /// 当前纪元，最低位选择读端使用的计数
+    std::atomic<unsigned> epoch;
+
+    /// 按线程分散的计数槽
+    Slot slots[SlotCount];
+
+    /**
+     * @brief 统计指定纪元上进行中的读端数量
+     * @param[in] which 纪元最低位
+     * @return 进行中的读端数量
+     */
+    long ActiveReaders(unsigned which) const {
+        long total = 0;
+        for (const auto &slot : this->slots) {
+            total += slot.count[which].load(std::memory_order_acquire);
+        }
+        return total;
+    }
+
+    /**
+     * @brief 获取当前线程使用的计数槽下标
+     * @return 计数槽下标
+     */
+    static unsigned SlotIndex() {
+        thread_local unsigned index =
+            (unsigned) (std::hash<std::thread::id>()(std::this_thread::get_id()) % SlotCount);
+        return index;
+    }
+};
+} // namespace Fleet::DataManager::Core
+#endif // FLEET_DATA_MANAGER_CORE_READER_EPOCH_H
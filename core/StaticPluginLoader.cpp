@@ -30,6 +30,7 @@ bool StaticPluginLoader::LoadPlugin(const std::string &path,
 
 bool StaticPluginLoader::UnloadPlugin(const std::shared_ptr<Plugin> &plugin) {
     // 无需卸载静态插件
+    (void) plugin;
     return true;
 }
 } // namespace Fleet::DataManager::Core
\ No newline at end of file
@@ -6,7 +6,9 @@
 #include "Device.h"
 #include "DynamicPluginManager.h"
 #include "Location.h"
+#include "CancellationToken.h"
 #include "Logger.h"
+#include "MemoryPool.h"
 #include "MessagingService.h"
 #include "PluginManager.h"
 #include "PortalService.h"
@@ -20,6 +22,17 @@
 std::set<void *> pluginManagerSet;
 std::mutex pluginManagerSetMutex;
 
+namespace {
+/**
+ * @brief 返回给调用者的数据块及其来源
+ * @details 数据块在分配时即确定是否映射段文件，释放时直接由数据块指针转换得到，不需要查表加锁
+ */
+struct DataBlockHolder : public DataBlock {
+    /// 映射方式读取时持有的存储数据块，映射在最后一个引用释放时解除，普通数据块为nullptr
+    std::shared_ptr<Fleet::DataManager::Storage::DataBlock> mapped;
+};
+} // namespace
+
 #ifdef DYNAMIC_PLUGIN_MANAGER
 #define NewDynamicPluginManager NewPluginManager
 #define NewDynamicPluginManagerByUuid NewPluginManagerByUuid
@@ -231,6 +244,29 @@ void LoadPlugins(void *pluginManager) {
                                                             "返回");
 }
 
+int ReloadPlugin(void *pluginManager, const char *path) {
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "调用");
+    if (!IsValidPluginManager(pluginManager)) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "无效的插件管理器指针");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return 0;
+    }
+    if (path == nullptr) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "插件路径为空");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return 0;
+    }
+    bool success = ((Fleet::DataManager::Core::PluginManager *) pluginManager)->LoadPlugin(path);
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "返回");
+    return success ? 1 : 0;
+}
+
 void UnloadPlugins(void *pluginManager) {
     Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                             "调用");
@@ -256,10 +292,10 @@ int StartApiServer(void *pluginManager, const char *address) {
                                                                 "返回");
         return false;
     }
+    auto apiServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Api");
     Fleet::DataManager::Api::ApiService *apiService =
-        (Fleet::DataManager::Api::ApiService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                     pluginManager)
-            ->GetService("Api");
+        (Fleet::DataManager::Api::ApiService *) apiServiceHandle.Get();
     if (apiService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -283,10 +319,10 @@ int StartApiServerByPort(void *pluginManager, const char *address, int port) {
                                                                 "返回");
         return false;
     }
+    auto apiServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Api");
     Fleet::DataManager::Api::ApiService *apiService =
-        (Fleet::DataManager::Api::ApiService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                     pluginManager)
-            ->GetService("Api");
+        (Fleet::DataManager::Api::ApiService *) apiServiceHandle.Get();
     if (apiService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -310,10 +346,10 @@ int StopApiServer(void *pluginManager) {
                                                                 "返回");
         return false;
     }
+    auto apiServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Api");
     Fleet::DataManager::Api::ApiService *apiService =
-        (Fleet::DataManager::Api::ApiService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                     pluginManager)
-            ->GetService("Api");
+        (Fleet::DataManager::Api::ApiService *) apiServiceHandle.Get();
     if (apiService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -337,10 +373,10 @@ int GetApiPort(void *pluginManager) {
                                                                 "返回");
         return -1;
     }
+    auto apiServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Api");
     Fleet::DataManager::Api::ApiService *apiService =
-        (Fleet::DataManager::Api::ApiService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                     pluginManager)
-            ->GetService("Api");
+        (Fleet::DataManager::Api::ApiService *) apiServiceHandle.Get();
     if (apiService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -364,10 +400,10 @@ void StartTcp(void *pluginManager, const char *address) {
                                                                 "返回");
         return;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         messagingService->StartTcp(address, 0);
     } else {
@@ -388,10 +424,10 @@ void StartTcpByPort(void *pluginManager, const char *address, int port) {
                                                                 "返回");
         return;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         messagingService->StartTcp(address, port);
     } else {
@@ -412,10 +448,10 @@ void StopTcp(void *pluginManager) {
                                                                 "返回");
         return;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         messagingService->StopTcp();
     } else {
@@ -436,10 +472,10 @@ int GetTcpPort(void *pluginManager) {
                                                                 "返回");
         return -1;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -463,10 +499,10 @@ void StartUdp(void *pluginManager, const char *address) {
                                                                 "返回");
         return;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         messagingService->StartUdp(address, 0);
     } else {
@@ -487,10 +523,10 @@ void StartUdpByPort(void *pluginManager, const char *address, int port) {
                                                                 "返回");
         return;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         messagingService->StartUdp(address, port);
     } else {
@@ -511,10 +547,10 @@ void StopUdp(void *pluginManager) {
                                                                 "返回");
         return;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         messagingService->StopUdp();
     } else {
@@ -535,10 +571,10 @@ int GetUdpPort(void *pluginManager) {
                                                                 "返回");
         return -1;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -574,8 +610,9 @@ int StartXQuic(void *pluginManager, const char *address) {
         return false;
     }
 
+    auto messagingServiceHandle = pm->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService *) pm->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
 
     if (messagingService != nullptr) {
         messagingService->StartXQuic(address, 0);
@@ -613,8 +650,9 @@ int StartXQuicByPort(void *pluginManager, const char *address, int port) {
         return false;
     }
 
+    auto messagingServiceHandle = pm->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService *) pm->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
 
     if (messagingService != nullptr) {
         messagingService->StartXQuic(address, port);
@@ -652,8 +690,9 @@ void StopXQuic(void *pluginManager) {
         return;
     }
 
+    auto messagingServiceHandle = pm->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService *) pm->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
 
     if (messagingService != nullptr) {
         messagingService->StopXQuic();
@@ -675,10 +714,10 @@ int GetXQuicPort(void *pluginManager) {
                                                                 "返回");
         return -1;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -710,10 +749,10 @@ void StartSharedMemory(void *pluginManager) {
         return;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         messagingService->StartSharedMemory();
     } else {
@@ -742,10 +781,10 @@ void StopSharedMemory(void *pluginManager) {
         return;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         messagingService->StopSharedMemory();
     } else {
@@ -766,10 +805,10 @@ void Join(void *pluginManager, const char *id, const char *address, int port) {
                                                                 "返回");
         return;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         messagingService->Join(id, address, port);
     } else {
@@ -790,10 +829,10 @@ void Leave(void *pluginManager, const char *id) {
                                                                 "返回");
         return;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         messagingService->Leave(id);
     } else {
@@ -814,10 +853,10 @@ int Publish(void *pluginManager, const char *topic, int size, const char *data)
                                                                 "返回");
         return false;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -842,10 +881,10 @@ int Subscribe(void *pluginManager, const char *topic, MessageCallback messageCal
                                                                 "返回");
         return false;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -869,10 +908,10 @@ int Unsubscribe(void *pluginManager, const char *topic, MessageCallback messageC
                                                                 "返回");
         return false;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -897,10 +936,10 @@ int Request(void *pluginManager, const char *topic, int requestSize, const char
                                                                 "返回");
         return false;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -925,10 +964,10 @@ int Reply(void *pluginManager, const char *uuid, int responseSize, const char *r
                                                                 "返回");
         return false;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -952,10 +991,10 @@ int CancelRequest(void *pluginManager, const char *uuid) {
                                                                 "返回");
         return 0;
     }
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         bool result = messagingService->CancelRequest(std::string(uuid));
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
@@ -1006,10 +1045,10 @@ int SqliteExecuteResult(void *pluginManager, const char *path, const char *sql,
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService != nullptr) {
         void *connection = storageService->ConnectToSqlite(path);
         if (connection == nullptr) {
@@ -1042,10 +1081,10 @@ int SqliteExecuteNoResult(void *pluginManager, const char *path, const char *sql
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService != nullptr) {
         void *connection = storageService->ConnectToSqlite(path);
         if (connection == nullptr) {
@@ -1077,10 +1116,10 @@ int SqliteExecuteParameterizedResult(void *pluginManager, const char *path, cons
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService != nullptr) {
         void *connection = storageService->ConnectToSqlite(path);
         if (connection == nullptr) {
@@ -1123,10 +1162,10 @@ int SqliteExecuteParameterizedNoResult(void *pluginManager, const char *path, co
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService != nullptr) {
         void *connection = storageService->ConnectToSqlite(path);
         if (connection == nullptr) {
@@ -1164,10 +1203,10 @@ int PostgreSqlExecuteResult(void *pluginManager, const char *connectionString, c
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService != nullptr) {
         void *connection = storageService->ConnectToPostgreSql(connectionString);
         if (connection == nullptr) {
@@ -1200,10 +1239,10 @@ int PostgreSqlExecuteNoResult(void *pluginManager, const char *connectionString,
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService != nullptr) {
         void *connection = storageService->ConnectToPostgreSql(connectionString);
         if (connection == nullptr) {
@@ -1236,10 +1275,10 @@ int PostgreSqlExecuteParameterizedResult(void *pluginManager, const char *connec
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService != nullptr) {
         void *connection = storageService->ConnectToPostgreSql(connectionString);
         if (connection == nullptr) {
@@ -1285,10 +1324,10 @@ int PostgreSqlExecuteParameterizedNoResult(void *pluginManager, const char *conn
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService != nullptr) {
         void *connection = storageService->ConnectToPostgreSql(connectionString);
         if (connection == nullptr) {
@@ -1359,10 +1398,10 @@ struct DataInfo *GetDataInfo(void *pluginManager, const char *name, const char *
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1403,10 +1442,10 @@ struct DataInfo *GetDataInfoWithVersion(void *pluginManager, const char *name, c
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1485,10 +1524,10 @@ int CreateDevice(void *pluginManager, const char *name, const char *description,
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1513,10 +1552,10 @@ int UpdateDevice(void *pluginManager, const char *name, const char *newDescripti
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1540,10 +1579,10 @@ int RemoveDevice(void *pluginManager, const char *name) {
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1598,10 +1637,10 @@ struct Device *GetDeviceByName(void *pluginManager, const char *name) {
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1626,10 +1665,10 @@ struct Device *GetDefaultDevice(void *pluginManager) {
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1654,10 +1693,10 @@ struct DeviceList *GetAllDevices(void *pluginManager) {
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1719,10 +1758,10 @@ int CreateStrategy(void *pluginManager, const char *name, const char *descriptio
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1757,10 +1796,10 @@ int UpdateStrategy(void *pluginManager, const char *name, const char *newDescrip
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1792,10 +1831,10 @@ int RemoveStrategy(void *pluginManager, const char *name) {
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1863,10 +1902,10 @@ struct Strategy *GetStrategyByName(void *pluginManager, const char *name) {
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1891,10 +1930,10 @@ struct Strategy *GetDefaultStrategy(void *pluginManager) {
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1919,10 +1958,10 @@ struct StrategyList *GetAllStrategies(void *pluginManager) {
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1956,10 +1995,10 @@ int CreateProfile(void *pluginManager, const char *application, const char *data
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -1984,10 +2023,10 @@ int UpdateProfile(void *pluginManager, const char *application, const char *data
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2011,10 +2050,10 @@ int RemoveProfile(void *pluginManager, const char *application, const char *data
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2038,10 +2077,10 @@ char *GetProfile(void *pluginManager, const char *application, const char *dataT
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2071,10 +2110,10 @@ int CreateProfileForApplication(void *pluginManager, const char *application,
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2099,10 +2138,10 @@ int UpdateProfileForApplication(void *pluginManager, const char *application,
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2126,10 +2165,10 @@ int RemoveProfileForApplication(void *pluginManager, const char *application) {
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2153,10 +2192,10 @@ char *GetProfileForApplication(void *pluginManager, const char *application) {
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2185,10 +2224,10 @@ int CreateProfileForDataType(void *pluginManager, const char *dataType, const ch
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2213,10 +2252,10 @@ int UpdateProfileForDataType(void *pluginManager, const char *dataType,
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2240,10 +2279,10 @@ int RemoveProfileForDataType(void *pluginManager, const char *dataType) {
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2267,10 +2306,10 @@ char *GetProfileForDataType(void *pluginManager, const char *dataType) {
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2299,10 +2338,10 @@ char *FindProfile(void *pluginManager, const char *application, const char *data
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2321,13 +2360,22 @@ char *FindProfile(void *pluginManager, const char *application, const char *data
     return ret;
 }
 
+/// 写入路径上数据块对象及其控制块的分配器
+using DataBlockAllocator =
+    Fleet::DataManager::Core::PoolAllocator<Fleet::DataManager::Storage::DataBlock,
+                                            Fleet::DataManager::Core::MemorySubsystem::Core>;
+
 void FreeDataBlock(struct DataBlock *dataBlock) {
     if (dataBlock == nullptr) {
         return;
     }
 
-    delete[] dataBlock->data;
-    delete dataBlock;
+    auto *holder = static_cast<DataBlockHolder *>(dataBlock);
+    if (holder->mapped == nullptr) {
+        Fleet::DataManager::Core::MemoryPool::Global().Deallocate(
+            dataBlock->data, dataBlock->size, Fleet::DataManager::Core::MemorySubsystem::Core);
+    }
+    delete holder;
 }
 
 struct DataBlock *
@@ -2335,13 +2383,28 @@ BuildDataBlock(const std::shared_ptr<Fleet::DataManager::Storage::DataBlock> &da
     if (dataBlock == nullptr) {
         return nullptr;
     }
-    struct DataBlock *ret = new struct DataBlock;
+    struct DataBlock *ret = new DataBlockHolder();
     ret->size = dataBlock->GetSize();
-    ret->data = new char[ret->size];
+    ret->data = static_cast<char *>(Fleet::DataManager::Core::MemoryPool::Global().Allocate(
+        ret->size, Fleet::DataManager::Core::MemorySubsystem::Core));
     memcpy(ret->data, dataBlock->GetData(), ret->size);
     return ret;
 }
 
+namespace {
+struct DataBlock *
+BuildMappedDataBlock(const std::shared_ptr<Fleet::DataManager::Storage::DataBlock> &dataBlock) {
+    if (dataBlock == nullptr || !dataBlock->IsMapped()) {
+        return BuildDataBlock(dataBlock);
+    }
+    auto *holder = new DataBlockHolder();
+    holder->mapped = dataBlock;
+    holder->size = dataBlock->GetSize();
+    holder->data = const_cast<char *>(dataBlock->GetData());
+    return holder;
+}
+} // namespace
+
 struct DataBlock *ReadData(void *pluginManager, const char *application, const char *dataType,
                            const char *name) {
     Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
@@ -2353,10 +2416,10 @@ struct DataBlock *ReadData(void *pluginManager, const char *application, const c
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2382,10 +2445,10 @@ struct DataBlock *ReadDataWithVersion(void *pluginManager, const char *applicati
                                                                 "返回");
         return nullptr;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2411,10 +2474,10 @@ int WriteData(void *pluginManager, const char *application, const char *dataType
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2422,7 +2485,8 @@ int WriteData(void *pluginManager, const char *application, const char *dataType
                                                                 "返回");
         return false;
     }
-    auto dataBlock = std::make_shared<Fleet::DataManager::Storage::DataBlock>(size, data);
+    auto dataBlock = std::allocate_shared<Fleet::DataManager::Storage::DataBlock>(
+        DataBlockAllocator(), size, data);
     bool success = storageService->WriteData(application, dataType, name, dataBlock);
     Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                             "返回");
@@ -2441,10 +2505,10 @@ int WriteDataWithVersion(void *pluginManager, const char *application, const cha
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2452,7 +2516,8 @@ int WriteDataWithVersion(void *pluginManager, const char *application, const cha
                                                                 "返回");
         return false;
     }
-    auto dataBlock = std::make_shared<Fleet::DataManager::Storage::DataBlock>(size, data);
+    auto dataBlock = std::allocate_shared<Fleet::DataManager::Storage::DataBlock>(
+        DataBlockAllocator(), size, data);
     bool success = storageService->WriteData(application, dataType, name, version, dataBlock);
     Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                             "返回");
@@ -2470,10 +2535,10 @@ int RemoveData(void *pluginManager, const char *application, const char *dataTyp
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2498,10 +2563,10 @@ int RemoveDataWithVersion(void *pluginManager, const char *application, const ch
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2526,10 +2591,10 @@ int RepairData(void *pluginManager, const char *application, const char *dataTyp
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2554,10 +2619,10 @@ int RepairDataWithVersion(void *pluginManager, const char *application, const ch
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2590,10 +2655,10 @@ int StoreTopic(void *pluginManager, const char *topic) {
         return false;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到消息协同插件");
@@ -2629,10 +2694,10 @@ int QueryTopic(void *pluginManager, const char *topic) {
         return -1;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到消息协同插件");
@@ -2668,10 +2733,10 @@ int DeleteTopic(void *pluginManager, const char *topic) {
         return false;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到消息协同插件");
@@ -2698,10 +2763,10 @@ int SetSpaceLimitSize(void *pluginManager, uint64_t size) {
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2725,10 +2790,10 @@ int GetSpaceLimitSize(void *pluginManager, uint64_t *size) {
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2752,10 +2817,10 @@ int GetUsedSpaceSize(void *pluginManager, uint64_t *size) {
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2779,10 +2844,10 @@ int GetTotalSpaceSize(void *pluginManager, uint64_t *size) {
                                                                 "返回");
         return false;
     }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
     Fleet::DataManager::Storage::StorageService *storageService =
-        (Fleet::DataManager::Storage::StorageService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                             pluginManager)
-            ->GetService("Storage");
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
     if (storageService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 本地存储 插件");
@@ -2863,10 +2928,10 @@ int CreateNode(void *pluginManager, const char *uuid, const char *ipAddress) {
         return false;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 消息协同 插件");
@@ -2903,10 +2968,10 @@ int UpdateNode(void *pluginManager, const char *uuid, const char *newIpAddress)
         return false;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 消息协同 插件");
@@ -2943,10 +3008,10 @@ int RemoveNode(void *pluginManager, const char *uuid) {
         return false;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 消息协同 插件");
@@ -2982,10 +3047,10 @@ struct NodeInfo *GetNodeByUuid(void *pluginManager, const char *uuid) {
         return nullptr;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 消息协同 插件");
@@ -3040,10 +3105,10 @@ struct NodeInfo *GetNodeByIpAddress(void *pluginManager, const char *ipAddress)
         return nullptr;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 消息协同 插件");
@@ -3090,10 +3155,10 @@ struct NodeInfoList *GetAllNodes(void *pluginManager) {
         return nullptr;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 消息协同 插件");
@@ -3166,10 +3231,10 @@ int NodeExists(void *pluginManager, const char *uuid) {
         return -1;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService == nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
                                                                 "未找到 消息协同 插件");
@@ -3198,10 +3263,10 @@ int UploadData(void *pluginManager, const char *dataType, const char *name, cons
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3226,10 +3291,10 @@ int UploadSecurityDataToAutoDownloadArea(void *pluginManager, const char *key, c
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3255,10 +3320,10 @@ int UploadSegmentData(void *pluginManager, const char *dataType, const char *key
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3285,10 +3350,10 @@ int DownloadData(void *pluginManager, const char *dataType, const char *name, co
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3312,10 +3377,10 @@ int QueryData(void *pluginManager, const char *dataType, const char *name, char
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3340,10 +3405,10 @@ int SyncData(void *pluginManager, const char *dataType, const char *name, const
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3367,10 +3432,10 @@ int SyncObject(void *pluginManager, const char *name, const char *dataOwner, con
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3394,10 +3459,10 @@ int ReceiveTelemetry(void *pluginManager, const char *from) {
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3421,10 +3486,10 @@ int ReportTelemetry(void *pluginManager, const char *from, const char *data, int
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3448,10 +3513,10 @@ int SendRemoteControl(void *pluginManager, const char *to, const char *data, int
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3493,10 +3558,10 @@ int BackupData(void *pluginManager, const char *dataType, const char *from, cons
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3521,10 +3586,10 @@ int RecoverData(void *pluginManager, const char *dataType, const char *from, con
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3548,10 +3613,10 @@ int ObservationOrder(void *pluginManager, const char *uuid, const char *data, in
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3575,10 +3640,10 @@ int ProcessingOrder(void *pluginManager, const char *uuid, const char *data, int
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3602,10 +3667,10 @@ int DispatchingOrder(void *pluginManager, const char *uuid, const char *data, in
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3629,10 +3694,10 @@ int OrderStatus(void *pluginManager, const char *uuid, char **data) {
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3656,10 +3721,10 @@ int OrderResult(void *pluginManager, const char *uuid, char **data) {
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3684,10 +3749,10 @@ int SqliteExecuteOnMultipleNodes(void *pluginManager, int nodeIdCount, const cha
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3719,10 +3784,10 @@ int SqliteExecuteParameterizedOnMultipleNodes(void *pluginManager, int nodeIdCou
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3759,10 +3824,10 @@ int PostgreSqlExecuteOnMultipleNodes(void *pluginManager, int nodeIdCount, const
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3795,10 +3860,10 @@ int PostgreSqlExecuteParameterizedOnMultipleNodes(void *pluginManager, int nodeI
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -3852,10 +3917,10 @@ int GetConfig(void *pluginManager, const char *key, char **value) {
         return -1;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         int result = messagingService->GetConfig(key, value);
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION, "返回，结果: {}",
@@ -3890,10 +3955,10 @@ int PutConfig(void *pluginManager, const char *key, const char *value, int lengt
         return 0;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         std::string valueStr(value, length);
         bool result = messagingService->PutConfig(key, valueStr, length);
@@ -3924,10 +3989,10 @@ int RemoveConfig(void *pluginManager, const char *key) {
         return 0;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         bool result = messagingService->RemoveConfig(key);
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION, "返回，结果: {}",
@@ -3951,10 +4016,10 @@ int SetClockOffset(void *pluginManager, long long offsetMs) {
         return 0;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         bool result = messagingService->SetClockOffset(static_cast<int64_t>(offsetMs));
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION, "返回，结果: {}",
@@ -3977,10 +4042,10 @@ long long GetClockOffset(void *pluginManager) {
         return 0;
     }
 
+    auto messagingServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Messaging");
     Fleet::DataManager::Messaging::MessagingService *messagingService =
-        (Fleet::DataManager::Messaging::MessagingService
-             *) ((Fleet::DataManager::Core::PluginManager *) pluginManager)
-            ->GetService("Messaging");
+        (Fleet::DataManager::Messaging::MessagingService *) messagingServiceHandle.Get();
     if (messagingService != nullptr) {
         int64_t result = messagingService->GetClockOffset();
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
@@ -4005,10 +4070,10 @@ int PublishResumableMessage(void *pluginManager, const char *topic, const char *
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4034,10 +4099,10 @@ int SubscribeResumableMessage(void *pluginManager, const char *topic,
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4062,10 +4127,10 @@ int PublishReliableMessage(void *pluginManager, const char *topic, const char *d
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4091,10 +4156,10 @@ int SubscribeReliableMessage(void *pluginManager, const char *topic,
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4120,10 +4185,10 @@ int SendControlCommand(void *pluginManager, const char *targetNode, const char *
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4149,10 +4214,10 @@ int SubscribeControlCommand(void *pluginManager,
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4178,10 +4243,10 @@ int SendStatusData(void *pluginManager, const char *targetNode, const char *stat
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4207,10 +4272,10 @@ int SubscribeStatusData(void *pluginManager,
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4236,10 +4301,10 @@ int SendTaskPlanningInfo(void *pluginManager, const char *targetNode, const char
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4265,10 +4330,10 @@ int SubscribeTaskPlanningInfo(void *pluginManager,
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4294,10 +4359,10 @@ int SendSchedulingInfo(void *pluginManager, const char *targetNode, const char *
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4323,10 +4388,10 @@ int SubscribeSchedulingInfo(void *pluginManager,
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4352,10 +4417,10 @@ int SendResourceStatus(void *pluginManager, const char *targetNode, const char *
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4381,10 +4446,10 @@ int SubscribeResourceStatus(void *pluginManager,
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4408,10 +4473,10 @@ int PublishCommand(void *pluginManager, const char *topic, const char *command,
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4435,10 +4500,10 @@ int SubscribeCommand(void *pluginManager, const char *topic, MessageCallback cal
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4463,10 +4528,10 @@ int RequestCommand(void *pluginManager, const char *topic, const char *request,
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4491,10 +4556,10 @@ int ReplyCommand(void *pluginManager, const char *uuid, const char *reply, int l
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4518,10 +4583,10 @@ int PublishStatusInfo(void *pluginManager, const char *topic, const char *status
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4545,10 +4610,10 @@ int SubscribeStatusInfo(void *pluginManager, const char *topic, MessageCallback
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4573,10 +4638,10 @@ int RequestStatusInfo(void *pluginManager, const char *topic, const char *reques
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4602,10 +4667,10 @@ int ReplyStatusInfo(void *pluginManager, const char *uuid, const char *reply, in
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4629,10 +4694,10 @@ int PublishSmallFile(void *pluginManager, const char *topic, const char *fileDat
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4656,10 +4721,10 @@ int SubscribeSmallFile(void *pluginManager, const char *topic, MessageCallback c
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4684,10 +4749,10 @@ int RequestSmallFile(void *pluginManager, const char *topic, const char *request
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4713,10 +4778,10 @@ int ReplySmallFile(void *pluginManager, const char *uuid, const char *reply, int
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4741,10 +4806,10 @@ int ProductDataStore(void *pluginManager, const char *name, const char *dataOwne
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4768,10 +4833,10 @@ int ProductAnalysis(void *pluginManager, const char *data, int length, const cha
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4796,10 +4861,10 @@ int QueryProductFilename(void *pluginManager, const char *ProductName, const cha
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4825,10 +4890,10 @@ int UploadSegmentObject(void *pluginManager, const char *key, const char *owner,
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4854,10 +4919,10 @@ int UploadObject(void *pluginManager, const char *name, const char *dataOwner, c
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4883,10 +4948,10 @@ int QueryObjectUseMeta(void *pluginManager, const char *dataOwner, const char *t
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4911,10 +4976,10 @@ int GetObjectMetadata(void *pluginManager, const char *name, const char *dataOwn
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4939,10 +5004,10 @@ int SetObjectMetadata(void *pluginManager, const char *name, const char *dataOwn
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4967,10 +5032,10 @@ int DeleteObjectMetadata(void *pluginManager, const char *name, const char *data
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -4995,10 +5060,10 @@ int UpdateObjectMetadata(void *pluginManager, const char *name, const char *data
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -5022,10 +5087,10 @@ int DownloadObject(void *pluginManager, const char *name, const char *dataOwner,
                                                                 "返回");
         return false;
     }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
     Fleet::DataManager::Portal::PortalService *portalService =
-        (Fleet::DataManager::Portal::PortalService *) ((Fleet::DataManager::Core::PluginManager *)
-                                                           pluginManager)
-            ->GetService("Portal");
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
     if (portalService != nullptr) {
         Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
                                                                 "返回");
@@ -5037,4 +5102,308 @@ int DownloadObject(void *pluginManager, const char *name, const char *dataOwner,
                                                                 "返回");
         return false;
     }
-}
\ No newline at end of file
+}
+
+int GetMemoryUsage(int subsystem, struct MemoryUsage *usage) {
+    if (usage == nullptr || subsystem < 0 ||
+        subsystem >= (int) Fleet::DataManager::Core::MemorySubsystem::Count) {
+        return 0;
+    }
+    auto statistics = Fleet::DataManager::Core::MemoryPool::Global().GetStatistics(
+        (Fleet::DataManager::Core::MemorySubsystem) subsystem);
+    usage->allocations = statistics.allocations;
+    usage->deallocations = statistics.deallocations;
+    usage->pooledAllocations = statistics.pooledAllocations;
+    usage->systemAllocations = statistics.systemAllocations;
+    usage->arenaAllocations = statistics.arenaAllocations;
+    usage->bytesInUse = statistics.bytesInUse;
+    return 1;
+}
+
+namespace {
+std::shared_ptr<Fleet::DataManager::Core::CancellationToken>
+GetCancellationToken(void *token) {
+    if (token == nullptr) {
+        return nullptr;
+    }
+    return *(std::shared_ptr<Fleet::DataManager::Core::CancellationToken> *) token;
+}
+} // namespace
+
+void *NewCancellationToken(long long timeoutMs) {
+    return new std::shared_ptr<Fleet::DataManager::Core::CancellationToken>(
+        Fleet::DataManager::Core::CancellationToken::Create(timeoutMs));
+}
+
+void CancelCancellationToken(void *token) {
+    auto cancellationToken = GetCancellationToken(token);
+    if (cancellationToken != nullptr) {
+        cancellationToken->Cancel();
+    }
+}
+
+int IsCancellationTokenCancelled(void *token) {
+    return Fleet::DataManager::Core::IsCancelled(GetCancellationToken(token)) ? 1 : 0;
+}
+
+void FreeCancellationToken(void *token) {
+    delete (std::shared_ptr<Fleet::DataManager::Core::CancellationToken> *) token;
+}
+
+struct DataBlock *ReadDataWithToken(void *pluginManager, const char *application,
+                                    const char *dataType, const char *name, void *token) {
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "调用");
+    if (!IsValidPluginManager(pluginManager)) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "无效的插件管理器指针");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return nullptr;
+    }
+    auto cancellationToken = GetCancellationToken(token);
+    if (Fleet::DataManager::Core::IsCancelled(cancellationToken)) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Warn(SOURCE_LOCATION,
+                                                               "请求已取消或已超时");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return nullptr;
+    }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
+    Fleet::DataManager::Storage::StorageService *storageService =
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
+    if (storageService == nullptr) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "未找到 本地存储 插件");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return nullptr;
+    }
+    auto dataBlock =
+        storageService->ReadDataWithToken(application, dataType, name, cancellationToken);
+    auto ret = BuildDataBlock(dataBlock);
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "返回");
+    return ret;
+}
+
+int DownloadDataWithToken(void *pluginManager, const char *dataType, const char *name,
+                          const char *from, char **data, void *token) {
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "调用");
+    if (!IsValidPluginManager(pluginManager)) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "无效的插件管理器指针");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return -1;
+    }
+    auto cancellationToken = GetCancellationToken(token);
+    if (Fleet::DataManager::Core::IsCancelled(cancellationToken)) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Warn(SOURCE_LOCATION,
+                                                               "请求已取消或已超时");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return -1;
+    }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
+    Fleet::DataManager::Portal::PortalService *portalService =
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
+    if (portalService != nullptr) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return portalService->DownloadDataWithToken(dataType, name, from, *data,
+                                                    cancellationToken);
+    } else {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "未找到 存储门户 插件");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return -1;
+    }
+}
+
+int SqliteExecuteOnMultipleNodesWithToken(void *pluginManager, int nodeIdCount,
+                                          const char **nodeIdList, const char *connectionString,
+                                          const char *sql, void *token) {
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "调用");
+    if (!IsValidPluginManager(pluginManager)) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "无效的插件管理器指针");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return false;
+    }
+    auto cancellationToken = GetCancellationToken(token);
+    if (Fleet::DataManager::Core::IsCancelled(cancellationToken)) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Warn(SOURCE_LOCATION,
+                                                               "请求已取消或已超时");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return false;
+    }
+    auto portalServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Portal");
+    Fleet::DataManager::Portal::PortalService *portalService =
+        (Fleet::DataManager::Portal::PortalService *) portalServiceHandle.Get();
+    if (portalService != nullptr) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        std::vector<std::string> nodeIds;
+        int i = 0;
+        for (i = 0; i < nodeIdCount; i++) {
+            nodeIds.emplace_back(nodeIdList[i]);
+        }
+        return portalService->SqliteExecuteWithToken(nodeIds, connectionString, sql,
+                                                     cancellationToken);
+    } else {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "未找到 存储门户 插件");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return false;
+    }
+}
+
+namespace {
+Fleet::DataManager::Storage::MapAdvice GetMapAdvice(int advice) {
+    if (advice < static_cast<int>(Fleet::DataManager::Storage::MapAdvice::Normal) ||
+        advice > static_cast<int>(Fleet::DataManager::Storage::MapAdvice::WillNeed)) {
+        return Fleet::DataManager::Storage::MapAdvice::Normal;
+    }
+    return static_cast<Fleet::DataManager::Storage::MapAdvice>(advice);
+}
+} // namespace
+
+struct DataBlock *ReadDataMapped(void *pluginManager, const char *application,
+                                 const char *dataType, const char *name, int advice) {
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "调用");
+    if (!IsValidPluginManager(pluginManager)) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "无效的插件管理器指针");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return nullptr;
+    }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
+    Fleet::DataManager::Storage::StorageService *storageService =
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
+    if (storageService == nullptr) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "未找到 本地存储 插件");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return nullptr;
+    }
+    auto dataBlock =
+        storageService->ReadDataMapped(application, dataType, name, GetMapAdvice(advice));
+    auto ret = BuildMappedDataBlock(dataBlock);
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "返回");
+    return ret;
+}
+
+struct DataBlock *ReadDataMappedWithVersion(void *pluginManager, const char *application,
+                                            const char *dataType, const char *name,
+                                            const char *version, int advice) {
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "调用");
+    if (!IsValidPluginManager(pluginManager)) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "无效的插件管理器指针");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return nullptr;
+    }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
+    Fleet::DataManager::Storage::StorageService *storageService =
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
+    if (storageService == nullptr) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "未找到 本地存储 插件");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return nullptr;
+    }
+    auto dataBlock = storageService->ReadDataMapped(application, dataType, name, version,
+                                                    GetMapAdvice(advice));
+    auto ret = BuildMappedDataBlock(dataBlock);
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "返回");
+    return ret;
+}
+
+int SetReadCacheSize(void *pluginManager, uint64_t size) {
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "调用");
+    if (!IsValidPluginManager(pluginManager)) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "无效的插件管理器指针");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return 0;
+    }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
+    Fleet::DataManager::Storage::StorageService *storageService =
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
+    if (storageService == nullptr) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "未找到 本地存储 插件");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return 0;
+    }
+    bool success = storageService->SetReadCacheSize(size);
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "返回");
+    return success ? 1 : 0;
+}
+
+int GetReadCacheUsage(void *pluginManager, struct ReadCacheUsage *usage) {
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "调用");
+    if (usage == nullptr || !IsValidPluginManager(pluginManager)) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(
+            SOURCE_LOCATION, "无效的插件管理器指针或统计结构指针");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return 0;
+    }
+    auto storageServiceHandle =
+        ((Fleet::DataManager::Core::PluginManager *) pluginManager)->AcquireService("Storage");
+    Fleet::DataManager::Storage::StorageService *storageService =
+        (Fleet::DataManager::Storage::StorageService *) storageServiceHandle.Get();
+    if (storageService == nullptr) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Error(SOURCE_LOCATION,
+                                                                "未找到 本地存储 插件");
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return 0;
+    }
+    Fleet::DataManager::Storage::ReadCacheStatistics statistics;
+    if (!storageService->GetReadCacheStatistics(&statistics)) {
+        Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                                "返回");
+        return 0;
+    }
+    usage->hits = statistics.hits;
+    usage->misses = statistics.misses;
+    usage->insertions = statistics.insertions;
+    usage->rejections = statistics.rejections;
+    usage->evictions = statistics.evictions;
+    usage->invalidations = statistics.invalidations;
+    usage->entries = statistics.entries;
+    usage->bytes = statistics.bytes;
+    usage->capacity = statistics.capacity;
+    usage->hitRatio = statistics.GetHitRatio();
+    Fleet::DataManager::Core::Logger::ConsoleLogger().Trace(SOURCE_LOCATION,
+                                                            "返回");
+    return 1;
+}
@@ -0,0 +1,433 @@
+/**
+ * @file AsyncService.h
+ * @brief 异步服务接口定义
+ * @details 为存储、消息和门户服务提供基于协程的可等待接口，默认实现在共享执行器上调用同步接口
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_CORE_ASYNC_SERVICE_H
+#define FLEET_DATA_MANAGER_CORE_ASYNC_SERVICE_H
+
+#include "Task.h"
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include "MessagingService.h"
+#include "PortalService.h"
+#include "ServiceHandle.h"
+#include "StorageService.h"
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief 异步存储服务
+ * @details 包装同步的StorageService，每个异步方法默认将同步调用提交到执行器并在完成后恢复调用方协程，
+ * 调用方线程不会被阻塞；支持原生异步IO的存储插件可以继承本类并重写对应方法
+ * @note 参数按值传递并保存在协程帧中，调用方无需保证实参在等待期间有效
+ */
+class AsyncStorageService {
+  public:
+    /**
+     * @brief 构造异步存储服务
+     * @param[in] handle 同步存储服务的句柄，本对象存活期间插件实例不会被重载或卸载销毁
+     * @param[in] executor 执行同步调用的执行器
+     */
+    explicit AsyncStorageService(Core::ServiceHandle handle,
+                                 Core::Executor &executor = Core::Executor::Global())
+        : handle(std::move(handle)), service((StorageService *) this->handle.Get()),
+          executor(executor) {
+    }
+
+    /**
+     * @brief 虚析构函数
+     */
+    virtual ~AsyncStorageService() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    AsyncStorageService(const AsyncStorageService &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    AsyncStorageService &operator=(const AsyncStorageService &) = delete;
+
+    /**
+     * @brief 获取被包装的同步存储服务
+     * @return 同步存储服务指针
+     */
+    StorageService *GetService() const {
+        return this->service;
+    }
+
+    /**
+     * @brief 异步读取数据的最新版本
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @return 数据块对象指针，未找到返回nullptr
+     */
+    virtual Core::Task<std::shared_ptr<DataBlock>>
+    ReadDataAsync(std::string application, std::string dataType, std::string name) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->ReadData(application, dataType, name);
+        });
+    }
+
+    /**
+     * @brief 异步读取数据的指定版本
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @param[in] version 版本信息
+     * @return 数据块对象指针，未找到返回nullptr
+     */
+    virtual Core::Task<std::shared_ptr<DataBlock>> ReadDataAsync(std::string application,
+                                                                 std::string dataType,
+                                                                 std::string name,
+                                                                 std::string version) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->ReadData(application, dataType, name, version);
+        });
+    }
+
+    /**
+     * @brief 异步写入数据，自动生成版本
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @param[in] dataBlock 数据块对象
+     * @return 写入成功返回true，失败返回false
+     */
+    virtual Core::Task<bool> WriteDataAsync(std::string application, std::string dataType,
+                                            std::string name,
+                                            std::shared_ptr<DataBlock> dataBlock) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->WriteData(application, dataType, name, dataBlock);
+        });
+    }
+
+    /**
+     * @brief 异步写入数据的指定版本
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @param[in] version 版本信息
+     * @param[in] dataBlock 数据块对象
+     * @return 写入成功返回true，失败返回false
+     */
+    virtual Core::Task<bool> WriteDataAsync(std::string application, std::string dataType,
+                                            std::string name, std::string version,
+                                            std::shared_ptr<DataBlock> dataBlock) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->WriteData(application, dataType, name, version, dataBlock);
+        });
+    }
+
+    /**
+     * @brief 异步删除数据的所有版本
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @return 删除成功返回true，失败返回false
+     */
+    virtual Core::Task<bool> RemoveDataAsync(std::string application, std::string dataType,
+                                             std::string name) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->RemoveData(application, dataType, name);
+        });
+    }
+
+    /**
+     * @brief 异步修复数据的最新版本
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @return 修复成功返回true，失败返回false
+     */
+    virtual Core::Task<bool> RepairDataAsync(std::string application, std::string dataType,
+                                             std::string name) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->RepairData(application, dataType, name);
+        });
+    }
+
+    /**
+     * @brief 异步获取数据最新版本的信息
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @return 数据信息对象指针，未找到返回nullptr
+     */
+    virtual Core::Task<std::shared_ptr<DataInfo>>
+    GetDataInfoAsync(std::string application, std::string dataType, std::string name) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->GetDataInfo(application, dataType, name);
+        });
+    }
+
+  protected:
+    /// 同步存储服务的句柄，保证异步调用执行时服务仍然有效
+    Core::ServiceHandle handle;
+
+    /// 被包装的同步存储服务，由handle持有
+    StorageService *service;
+
+    /// 执行同步调用的执行器
+    Core::Executor &executor;
+};
+} // namespace Fleet::DataManager::Storage
+
+namespace Fleet::DataManager::Messaging {
+/**
+ * @brief 异步消息服务
+ * @details 包装同步的MessagingService，默认将同步调用提交到执行器执行
+ * @note 参数按值传递并保存在协程帧中，调用方无需保证实参在等待期间有效
+ */
+class AsyncMessagingService {
+  public:
+    /**
+     * @brief 构造异步消息服务
+     * @param[in] handle 同步消息服务的句柄，本对象存活期间插件实例不会被重载或卸载销毁
+     * @param[in] executor 执行同步调用的执行器
+     */
+    explicit AsyncMessagingService(Core::ServiceHandle handle,
+                                   Core::Executor &executor = Core::Executor::Global())
+        : handle(std::move(handle)), service((MessagingService *) this->handle.Get()),
+          executor(executor) {
+    }
+
+    /**
+     * @brief 虚析构函数
+     */
+    virtual ~AsyncMessagingService() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    AsyncMessagingService(const AsyncMessagingService &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    AsyncMessagingService &operator=(const AsyncMessagingService &) = delete;
+
+    /**
+     * @brief 获取被包装的同步消息服务
+     * @return 同步消息服务指针
+     */
+    MessagingService *GetService() const {
+        return this->service;
+    }
+
+    /**
+     * @brief 异步发布消息到指定主题
+     * @param[in] topic 消息主题
+     * @param[in] data 消息数据内容
+     * @return 发布成功返回true，失败返回false
+     */
+    virtual Core::Task<bool> PublishAsync(std::string topic, std::string data) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->Publish(topic, (int) data.size(), data.data());
+        });
+    }
+
+    /**
+     * @brief 异步回复请求消息
+     * @param[in] uuid 请求消息的唯一标识符
+     * @param[in] data 响应数据内容
+     * @return 回复成功返回true，失败返回false
+     */
+    virtual Core::Task<bool> ReplyAsync(std::string uuid, std::string data) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->Reply(uuid, (int) data.size(), data.data());
+        });
+    }
+
+    /**
+     * @brief 异步获取所有节点信息
+     * @return 节点信息列表
+     */
+    virtual Core::Task<std::vector<std::shared_ptr<NodeInfo>>> GetAllNodesAsync() {
+        co_return co_await Core::RunOn(this->executor,
+                                       [&]() { return this->service->GetAllNodes(); });
+    }
+
+  protected:
+    /// 同步消息服务的句柄，保证异步调用执行时服务仍然有效
+    Core::ServiceHandle handle;
+
+    /// 被包装的同步消息服务，由handle持有
+    MessagingService *service;
+
+    /// 执行同步调用的执行器
+    Core::Executor &executor;
+};
+} // namespace Fleet::DataManager::Messaging
+
+namespace Fleet::DataManager::Portal {
+/**
+ * @brief 异步门户服务
+ * @details 包装同步的PortalService，默认将同步调用提交到执行器执行
+ * @note 参数按值传递并保存在协程帧中，调用方无需保证实参在等待期间有效
+ */
+class AsyncPortalService {
+  public:
+    /**
+     * @brief 构造异步门户服务
+     * @param[in] handle 同步门户服务的句柄，本对象存活期间插件实例不会被重载或卸载销毁
+     * @param[in] executor 执行同步调用的执行器
+     */
+    explicit AsyncPortalService(Core::ServiceHandle handle,
+                                Core::Executor &executor = Core::Executor::Global())
+        : handle(std::move(handle)), service((PortalService *) this->handle.Get()),
+          executor(executor) {
+    }
+
+    /**
+     * @brief 虚析构函数
+     */
+    virtual ~AsyncPortalService() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    AsyncPortalService(const AsyncPortalService &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    AsyncPortalService &operator=(const AsyncPortalService &) = delete;
+
+    /**
+     * @brief 获取被包装的同步门户服务
+     * @return 同步门户服务指针
+     */
+    PortalService *GetService() const {
+        return this->service;
+    }
+
+    /**
+     * @brief 异步上传数据
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据唯一标识符
+     * @param[in] to 应用名称
+     * @param[in] data 数据
+     * @return 上传成功返回true，失败返回false
+     */
+    virtual Core::Task<bool> UploadDataAsync(std::string dataType, std::string name,
+                                             std::string to, std::string data) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->UploadData(dataType.c_str(), name.c_str(), to.c_str(),
+                                             data.data(), data.size());
+        });
+    }
+
+    /**
+     * @brief 异步下载数据
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据唯一标识符
+     * @param[in] from 数据来源
+     * @param[out] data 数据，由服务分配内存，调用方负责释放
+     * @return 数据长度
+     * @note data引用在等待期间必须有效
+     */
+    virtual Core::Task<int> DownloadDataAsync(std::string dataType, std::string name,
+                                              std::string from, char *&data) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->DownloadData(dataType.c_str(), name.c_str(), from.c_str(),
+                                               data);
+        });
+    }
+
+    /**
+     * @brief 异步同步数据到指定节点
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据唯一标识符
+     * @param[in] dataOwner 数据所有者
+     * @param[in] to 目标节点
+     * @return 同步成功返回true，失败返回false
+     */
+    virtual Core::Task<bool> SyncDataAsync(std::string dataType, std::string name,
+                                           std::string dataOwner, std::string to) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->SyncData(dataType.c_str(), name.c_str(), dataOwner.c_str(),
+                                           to.c_str());
+        });
+    }
+
+    /**
+     * @brief 异步上传对象
+     * @param[in] name 对象名称
+     * @param[in] dataOwner 数据所有者
+     * @param[in] data 对象数据
+     * @param[in] metadata 对象元数据（json格式）
+     * @return 上传成功返回true，失败返回false
+     */
+    virtual Core::Task<bool> UploadObjectAsync(std::string name, std::string dataOwner,
+                                               std::string data, std::string metadata) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->UploadObject(name.c_str(), dataOwner.c_str(), data.data(),
+                                               data.size(), metadata.data(), metadata.size());
+        });
+    }
+
+    /**
+     * @brief 异步下载对象
+     * @param[in] name 对象名称
+     * @param[in] dataOwner 数据所有者
+     * @param[out] data 对象数据，由服务分配内存，调用方负责释放
+     * @return 对象大小，小于0表示失败
+     * @note data引用在等待期间必须有效
+     */
+    virtual Core::Task<int> DownloadObjectAsync(std::string name, std::string dataOwner,
+                                                char *&data) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->DownloadObject(name.c_str(), dataOwner.c_str(), data);
+        });
+    }
+
+    /**
+     * @brief 异步发送状态数据
+     * @param[in] targetNode 目标节点
+     * @param[in] statusData 状态数据
+     * @return 发送成功返回true，失败返回false
+     */
+    virtual Core::Task<bool> SendStatusDataAsync(std::string targetNode, std::string statusData) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->SendStatusData(targetNode.c_str(), statusData.data(),
+                                                 statusData.size());
+        });
+    }
+
+    /**
+     * @brief 异步发布状态信息
+     * @param[in] topic 主题
+     * @param[in] statusInfo 状态信息
+     * @return 发布成功返回true，失败返回false
+     */
+    virtual Core::Task<bool> PublishStatusInfoAsync(std::string topic, std::string statusInfo) {
+        co_return co_await Core::RunOn(this->executor, [&]() {
+            return this->service->PublishStatusInfo(topic.c_str(), statusInfo.data(),
+                                                    (int) statusInfo.size());
+        });
+    }
+
+  protected:
+    /// 同步门户服务的句柄，保证异步调用执行时服务仍然有效
+    Core::ServiceHandle handle;
+
+    /// 被包装的同步门户服务，由handle持有
+    PortalService *service;
+
+    /// 执行同步调用的执行器
+    Core::Executor &executor;
+};
+} // namespace Fleet::DataManager::Portal
+
+#endif // __cpp_impl_coroutine
+#endif // FLEET_DATA_MANAGER_CORE_ASYNC_SERVICE_H
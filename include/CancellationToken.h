@@ -0,0 +1,227 @@
+/**
+ * @file CancellationToken.h
+ * @brief 取消令牌模块
+ * @details 提供截止时间和主动取消两种方式限定服务调用的执行时间，令牌可沿调用链传递到存储IO、网络调用和多节点扇出
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_CORE_CANCELLATION_TOKEN_H
+#define FLEET_DATA_MANAGER_CORE_CANCELLATION_TOKEN_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace Fleet::DataManager::Core {
+/**
+ * @brief 取消令牌类
+ * @details 令牌在被主动取消或到达截止时间后视为已取消。
+ * 长时间运行的操作应在开始前和各阶段之间调用IsCancelled检查，阻塞在IO或网络上的操作可以注册取消回调以便及时中断。
+ * 子令牌继承父令牌的取消状态，并可设置更早的截止时间
+ * @note 线程安全，通过Create或CreateChild创建并以std::shared_ptr共享
+ */
+class CancellationToken : public std::enable_shared_from_this<CancellationToken> {
+  public:
+    /// 时钟类型
+    using Clock = std::chrono::steady_clock;
+
+    /// 取消回调函数类型
+    using Callback = std::function<void()>;
+
+    /**
+     * @brief 创建取消令牌
+     * @param[in] timeoutMs 超时时间，单位毫秒，小于等于0表示没有截止时间
+     * @return 取消令牌
+     */
+    static std::shared_ptr<CancellationToken> Create(int64_t timeoutMs = 0) {
+        auto token = std::shared_ptr<CancellationToken>(new CancellationToken());
+        if (timeoutMs > 0) {
+            token->deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+            token->hasDeadline = true;
+        }
+        return token;
+    }
+
+    /**
+     * @brief 创建子令牌
+     * @details 父令牌取消时子令牌随之取消，子令牌的截止时间不晚于父令牌
+     * @param[in] timeoutMs 子令牌的超时时间，单位毫秒，小于等于0表示沿用父令牌的截止时间
+     * @return 子令牌
+     */
+    std::shared_ptr<CancellationToken> CreateChild(int64_t timeoutMs = 0) {
+        auto child = Create(timeoutMs);
+        if (this->hasDeadline && (!child->hasDeadline || this->deadline < child->deadline)) {
+            child->deadline = this->deadline;
+            child->hasDeadline = true;
+        }
+        std::weak_ptr<CancellationToken> weakChild = child;
+        uint64_t id = this->RegisterCallback([weakChild]() {
+            auto locked = weakChild.lock();
+            if (locked != nullptr) {
+                locked->Cancel();
+            }
+        });
+        child->parent = this->shared_from_this();
+        child->parentCallbackId = id;
+        return child;
+    }
+
+    /**
+     * @brief 析构函数，从父令牌注销
+     */
+    ~CancellationToken() {
+        if (this->parent != nullptr) {
+            this->parent->UnregisterCallback(this->parentCallbackId);
+        }
+    }
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    CancellationToken(const CancellationToken &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    CancellationToken &operator=(const CancellationToken &) = delete;
+
+    /**
+     * @brief 取消令牌并执行已注册的取消回调
+     * @details 重复调用无副作用，回调只执行一次
+     */
+    void Cancel() {
+        if (this->cancelled.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        std::map<uint64_t, Callback> toRun;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            toRun.swap(this->callbacks);
+        }
+        for (const auto &elem : toRun) {
+            elem.second();
+        }
+    }
+
+    /**
+     * @brief 判断令牌是否已取消或已超过截止时间
+     * @return 已取消返回true，否则返回false
+     */
+    bool IsCancelled() const {
+        if (this->cancelled.load(std::memory_order_acquire)) {
+            return true;
+        }
+        return this->hasDeadline && Clock::now() >= this->deadline;
+    }
+
+    /**
+     * @brief 判断令牌是否设置了截止时间
+     * @return 设置了截止时间返回true，否则返回false
+     */
+    bool HasDeadline() const {
+        return this->hasDeadline;
+    }
+
+    /**
+     * @brief 获取截止时间
+     * @return 截止时间，未设置时返回时钟最大值
+     */
+    Clock::time_point GetDeadline() const {
+        return this->hasDeadline ? this->deadline : Clock::time_point::max();
+    }
+
+    /**
+     * @brief 获取距离截止时间的剩余毫秒数
+     * @return 剩余毫秒数，已取消或已超时返回0，未设置截止时间返回-1
+     * @note 可直接用于poll、epoll_wait等以毫秒为单位、以-1表示无限等待的系统调用
+     */
+    int64_t GetRemainingMilliseconds() const {
+        if (this->cancelled.load(std::memory_order_acquire)) {
+            return 0;
+        }
+        if (!this->hasDeadline) {
+            return -1;
+        }
+        auto remaining =
+            std::chrono::duration_cast<std::chrono::milliseconds>(this->deadline - Clock::now())
+                .count();
+        return remaining > 0 ? remaining : 0;
+    }
+
+    /**
+     * @brief 注册取消回调
+     * @details 令牌被主动取消时执行，用于中断阻塞中的IO或网络操作；注册时已取消则立即执行
+     * @param[in] callback 取消回调函数，不能抛出异常
+     * @return 回调标识符，用于注销回调
+     * @note 截止时间到达不会触发回调，阻塞操作应结合GetRemainingMilliseconds设置超时
+     */
+    uint64_t RegisterCallback(Callback callback) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (!this->cancelled.load(std::memory_order_acquire)) {
+                uint64_t id = ++this->nextCallbackId;
+                this->callbacks[id] = std::move(callback);
+                return id;
+            }
+        }
+        callback();
+        return 0;
+    }
+
+    /**
+     * @brief 注销取消回调
+     * @param[in] id RegisterCallback返回的回调标识符
+     */
+    void UnregisterCallback(uint64_t id) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->callbacks.erase(id);
+    }
+
+  private:
+    /// 主动取消标志
+    std::atomic<bool> cancelled;
+
+    /// 是否设置了截止时间
+    bool hasDeadline;
+
+    /// 截止时间
+    Clock::time_point deadline;
+
+    /// 回调表互斥锁
+    std::mutex mutex;
+
+    /// 已注册的取消回调
+    std::map<uint64_t, Callback> callbacks;
+
+    /// 下一个回调标识符
+    uint64_t nextCallbackId;
+
+    /// 父令牌
+    std::shared_ptr<CancellationToken> parent;
+
+    /// 在父令牌上注册的回调标识符
+    uint64_t parentCallbackId;
+
+    /**
+     * @brief 构造未取消且没有截止时间的令牌
+     */
+    CancellationToken()
+        : cancelled(false), hasDeadline(false), nextCallbackId(0), parentCallbackId(0) {
+    }
+};
+
+/**
+ * @brief 判断可选令牌是否已取消
+ * @param[in] token 取消令牌，允许为nullptr
+ * @return 令牌存在且已取消返回true，否则返回false
+ */
+inline bool IsCancelled(const std::shared_ptr<CancellationToken> &token) {
+    return token != nullptr && token->IsCancelled();
+}
+} // namespace Fleet::DataManager::Core
+#endif // FLEET_DATA_MANAGER_CORE_CANCELLATION_TOKEN_H
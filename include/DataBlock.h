@@ -16,6 +16,8 @@
 #include <cstdint>
 #include <cstring>
 
+#include "MemoryPool.h"
+
 namespace Fleet::DataManager::Storage {
 /**
  * @brief 数据块类
@@ -29,20 +31,37 @@ class DataBlock {
      * @details 创建数据块并拷贝输入数据到内部缓冲区
      * @param[in] size 数据大小，单位字节
      * @param[in] data 数据内容指针
-     * @note 会分配新内存并拷贝数据，调用方可安全释放原数据
+     * @note 会从内存池分配新内存并拷贝数据，调用方可安全释放原数据
      */
     DataBlock(uint64_t size, const char *data) {
         this->size = size;
-        this->data = new char[this->size];
+        this->data = static_cast<char *>(
+            Core::MemoryPool::Global().Allocate(this->size, Core::MemorySubsystem::Storage));
+        this->pooled = true;
         memcpy(this->data, data, size);
     }
 
+    /**
+     * @brief 构造未初始化的数据块
+     * @details 从内存池分配指定大小的缓冲区，由生产者通过GetMutableData填充，避免先组装再拷贝
+     * @param[in] size 数据大小，单位字节
+     */
+    explicit DataBlock(uint64_t size) {
+        this->size = size;
+        this->data = static_cast<char *>(
+            Core::MemoryPool::Global().Allocate(this->size, Core::MemorySubsystem::Storage));
+        this->pooled = true;
+    }
+
     /**
      * @brief 析构函数
-     * @details 释放内部分配的数据缓冲区
+     * @details 内部缓冲区来自内存池时将其归还内存池
      */
     virtual ~DataBlock() {
-        delete[] this->data;
+        if (this->pooled) {
+            Core::MemoryPool::Global().Deallocate(this->data, this->size,
+                                                  Core::MemorySubsystem::Storage);
+        }
     }
 
     /**
@@ -72,11 +91,46 @@ class DataBlock {
         return this->data;
     }
 
+    /**
+     * @brief 获取可写的数据内容指针
+     * @return 数据内容指针
+     * @note 仅供生产者在数据块共享给其他线程之前填充数据，映射数据块的内容不可写
+     */
+    char *GetMutableData() {
+        return this->data;
+    }
+
+    /**
+     * @brief 判断数据是否直接映射自存储文件
+     * @return 映射数据块返回true，内存数据块返回false
+     */
+    virtual bool IsMapped() const {
+        return false;
+    }
+
+  protected:
+    /**
+     * @brief 外部缓冲区标记，用于区分拷贝构造数据的公有构造函数
+     */
+    struct ExternalBuffer {};
+
+    /**
+     * @brief 构造引用外部缓冲区的数据块
+     * @details 供派生类使用，不拷贝数据，缓冲区由派生类负责释放
+     * @param[in] size 数据大小，单位字节
+     * @param[in] data 外部缓冲区指针
+     */
+    DataBlock(uint64_t size, char *data, ExternalBuffer)
+        : size(size), data(data), pooled(false) {
+    }
+
   private:
     /// 数据大小，单位字节
     uint64_t size;
     /// 数据内容缓冲区
     char *data;
+    /// 缓冲区是否来自内存池
+    bool pooled;
 };
 } // namespace Fleet::DataManager::Storage
 
@@ -13,12 +13,23 @@
 #ifndef FLEET_DATA_MANAGER_STORAGE_DATA_KEY_H
 #define FLEET_DATA_MANAGER_STORAGE_DATA_KEY_H
 
-#include <string>
+#include "InternTable.h"
+#include "Serializer.h"
 #include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
 namespace Fleet::DataManager::Storage {
 /**
  * @brief 数据键管理类
- * @details 用于唯一标识存储系统中的数据项，包含应用名称、数据类型、数据名称和版本信息
+ * @details 用于唯一标识存储系统中的数据项，包含应用名称、数据类型、数据名称和版本信息。
+ * 应用名称和数据类型取值有限，驻留在全局字符串驻留表中，对象只保存其标识符；
+ * 数据名称和版本随写入不断产生新值，驻留表不释放字符串且有数量上限，因此由对象自行保存。
+ * 对象同时保存构造时计算的64位哈希值，比较先比较哈希值和标识符，最后才比较名称和版本
+ * @note 标识符只在进程内有效，跨进程传递时使用Serialize得到的字符串形式。
+ * 名称和版本使用std::string保存，复制不是平凡复制，短字符串不分配内存；
+ * 名称长度没有上限，固定长度的内联存储无法容纳，因此没有采用
  */
 class DataKey {
   public:
@@ -31,7 +42,9 @@ class DataKey {
      * @param[in] version 版本信息
      */
     DataKey(const std::string &application, const std::string &dataType, const std::string &name,
-            const std::string &version);
+            const std::string &version) {
+        this->Assign(application, dataType, name, version);
+    }
 
     /**
      * @brief 构造默认版本数据键
@@ -40,31 +53,40 @@ class DataKey {
      * @param[in] dataType 数据类型
      * @param[in] name 数据名称
      */
-    DataKey(const std::string &application, const std::string &dataType, const std::string &name);
+    DataKey(const std::string &application, const std::string &dataType, const std::string &name) {
+        this->Assign(application, dataType, name, "default");
+    }
 
     /**
      * @brief 从序列化数据构造数据键
      * @details 从二进制缓冲区反序列化构造数据键对象
      * @param[in] buffer 序列化数据缓冲区
      * @param[in,out] position 缓冲区读取位置，执行后会更新到下一个位置
+     * @note 数据不完整时各字段为空字符串，读取位置不变
      */
-    DataKey(const std::string &buffer, uint32_t &position);
+    DataKey(const std::string &buffer, uint32_t &position) {
+        if (!this->Deserialize(buffer, position)) {
+            this->Assign("", "", "", "");
+        }
+    }
 
     /**
      * @brief 析构函数
      */
-    virtual ~DataKey();
+    ~DataKey() = default;
 
     /**
      * @brief 拷贝构造函数
      * @param[in] another 源数据键对象
      */
-    DataKey(const DataKey &another);
+    DataKey(const DataKey &another) = default;
 
     /**
-     * @brief 禁用赋值操作符
+     * @brief 赋值操作符
+     * @param[in] another 源数据键对象
+     * @return 当前对象引用
      */
-    DataKey &operator=(const DataKey &another) = delete;
+    DataKey &operator=(const DataKey &another) = default;
 
     /**
      * @brief 数据键相等比较
@@ -72,57 +94,192 @@ class DataKey {
      * @param[in] another 比较对象
      * @return 相等返回true，否则返回false
      */
-    bool operator==(const DataKey &another) const;
+    bool operator==(const DataKey &another) const {
+        return this->hash == another.hash && this->applicationId == another.applicationId &&
+               this->dataTypeId == another.dataTypeId && this->name == another.name &&
+               this->version == another.version;
+    }
+
+    /**
+     * @brief 数据键不等比较
+     * @param[in] another 比较对象
+     * @return 不相等返回true，否则返回false
+     */
+    bool operator!=(const DataKey &another) const {
+        return !(*this == another);
+    }
 
     /**
      * @brief 获取应用名称
      * @return 应用名称字符串引用
      */
-    const std::string &GetApplication() const;
+    const std::string &GetApplication() const {
+        return Core::InternTable::Global().Lookup(this->applicationId).value;
+    }
 
     /**
      * @brief 获取数据类型
      * @return 数据类型字符串引用
      */
-    const std::string &GetDataType() const;
+    const std::string &GetDataType() const {
+        return Core::InternTable::Global().Lookup(this->dataTypeId).value;
+    }
 
     /**
      * @brief 获取数据名称
      * @return 数据名称字符串引用
      */
-    const std::string &GetName() const;
+    const std::string &GetName() const {
+        return this->name;
+    }
 
     /**
      * @brief 获取版本信息
      * @return 版本信息字符串引用
      */
-    const std::string &GetVersion() const;
+    const std::string &GetVersion() const {
+        return this->version;
+    }
+
+    /**
+     * @brief 获取应用名称的驻留标识符
+     * @return 应用名称标识符
+     */
+    uint32_t GetApplicationId() const {
+        return this->applicationId;
+    }
+
+    /**
+     * @brief 获取数据类型的驻留标识符
+     * @return 数据类型标识符
+     */
+    uint32_t GetDataTypeId() const {
+        return this->dataTypeId;
+    }
+
+    /**
+     * @brief 获取数据键的哈希值
+     * @details 由四个字段的内容计算，与驻留顺序和进程无关，可用于跨进程一致的分片
+     * @return 64位哈希值
+     */
+    uint64_t GetHash() const {
+        return this->hash;
+    }
+
+    /**
+     * @brief 获取序列化长度
+     * @return 序列化后的字节数
+     */
+    uint32_t GetSerializedSize() const {
+        return Core::BufferWriter::SizeOfString(this->GetApplication()) +
+               Core::BufferWriter::SizeOfString(this->GetDataType()) +
+               Core::BufferWriter::SizeOfString(this->GetName()) +
+               Core::BufferWriter::SizeOfString(this->GetVersion());
+    }
+
+    /**
+     * @brief 将数据键序列化到调用方提供的缓冲区
+     * @details 不分配内存，缓冲区剩余空间应不少于GetSerializedSize
+     * @param[in,out] writer 序列化器
+     * @return 写入成功返回true，空间不足返回false
+     */
+    bool SerializeTo(Core::BufferWriter &writer) const {
+        // 每个字段为4 bytes长度加n bytes内容
+        return writer.WriteString(this->GetApplication()) &&
+               writer.WriteString(this->GetDataType()) && writer.WriteString(this->GetName()) &&
+               writer.WriteString(this->GetVersion());
+    }
 
     /**
      * @brief 序列化数据键
      * @details 将数据键对象序列化为二进制字符串格式
      * @return 序列化后的二进制数据
      */
-    std::string Serialize();
+    std::string Serialize() const {
+        std::string ret(this->GetSerializedSize(), '\0');
+        Core::BufferWriter writer(ret.data(), ret.size());
+        this->SerializeTo(writer);
+        return ret;
+    }
+
+    /**
+     * @brief 从反序列化器读取数据键
+     * @param[in,out] reader 反序列化器
+     * @return 读取成功返回true，数据不完整返回false，此时对象保持不变
+     */
+    bool Deserialize(Core::BufferReader &reader) {
+        std::string_view fields[4];
+        for (auto &field : fields) {
+            if (!reader.ReadStringView(field)) {
+                return false;
+            }
+        }
+        this->Assign(fields[0], fields[1], fields[2], fields[3]);
+        return true;
+    }
 
   private:
-    /// 应用名称，标识数据所属的应用程序
-    std::string application;
-    /// 数据类型，标识数据的类别或格式
-    std::string dataType;
-    /// 数据名称，数据项的具体标识符
+    /// 应用名称标识符，标识数据所属的应用程序
+    uint32_t applicationId;
+    /// 数据类型标识符，标识数据的类别或格式
+    uint32_t dataTypeId;
+    /// 数据名称，数据项的具体标识符，不驻留
     std::string name;
-    /// 版本信息，数据的版本标识
+    /// 版本信息，数据的版本标识，不驻留
     std::string version;
+    /// 四个字段内容的组合哈希值
+    uint64_t hash;
+
+    /**
+     * @brief 驻留应用名称和数据类型，保存名称和版本并计算哈希值
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @param[in] version 版本信息
+     */
+    void Assign(std::string_view application, std::string_view dataType, std::string_view name,
+                std::string_view version) {
+        Core::InternTable &table = Core::InternTable::Global();
+        this->applicationId = table.Intern(application);
+        this->dataTypeId = table.Intern(dataType);
+        this->name.assign(name.data(), name.size());
+        this->version.assign(version.data(), version.size());
+        this->hash = 0;
+        for (uint64_t fieldHash :
+             {table.Lookup(this->applicationId).hash, table.Lookup(this->dataTypeId).hash,
+              Core::InternTable::Hash(name), Core::InternTable::Hash(version)}) {
+            // boost::hash_combine的64位形式
+            this->hash ^= fieldHash + 0x9E3779B97F4A7C15ull + (this->hash << 12) +
+                          (this->hash >> 4);
+        }
+    }
 
     /**
      * @brief 反序列化数据键
      * @details 从二进制缓冲区中解析数据键的各个字段
      * @param[in] buffer 序列化数据缓冲区
-     * @param[in,out] position 缓冲区读取位置，执行后会更新
-     * @return 反序列化成功返回true，失败返回false
+     * @param[in,out] position 缓冲区读取位置，成功时更新到下一个位置
+     * @return 反序列化成功返回true，数据不完整返回false
      */
-    bool Deserialize(const std::string &buffer, uint32_t &position);
+    bool Deserialize(const std::string &buffer, uint32_t &position) {
+        Core::BufferReader reader(buffer.data(), buffer.size(), position);
+        if (!this->Deserialize(reader)) {
+            return false;
+        }
+        position = reader.GetPosition();
+        return true;
+    }
 };
 } // namespace Fleet::DataManager::Storage
+
+/**
+ * @brief 数据键的std::hash特化，使数据键可直接作为无序容器的键
+ */
+namespace std {
+template <> struct hash<Fleet::DataManager::Storage::DataKey> {
+    size_t operator()(const Fleet::DataManager::Storage::DataKey &key) const noexcept {
+        return static_cast<size_t>(key.GetHash());
+    }
+};
+} // namespace std
 #endif //FLEET_DATA_MANAGER_STORAGE_DATA_KEY_H
@@ -0,0 +1,133 @@
+/**
+ * @file Executor.h
+ * @brief 共享执行器模块
+ * @details 提供进程内共享的线程池，用于执行异步服务调用和后台任务
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_CORE_EXECUTOR_H
+#define FLEET_DATA_MANAGER_CORE_EXECUTOR_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Fleet::DataManager::Core {
+/**
+ * @brief 执行器类
+ * @details 固定数量工作线程的线程池，任务按提交顺序出队执行
+ * @note 进程内共享的实例通过Global或PluginContext::GetExecutor获取
+ */
+class Executor {
+  public:
+    /**
+     * @brief 构造执行器
+     * @param[in] threadCount 工作线程数量，小于1时按1处理
+     */
+    explicit Executor(int threadCount) : stopping(false) {
+        if (threadCount < 1) {
+            threadCount = 1;
+        }
+        for (int i = 0; i < threadCount; i++) {
+            this->workers.emplace_back([this]() { this->Run(); });
+        }
+    }
+
+    /**
+     * @brief 析构函数，执行完已提交的任务后停止工作线程
+     */
+    ~Executor() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stopping = true;
+        }
+        this->condition.notify_all();
+        for (auto &worker : this->workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    Executor(const Executor &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    Executor &operator=(const Executor &) = delete;
+
+    /**
+     * @brief 获取进程内共享的执行器
+     * @details 工作线程数量取硬件并发数，至少为2，避免异步流水线中同步等待的任务占满唯一线程
+     * @return 执行器引用
+     * @note 实例不会被析构，工作线程随进程退出
+     */
+    static Executor &Global() {
+        static Executor *executor =
+            new Executor(std::max(2, (int) std::thread::hardware_concurrency()));
+        return *executor;
+    }
+
+    /**
+     * @brief 提交任务
+     * @param[in] task 待执行的任务
+     * @return 提交成功返回true，执行器正在停止时返回false
+     */
+    bool Post(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (this->stopping) {
+                return false;
+            }
+            this->tasks.push_back(std::move(task));
+        }
+        this->condition.notify_one();
+        return true;
+    }
+
+  private:
+    /// 任务队列互斥锁
+    std::mutex mutex;
+
+    /// 任务队列条件变量
+    std::condition_variable condition;
+
+    /// 待执行的任务队列
+    std::deque<std::function<void()>> tasks;
+
+    /// 工作线程
+    std::vector<std::thread> workers;
+
+    /// 停止标志
+    bool stopping;
+
+    /**
+     * @brief 工作线程主循环
+     */
+    void Run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->condition.wait(lock,
+                                     [this]() { return this->stopping || !this->tasks.empty(); });
+                if (this->tasks.empty()) {
+                    return;
+                }
+                task = std::move(this->tasks.front());
+                this->tasks.pop_front();
+            }
+            task();
+        }
+    }
+};
+} // namespace Fleet::DataManager::Core
+#endif // FLEET_DATA_MANAGER_CORE_EXECUTOR_H
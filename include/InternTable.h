@@ -0,0 +1,174 @@
+/**
+ * @file InternTable.h
+ * @brief 字符串驻留表
+ * @details 为反复出现的应用名称、数据类型等字符串分配紧凑的整数标识符，同一字符串在进程内只保存一份
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_CORE_INTERN_TABLE_H
+#define FLEET_DATA_MANAGER_CORE_INTERN_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Fleet::DataManager::Core {
+/**
+ * @brief 字符串驻留表类
+ * @details 字符串到标识符的查找使用读写锁保护的哈希表，已驻留字符串的查找只持有共享锁；
+ * 标识符到字符串的查找通过分块数组完成，不加锁。字符串在进程生命周期内不会释放，
+ * 对应的引用和标识符始终有效
+ * @note 线程安全。标识符只在进程内有效，不能持久化或跨进程传递
+ */
+class InternTable {
+  public:
+    /**
+     * @brief 驻留字符串
+     */
+    struct Entry {
+        /// 字符串内容
+        std::string value;
+        /// 字符串内容的64位FNV-1a哈希值，与进程无关
+        uint64_t hash;
+    };
+
+    /**
+     * @brief 获取全局驻留表
+     * @details 全局驻留表不会析构，静态对象析构期间仍可使用
+     * @return 全局驻留表引用
+     */
+    static InternTable &Global() {
+        static InternTable *instance = new InternTable();
+        return *instance;
+    }
+
+    /**
+     * @brief 构造空的驻留表
+     */
+    InternTable() : chunks(new std::atomic<Entry *>[MaxChunks]) {
+        for (uint32_t i = 0; i < MaxChunks; ++i) {
+            this->chunks[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 析构函数，释放所有分块
+     */
+    virtual ~InternTable() {
+        for (uint32_t i = 0; i < MaxChunks; ++i) {
+            delete[] this->chunks[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    InternTable(const InternTable &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    InternTable &operator=(const InternTable &) = delete;
+
+    /**
+     * @brief 驻留字符串
+     * @param[in] value 字符串
+     * @return 字符串的标识符，相同内容始终返回相同的标识符
+     * @note 字符串不会释放，只应驻留取值有限的字符串，
+     * 数据名称和版本号等不断产生新值的字符串不应驻留。
+     * 驻留的字符串数量超过上限时抛出std::length_error
+     */
+    uint32_t Intern(std::string_view value) {
+        {
+            std::shared_lock<std::shared_mutex> lock(this->mutex);
+            auto iter = this->ids.find(value);
+            if (iter != this->ids.end()) {
+                return iter->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(this->mutex);
+        auto iter = this->ids.find(value);
+        if (iter != this->ids.end()) {
+            return iter->second;
+        }
+        uint32_t id = this->size.load(std::memory_order_relaxed);
+        uint32_t chunkIndex = id >> ChunkBits;
+        if (chunkIndex >= MaxChunks) {
+            throw std::length_error("驻留字符串数量超过上限");
+        }
+        Entry *chunk = this->chunks[chunkIndex].load(std::memory_order_relaxed);
+        if (chunk == nullptr) {
+            chunk = new Entry[ChunkSize];
+            this->chunks[chunkIndex].store(chunk, std::memory_order_release);
+        }
+        Entry &entry = chunk[id & (ChunkSize - 1)];
+        entry.value.assign(value.data(), value.size());
+        entry.hash = Hash(value);
+        this->ids.emplace(std::string_view(entry.value), id);
+        this->size.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    /**
+     * @brief 按标识符查找驻留字符串
+     * @param[in] id Intern返回的标识符
+     * @return 驻留字符串，引用在驻留表生命周期内有效
+     */
+    const Entry &Lookup(uint32_t id) const {
+        Entry *chunk = this->chunks[id >> ChunkBits].load(std::memory_order_acquire);
+        return chunk[id & (ChunkSize - 1)];
+    }
+
+    /**
+     * @brief 获取已驻留的字符串数量
+     * @return 字符串数量
+     */
+    uint32_t GetSize() const {
+        return this->size.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 计算字符串的64位FNV-1a哈希值
+     * @param[in] value 字符串
+     * @return 哈希值
+     */
+    static uint64_t Hash(std::string_view value) {
+        uint64_t ret = 0xCBF29CE484222325ull;
+        for (unsigned char c : value) {
+            ret ^= c;
+            ret *= 0x100000001B3ull;
+        }
+        return ret;
+    }
+
+  private:
+    /// 每个分块容纳的字符串数量的对数
+    static constexpr uint32_t ChunkBits = 12;
+    /// 每个分块容纳的字符串数量
+    static constexpr uint32_t ChunkSize = 1u << ChunkBits;
+    /// 分块数量上限，驻留字符串总数上限为ChunkSize * MaxChunks
+    static constexpr uint32_t MaxChunks = 1u << 16;
+
+    /// 分块目录，分块一经分配不再移动
+    std::unique_ptr<std::atomic<Entry *>[]> chunks;
+
+    /// 已驻留的字符串数量
+    std::atomic<uint32_t> size{0};
+
+    /// 字符串到标识符映射的读写锁
+    std::shared_mutex mutex;
+
+    /// 字符串到标识符的映射，键引用分块中的字符串
+    std::unordered_map<std::string_view, uint32_t> ids;
+};
+} // namespace Fleet::DataManager::Core
+
+#endif // FLEET_DATA_MANAGER_CORE_INTERN_TABLE_H
@@ -13,8 +13,9 @@
 #ifndef FLEET_DATA_MANAGER_STORAGE_LOCATION_H
 #define FLEET_DATA_MANAGER_STORAGE_LOCATION_H
 
-#include <string>
+#include "Serializer.h"
 #include <cstdint>
+#include <string>
 namespace Fleet::DataManager::Storage {
 /**
  * @brief 存储位置类
@@ -37,9 +38,13 @@ class Location {
      * @details 从二进制缓冲区反序列化构造位置对象
      * @param[in] buffer 序列化数据缓冲区
      * @param[in,out] position 缓冲区读取位置，执行后会更新到下一个位置
+     * @note 数据不完整时各字段为空字符串，读取位置不变
      */
     Location(const std::string &buffer, uint32_t &position) {
-        this->Deserialize(buffer, position);
+        if (!this->Deserialize(buffer, position)) {
+            this->deviceName.clear();
+            this->relativePath.clear();
+        }
     }
 
     /**
@@ -89,26 +94,55 @@ class Location {
         return true;
     }
 
+    /**
+     * @brief 获取序列化长度
+     * @return 序列化后的字节数
+     */
+    uint32_t GetSerializedSize() const {
+        return Core::BufferWriter::SizeOfString(this->deviceName) +
+               Core::BufferWriter::SizeOfString(this->relativePath);
+    }
+
+    /**
+     * @brief 将存储位置序列化到调用方提供的缓冲区
+     * @details 不分配内存，缓冲区剩余空间应不少于GetSerializedSize
+     * @param[in,out] writer 序列化器
+     * @return 写入成功返回true，空间不足返回false
+     */
+    bool SerializeTo(Core::BufferWriter &writer) const {
+        // 4 bytes: device name size, n bytes: device name
+        // 4 bytes: relative path size, n bytes: relative path
+        return writer.WriteString(this->deviceName) && writer.WriteString(this->relativePath);
+    }
+
     /**
      * @brief 序列化存储位置
      * @details 将位置对象序列化为二进制字符串格式
      * @return 序列化后的二进制数据
      */
-    std::string Serialize() {
-        std::string ret;
-        // 4 bytes: device name size
-        uint32_t deviceNameSize = this->deviceName.size();
-        ret.append(std::string((const char *) &deviceNameSize, sizeof(deviceNameSize)));
-        // n bytes: device name
-        ret.append(this->deviceName);
-        // 4 bytes: relative path size
-        uint32_t relativePathSize = this->relativePath.size();
-        ret.append(std::string((const char *) &relativePathSize, sizeof(relativePathSize)));
-        // n bytes: relative path
-        ret.append(this->relativePath);
+    std::string Serialize() const {
+        std::string ret(this->GetSerializedSize(), '\0');
+        Core::BufferWriter writer(ret.data(), ret.size());
+        this->SerializeTo(writer);
         return ret;
     }
 
+    /**
+     * @brief 从反序列化器读取存储位置
+     * @param[in,out] reader 反序列化器
+     * @return 读取成功返回true，数据不完整返回false，此时对象保持不变
+     */
+    bool Deserialize(Core::BufferReader &reader) {
+        std::string_view newDeviceName;
+        std::string_view newRelativePath;
+        if (!reader.ReadStringView(newDeviceName) || !reader.ReadStringView(newRelativePath)) {
+            return false;
+        }
+        this->deviceName.assign(newDeviceName.data(), newDeviceName.size());
+        this->relativePath.assign(newRelativePath.data(), newRelativePath.size());
+        return true;
+    }
+
   private:
     /// 设备名称，标识存储设备
     std::string deviceName;
@@ -119,23 +153,15 @@ class Location {
      * @brief 反序列化存储位置
      * @details 从二进制缓冲区中解析位置信息的各个字段
      * @param[in] buffer 序列化数据缓冲区
-     * @param[in,out] position 缓冲区读取位置，执行后会更新
-     * @return 反序列化成功返回true，失败返回false
+     * @param[in,out] position 缓冲区读取位置，成功时更新到下一个位置
+     * @return 反序列化成功返回true，数据不完整返回false
      */
     bool Deserialize(const std::string &buffer, uint32_t &position) {
-        // 4 bytes: device name size
-        uint32_t deviceNameSize = *((uint32_t *) (buffer.data() + position));
-        position += sizeof(deviceNameSize);
-        // n bytes: device name
-        this->deviceName = std::string((const char *) (buffer.data() + position), deviceNameSize);
-        position += deviceNameSize;
-        // 4 bytes: relative path size
-        uint32_t relativePathSize = *((uint32_t *) (buffer.data() + position));
-        position += sizeof(relativePathSize);
-        // n bytes: relative path
-        this->relativePath =
-            std::string((const char *) (buffer.data() + position), relativePathSize);
-        position += relativePathSize;
+        Core::BufferReader reader(buffer.data(), buffer.size(), position);
+        if (!this->Deserialize(reader)) {
+            return false;
+        }
+        position = reader.GetPosition();
         return true;
     }
 };
@@ -0,0 +1,175 @@
+/**
+ * @file MappedDataBlock.h
+ * @brief 内存映射数据块
+ * @details 将存储文件或段文件中的一段区域直接映射为数据块，读取大对象时只为实际访问的页付出IO和内存
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_MAPPED_DATA_BLOCK_H
+#define FLEET_DATA_MANAGER_STORAGE_MAPPED_DATA_BLOCK_H
+
+#include "DataBlock.h"
+#include <cstdint>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief 内存映射访问模式提示
+ * @details 对应madvise的建议值，数值与C接口中的advice参数一致
+ */
+enum class MapAdvice : int {
+    /// 不做提示，由内核决定预读策略
+    Normal = 0,
+    /// 顺序访问，内核加大预读并及时回收已读过的页
+    Sequential = 1,
+    /// 随机访问，内核关闭预读
+    Random = 2,
+    /// 即将访问，内核立即开始异步预读
+    WillNeed = 3
+};
+
+/**
+ * @brief 内存映射数据块类
+ * @details 以只读私有映射引用文件中的数据，不拷贝到堆内存，页在首次访问时才从设备读入。
+ * 映射在数据块析构时解除，文件描述符在映射建立后即可关闭
+ * @note 映射期间文件被截断会使访问截断部分的线程收到SIGBUS，存储插件只能对不会被原地截断的文件使用映射读取；
+ * 文件被删除或重命名不影响已建立的映射
+ */
+class MappedDataBlock : public DataBlock {
+  public:
+    /**
+     * @brief 映射文件描述符中的一段区域
+     * @param[in] fd 以读方式打开的文件描述符
+     * @param[in] offset 区域在文件中的偏移，不要求按页对齐
+     * @param[in] length 区域长度，单位字节
+     * @param[in] advice 访问模式提示
+     * @return 映射数据块，映射失败返回nullptr
+     */
+    static std::shared_ptr<MappedDataBlock> Map(int fd, uint64_t offset, uint64_t length,
+                                                MapAdvice advice) {
+        if (length == 0) {
+            return std::shared_ptr<MappedDataBlock>(new MappedDataBlock(nullptr, 0, 0, 0));
+        }
+        uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        uint64_t alignedOffset = offset - offset % pageSize;
+        uint64_t delta = offset - alignedOffset;
+        void *base = mmap(nullptr, length + delta, PROT_READ, MAP_PRIVATE, fd,
+                          static_cast<off_t>(alignedOffset));
+        if (base == MAP_FAILED) {
+            return nullptr;
+        }
+        auto ret = std::shared_ptr<MappedDataBlock>(
+            new MappedDataBlock(static_cast<char *>(base), length + delta, delta, length));
+        ret->Advise(0, length, advice);
+        return ret;
+    }
+
+    /**
+     * @brief 映射整个文件
+     * @param[in] path 文件路径
+     * @param[in] advice 访问模式提示
+     * @return 映射数据块，文件不存在或映射失败返回nullptr
+     */
+    static std::shared_ptr<MappedDataBlock> MapFile(const std::string &path, MapAdvice advice) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat fileStat {};
+        if (fstat(fd, &fileStat) != 0) {
+            close(fd);
+            return nullptr;
+        }
+        auto ret = Map(fd, 0, static_cast<uint64_t>(fileStat.st_size), advice);
+        close(fd);
+        return ret;
+    }
+
+    /**
+     * @brief 析构函数，解除映射
+     */
+    ~MappedDataBlock() override {
+        if (this->base != nullptr) {
+            munmap(this->base, this->mappedLength);
+        }
+    }
+
+    /**
+     * @brief 判断数据是否直接映射自存储文件
+     * @return 始终返回true
+     */
+    bool IsMapped() const override {
+        return true;
+    }
+
+    /**
+     * @brief 为数据块中的一段区域设置访问模式提示
+     * @details 只读取产品局部的调用方可以对即将访问的区域提示WillNeed，对其余区域提示Random
+     * @param[in] offset 区域在数据块中的偏移
+     * @param[in] length 区域长度，单位字节
+     * @param[in] advice 访问模式提示
+     * @return 设置成功返回true，区域越界或系统调用失败返回false
+     */
+    bool Advise(uint64_t offset, uint64_t length, MapAdvice advice) {
+        if (offset > this->GetSize() || length > this->GetSize() - offset) {
+            return false;
+        }
+        if (length == 0) {
+            return true;
+        }
+        uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        uint64_t begin = this->delta + offset;
+        uint64_t alignedBegin = begin - begin % pageSize;
+        return madvise(this->base + alignedBegin, length + begin - alignedBegin,
+                       ToMadvise(advice)) == 0;
+    }
+
+  private:
+    /// 映射起始地址，按页对齐
+    char *base;
+
+    /// 映射长度，单位字节
+    uint64_t mappedLength;
+
+    /// 数据相对映射起始地址的偏移
+    uint64_t delta;
+
+    /**
+     * @brief 构造映射数据块
+     * @param[in] base 映射起始地址
+     * @param[in] mappedLength 映射长度
+     * @param[in] delta 数据相对映射起始地址的偏移
+     * @param[in] size 数据大小
+     */
+    MappedDataBlock(char *base, uint64_t mappedLength, uint64_t delta, uint64_t size)
+        : DataBlock(size, base == nullptr ? nullptr : base + delta, ExternalBuffer{}), base(base),
+          mappedLength(mappedLength), delta(delta) {
+    }
+
+    /**
+     * @brief 转换为madvise的建议值
+     * @param[in] advice 访问模式提示
+     * @return madvise的建议值
+     */
+    static int ToMadvise(MapAdvice advice) {
+        switch (advice) {
+        case MapAdvice::Sequential:
+            return MADV_SEQUENTIAL;
+        case MapAdvice::Random:
+            return MADV_RANDOM;
+        case MapAdvice::WillNeed:
+            return MADV_WILLNEED;
+        default:
+            return MADV_NORMAL;
+        }
+    }
+};
+} // namespace Fleet::DataManager::Storage
+
+#endif // FLEET_DATA_MANAGER_STORAGE_MAPPED_DATA_BLOCK_H
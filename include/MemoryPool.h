@@ -0,0 +1,573 @@
+/**
+ * @file MemoryPool.h
+ * @brief 内存池模块
+ * @details 提供按尺寸分级的块内存池、线程本地缓存、按请求使用的线性分配区以及分子系统的分配计数
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_CORE_MEMORY_POOL_H
+#define FLEET_DATA_MANAGER_CORE_MEMORY_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace Fleet::DataManager::Core {
+/**
+ * @brief 内存分配所属的子系统
+ * @details 用于分别统计各子系统的分配次数和字节数
+ */
+enum class MemorySubsystem : int {
+    /// 插件管理器和C接口
+    Core = 0,
+    /// 存储
+    Storage,
+    /// 消息
+    Messaging,
+    /// 门户
+    Portal,
+    /// API服务
+    Api,
+    /// 其他插件
+    Other,
+    /// 子系统数量
+    Count
+};
+
+/**
+ * @brief 单个子系统的内存分配统计
+ */
+struct MemoryStatistics {
+    /// 分配次数
+    uint64_t allocations;
+    /// 释放次数
+    uint64_t deallocations;
+    /// 由块内存池满足的分配次数
+    uint64_t pooledAllocations;
+    /// 超出最大尺寸级别、直接向系统申请的分配次数
+    uint64_t systemAllocations;
+    /// 由线性分配区满足的分配次数
+    uint64_t arenaAllocations;
+    /// 当前仍在使用的字节数
+    int64_t bytesInUse;
+};
+
+/**
+ * @brief 块内存池类
+ * @details 将16字节到4096字节的请求向上取整到2的幂次尺寸级别，从64KB的内存板中切分固定大小的块。
+ * 每个线程为每个尺寸级别缓存少量空闲块，分配和释放通常无需加锁，缓存过多或耗尽时与全局空闲链表批量交换。
+ * 超过最大尺寸级别的请求直接使用系统分配器。
+ * 内存板在进程生命周期内不归还系统
+ * @note 进程内只有一个实例，通过Global或PluginContext::GetMemoryPool获取
+ */
+class MemoryPool {
+  public:
+    /// 最小尺寸级别，单位字节
+    static constexpr std::size_t MinBlockSize = 16;
+
+    /// 最大尺寸级别，单位字节
+    static constexpr std::size_t MaxBlockSize = 4096;
+
+    /**
+     * @brief 获取进程内唯一的内存池实例
+     * @return 内存池引用
+     * @note 实例不会被析构，保证线程退出时归还线程缓存的操作始终有效
+     */
+    static MemoryPool &Global() {
+        static MemoryPool *pool = new MemoryPool();
+        return *pool;
+    }
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    MemoryPool(const MemoryPool &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    MemoryPool &operator=(const MemoryPool &) = delete;
+
+    /**
+     * @brief 分配内存
+     * @param[in] size 请求的字节数
+     * @param[in] subsystem 所属子系统
+     * @return 内存指针，按16字节对齐，size为0时返回可释放的最小块
+     * @note 必须使用相同的size调用Deallocate释放
+     */
+    void *Allocate(std::size_t size, MemorySubsystem subsystem) {
+        Counters &counters = this->CountersOf(subsystem);
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.bytesInUse.fetch_add((int64_t) size, std::memory_order_relaxed);
+        if (size > MaxBlockSize) {
+            counters.systemAllocations.fetch_add(1, std::memory_order_relaxed);
+            return ::operator new(size);
+        }
+        counters.pooledAllocations.fetch_add(1, std::memory_order_relaxed);
+        int index = SizeClassOf(size);
+        FreeList &list = LocalCache().lists[index];
+        if (list.head == nullptr) {
+            this->Refill(index, list);
+        }
+        FreeBlock *block = list.head;
+        list.head = block->next;
+        list.count--;
+        return block;
+    }
+
+    /**
+     * @brief 释放内存
+     * @param[in] pointer Allocate返回的内存指针，允许为nullptr
+     * @param[in] size 分配时请求的字节数
+     * @param[in] subsystem 所属子系统
+     */
+    void Deallocate(void *pointer, std::size_t size, MemorySubsystem subsystem) {
+        if (pointer == nullptr) {
+            return;
+        }
+        Counters &counters = this->CountersOf(subsystem);
+        counters.deallocations.fetch_add(1, std::memory_order_relaxed);
+        counters.bytesInUse.fetch_sub((int64_t) size, std::memory_order_relaxed);
+        if (size > MaxBlockSize) {
+            ::operator delete(pointer);
+            return;
+        }
+        int index = SizeClassOf(size);
+        FreeList &list = LocalCache().lists[index];
+        auto *block = static_cast<FreeBlock *>(pointer);
+        block->next = list.head;
+        list.head = block;
+        list.count++;
+        if (list.count > ThreadCacheLimit) {
+            this->Drain(index, list, ThreadCacheLimit / 2);
+        }
+    }
+
+    /**
+     * @brief 记录一次由线性分配区满足的分配
+     * @param[in] subsystem 所属子系统
+     */
+    void RecordArenaAllocation(MemorySubsystem subsystem) {
+        this->CountersOf(subsystem).arenaAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 获取子系统的分配统计
+     * @param[in] subsystem 子系统
+     * @return 统计数据快照
+     */
+    MemoryStatistics GetStatistics(MemorySubsystem subsystem) {
+        Counters &counters = this->CountersOf(subsystem);
+        MemoryStatistics ret{};
+        ret.allocations = counters.allocations.load(std::memory_order_relaxed);
+        ret.deallocations = counters.deallocations.load(std::memory_order_relaxed);
+        ret.pooledAllocations = counters.pooledAllocations.load(std::memory_order_relaxed);
+        ret.systemAllocations = counters.systemAllocations.load(std::memory_order_relaxed);
+        ret.arenaAllocations = counters.arenaAllocations.load(std::memory_order_relaxed);
+        ret.bytesInUse = counters.bytesInUse.load(std::memory_order_relaxed);
+        return ret;
+    }
+
+  private:
+    /// 尺寸级别数量
+    static constexpr int SizeClassCount = 9;
+
+    /// 每个内存板的大小，单位字节
+    static constexpr std::size_t SlabSize = 64 * 1024;
+
+    /// 线程缓存中每个尺寸级别最多保留的空闲块数量
+    static constexpr std::size_t ThreadCacheLimit = 64;
+
+    /**
+     * @brief 空闲块，复用块内存存放链表指针
+     */
+    struct FreeBlock {
+        /// 下一个空闲块
+        FreeBlock *next;
+    };
+
+    /**
+     * @brief 空闲块链表
+     */
+    struct FreeList {
+        /// 链表头
+        FreeBlock *head = nullptr;
+        /// 链表长度
+        std::size_t count = 0;
+    };
+
+    /**
+     * @brief 线程本地缓存，线程退出时将空闲块归还全局链表
+     */
+    struct ThreadCache {
+        /// 各尺寸级别的空闲块链表
+        FreeList lists[SizeClassCount];
+
+        /**
+         * @brief 析构函数，归还所有空闲块
+         */
+        ~ThreadCache() {
+            for (int i = 0; i < SizeClassCount; i++) {
+                Global().Drain(i, this->lists[i], this->lists[i].count);
+            }
+        }
+    };
+
+    /**
+     * @brief 子系统计数器，每个子系统独占缓存行
+     */
+    struct alignas(64) Counters {
+        /// 分配次数
+        std::atomic<uint64_t> allocations{0};
+        /// 释放次数
+        std::atomic<uint64_t> deallocations{0};
+        /// 由块内存池满足的分配次数
+        std::atomic<uint64_t> pooledAllocations{0};
+        /// 直接向系统申请的分配次数
+        std::atomic<uint64_t> systemAllocations{0};
+        /// 由线性分配区满足的分配次数
+        std::atomic<uint64_t> arenaAllocations{0};
+        /// 当前仍在使用的字节数
+        std::atomic<int64_t> bytesInUse{0};
+    };
+
+    /// 各尺寸级别的全局空闲块链表
+    FreeList globalLists[SizeClassCount];
+
+    /// 全局空闲块链表互斥锁，每个尺寸级别一把
+    std::mutex globalMutexes[SizeClassCount];
+
+    /// 各子系统的计数器
+    Counters counters[(int) MemorySubsystem::Count];
+
+    /**
+     * @brief 构造内存池
+     */
+    MemoryPool() = default;
+
+    /**
+     * @brief 获取当前线程的缓存
+     * @return 线程缓存引用
+     */
+    static ThreadCache &LocalCache() {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief 计算请求尺寸对应的尺寸级别
+     * @param[in] size 请求的字节数，不超过MaxBlockSize
+     * @return 尺寸级别下标
+     */
+    static int SizeClassOf(std::size_t size) {
+        int index = 0;
+        std::size_t blockSize = MinBlockSize;
+        while (blockSize < size) {
+            blockSize <<= 1;
+            index++;
+        }
+        return index;
+    }
+
+    /**
+     * @brief 获取子系统计数器
+     * @param[in] subsystem 子系统
+     * @return 计数器引用
+     */
+    Counters &CountersOf(MemorySubsystem subsystem) {
+        int index = (int) subsystem;
+        if (index < 0 || index >= (int) MemorySubsystem::Count) {
+            index = (int) MemorySubsystem::Other;
+        }
+        return this->counters[index];
+    }
+
+    /**
+     * @brief 从全局链表批量补充线程缓存，全局链表为空时切分新的内存板
+     * @param[in] index 尺寸级别下标
+     * @param[in,out] list 线程缓存链表
+     */
+    void Refill(int index, FreeList &list) {
+        std::size_t batch = ThreadCacheLimit / 2;
+        {
+            std::lock_guard<std::mutex> lock(this->globalMutexes[index]);
+            FreeList &global = this->globalLists[index];
+            while (global.head != nullptr && list.count < batch) {
+                FreeBlock *block = global.head;
+                global.head = block->next;
+                global.count--;
+                block->next = list.head;
+                list.head = block;
+                list.count++;
+            }
+        }
+        if (list.head != nullptr) {
+            return;
+        }
+        std::size_t blockSize = MinBlockSize << index;
+        char *slab = static_cast<char *>(::operator new(SlabSize));
+        for (std::size_t offset = 0; offset + blockSize <= SlabSize; offset += blockSize) {
+            auto *block = reinterpret_cast<FreeBlock *>(slab + offset);
+            block->next = list.head;
+            list.head = block;
+            list.count++;
+        }
+    }
+
+    /**
+     * @brief 将线程缓存中的空闲块归还全局链表
+     * @param[in] index 尺寸级别下标
+     * @param[in,out] list 线程缓存链表
+     * @param[in] count 归还的块数量
+     */
+    void Drain(int index, FreeList &list, std::size_t count) {
+        std::lock_guard<std::mutex> lock(this->globalMutexes[index]);
+        FreeList &global = this->globalLists[index];
+        while (count > 0 && list.head != nullptr) {
+            FreeBlock *block = list.head;
+            list.head = block->next;
+            list.count--;
+            block->next = global.head;
+            global.head = block;
+            global.count++;
+            count--;
+        }
+    }
+};
+
+/**
+ * @brief 线性分配区类
+ * @details 按请求创建，从内存池申请4KB的内存页顺序切分，单次分配只移动指针；
+ * 分配区析构时一次性归还全部内存页，适用于单次操作内的临时字符串、列表等短生命周期对象
+ * @note 非线程安全，每个请求或线程使用独立的分配区
+ */
+class Arena {
+  public:
+    /**
+     * @brief 构造线性分配区
+     * @param[in] subsystem 所属子系统
+     */
+    explicit Arena(MemorySubsystem subsystem = MemorySubsystem::Other)
+        : subsystem(subsystem), current(nullptr), remaining(0) {
+    }
+
+    /**
+     * @brief 析构函数，归还全部内存页
+     */
+    ~Arena() {
+        this->Reset();
+    }
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    Arena(const Arena &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * @brief 分配内存
+     * @param[in] size 请求的字节数
+     * @param[in] alignment 对齐要求，必须是2的幂且不超过16
+     * @return 内存指针，生命周期与分配区相同
+     */
+    void *Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+        MemoryPool &pool = MemoryPool::Global();
+        pool.RecordArenaAllocation(this->subsystem);
+        if (size > PageSize / 4) {
+            // 大对象单独申请, 避免浪费当前页的剩余空间
+            void *pointer = pool.Allocate(size, this->subsystem);
+            this->blocks.push_back({pointer, size});
+            return pointer;
+        }
+        std::size_t padding =
+            (alignment - ((uintptr_t) this->current & (alignment - 1))) & (alignment - 1);
+        if (this->current == nullptr || padding + size > this->remaining) {
+            this->current = static_cast<char *>(pool.Allocate(PageSize, this->subsystem));
+            this->remaining = PageSize;
+            this->blocks.push_back({this->current, PageSize});
+            padding = 0;
+        }
+        char *pointer = this->current + padding;
+        this->current = pointer + size;
+        this->remaining -= padding + size;
+        return pointer;
+    }
+
+    /**
+     * @brief 归还全部内存页，之前分配的内存全部失效
+     */
+    void Reset() {
+        MemoryPool &pool = MemoryPool::Global();
+        for (const auto &block : this->blocks) {
+            pool.Deallocate(block.pointer, block.size, this->subsystem);
+        }
+        this->blocks.clear();
+        this->current = nullptr;
+        this->remaining = 0;
+    }
+
+  private:
+    /// 内存页大小，单位字节
+    static constexpr std::size_t PageSize = 4096;
+
+    /**
+     * @brief 从内存池申请的内存
+     */
+    struct Block {
+        /// 内存指针
+        void *pointer;
+        /// 字节数
+        std::size_t size;
+    };
+
+    /// 所属子系统
+    MemorySubsystem subsystem;
+
+    /// 当前内存页中下一个可分配的位置
+    char *current;
+
+    /// 当前内存页剩余字节数
+    std::size_t remaining;
+
+    /// 已申请的全部内存
+    std::vector<Block> blocks;
+};
+
+/**
+ * @brief 基于块内存池的标准分配器
+ * @details 可用于std::allocate_shared以及标准容器，对象和控制块一起从内存池分配
+ * @tparam T 元素类型
+ * @tparam Subsystem 所属子系统
+ */
+template <typename T, MemorySubsystem Subsystem = MemorySubsystem::Other> class PoolAllocator {
+  public:
+    /// 元素类型
+    using value_type = T;
+
+    /**
+     * @brief 重新绑定到其他元素类型
+     */
+    template <typename U> struct rebind {
+        /// 重新绑定后的分配器类型
+        using other = PoolAllocator<U, Subsystem>;
+    };
+
+    /**
+     * @brief 默认构造函数
+     */
+    PoolAllocator() noexcept = default;
+
+    /**
+     * @brief 从其他元素类型的分配器构造
+     */
+    template <typename U> PoolAllocator(const PoolAllocator<U, Subsystem> &) noexcept {
+    }
+
+    /**
+     * @brief 分配n个元素的内存
+     * @param[in] n 元素数量
+     * @return 内存指针
+     */
+    T *allocate(std::size_t n) {
+        return static_cast<T *>(MemoryPool::Global().Allocate(n * sizeof(T), Subsystem));
+    }
+
+    /**
+     * @brief 释放n个元素的内存
+     * @param[in] pointer 内存指针
+     * @param[in] n 元素数量
+     */
+    void deallocate(T *pointer, std::size_t n) noexcept {
+        MemoryPool::Global().Deallocate(pointer, n * sizeof(T), Subsystem);
+    }
+
+    /**
+     * @brief 比较分配器，所有实例共享同一内存池
+     */
+    template <typename U> bool operator==(const PoolAllocator<U, Subsystem> &) const noexcept {
+        return true;
+    }
+
+    /**
+     * @brief 比较分配器，所有实例共享同一内存池
+     */
+    template <typename U> bool operator!=(const PoolAllocator<U, Subsystem> &) const noexcept {
+        return false;
+    }
+};
+
+/**
+ * @brief 基于线性分配区的标准分配器
+ * @details 可用于std::vector、std::basic_string等容器，释放操作为空，内存在分配区析构时统一归还
+ * @tparam T 元素类型
+ */
+template <typename T> class ArenaAllocator {
+  public:
+    /// 元素类型
+    using value_type = T;
+
+    /**
+     * @brief 构造分配器
+     * @param[in] arena 线性分配区，生命周期必须长于使用该分配器的容器
+     */
+    explicit ArenaAllocator(Arena &arena) noexcept : arena(&arena) {
+    }
+
+    /**
+     * @brief 从其他元素类型的分配器构造
+     */
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &another) noexcept : arena(another.GetArena()) {
+    }
+
+    /**
+     * @brief 分配n个元素的内存
+     * @param[in] n 元素数量
+     * @return 内存指针
+     */
+    T *allocate(std::size_t n) {
+        return static_cast<T *>(this->arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief 释放内存，由分配区统一回收
+     */
+    void deallocate(T *, std::size_t) noexcept {
+    }
+
+    /**
+     * @brief 获取线性分配区
+     * @return 线性分配区指针
+     */
+    Arena *GetArena() const noexcept {
+        return this->arena;
+    }
+
+    /**
+     * @brief 比较分配器是否使用同一分配区
+     */
+    template <typename U> bool operator==(const ArenaAllocator<U> &another) const noexcept {
+        return this->arena == another.GetArena();
+    }
+
+    /**
+     * @brief 比较分配器是否使用不同分配区
+     */
+    template <typename U> bool operator!=(const ArenaAllocator<U> &another) const noexcept {
+        return this->arena != another.GetArena();
+    }
+
+  private:
+    /// 线性分配区
+    Arena *arena;
+};
+} // namespace Fleet::DataManager::Core
+#endif // FLEET_DATA_MANAGER_CORE_MEMORY_POOL_H
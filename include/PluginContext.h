@@ -9,7 +9,10 @@
 #ifndef FLEET_DATA_MANAGER_CORE_PLUGIN_CONTEXT_H
 #define FLEET_DATA_MANAGER_CORE_PLUGIN_CONTEXT_H
 
+#include "Executor.h"
 #include "Logger.h"
+#include "MemoryPool.h"
+#include "ServiceHandle.h"
 #include <memory>
 #include <string>
 
@@ -56,9 +59,20 @@ class PluginContext {
      * @param[in] pluginName 插件名称
      * @return 服务对象指针，未找到返回nullptr
      * @note 调用方需要将返回指针转换为对应的服务接口类型
+     * @deprecated 返回的指针不阻止插件热重载或卸载，仅用于检查插件是否存在；
+     * 数据路径上调用服务应使用AcquireService
      */
     virtual void *GetService(const std::string &pluginName) = 0;
 
+    /**
+     * @brief 获取其他插件的服务句柄
+     * @details 句柄存活期间插件实例不会被热重载或卸载销毁
+     * @param[in] pluginName 插件名称
+     * @return 服务句柄，未找到插件时句柄内的服务对象指针为nullptr
+     * @see ServiceHandle
+     */
+    virtual ServiceHandle AcquireService(const std::string &pluginName) = 0;
+
     /**
      * @brief 获取基础目录路径
      * @details 返回插件系统的根目录路径
@@ -87,6 +101,22 @@ class PluginContext {
      */
     virtual const std::string &GetDatabaseDirectory() = 0;
 
+    /**
+     * @brief 获取内存池
+     * @details 返回进程内共享的块内存池，插件可用其分配数据路径上的短生命周期对象并查看分配统计
+     * @return 内存池引用
+     * @see MemoryPool, Arena, PoolAllocator
+     */
+    virtual MemoryPool &GetMemoryPool() = 0;
+
+    /**
+     * @brief 获取共享执行器
+     * @details 返回进程内共享的线程池，用于驱动异步服务接口和插件的后台任务
+     * @return 执行器引用
+     * @see AsyncStorageService, AsyncMessagingService, AsyncPortalService
+     */
+    virtual Executor &GetExecutor() = 0;
+
     /**
      * @brief 记录跟踪级别日志
      * @details 记录详细的程序执行跟踪信息，用于调试和问题定位
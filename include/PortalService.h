@@ -13,6 +13,7 @@
 #ifndef FLEET_DATA_MANAGER_PORTAL_PORTAL_SERVICE_H
 #define FLEET_DATA_MANAGER_PORTAL_PORTAL_SERVICE_H
 
+#include "CancellationToken.h"
 #include "MessagingService.h"
 #include <string>
 #include <vector>
@@ -672,6 +673,56 @@ class PortalService {
      * @return true if success
      */
     virtual bool ReplySmallFile(const char *uuid, const char *reply, int length) = 0;
+
+    // ================= 带取消令牌的操作 =================
+    // 名称与不带令牌的方法不同，插件重写其中之一不会隐藏另一个
+
+    /**
+     * @brief 在截止时间内于多个节点执行SQLite语句
+     * @details 默认实现逐个节点调用不带令牌的SqliteExecute，在每个节点执行前检查令牌，
+     * 令牌取消后不再向剩余的节点发出语句，单个节点的执行期间不响应令牌；
+     * 门户插件可重写此方法并发执行，并在网络等待中响应令牌
+     * @param[in] nodeIdList 目标节点ID列表
+     * @param[in] connectionString 数据库连接字符串
+     * @param[in] sql SQL语句
+     * @param[in] token 取消令牌，nullptr表示不限时
+     * @return 全部节点执行成功返回true，任一节点失败、已取消或已超时返回false
+     * @note 多个节点上的执行不是原子的，返回false时部分节点可能已经执行了语句
+     */
+    virtual bool SqliteExecuteWithToken(const std::vector<std::string> &nodeIdList,
+                                        const std::string &connectionString,
+                                        const std::string &sql,
+                                        const std::shared_ptr<Core::CancellationToken> &token) {
+        bool ret = true;
+        for (const auto &nodeId : nodeIdList) {
+            if (Core::IsCancelled(token)) {
+                return false;
+            }
+            ret = this->SqliteExecute({nodeId}, connectionString, sql) && ret;
+        }
+        return ret;
+    }
+
+    /**
+     * @brief 在截止时间内下载数据
+     * @details 默认实现只在调用前检查一次令牌，未取消时调用不带令牌的DownloadData，下载期间不响应令牌；
+     * 本地无数据需向其他节点请求时，门户插件应重写此方法并以剩余时间作为网络超时
+     * @param [in] dataType 数据类型
+     * @param [in] name 数据唯一标识符
+     * @param [in] from 数据来源
+     * @param [out] data 数据
+     * @param [in] token 取消令牌，nullptr表示不限时
+     * @return 数据长度，已取消或已超时返回-1
+     * @note 函数会自行为data分配内存，请传入空指针，调用后需要释放data
+     */
+    virtual int DownloadDataWithToken(const char *dataType, const char *name, const char *from,
+                                      char *&data,
+                                      const std::shared_ptr<Core::CancellationToken> &token) {
+        if (Core::IsCancelled(token)) {
+            return -1;
+        }
+        return this->DownloadData(dataType, name, from, data);
+    }
 };
 } // namespace Fleet::DataManager::Portal
 #endif // FLEET_DATA_MANAGER_PORTAL_PORTAL_SERVICE_H
\ No newline at end of file
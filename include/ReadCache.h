@@ -0,0 +1,494 @@
+/**
+ * @file ReadCache.h
+ * @brief 读缓存模块
+ * @details 按字节数限定容量的分片进程内缓存，以W-TinyLFU策略决定准入和淘汰，缓存频繁读取的配置和模型数据
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_READ_CACHE_H
+#define FLEET_DATA_MANAGER_STORAGE_READ_CACHE_H
+
+#include "DataBlock.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief 读缓存统计
+ */
+struct ReadCacheStatistics {
+    /// 命中次数
+    uint64_t hits = 0;
+    /// 未命中次数
+    uint64_t misses = 0;
+    /// 插入次数
+    uint64_t insertions = 0;
+    /// 因准入策略、容量或并发失效而未插入的次数
+    uint64_t rejections = 0;
+    /// 因容量不足淘汰的条目数
+    uint64_t evictions = 0;
+    /// 因数据变更失效的条目数
+    uint64_t invalidations = 0;
+    /// 当前条目数
+    uint64_t entries = 0;
+    /// 当前占用的字节数
+    uint64_t bytes = 0;
+    /// 容量，单位字节
+    uint64_t capacity = 0;
+
+    /**
+     * @brief 计算命中率
+     * @return 命中次数占查找次数的比例，没有查找时返回0
+     */
+    double GetHitRatio() const {
+        uint64_t lookups = this->hits + this->misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(this->hits) / lookups;
+    }
+};
+
+/**
+ * @brief 读缓存类
+ * @details 键按哈希分到多个分片，每个分片独立加锁。分片内分为窗口区和主区，主区又分为试用段和保护段：
+ * 新条目先进入窗口区，窗口区溢出的条目与试用段末尾的条目比较访问频率，频率更高者留在主区；
+ * 试用段中再次被访问的条目晋升到保护段。访问频率由定期衰减的Count-Min草图估计，
+ * 一次性扫描的大量数据因此不会冲掉反复读取的热点数据。
+ * 缓存直接持有数据块的共享指针，命中时不拷贝数据
+ * @note 线程安全。查找未命中时返回的票据用于插入，插入前分片上发生过失效则放弃插入，
+ * 避免与写入并发的读取把旧数据放回缓存
+ */
+class ReadCache {
+  public:
+    /**
+     * @brief 构造读缓存
+     * @param[in] capacity 容量，单位字节，为0时不缓存任何数据
+     * @param[in] shardCount 分片数量，至少为1
+     */
+    explicit ReadCache(uint64_t capacity, uint32_t shardCount = 16)
+        : shards(std::max<uint32_t>(shardCount, 1)) {
+        this->SetCapacity(capacity);
+    }
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    ReadCache(const ReadCache &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    ReadCache &operator=(const ReadCache &) = delete;
+
+    /**
+     * @brief 查找缓存
+     * @param[in] key 键
+     * @param[out] ticket 未命中时写入插入票据，允许为nullptr
+     * @return 数据块对象指针，未命中返回nullptr
+     */
+    std::shared_ptr<DataBlock> Get(const std::string &key, uint64_t *ticket = nullptr) {
+        size_t hash = std::hash<std::string>()(key);
+        Shard &shard = this->GetShard(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.sketch.Increment(hash);
+        auto iter = shard.map.find(key);
+        if (iter == shard.map.end()) {
+            ++shard.statistics.misses;
+            if (ticket != nullptr) {
+                *ticket = shard.epoch;
+            }
+            return nullptr;
+        }
+        ++shard.statistics.hits;
+        shard.Touch(iter->second);
+        return iter->second->block;
+    }
+
+    /**
+     * @brief 插入缓存
+     * @param[in] key 键
+     * @param[in] block 数据块对象
+     * @param[in] ticket 查找未命中时获得的插入票据
+     * @return 插入成功返回true，分片上已发生失效、数据块超过分片容量或未通过准入返回false
+     */
+    bool Put(const std::string &key, const std::shared_ptr<DataBlock> &block, uint64_t ticket) {
+        if (block == nullptr) {
+            return false;
+        }
+        size_t hash = std::hash<std::string>()(key);
+        Shard &shard = this->GetShard(hash);
+        uint64_t charge = block->GetSize() + key.size() + EntryOverhead;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (ticket != shard.epoch || charge > shard.capacity) {
+            ++shard.statistics.rejections;
+            return false;
+        }
+        auto iter = shard.map.find(key);
+        if (iter != shard.map.end()) {
+            shard.Remove(iter->second);
+            shard.map.erase(iter);
+        }
+        shard.window.push_front(Entry{key, hash, block, charge, Region::Window});
+        shard.windowBytes += charge;
+        shard.map[key] = shard.window.begin();
+        ++shard.statistics.insertions;
+        shard.Evict();
+        return shard.map.find(key) != shard.map.end();
+    }
+
+    /**
+     * @brief 使缓存条目失效
+     * @details 数据写入、删除或修复后调用，同时使该分片上进行中的加载作废
+     * @param[in] key 键
+     */
+    void Invalidate(const std::string &key) {
+        size_t hash = std::hash<std::string>()(key);
+        Shard &shard = this->GetShard(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        ++shard.epoch;
+        auto iter = shard.map.find(key);
+        if (iter != shard.map.end()) {
+            shard.Remove(iter->second);
+            shard.map.erase(iter);
+            ++shard.statistics.invalidations;
+        }
+    }
+
+    /**
+     * @brief 清空缓存
+     */
+    void Clear() {
+        for (auto &shard : this->shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            ++shard.epoch;
+            shard.statistics.invalidations += shard.map.size();
+            shard.map.clear();
+            shard.window.clear();
+            shard.probation.clear();
+            shard.protection.clear();
+            shard.windowBytes = 0;
+            shard.probationBytes = 0;
+            shard.protectionBytes = 0;
+        }
+    }
+
+    /**
+     * @brief 设置容量
+     * @details 容量平均分配到各分片，缩小容量时立即淘汰超出部分
+     * @param[in] capacity 容量，单位字节，为0时清空并停止缓存
+     */
+    void SetCapacity(uint64_t capacity) {
+        uint64_t shardCapacity = capacity / this->shards.size();
+        for (auto &shard : this->shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.Resize(shardCapacity);
+        }
+    }
+
+    /**
+     * @brief 获取容量
+     * @return 容量，单位字节
+     */
+    uint64_t GetCapacity() {
+        uint64_t ret = 0;
+        for (auto &shard : this->shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            ret += shard.capacity;
+        }
+        return ret;
+    }
+
+    /**
+     * @brief 获取统计信息
+     * @return 所有分片统计信息之和
+     */
+    ReadCacheStatistics GetStatistics() {
+        ReadCacheStatistics ret;
+        for (auto &shard : this->shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            ret.hits += shard.statistics.hits;
+            ret.misses += shard.statistics.misses;
+            ret.insertions += shard.statistics.insertions;
+            ret.rejections += shard.statistics.rejections;
+            ret.evictions += shard.statistics.evictions;
+            ret.invalidations += shard.statistics.invalidations;
+            ret.entries += shard.map.size();
+            ret.bytes += shard.windowBytes + shard.probationBytes + shard.protectionBytes;
+            ret.capacity += shard.capacity;
+        }
+        return ret;
+    }
+
+  private:
+    /// 每个条目的估计管理开销，计入占用字节数
+    static constexpr uint64_t EntryOverhead = 128;
+
+    /**
+     * @brief 条目所在区域
+     */
+    enum class Region { Window, Probation, Protection };
+
+    /**
+     * @brief 缓存条目
+     */
+    struct Entry {
+        /// 键
+        std::string key;
+        /// 键的哈希值
+        size_t hash;
+        /// 数据块
+        std::shared_ptr<DataBlock> block;
+        /// 占用的字节数
+        uint64_t charge;
+        /// 所在区域
+        Region region;
+    };
+
+    /**
+     * @brief 访问频率草图
+     * @details 4行4位饱和计数器的Count-Min草图，累计增量达到宽度的10倍后所有计数减半，使旧的热度逐渐衰减
+     */
+    class FrequencySketch {
+      public:
+        /**
+         * @brief 按预计条目数重新分配计数器
+         * @param[in] expectedEntries 预计条目数
+         */
+        void Resize(uint64_t expectedEntries) {
+            uint64_t width = 64;
+            while (width < expectedEntries && width < (1u << 20)) {
+                width <<= 1;
+            }
+            this->mask = width - 1;
+            this->counters.assign(width * Depth, 0);
+            this->additions = 0;
+            this->sampleSize = width * 10;
+        }
+
+        /**
+         * @brief 记录一次访问
+         * @param[in] hash 键的哈希值
+         */
+        void Increment(size_t hash) {
+            bool added = false;
+            for (uint32_t row = 0; row < Depth; ++row) {
+                uint8_t &counter = this->counters[this->IndexOf(hash, row)];
+                if (counter < 15) {
+                    ++counter;
+                    added = true;
+                }
+            }
+            if (added && ++this->additions >= this->sampleSize) {
+                for (auto &counter : this->counters) {
+                    counter >>= 1;
+                }
+                this->additions /= 2;
+            }
+        }
+
+        /**
+         * @brief 估计访问频率
+         * @param[in] hash 键的哈希值
+         * @return 估计的访问次数，最大为15
+         */
+        uint32_t Estimate(size_t hash) const {
+            uint32_t ret = 15;
+            for (uint32_t row = 0; row < Depth; ++row) {
+                ret = std::min<uint32_t>(ret, this->counters[this->IndexOf(hash, row)]);
+            }
+            return ret;
+        }
+
+      private:
+        /// 行数
+        static constexpr uint32_t Depth = 4;
+        /// 计数器，按行连续存放
+        std::vector<uint8_t> counters;
+        /// 行宽掩码
+        uint64_t mask = 0;
+        /// 上次衰减以来的累计增量
+        uint64_t additions = 0;
+        /// 触发衰减的累计增量
+        uint64_t sampleSize = 0;
+
+        /**
+         * @brief 计算计数器下标
+         * @param[in] hash 键的哈希值
+         * @param[in] row 行号
+         * @return 计数器下标
+         */
+        uint64_t IndexOf(size_t hash, uint32_t row) const {
+            uint64_t mixed = (static_cast<uint64_t>(hash) + row) * 0x9E3779B97F4A7C15ull;
+            mixed ^= mixed >> 29;
+            return row * (this->mask + 1) + (mixed & this->mask);
+        }
+    };
+
+    /**
+     * @brief 缓存分片
+     */
+    struct Shard {
+        /// 分片互斥锁
+        std::mutex mutex;
+        /// 键到条目的映射
+        std::unordered_map<std::string, std::list<Entry>::iterator> map;
+        /// 窗口区，按最近访问排序
+        std::list<Entry> window;
+        /// 主区试用段，按最近访问排序
+        std::list<Entry> probation;
+        /// 主区保护段，按最近访问排序
+        std::list<Entry> protection;
+        /// 窗口区占用的字节数
+        uint64_t windowBytes = 0;
+        /// 试用段占用的字节数
+        uint64_t probationBytes = 0;
+        /// 保护段占用的字节数
+        uint64_t protectionBytes = 0;
+        /// 分片容量
+        uint64_t capacity = 0;
+        /// 窗口区容量
+        uint64_t windowCapacity = 0;
+        /// 保护段容量
+        uint64_t protectionCapacity = 0;
+        /// 失效纪元，每次失效加一
+        uint64_t epoch = 0;
+        /// 访问频率草图
+        FrequencySketch sketch;
+        /// 统计信息，entries、bytes和capacity不在此累计
+        ReadCacheStatistics statistics;
+
+        /**
+         * @brief 调整分片容量
+         * @param[in] newCapacity 新容量
+         */
+        void Resize(uint64_t newCapacity) {
+            this->capacity = newCapacity;
+            this->windowCapacity = newCapacity / 100;
+            this->protectionCapacity = (newCapacity - this->windowCapacity) / 5 * 4;
+            // 按每个条目约4KiB估计条目数
+            this->sketch.Resize(newCapacity / 4096);
+            this->Evict();
+        }
+
+        /**
+         * @brief 记录一次命中并调整条目位置
+         * @param[in] iter 条目迭代器
+         */
+        void Touch(std::list<Entry>::iterator iter) {
+            switch (iter->region) {
+            case Region::Window:
+                this->window.splice(this->window.begin(), this->window, iter);
+                break;
+            case Region::Probation:
+                iter->region = Region::Protection;
+                this->probationBytes -= iter->charge;
+                this->protectionBytes += iter->charge;
+                this->protection.splice(this->protection.begin(), this->probation, iter);
+                while (this->protectionBytes > this->protectionCapacity &&
+                       this->protection.size() > 1) {
+                    auto demoted = std::prev(this->protection.end());
+                    demoted->region = Region::Probation;
+                    this->protectionBytes -= demoted->charge;
+                    this->probationBytes += demoted->charge;
+                    this->probation.splice(this->probation.begin(), this->protection, demoted);
+                }
+                break;
+            case Region::Protection:
+                this->protection.splice(this->protection.begin(), this->protection, iter);
+                break;
+            }
+        }
+
+        /**
+         * @brief 从所在区域移除条目，不修改映射
+         * @param[in] iter 条目迭代器
+         */
+        void Remove(std::list<Entry>::iterator iter) {
+            switch (iter->region) {
+            case Region::Window:
+                this->windowBytes -= iter->charge;
+                this->window.erase(iter);
+                break;
+            case Region::Probation:
+                this->probationBytes -= iter->charge;
+                this->probation.erase(iter);
+                break;
+            case Region::Protection:
+                this->protectionBytes -= iter->charge;
+                this->protection.erase(iter);
+                break;
+            }
+        }
+
+        /**
+         * @brief 淘汰条目直到各区域不超过容量
+         * @details 窗口区溢出的条目作为候选进入试用段，主区超出容量时候选与试用段末尾的条目比较访问频率，淘汰频率较低者
+         */
+        void Evict() {
+            uint64_t mainCapacity = this->capacity - this->windowCapacity;
+            while (this->windowBytes > this->windowCapacity && !this->window.empty()) {
+                auto candidate = std::prev(this->window.end());
+                candidate->region = Region::Probation;
+                this->windowBytes -= candidate->charge;
+                this->probationBytes += candidate->charge;
+                this->probation.splice(this->probation.begin(), this->window, candidate);
+                while (this->probationBytes + this->protectionBytes > mainCapacity) {
+                    if (this->probation.size() == 1 && !this->protection.empty()) {
+                        auto demoted = std::prev(this->protection.end());
+                        demoted->region = Region::Probation;
+                        this->protectionBytes -= demoted->charge;
+                        this->probationBytes += demoted->charge;
+                        this->probation.splice(this->probation.end(), this->protection, demoted);
+                    }
+                    auto victim = std::prev(this->probation.end());
+                    if (victim == candidate ||
+                        this->sketch.Estimate(candidate->hash) <=
+                            this->sketch.Estimate(victim->hash)) {
+                        this->Drop(candidate);
+                        break;
+                    }
+                    this->Drop(victim);
+                }
+            }
+            while (this->probationBytes + this->protectionBytes > mainCapacity) {
+                auto &region = this->probation.empty() ? this->protection : this->probation;
+                if (region.empty()) {
+                    break;
+                }
+                this->Drop(std::prev(region.end()));
+            }
+        }
+
+        /**
+         * @brief 淘汰条目
+         * @param[in] iter 条目迭代器
+         */
+        void Drop(std::list<Entry>::iterator iter) {
+            this->map.erase(iter->key);
+            this->Remove(iter);
+            ++this->statistics.evictions;
+        }
+    };
+
+    /// 分片
+    std::vector<Shard> shards;
+
+    /**
+     * @brief 获取键所在的分片
+     * @param[in] hash 键的哈希值
+     * @return 分片引用
+     */
+    Shard &GetShard(size_t hash) {
+        return this->shards[(hash >> 16) % this->shards.size()];
+    }
+};
+} // namespace Fleet::DataManager::Storage
+
+#endif // FLEET_DATA_MANAGER_STORAGE_READ_CACHE_H
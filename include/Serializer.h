@@ -0,0 +1,270 @@
+/**
+ * @file Serializer.h
+ * @brief 序列化工具
+ * @details 提供写入调用方缓冲区的序列化器和带边界检查的反序列化器，供数据键、存储位置和存储策略使用
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_CORE_SERIALIZER_H
+#define FLEET_DATA_MANAGER_CORE_SERIALIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace Fleet::DataManager::Core {
+/**
+ * @brief 缓冲区序列化器
+ * @details 向调用方提供的定长缓冲区顺序写入，不分配内存。整数按本机字节序写入，与原有的序列化格式一致；
+ * 字符串写为4字节长度加内容。空间不足时不写入任何内容并进入溢出状态，之后的写入全部失败
+ * @note 非线程安全，调用方应先通过各类型的GetSerializedSize计算所需空间
+ */
+class BufferWriter {
+  public:
+    /**
+     * @brief 构造序列化器
+     * @param[in] buffer 目标缓冲区
+     * @param[in] capacity 缓冲区大小，单位字节
+     */
+    BufferWriter(char *buffer, size_t capacity)
+        : buffer(buffer), capacity(capacity), position(0), overflowed(false) {
+    }
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    BufferWriter(const BufferWriter &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    BufferWriter &operator=(const BufferWriter &) = delete;
+
+    /**
+     * @brief 写入32位无符号整数
+     * @param[in] value 整数值
+     * @return 写入成功返回true，空间不足返回false
+     */
+    bool WriteUInt32(uint32_t value) {
+        return this->WriteBytes(&value, sizeof(value));
+    }
+
+    /**
+     * @brief 写入字符串
+     * @param[in] value 字符串，长度不能超过UINT32_MAX
+     * @return 写入成功返回true，空间不足或字符串过长返回false
+     */
+    bool WriteString(std::string_view value) {
+        if (value.size() > UINT32_MAX ||
+            !this->Reserve(SizeOfUInt32 + value.size())) {
+            return false;
+        }
+        return this->WriteUInt32(static_cast<uint32_t>(value.size())) &&
+               this->WriteBytes(value.data(), value.size());
+    }
+
+    /**
+     * @brief 写入原始字节
+     * @param[in] data 数据
+     * @param[in] size 数据大小
+     * @return 写入成功返回true，空间不足返回false
+     */
+    bool WriteBytes(const void *data, size_t size) {
+        if (!this->Reserve(size)) {
+            return false;
+        }
+        if (size > 0) {
+            memcpy(this->buffer + this->position, data, size);
+        }
+        this->position += size;
+        return true;
+    }
+
+    /**
+     * @brief 获取已写入的字节数
+     * @return 已写入的字节数
+     */
+    size_t GetPosition() const {
+        return this->position;
+    }
+
+    /**
+     * @brief 判断是否发生过空间不足
+     * @return 发生过返回true，否则返回false
+     */
+    bool IsOverflowed() const {
+        return this->overflowed;
+    }
+
+    /// 32位无符号整数的序列化长度
+    static constexpr size_t SizeOfUInt32 = sizeof(uint32_t);
+
+    /**
+     * @brief 计算字符串的序列化长度
+     * @param[in] value 字符串
+     * @return 序列化长度，单位字节
+     */
+    static size_t SizeOfString(std::string_view value) {
+        return SizeOfUInt32 + value.size();
+    }
+
+  private:
+    /// 目标缓冲区
+    char *buffer;
+
+    /// 缓冲区大小
+    size_t capacity;
+
+    /// 当前写入位置
+    size_t position;
+
+    /// 是否发生过空间不足
+    bool overflowed;
+
+    /**
+     * @brief 检查剩余空间
+     * @param[in] size 需要的字节数
+     * @return 空间足够返回true，否则进入溢出状态并返回false
+     */
+    bool Reserve(size_t size) {
+        if (this->overflowed || size > this->capacity - this->position) {
+            this->overflowed = true;
+            return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief 缓冲区反序列化器
+ * @details 从只读缓冲区顺序读取，所有读取先检查剩余长度，通过memcpy读取整数，不要求对齐。
+ * 读取越界时不修改输出参数并进入失败状态，之后的读取全部失败
+ * @note 非线程安全，读取字符串视图时返回的视图引用原缓冲区
+ */
+class BufferReader {
+  public:
+    /**
+     * @brief 构造反序列化器
+     * @param[in] data 源缓冲区
+     * @param[in] size 缓冲区大小，单位字节
+     * @param[in] position 起始读取位置
+     */
+    BufferReader(const char *data, size_t size, size_t position = 0)
+        : data(data), size(size), position(position), failed(position > size) {
+    }
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    BufferReader(const BufferReader &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    BufferReader &operator=(const BufferReader &) = delete;
+
+    /**
+     * @brief 读取32位无符号整数
+     * @param[out] value 整数值
+     * @return 读取成功返回true，剩余长度不足返回false
+     */
+    bool ReadUInt32(uint32_t &value) {
+        return this->ReadBytes(&value, sizeof(value));
+    }
+
+    /**
+     * @brief 读取字符串视图
+     * @param[out] value 引用源缓冲区的字符串视图
+     * @return 读取成功返回true，剩余长度不足返回false
+     */
+    bool ReadStringView(std::string_view &value) {
+        size_t start = this->position;
+        uint32_t length = 0;
+        if (!this->ReadUInt32(length)) {
+            return false;
+        }
+        if (length > this->size - this->position) {
+            this->position = start;
+            this->failed = true;
+            return false;
+        }
+        value = std::string_view(this->data + this->position, length);
+        this->position += length;
+        return true;
+    }
+
+    /**
+     * @brief 读取字符串
+     * @param[out] value 字符串
+     * @return 读取成功返回true，剩余长度不足返回false
+     */
+    bool ReadString(std::string &value) {
+        std::string_view view;
+        if (!this->ReadStringView(view)) {
+            return false;
+        }
+        value.assign(view.data(), view.size());
+        return true;
+    }
+
+    /**
+     * @brief 读取原始字节
+     * @param[out] output 输出缓冲区
+     * @param[in] length 读取长度
+     * @return 读取成功返回true，剩余长度不足返回false
+     */
+    bool ReadBytes(void *output, size_t length) {
+        if (this->failed || length > this->size - this->position) {
+            this->failed = true;
+            return false;
+        }
+        if (length > 0) {
+            memcpy(output, this->data + this->position, length);
+        }
+        this->position += length;
+        return true;
+    }
+
+    /**
+     * @brief 获取当前读取位置
+     * @return 当前读取位置
+     */
+    size_t GetPosition() const {
+        return this->position;
+    }
+
+    /**
+     * @brief 获取剩余的字节数
+     * @return 剩余的字节数
+     */
+    size_t GetRemaining() const {
+        return this->failed ? 0 : this->size - this->position;
+    }
+
+    /**
+     * @brief 判断是否发生过读取越界
+     * @return 发生过返回true，否则返回false
+     */
+    bool IsFailed() const {
+        return this->failed;
+    }
+
+  private:
+    /// 源缓冲区
+    const char *data;
+
+    /// 缓冲区大小
+    size_t size;
+
+    /// 当前读取位置
+    size_t position;
+
+    /// 是否发生过读取越界
+    bool failed;
+};
+} // namespace Fleet::DataManager::Core
+
+#endif // FLEET_DATA_MANAGER_CORE_SERIALIZER_H
@@ -0,0 +1,144 @@
+/**
+ * @file ServiceHandle.h
+ * @brief 插件服务句柄
+ * @details 在一次服务调用期间持有插件实例，保证热重载时旧实例在调用结束后才被销毁
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-06-29
+ */
+
+#ifndef FLEET_DATA_MANAGER_CORE_SERVICE_HANDLE_H
+#define FLEET_DATA_MANAGER_CORE_SERVICE_HANDLE_H
+
+#include <memory>
+#include <utility>
+
+namespace Fleet::DataManager::Core {
+/// 线程持有的服务调用记录，由核心库维护
+struct ThreadPins;
+
+/**
+ * @brief 服务调用登记接口
+ * @details 由核心库的插件对象实现，服务句柄释放时通过该接口结束调用
+ */
+class ServicePin {
+  public:
+    /**
+     * @brief 虚析构函数
+     */
+    virtual ~ServicePin() = default;
+
+    /**
+     * @brief 结束一次进行中的服务调用
+     * @param[in] owner 登记该调用的线程记录
+     */
+    virtual void EndCall(const std::shared_ptr<ThreadPins> &owner) = 0;
+};
+
+/**
+ * @brief 插件服务句柄类
+ * @details 由PluginManager::AcquireService创建，句柄存活期间对应插件实例计入一次进行中的调用，
+ * 热重载或卸载插件时会等待所有句柄释放后再销毁旧实例。
+ * 调用记在获取句柄的线程上，该线程在句柄存活期间重载或卸载同一插件时，旧实例交给后台回收
+ * @note 句柄可以移动到其他线程释放
+ */
+class ServiceHandle {
+  public:
+    /**
+     * @brief 构造空句柄
+     */
+    ServiceHandle() : service(nullptr) {
+    }
+
+    /**
+     * @brief 构造服务句柄
+     * @param[in] pin 插件对象，调用方已对其登记一次调用
+     * @param[in] owner 登记该调用的线程记录
+     */
+    ServiceHandle(std::shared_ptr<ServicePin> pin, std::shared_ptr<ThreadPins> owner)
+        : pin(std::move(pin)), owner(std::move(owner)), service(nullptr) {
+    }
+
+    /**
+     * @brief 析构函数，结束本次服务调用
+     */
+    ~ServiceHandle() {
+        this->Release();
+    }
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    ServiceHandle(const ServiceHandle &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    ServiceHandle &operator=(const ServiceHandle &) = delete;
+
+    /**
+     * @brief 移动构造函数
+     * @param[in] another 源句柄
+     */
+    ServiceHandle(ServiceHandle &&another) noexcept
+        : pin(std::move(another.pin)), owner(std::move(another.owner)),
+          service(another.service) {
+        another.service = nullptr;
+    }
+
+    /**
+     * @brief 移动赋值操作符
+     * @param[in] another 源句柄
+     * @return 当前句柄引用
+     */
+    ServiceHandle &operator=(ServiceHandle &&another) noexcept {
+        if (this != &another) {
+            this->Release();
+            this->pin = std::move(another.pin);
+            this->owner = std::move(another.owner);
+            this->service = another.service;
+            another.service = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 获取服务接口指针
+     * @return 服务接口指针，插件不存在时返回nullptr
+     * @note 返回的指针仅在句柄存活期间有效
+     */
+    void *Get() const {
+        return this->service;
+    }
+
+    /**
+     * @brief 设置服务接口指针
+     * @param[in] service 服务接口指针
+     */
+    void Set(void *service) {
+        this->service = service;
+    }
+
+  private:
+    /// 被调用的插件对象，为nullptr表示空句柄
+    std::shared_ptr<ServicePin> pin;
+
+    /// 登记本次调用的线程记录
+    std::shared_ptr<ThreadPins> owner;
+
+    /// 插件提供的服务接口指针
+    void *service;
+
+    /**
+     * @brief 结束本次服务调用并清空句柄
+     */
+    void Release() {
+        if (this->pin != nullptr) {
+            this->pin->EndCall(this->owner);
+            this->pin.reset();
+            this->owner.reset();
+        }
+        this->service = nullptr;
+    }
+};
+} // namespace Fleet::DataManager::Core
+#endif // FLEET_DATA_MANAGER_CORE_SERVICE_HANDLE_H
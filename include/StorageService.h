@@ -9,9 +9,12 @@
 #ifndef FLEET_DATA_MANAGER_STORAGE_STORAGE_SERVICE_H
 #define FLEET_DATA_MANAGER_STORAGE_STORAGE_SERVICE_H
 
+#include "CancellationToken.h"
 #include "DataBlock.h"
 #include "DataInfo.h"
 #include "DataKey.h"
+#include "MappedDataBlock.h"
+#include "ReadCache.h"
 #include "Device.h"
 #include "Location.h"
 #include "Strategy.h"
@@ -590,6 +593,133 @@ class StorageService {
      * @details 删除调度目录中的所有文件
      */
     virtual void CleareSchedulingDir() = 0;
+
+    // ================= 带取消令牌的数据操作 =================
+    // 名称与不带令牌的方法不同，插件重写其中之一不会隐藏另一个
+
+    /**
+     * @brief 在截止时间内读取数据的最新版本
+     * @details 默认实现只在调用前检查一次令牌，未取消时调用不带令牌的ReadData，读取期间不响应令牌；
+     * 存储插件应重写此方法并将令牌传给StorageEngine::ReadLatest，由其在读取每个副本或分片前检查
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @param[in] token 取消令牌，nullptr表示不限时
+     * @return 数据块对象指针，未找到、已取消或已超时返回nullptr
+     */
+    virtual std::shared_ptr<DataBlock>
+    ReadDataWithToken(const std::string &application, const std::string &dataType,
+                      const std::string &name,
+                      const std::shared_ptr<Core::CancellationToken> &token) {
+        if (Core::IsCancelled(token)) {
+            return nullptr;
+        }
+        return this->ReadData(application, dataType, name);
+    }
+
+    /**
+     * @brief 在截止时间内读取数据的指定版本
+     * @details 默认实现只在调用前检查一次令牌，未取消时调用不带令牌的ReadData；
+     * 存储插件应重写此方法并将令牌传给StorageEngine::ReadData
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @param[in] version 版本信息
+     * @param[in] token 取消令牌，nullptr表示不限时
+     * @return 数据块对象指针，未找到、已取消或已超时返回nullptr
+     */
+    virtual std::shared_ptr<DataBlock>
+    ReadDataWithToken(const std::string &application, const std::string &dataType,
+                      const std::string &name, const std::string &version,
+                      const std::shared_ptr<Core::CancellationToken> &token) {
+        if (Core::IsCancelled(token)) {
+            return nullptr;
+        }
+        return this->ReadData(application, dataType, name, version);
+    }
+
+    /**
+     * @brief 在截止时间内写入数据，自动生成版本
+     * @details 默认实现只在调用前检查一次令牌，未取消时调用不带令牌的WriteData，写入期间不响应令牌；
+     * 存储插件应重写此方法并将令牌传给StorageEngine::WriteData，放弃仍在写队列中的副本写入
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @param[in] dataBlock 数据块对象
+     * @param[in] token 取消令牌，nullptr表示不限时
+     * @return 写入成功返回true，失败、已取消或已超时返回false
+     */
+    virtual bool WriteDataWithToken(const std::string &application, const std::string &dataType,
+                                    const std::string &name,
+                                    const std::shared_ptr<DataBlock> &dataBlock,
+                                    const std::shared_ptr<Core::CancellationToken> &token) {
+        if (Core::IsCancelled(token)) {
+            return false;
+        }
+        return this->WriteData(application, dataType, name, dataBlock);
+    }
+
+    // ================= 映射读取 =================
+
+    /**
+     * @brief 以内存映射方式读取数据的最新版本
+     * @details 存储插件应重写此方法，返回直接映射存储文件或段文件的MappedDataBlock，
+     * 只访问产品局部的调用方只为实际访问的页付出IO；默认实现回退到ReadData，将整个数据读入堆内存
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @param[in] advice 访问模式提示
+     * @return 数据块对象指针，未找到返回nullptr，可通过IsMapped判断是否为映射数据块
+     */
+    virtual std::shared_ptr<DataBlock> ReadDataMapped(const std::string &application,
+                                                      const std::string &dataType,
+                                                      const std::string &name, MapAdvice advice) {
+        (void) advice;
+        return this->ReadData(application, dataType, name);
+    }
+
+    /**
+     * @brief 以内存映射方式读取数据的指定版本
+     * @details 默认实现回退到ReadData，将整个数据读入堆内存
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @param[in] version 版本信息
+     * @param[in] advice 访问模式提示
+     * @return 数据块对象指针，未找到返回nullptr，可通过IsMapped判断是否为映射数据块
+     */
+    virtual std::shared_ptr<DataBlock> ReadDataMapped(const std::string &application,
+                                                      const std::string &dataType,
+                                                      const std::string &name,
+                                                      const std::string &version,
+                                                      MapAdvice advice) {
+        (void) advice;
+        return this->ReadData(application, dataType, name, version);
+    }
+
+    // ================= 读缓存 =================
+
+    /**
+     * @brief 设置读缓存容量
+     * @details 与SetSpaceLimitSize一样以字节为单位，缓存按完整数据键保存最近读取的数据，
+     * 写入、删除和修复数据时相应的条目失效；默认实现不提供缓存
+     * @param[in] size 容量，单位字节，为0时清空并停止缓存
+     * @return 设置成功返回true，存储插件不支持读缓存返回false
+     */
+    virtual bool SetReadCacheSize(uint64_t size) {
+        (void) size;
+        return false;
+    }
+
+    /**
+     * @brief 获取读缓存统计信息
+     * @param[out] statistics 读缓存统计信息
+     * @return 获取成功返回true，存储插件不支持读缓存返回false
+     */
+    virtual bool GetReadCacheStatistics(ReadCacheStatistics *statistics) {
+        (void) statistics;
+        return false;
+    }
 };
 } // namespace Fleet::DataManager::Storage
 #endif // FLEET_DATA_MANAGER_STORAGE_STORAGE_SERVICE_H
\ No newline at end of file
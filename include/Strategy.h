@@ -14,6 +14,8 @@
 #define FLEET_DATA_MANAGER_STORAGE_STRATEGY_H
 
 #include "Location.h"
+#include "Serializer.h"
+#include <algorithm>
 #include <string>
 #include <uuid/uuid.h>
 #include <vector>
@@ -40,8 +42,7 @@ class Strategy {
         this->DoCreate(name, description, errorCorrectingAlgorithm, integrityCheckAlgorithm,
                        lifeTimeInSecond);
         this->locations.clear();
-        int i = 0;
-        for (i = 0; i < locations.size(); i++) {
+        for (size_t i = 0; i < locations.size(); i++) {
             this->locations.push_back(locations.at(i));
         }
     }
@@ -54,6 +55,7 @@ class Strategy {
      * @param[in] errorCorrectingAlgorithm 容错纠错算法
      * @param[in] integrityCheckAlgorithm 完整性校验算法
      * @param[in] lifeTimeInSecond 数据保存时长，单位秒
+     * @note 位置数据不完整时位置列表为空
      */
     Strategy(const std::string &name, const std::string &description,
              const std::string &serializedLocations, const std::string &errorCorrectingAlgorithm,
@@ -126,20 +128,46 @@ class Strategy {
         return this->lifeTimeInSecond;
     }
 
+    /**
+     * @brief 获取存储位置列表的序列化长度
+     * @return 序列化后的字节数
+     */
+    uint32_t GetSerializedLocationsSize() const {
+        uint32_t ret = Core::BufferWriter::SizeOfUInt32;
+        for (const auto &location : this->locations) {
+            ret += location.GetSerializedSize();
+        }
+        return ret;
+    }
+
+    /**
+     * @brief 将存储位置列表序列化到调用方提供的缓冲区
+     * @details 不分配内存，缓冲区剩余空间应不少于GetSerializedLocationsSize
+     * @param[in,out] writer 序列化器
+     * @return 写入成功返回true，空间不足返回false
+     */
+    bool SerializeLocationsTo(Core::BufferWriter &writer) const {
+        // 4 bytes: location count
+        if (!writer.WriteUInt32(static_cast<uint32_t>(this->locations.size()))) {
+            return false;
+        }
+        for (const auto &location : this->locations) {
+            if (!location.SerializeTo(writer)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     /**
      * @brief 序列化存储位置列表
      * @details 将位置列表序列化为二进制字符串格式
      * @return 序列化后的位置数据
      */
-    std::string SerializeLocations() {
-        std::string ret;
-        // 4 bytes: location count
-        uint32_t locationSize = this->locations.size();
-        ret.append(std::string((const char *) &locationSize, sizeof(locationSize)));
-        int i = 0;
-        for (i = 0; i < this->locations.size(); i++) {
-            ret.append(this->locations[i].Serialize());
-        }
+    std::string SerializeLocations() const {
+        std::string ret(this->GetSerializedLocationsSize(), '\0');
+        Core::BufferWriter writer(ret.data(), ret.size());
+        this->SerializeLocationsTo(writer);
         return ret;
     }
 
@@ -177,19 +205,30 @@ class Strategy {
 
     /**
      * @brief 反序列化存储位置列表
-     * @details 从序列化数据中解析位置列表
+     * @details 从序列化数据中解析位置列表，数据不完整时清空位置列表，
+     * 避免残缺的列表被当作完整的放置结果使用
      * @param[in] serializedLocation 序列化的位置数据
+     * @return 解析成功返回true，数据不完整返回false
      */
-    void DeserializeLocations(const std::string &serializedLocation) {
-        uint32_t position = 0;
+    bool DeserializeLocations(const std::string &serializedLocation) {
+        Core::BufferReader reader(serializedLocation.data(), serializedLocation.size());
         this->locations.clear();
         // 4 bytes: location count
-        uint32_t locationSize = *((uint32_t *) (serializedLocation.data() + position));
-        position += sizeof(locationSize);
-        int i = 0;
-        for (i = 0; i < locationSize; i++) {
-            this->locations.push_back(Location(serializedLocation, position));
+        uint32_t locationSize = 0;
+        if (!reader.ReadUInt32(locationSize)) {
+            return false;
+        }
+        // 每个位置至少包含两个长度字段，据此限制预留空间，避免损坏的计数导致过量分配
+        this->locations.reserve(std::min<size_t>(
+            locationSize, reader.GetRemaining() / (2 * Core::BufferWriter::SizeOfUInt32)));
+        for (uint32_t i = 0; i < locationSize; i++) {
+            this->locations.emplace_back("", "");
+            if (!this->locations.back().Deserialize(reader)) {
+                this->locations.clear();
+                return false;
+            }
         }
+        return true;
     }
 };
 } // namespace Fleet::DataManager::Storage
@@ -0,0 +1,457 @@
+/**
+ * @file Task.h
+ * @brief 协程任务模块
+ * @details 基于C++20协程的惰性任务类型，以及在共享执行器上执行同步调用、启动和等待任务的工具
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_CORE_TASK_H
+#define FLEET_DATA_MANAGER_CORE_TASK_H
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include "Executor.h"
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace Fleet::DataManager::Core {
+template <typename T> class Task;
+
+namespace Detail {
+/**
+ * @brief 任务承诺对象的公共部分
+ * @details 保存等待者的协程句柄和异常，任务结束时对称转移到等待者
+ */
+class TaskPromiseBase {
+  public:
+    /**
+     * @brief 任务结束时的等待器
+     */
+    struct FinalAwaiter {
+        /**
+         * @brief 总是挂起，由等待者负责销毁协程帧
+         */
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        /**
+         * @brief 恢复等待者，没有等待者时返回空协程
+         * @param[in] handle 已结束的任务协程句柄
+         * @return 下一个要恢复的协程句柄
+         */
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            auto continuation = handle.promise().continuation;
+            if (continuation) {
+                return continuation;
+            }
+            return std::noop_coroutine();
+        }
+
+        /**
+         * @brief 不会被调用
+         */
+        void await_resume() noexcept {
+        }
+    };
+
+    /**
+     * @brief 惰性启动，任务在被等待时才开始执行
+     */
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    /**
+     * @brief 结束时恢复等待者
+     */
+    FinalAwaiter final_suspend() noexcept {
+        return {};
+    }
+
+    /**
+     * @brief 保存未处理的异常，在等待者处重新抛出
+     */
+    void unhandled_exception() noexcept {
+        this->exception = std::current_exception();
+    }
+
+    /// 等待该任务的协程句柄
+    std::coroutine_handle<> continuation;
+
+    /// 任务执行过程中抛出的异常
+    std::exception_ptr exception;
+};
+
+/**
+ * @brief 有返回值任务的承诺对象
+ * @tparam T 返回值类型
+ */
+template <typename T> class TaskPromise : public TaskPromiseBase {
+  public:
+    /**
+     * @brief 创建任务对象
+     */
+    Task<T> get_return_object() noexcept;
+
+    /**
+     * @brief 保存返回值
+     * @param[in] value 返回值
+     */
+    template <typename U> void return_value(U &&value) {
+        this->value.emplace(std::forward<U>(value));
+    }
+
+    /**
+     * @brief 取出返回值，有异常时重新抛出
+     * @return 返回值
+     */
+    T Result() {
+        if (this->exception) {
+            std::rethrow_exception(this->exception);
+        }
+        return std::move(*this->value);
+    }
+
+  private:
+    /// 返回值
+    std::optional<T> value;
+};
+
+/**
+ * @brief 无返回值任务的承诺对象
+ */
+template <> class TaskPromise<void> : public TaskPromiseBase {
+  public:
+    /**
+     * @brief 创建任务对象
+     */
+    Task<void> get_return_object() noexcept;
+
+    /**
+     * @brief 任务正常结束
+     */
+    void return_void() noexcept {
+    }
+
+    /**
+     * @brief 有异常时重新抛出
+     */
+    void Result() {
+        if (this->exception) {
+            std::rethrow_exception(this->exception);
+        }
+    }
+};
+
+/**
+ * @brief 立即执行且自行销毁的协程，用于启动任务
+ */
+struct DetachedTask {
+    /**
+     * @brief 承诺对象
+     */
+    struct promise_type {
+        DetachedTask get_return_object() noexcept {
+            return {};
+        }
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+        void return_void() noexcept {
+        }
+        void unhandled_exception() noexcept {
+            std::terminate();
+        }
+    };
+};
+} // namespace Detail
+
+/**
+ * @brief 协程任务类
+ * @details 惰性任务，co_await时开始执行并在结束后恢复等待者；任务对象拥有协程帧，只能移动不能拷贝
+ * @tparam T 返回值类型，可以为void
+ */
+template <typename T = void> class [[nodiscard]] Task {
+  public:
+    /// 承诺对象类型
+    using promise_type = Detail::TaskPromise<T>;
+
+    /**
+     * @brief 构造空任务
+     */
+    Task() noexcept = default;
+
+    /**
+     * @brief 从协程句柄构造任务
+     * @param[in] handle 协程句柄
+     */
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle(handle) {
+    }
+
+    /**
+     * @brief 析构函数，销毁协程帧
+     */
+    ~Task() {
+        if (this->handle) {
+            this->handle.destroy();
+        }
+    }
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    Task(const Task &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    Task &operator=(const Task &) = delete;
+
+    /**
+     * @brief 移动构造函数
+     * @param[in] another 源任务
+     */
+    Task(Task &&another) noexcept : handle(std::exchange(another.handle, nullptr)) {
+    }
+
+    /**
+     * @brief 移动赋值操作符
+     * @param[in] another 源任务
+     * @return 当前任务引用
+     */
+    Task &operator=(Task &&another) noexcept {
+        if (this != &another) {
+            if (this->handle) {
+                this->handle.destroy();
+            }
+            this->handle = std::exchange(another.handle, nullptr);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 等待任务完成
+     * @return 等待器
+     */
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() noexcept {
+                return !this->handle || this->handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                this->handle.promise().continuation = awaiting;
+                return this->handle;
+            }
+
+            T await_resume() {
+                return this->handle.promise().Result();
+            }
+        };
+        return Awaiter{this->handle};
+    }
+
+  private:
+    /// 协程句柄
+    std::coroutine_handle<promise_type> handle;
+};
+
+namespace Detail {
+template <typename T> Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+} // namespace Detail
+
+/**
+ * @brief 在执行器上执行同步调用的等待器
+ * @details 挂起当前协程并将调用提交到执行器，调用完成后在执行器线程上恢复协程
+ * @tparam Function 可调用对象类型，返回值不能为void
+ */
+template <typename Function> class RunOnAwaiter {
+  public:
+    /// 调用结果类型
+    using ResultType = std::invoke_result_t<Function &>;
+
+    /**
+     * @brief 构造等待器
+     * @param[in] executor 执行器
+     * @param[in] function 待执行的同步调用
+     */
+    RunOnAwaiter(Executor &executor, Function function)
+        : executor(executor), function(std::move(function)) {
+    }
+
+    /**
+     * @brief 总是挂起
+     */
+    bool await_ready() noexcept {
+        return false;
+    }
+
+    /**
+     * @brief 将调用提交到执行器，执行器已停止时在当前线程执行
+     * @param[in] awaiting 等待的协程句柄
+     */
+    void await_suspend(std::coroutine_handle<> awaiting) {
+        auto run = [this, awaiting]() {
+            try {
+                this->result.emplace(this->function());
+            } catch (...) {
+                this->exception = std::current_exception();
+            }
+            awaiting.resume();
+        };
+        if (!this->executor.Post(run)) {
+            run();
+        }
+    }
+
+    /**
+     * @brief 取出调用结果，调用抛出异常时重新抛出
+     * @return 调用结果
+     */
+    ResultType await_resume() {
+        if (this->exception) {
+            std::rethrow_exception(this->exception);
+        }
+        return std::move(*this->result);
+    }
+
+  private:
+    /// 执行器
+    Executor &executor;
+
+    /// 待执行的同步调用
+    Function function;
+
+    /// 调用结果
+    std::optional<ResultType> result;
+
+    /// 调用抛出的异常
+    std::exception_ptr exception;
+};
+
+/**
+ * @brief 在执行器上执行同步调用
+ * @param[in] executor 执行器
+ * @param[in] function 待执行的同步调用，返回值不能为void
+ * @return 可co_await的等待器，结果为调用的返回值
+ */
+template <typename Function> RunOnAwaiter<Function> RunOn(Executor &executor, Function function) {
+    static_assert(!std::is_void_v<std::invoke_result_t<Function &>>,
+                  "RunOn 要求同步调用有返回值");
+    return RunOnAwaiter<Function>(executor, std::move(function));
+}
+
+/**
+ * @brief 切换到执行器线程继续执行
+ * @param[in] executor 执行器
+ * @return 可co_await的等待器
+ */
+inline auto ScheduleOn(Executor &executor) {
+    struct Awaiter {
+        Executor &executor;
+
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> awaiting) {
+            if (!this->executor.Post([awaiting]() { awaiting.resume(); })) {
+                awaiting.resume();
+            }
+        }
+
+        void await_resume() noexcept {
+        }
+    };
+    return Awaiter{executor};
+}
+
+/**
+ * @brief 启动任务，不等待其完成
+ * @param[in] task 待启动的任务，异常会终止进程，需在任务内部处理
+ */
+inline void Spawn(Task<void> task) {
+    [](Task<void> task) -> Detail::DetachedTask { co_await task; }(std::move(task));
+}
+
+namespace Detail {
+/**
+ * @brief 同步等待的共享状态
+ * @tparam T 任务返回值类型
+ */
+template <typename T> struct SyncWaitState {
+    /// 互斥锁
+    std::mutex mutex;
+    /// 完成通知
+    std::condition_variable condition;
+    /// 完成标志
+    bool done = false;
+    /// 任务返回值，无返回值任务仅作完成占位
+    std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> result;
+    /// 任务抛出的异常
+    std::exception_ptr exception;
+};
+
+/**
+ * @brief 等待任务完成并通知同步等待者
+ * @param[in] task 待等待的任务
+ * @param[in,out] state 同步等待的共享状态
+ */
+template <typename T> DetachedTask RunSyncWait(Task<T> &task, SyncWaitState<T> &state) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await task;
+            state.result.emplace(true);
+        } else {
+            state.result.emplace(co_await task);
+        }
+    } catch (...) {
+        state.exception = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.done = true;
+    state.condition.notify_one();
+}
+} // namespace Detail
+
+/**
+ * @brief 阻塞当前线程直到任务完成
+ * @details 供同步代码调用异步接口，不能在执行器线程上调用，否则可能因线程耗尽而死锁
+ * @param[in] task 待等待的任务
+ * @return 任务返回值
+ */
+template <typename T> T SyncWait(Task<T> task) {
+    Detail::SyncWaitState<T> state;
+    Detail::RunSyncWait(task, state);
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.condition.wait(lock, [&state]() { return state.done; });
+    if (state.exception) {
+        std::rethrow_exception(state.exception);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*state.result);
+    }
+}
+} // namespace Fleet::DataManager::Core
+
+#endif // __cpp_impl_coroutine
+#endif // FLEET_DATA_MANAGER_CORE_TASK_H
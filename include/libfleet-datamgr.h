@@ -70,6 +70,15 @@ void SetParameter(void *pluginManager, const char *key, const char *value);
  */
 void LoadPlugins(void *pluginManager);
 
+/**
+ * @brief 重载插件
+ * @details 新插件实例初始化完成后替换同名插件，旧实例在进行中的调用结束后销毁
+ * @param[in] pluginManager 插件管理器实例指针
+ * @param[in] path 插件文件路径
+ * @return 成功返回1，失败返回0
+ */
+int ReloadPlugin(void *pluginManager, const char *path);
+
 /**
  * @brief 卸载所有插件
  * @param[in] pluginManager 插件管理器实例指针
@@ -2410,6 +2419,207 @@ int SyncObject(void *pluginManager, const char *name, const char *dataOwner, con
  */
 int DownloadObject(void *pluginManager, const char *name, const char *dataOwner, char **data);
 
+/**
+ * @brief 内存分配统计
+ */
+struct MemoryUsage {
+    /**
+     * @brief 分配次数
+     */
+    uint64_t allocations;
+    /**
+     * @brief 释放次数
+     */
+    uint64_t deallocations;
+    /**
+     * @brief 由块内存池满足的分配次数
+     */
+    uint64_t pooledAllocations;
+    /**
+     * @brief 直接向系统申请的分配次数
+     */
+    uint64_t systemAllocations;
+    /**
+     * @brief 由线性分配区满足的分配次数
+     */
+    uint64_t arenaAllocations;
+    /**
+     * @brief 当前仍在使用的字节数
+     */
+    int64_t bytesInUse;
+};
+
+/**
+ * @brief 获取子系统的内存分配统计
+ * @param[in] subsystem 子系统：0 核心，1 存储，2 消息，3 门户，4 API服务，5 其他
+ * @param[out] usage 内存分配统计
+ * @return 成功返回1，子系统无效或usage为空返回0
+ */
+int GetMemoryUsage(int subsystem, struct MemoryUsage *usage);
+
+/**
+ * @brief 创建取消令牌
+ * @details 令牌在超时或被CancelCancellationToken取消后，传入该令牌的调用会尽早放弃执行
+ * @param[in] timeoutMs 超时时间，单位毫秒，小于等于0表示没有截止时间
+ * @return 取消令牌，使用完毕后需调用FreeCancellationToken释放
+ */
+void *NewCancellationToken(long long timeoutMs);
+
+/**
+ * @brief 取消令牌
+ * @details 可在其他线程调用，用于中止正在使用该令牌的调用
+ * @param[in] token 取消令牌
+ */
+void CancelCancellationToken(void *token);
+
+/**
+ * @brief 判断令牌是否已取消或已超时
+ * @param[in] token 取消令牌
+ * @return 已取消或已超时返回1，否则返回0
+ */
+int IsCancellationTokenCancelled(void *token);
+
+/**
+ * @brief 释放取消令牌
+ * @details 正在使用该令牌的调用不受影响
+ * @param[in] token 取消令牌
+ */
+void FreeCancellationToken(void *token);
+
+/**
+ * @brief 在截止时间内读取数据
+ * @details 令牌已取消或已超时时不读取，存储插件支持时在读取各副本之间响应令牌
+ * @param[in] pluginManager 插件管理器实例指针
+ * @param[in] application 应用
+ * @param[in] dataType 数据类型
+ * @param[in] name 数据唯一标识符
+ * @param[in] token 取消令牌，nullptr表示不限时
+ * @return 数据块，未找到、已取消或已超时返回nullptr
+ */
+struct DataBlock *ReadDataWithToken(void *pluginManager, const char *application,
+                                    const char *dataType, const char *name, void *token);
+
+/**
+ * @brief 在截止时间内下载数据
+ * @details 令牌已取消或已超时时不下载，门户插件支持时在下载期间响应令牌
+ * @param [in] pluginManager 插件管理器
+ * @param [in] dataType 数据类型
+ * @param [in] name 数据唯一标识符
+ * @param [in] from 应用名称
+ * @param [out] data 数据
+ * @param [in] token 取消令牌，nullptr表示不限时
+ * @return data size > 0, < 0 表示错误、已取消或已超时
+ * @note 该函数会为data分配内存，调用者需要负责释放
+ */
+int DownloadDataWithToken(void *pluginManager, const char *dataType, const char *name,
+                          const char *from, char **data, void *token);
+
+/**
+ * @brief 在截止时间内于多个节点执行SQLite语句
+ * @details 在每个节点执行前检查令牌，令牌取消后不再向剩余的节点发出语句，门户插件支持时在执行期间响应令牌
+ * @param[in] pluginManager 插件管理器实例指针
+ * @param[in] nodeIdCount 节点数量
+ * @param[in] nodeIdList 节点ID列表
+ * @param[in] connectionString 数据库连接字符串
+ * @param[in] sql SQL语句
+ * @param[in] token 取消令牌，nullptr表示不限时
+ * @return 全部节点执行成功返回1，否则返回0
+ * @note 多个节点上的执行不是原子的，返回0时部分节点可能已经执行了语句
+ */
+int SqliteExecuteOnMultipleNodesWithToken(void *pluginManager, int nodeIdCount,
+                                          const char **nodeIdList, const char *connectionString,
+                                          const char *sql, void *token);
+
+/**
+ * @brief 以内存映射方式读取数据
+ * @details 存储插件支持映射读取时，返回的数据块直接映射存储文件，只访问数据局部时只为实际访问的页付出IO；
+ * 不支持时退化为ReadData。返回的数据块只读，必须通过FreeDataBlock释放，映射随之解除
+ * @param[in] pluginManager 插件管理器实例指针
+ * @param[in] application 应用
+ * @param[in] dataType 数据类型
+ * @param[in] name 数据唯一标识符
+ * @param[in] advice 访问模式提示，0为默认，1为顺序访问，2为随机访问，3为即将访问，其余值按默认处理
+ * @return 数据块
+ */
+struct DataBlock *ReadDataMapped(void *pluginManager, const char *application,
+                                 const char *dataType, const char *name, int advice);
+
+/**
+ * @brief 以内存映射方式读取指定版本的数据
+ * @param[in] pluginManager 插件管理器实例指针
+ * @param[in] application 应用
+ * @param[in] dataType 数据类型
+ * @param[in] name 数据唯一标识符
+ * @param[in] version 版本
+ * @param[in] advice 访问模式提示，取值同ReadDataMapped
+ * @return 数据块
+ */
+struct DataBlock *ReadDataMappedWithVersion(void *pluginManager, const char *application,
+                                            const char *dataType, const char *name,
+                                            const char *version, int advice);
+
+/**
+ * @brief 读缓存统计
+ */
+struct ReadCacheUsage {
+    /**
+     * @brief 命中次数
+     */
+    uint64_t hits;
+    /**
+     * @brief 未命中次数
+     */
+    uint64_t misses;
+    /**
+     * @brief 插入次数
+     */
+    uint64_t insertions;
+    /**
+     * @brief 因准入策略、容量或并发失效而未插入的次数
+     */
+    uint64_t rejections;
+    /**
+     * @brief 因容量不足淘汰的条目数
+     */
+    uint64_t evictions;
+    /**
+     * @brief 因数据变更失效的条目数
+     */
+    uint64_t invalidations;
+    /**
+     * @brief 当前条目数
+     */
+    uint64_t entries;
+    /**
+     * @brief 当前占用的字节数
+     */
+    uint64_t bytes;
+    /**
+     * @brief 容量，单位字节
+     */
+    uint64_t capacity;
+    /**
+     * @brief 命中率
+     */
+    double hitRatio;
+};
+
+/**
+ * @brief 设置读缓存容量
+ * @param[in] pluginManager 插件管理器实例指针
+ * @param[in] size 容量，单位字节，为0时清空并停止缓存
+ * @return 成功返回1，失败或存储插件不支持读缓存返回0
+ */
+int SetReadCacheSize(void *pluginManager, uint64_t size);
+
+/**
+ * @brief 获取读缓存统计
+ * @param[in] pluginManager 插件管理器实例指针
+ * @param[out] usage 读缓存统计
+ * @return 成功返回1，失败或存储插件不支持读缓存返回0
+ */
+int GetReadCacheUsage(void *pluginManager, struct ReadCacheUsage *usage);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,66 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#include "AlignedBufferPool.h"
+#include <cstdlib>
+
+namespace Fleet::DataManager::Storage {
+namespace {
+/// 最小的大小级别
+constexpr uint64_t MinimumSize = 64 * 1024;
+} // namespace
+
+AlignedBufferPool::AlignedBufferPool(uint64_t capacity) : capacity(capacity), pooledBytes(0) {
+}
+
+AlignedBufferPool::~AlignedBufferPool() {
+    for (const auto &elem : this->buffers) {
+        for (auto *buffer : elem.second) {
+            free(buffer);
+        }
+    }
+}
+
+std::shared_ptr<char> AlignedBufferPool::Acquire(uint64_t size) {
+    uint64_t rounded = MinimumSize;
+    while (rounded < size) {
+        rounded <<= 1;
+    }
+    if (rounded > this->capacity) {
+        rounded = (size + Alignment - 1) / Alignment * Alignment;
+    }
+    char *buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto iter = this->buffers.find(rounded);
+        if (iter != this->buffers.end() && !iter->second.empty()) {
+            buffer = iter->second.back();
+            iter->second.pop_back();
+            this->pooledBytes -= rounded;
+        }
+    }
+    if (buffer == nullptr && posix_memalign((void **) &buffer, Alignment, rounded) != 0) {
+        return nullptr;
+    }
+    return std::shared_ptr<char>(buffer,
+                                 [this, rounded](char *buffer) { this->Release(buffer, rounded); });
+}
+
+uint64_t AlignedBufferPool::GetPooledBytes() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->pooledBytes;
+}
+
+void AlignedBufferPool::Release(char *buffer, uint64_t size) {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->pooledBytes + size <= this->capacity) {
+            this->buffers[size].push_back(buffer);
+            this->pooledBytes += size;
+            return;
+        }
+    }
+    free(buffer);
+}
+} // namespace Fleet::DataManager::Storage
@@ -0,0 +1,86 @@
+/**
+ * @file AlignedBufferPool.h
+ * @brief 对齐缓冲区池
+ * @details 为直接I/O提供起始地址按页对齐的缓冲区，释放的缓冲区按大小分级缓存，避免大块内存反复申请和缺页
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_ALIGNED_BUFFER_POOL_H
+#define FLEET_DATA_MANAGER_STORAGE_ALIGNED_BUFFER_POOL_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief 对齐缓冲区池类
+ * @details 请求的大小向上取整到不小于64KB的2的幂，同一级别的空闲缓冲区后进先出地复用。
+ * 缓存的空闲缓冲区总字节数不超过容量，取整后超过容量的请求按Alignment取整后直接分配，释放时归还系统
+ * @note 线程安全，取出的缓冲区必须在内存池析构前释放
+ */
+class AlignedBufferPool {
+  public:
+    /// 缓冲区起始地址和大小的对齐单位，单位字节
+    static constexpr uint64_t Alignment = 4096;
+
+    /**
+     * @brief 构造对齐缓冲区池
+     * @param[in] capacity 缓存的空闲缓冲区总字节数上限
+     */
+    explicit AlignedBufferPool(uint64_t capacity);
+
+    /**
+     * @brief 析构函数，释放缓存的空闲缓冲区
+     */
+    virtual ~AlignedBufferPool();
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    AlignedBufferPool(const AlignedBufferPool &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    AlignedBufferPool &operator=(const AlignedBufferPool &) = delete;
+
+    /**
+     * @brief 取出缓冲区
+     * @param[in] size 需要的字节数
+     * @return 起始地址按Alignment对齐、大小不小于size的缓冲区，内容未初始化，释放时归还内存池，
+     * 内存不足返回nullptr
+     */
+    std::shared_ptr<char> Acquire(uint64_t size);
+
+    /**
+     * @brief 获取缓存的空闲缓冲区总字节数
+     * @return 字节数
+     */
+    uint64_t GetPooledBytes();
+
+  private:
+    /// 缓存的空闲缓冲区总字节数上限
+    uint64_t capacity;
+
+    /// 互斥锁，保护以下成员
+    std::mutex mutex;
+
+    /// 大小级别到空闲缓冲区的映射
+    std::map<uint64_t, std::vector<char *>> buffers;
+
+    /// 缓存的空闲缓冲区总字节数
+    uint64_t pooledBytes;
+
+    /**
+     * @brief 归还缓冲区，超出容量时释放
+     * @param[in] buffer 缓冲区
+     * @param[in] size 缓冲区大小
+     */
+    void Release(char *buffer, uint64_t size);
+};
+} // namespace Fleet::DataManager::Storage
+#endif // FLEET_DATA_MANAGER_STORAGE_ALIGNED_BUFFER_POOL_H
@@ -0,0 +1,473 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#include "ChunkStore.h"
+#include <cstring>
+
+namespace Fleet::DataManager::Storage {
+namespace {
+/// 分块清单魔数
+constexpr uint64_t ManifestMagic = 0x3154534e4d4b4843;
+/// 清单头长度：魔数8字节，原始数据大小8字节，分块数4字节，保留4字节
+constexpr uint64_t ManifestHeaderSize = 24;
+/// 清单中每个分块占用的长度：哈希32字节，大小4字节
+constexpr uint64_t ManifestEntrySize = 36;
+/// 清单末尾CRC32C的长度
+constexpr uint64_t ManifestTrailerSize = 4;
+/// 分块的键前缀
+const std::string ChunkPrefix("\0chunk\0", 7);
+/// 标记的键前缀
+const std::string MarkerPrefix("\0manifest\0", 10);
+
+std::string ToHex(const uint8_t *digest, size_t size) {
+    static const char digits[] = "0123456789abcdef";
+    std::string ret(size * 2, '0');
+    for (size_t i = 0; i < size; ++i) {
+        ret[i * 2] = digits[digest[i] >> 4];
+        ret[i * 2 + 1] = digits[digest[i] & 0x0f];
+    }
+    return ret;
+}
+
+int FromHexDigit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief 持有互斥锁期间使用的持久化级别，批量落盘改为释放锁后等待
+ */
+Durability WithoutBatch(Durability durability) {
+    return durability == Durability::Batch ? Durability::None : durability;
+}
+} // namespace
+
+ChunkStore::ChunkStore(const std::shared_ptr<Core::PluginContext> &pluginContext,
+                       const std::shared_ptr<LogStructuredStore> &store)
+    : pluginContext(pluginContext), store(store) {
+}
+
+bool ChunkStore::Open() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->chunks.clear();
+    this->manifests.clear();
+    this->statistics = ChunkStatistics();
+    std::vector<std::string> markers;
+    this->store->Scan(MarkerPrefix, [&markers](const std::string &key, uint64_t) {
+        markers.push_back(key);
+        return true;
+    });
+    uint64_t stale = 0;
+    std::vector<ChunkReference> references;
+    for (const auto &marker : markers) {
+        auto value = this->store->Get(marker);
+        std::string key;
+        if (value != nullptr) {
+            key.assign(value->GetData(), value->GetSize());
+        }
+        uint64_t total = 0;
+        auto manifest = value == nullptr ? nullptr : this->store->Get(key);
+        if (manifest != nullptr && MarkerKey(key) == marker &&
+            DecodeManifest(manifest->GetData(), manifest->GetSize(), references, total)) {
+            this->Acquire(key, references);
+            continue;
+        }
+        // 写入中断、改为直接写入或清单已损坏，标记不再对应任何分块清单
+        this->store->Remove(marker);
+        ++stale;
+    }
+
+    std::vector<std::string> chunkKeys;
+    this->store->Scan(ChunkPrefix, [&chunkKeys](const std::string &key, uint64_t) {
+        chunkKeys.push_back(key);
+        return true;
+    });
+    uint64_t orphans = 0;
+    for (const auto &chunkKey : chunkKeys) {
+        ChunkHash hash;
+        if (ParseChunkKey(chunkKey, hash) && this->chunks.find(hash) != this->chunks.end()) {
+            continue;
+        }
+        this->store->Remove(chunkKey);
+        ++orphans;
+    }
+    this->pluginContext->LogInfo(SOURCE_LOCATION,
+                                 "存储 {} 有 {} 个分块清单引用 {} 个分块, 删除了 {} 个无效标记和 {} 个未被引用的分块",
+                                 this->store->GetDirectory(), this->statistics.manifests,
+                                 this->statistics.chunks, stale, orphans);
+    return true;
+}
+
+bool ChunkStore::Put(const std::string &key, const char *data, uint64_t size,
+                     IntegrityAlgorithm algorithm, uint64_t expiry, Durability durability,
+                     uint64_t writeId) {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->store->Put(key, data, size, algorithm, expiry, WithoutBatch(durability),
+                              writeId)) {
+            return false;
+        }
+        this->Drop(key);
+    }
+    // 释放互斥锁后等待落盘，其他写入可以并入同一次提交
+    return durability != Durability::Batch || this->store->Commit();
+}
+
+bool ChunkStore::PutChunked(const std::string &key, const char *data,
+                            const std::vector<ChunkReference> &chunks,
+                            IntegrityAlgorithm algorithm, uint64_t expiry,
+                            Durability durability, uint64_t writeId) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    // 标记先于清单写入，打开时总能找到所有清单
+    if (!this->store->Put(MarkerKey(key), key.data(), key.size(), algorithm, expiry,
+                          Durability::None)) {
+        return false;
+    }
+    uint64_t offset = 0;
+    for (const auto &chunk : chunks) {
+        std::string chunkKey = ChunkKey(chunk.hash);
+        if (!this->store->Contains(chunkKey) &&
+            !this->store->Put(chunkKey, data + offset, chunk.size, algorithm, 0,
+                              Durability::None)) {
+            this->Collect(chunks);
+            return false;
+        }
+        offset += chunk.size;
+    }
+    std::vector<char> manifest;
+    EncodeManifest(chunks, manifest);
+    // 清单之前追加的标记和分块随清单一起落盘
+    if (!this->store->Put(key, manifest.data(), manifest.size(), algorithm, expiry,
+                          WithoutBatch(durability), writeId)) {
+        this->Collect(chunks);
+        return false;
+    }
+    this->Acquire(key, chunks);
+    lock.unlock();
+    return durability != Durability::Batch || this->store->Commit();
+}
+
+std::shared_ptr<DataBlock> ChunkStore::Get(const std::string &key,
+                                           const std::shared_ptr<Core::CancellationToken> &token) {
+    return this->Read(key, [this, &key, &token]() { return this->store->Get(key, token); }, token);
+}
+
+std::shared_ptr<DataBlock> ChunkStore::GetMapped(const std::string &key, MapAdvice advice) {
+    return this->Read(
+        key, [this, &key, advice]() { return this->store->GetMapped(key, advice); }, nullptr);
+}
+
+bool ChunkStore::Remove(const std::string &key) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    bool ret = this->store->Remove(key);
+    this->Drop(key);
+    return ret;
+}
+
+void ChunkStore::Release(const std::vector<std::string> &keys) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (const auto &key : keys) {
+        // 过期删除之后重新写入的键持有新的清单
+        if (this->manifests.find(key) != this->manifests.end() && !this->store->Contains(key)) {
+            this->Drop(key);
+        }
+    }
+}
+
+std::shared_ptr<DataBlock> ChunkStore::GetChunk(const std::string &chunkKey) {
+    ChunkHash hash;
+    if (!ParseChunkKey(chunkKey, hash)) {
+        return nullptr;
+    }
+    auto dataBlock = this->store->Get(chunkKey);
+    if (dataBlock == nullptr) {
+        return nullptr;
+    }
+    ChunkHash digest;
+    IntegrityCheck::Blake3(dataBlock->GetData(), dataBlock->GetSize(), digest.data());
+    if (digest != hash) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "存储 {} 中的分块与哈希不符",
+                                      this->store->GetDirectory());
+        return nullptr;
+    }
+    return dataBlock;
+}
+
+bool ChunkStore::RepairChunk(const std::string &chunkKey,
+                             const std::shared_ptr<DataBlock> &dataBlock,
+                             IntegrityAlgorithm algorithm) {
+    ChunkHash hash;
+    if (!ParseChunkKey(chunkKey, hash)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->chunks.find(hash) == this->chunks.end()) {
+        this->store->Remove(chunkKey);
+        return true;
+    }
+    return this->store->Put(chunkKey, dataBlock->GetData(), dataBlock->GetSize(), algorithm, 0);
+}
+
+ChunkStatistics ChunkStore::GetStatistics() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->statistics;
+}
+
+LogStructuredStore &ChunkStore::GetStore() {
+    return *this->store;
+}
+
+void ChunkStore::Split(const Chunker &chunker, const char *data, uint64_t size,
+                       std::vector<ChunkReference> &chunks) {
+    std::vector<uint32_t> sizes;
+    chunker.Split(data, size, sizes);
+    chunks.resize(sizes.size());
+    uint64_t offset = 0;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        IntegrityCheck::Blake3(data + offset, sizes[i], chunks[i].hash.data());
+        chunks[i].size = sizes[i];
+        offset += sizes[i];
+    }
+}
+
+bool ChunkStore::IsManifest(const char *data, uint64_t size) {
+    if (size < ManifestHeaderSize + ManifestTrailerSize) {
+        return false;
+    }
+    uint64_t magic = 0;
+    uint32_t count = 0;
+    memcpy(&magic, data, sizeof(magic));
+    memcpy(&count, data + 16, sizeof(count));
+    if (magic != ManifestMagic ||
+        size != ManifestHeaderSize + ManifestEntrySize * count + ManifestTrailerSize) {
+        return false;
+    }
+    uint32_t crc = 0;
+    memcpy(&crc, data + size - ManifestTrailerSize, sizeof(crc));
+    return crc == IntegrityCheck::Crc32c(0, data, size - ManifestTrailerSize);
+}
+
+bool ChunkStore::IsChunkKey(const std::string &key) {
+    ChunkHash hash;
+    return ParseChunkKey(key, hash);
+}
+
+void ChunkStore::Acquire(const std::string &key, const std::vector<ChunkReference> &references) {
+    std::vector<ChunkHash> hashes;
+    hashes.reserve(references.size());
+    for (const auto &reference : references) {
+        auto &entry = this->chunks[reference.hash];
+        if (entry.references++ == 0) {
+            entry.size = reference.size;
+            ++this->statistics.chunks;
+            this->statistics.storedBytes += reference.size;
+        }
+        this->statistics.referencedBytes += reference.size;
+        hashes.push_back(reference.hash);
+    }
+    auto iter = this->manifests.find(key);
+    if (iter == this->manifests.end()) {
+        this->manifests.emplace(key, std::move(hashes));
+        ++this->statistics.manifests;
+        return;
+    }
+    // 先引用新清单的分块再释放旧清单，两个版本共有的分块不会被删除
+    hashes.swap(iter->second);
+    this->Unreference(hashes);
+}
+
+void ChunkStore::Drop(const std::string &key) {
+    auto iter = this->manifests.find(key);
+    if (iter == this->manifests.end()) {
+        return;
+    }
+    this->store->Remove(MarkerKey(key));
+    std::vector<ChunkHash> hashes = std::move(iter->second);
+    this->manifests.erase(iter);
+    --this->statistics.manifests;
+    this->Unreference(hashes);
+}
+
+void ChunkStore::Unreference(const std::vector<ChunkHash> &hashes) {
+    for (const auto &hash : hashes) {
+        auto iter = this->chunks.find(hash);
+        if (iter == this->chunks.end()) {
+            continue;
+        }
+        this->statistics.referencedBytes -= iter->second.size;
+        if (--iter->second.references > 0) {
+            continue;
+        }
+        --this->statistics.chunks;
+        this->statistics.storedBytes -= iter->second.size;
+        // 正在拼接的读取仍需要该分块, 最后一个读取结束时删除
+        if (iter->second.pins == 0) {
+            this->store->Remove(ChunkKey(hash));
+            this->chunks.erase(iter);
+        }
+    }
+}
+
+void ChunkStore::Collect(const std::vector<ChunkReference> &references) {
+    for (const auto &reference : references) {
+        if (this->chunks.find(reference.hash) == this->chunks.end()) {
+            this->store->Remove(ChunkKey(reference.hash));
+        }
+    }
+}
+
+std::shared_ptr<DataBlock>
+ChunkStore::Read(const std::string &key, const std::function<std::shared_ptr<DataBlock>()> &read,
+                 const std::shared_ptr<Core::CancellationToken> &token) {
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        auto dataBlock = read();
+        if (dataBlock == nullptr || !IsManifest(dataBlock->GetData(), dataBlock->GetSize())) {
+            return dataBlock;
+        }
+        std::vector<ChunkReference> references;
+        uint64_t total = 0;
+        if (!DecodeManifest(dataBlock->GetData(), dataBlock->GetSize(), references, total)) {
+            return nullptr;
+        }
+        // 读到清单之后键可能已被覆盖或删除, 旧清单的分块随之回收, 此时重读当前的清单
+        if (!this->Pin(key, references)) {
+            continue;
+        }
+        auto ret = this->Assemble(references, total, token);
+        this->Unpin(references);
+        return ret;
+    }
+    this->pluginContext->LogError(SOURCE_LOCATION, "存储 {} 中的分块清单在读取期间连续被修改",
+                                  this->store->GetDirectory());
+    return nullptr;
+}
+
+bool ChunkStore::Pin(const std::string &key, const std::vector<ChunkReference> &references) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto iter = this->manifests.find(key);
+    if (iter == this->manifests.end() || iter->second.size() != references.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < references.size(); ++i) {
+        if (iter->second[i] != references[i].hash) {
+            return false;
+        }
+    }
+    // 当前清单引用的分块都在映射中
+    for (const auto &reference : references) {
+        ++this->chunks[reference.hash].pins;
+    }
+    return true;
+}
+
+void ChunkStore::Unpin(const std::vector<ChunkReference> &references) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (const auto &reference : references) {
+        auto iter = this->chunks.find(reference.hash);
+        if (iter == this->chunks.end()) {
+            continue;
+        }
+        if (--iter->second.pins == 0 && iter->second.references == 0) {
+            this->store->Remove(ChunkKey(reference.hash));
+            this->chunks.erase(iter);
+        }
+    }
+}
+
+std::shared_ptr<DataBlock>
+ChunkStore::Assemble(const std::vector<ChunkReference> &references, uint64_t total,
+                     const std::shared_ptr<Core::CancellationToken> &token) {
+    auto ret = std::make_shared<DataBlock>(total);
+    uint64_t offset = 0;
+    for (const auto &reference : references) {
+        auto chunk = this->store->Get(ChunkKey(reference.hash), token);
+        if (chunk == nullptr || chunk->GetSize() != reference.size) {
+            if (!Core::IsCancelled(token)) {
+                this->pluginContext->LogError(SOURCE_LOCATION, "存储 {} 中缺少分块清单引用的分块",
+                                              this->store->GetDirectory());
+            }
+            return nullptr;
+        }
+        memcpy(ret->GetMutableData() + offset, chunk->GetData(), reference.size);
+        offset += reference.size;
+    }
+    return ret;
+}
+
+void ChunkStore::EncodeManifest(const std::vector<ChunkReference> &references,
+                                std::vector<char> &manifest) {
+    uint32_t count = (uint32_t) references.size();
+    uint32_t reserved = 0;
+    uint64_t total = 0;
+    for (const auto &reference : references) {
+        total += reference.size;
+    }
+    manifest.resize(ManifestHeaderSize + ManifestEntrySize * count + ManifestTrailerSize);
+    char *cursor = manifest.data();
+    memcpy(cursor, &ManifestMagic, sizeof(ManifestMagic));
+    memcpy(cursor + 8, &total, sizeof(total));
+    memcpy(cursor + 16, &count, sizeof(count));
+    memcpy(cursor + 20, &reserved, sizeof(reserved));
+    cursor += ManifestHeaderSize;
+    for (const auto &reference : references) {
+        memcpy(cursor, reference.hash.data(), reference.hash.size());
+        memcpy(cursor + reference.hash.size(), &reference.size, sizeof(reference.size));
+        cursor += ManifestEntrySize;
+    }
+    uint32_t crc = IntegrityCheck::Crc32c(0, manifest.data(), cursor - manifest.data());
+    memcpy(cursor, &crc, sizeof(crc));
+}
+
+bool ChunkStore::DecodeManifest(const char *data, uint64_t size,
+                                std::vector<ChunkReference> &references, uint64_t &total) {
+    references.clear();
+    if (!IsManifest(data, size)) {
+        return false;
+    }
+    uint32_t count = 0;
+    memcpy(&total, data + 8, sizeof(total));
+    memcpy(&count, data + 16, sizeof(count));
+    references.resize(count);
+    const char *cursor = data + ManifestHeaderSize;
+    uint64_t sum = 0;
+    for (auto &reference : references) {
+        memcpy(reference.hash.data(), cursor, reference.hash.size());
+        memcpy(&reference.size, cursor + reference.hash.size(), sizeof(reference.size));
+        sum += reference.size;
+        cursor += ManifestEntrySize;
+    }
+    return sum == total;
+}
+
+std::string ChunkStore::ChunkKey(const ChunkHash &hash) {
+    return ChunkPrefix + ToHex(hash.data(), hash.size());
+}
+
+std::string ChunkStore::MarkerKey(const std::string &key) {
+    ChunkHash digest;
+    IntegrityCheck::Blake3(key.data(), key.size(), digest.data());
+    return MarkerPrefix + ToHex(digest.data(), digest.size());
+}
+
+bool ChunkStore::ParseChunkKey(const std::string &key, ChunkHash &hash) {
+    if (key.size() != ChunkPrefix.size() + hash.size() * 2 ||
+        key.compare(0, ChunkPrefix.size(), ChunkPrefix) != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < hash.size(); ++i) {
+        int high = FromHexDigit(key[ChunkPrefix.size() + i * 2]);
+        int low = FromHexDigit(key[ChunkPrefix.size() + i * 2 + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        hash[i] = (uint8_t) ((high << 4) | low);
+    }
+    return true;
+}
+} // namespace Fleet::DataManager::Storage
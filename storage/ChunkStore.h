@@ -0,0 +1,354 @@
+/**
+ * @file ChunkStore.h
+ * @brief 分块去重存储
+ * @details 在单个设备的日志结构存储之上保存按内容寻址的分块，数据的各版本保存为分块清单，相同的分块只保存一份
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_CHUNK_STORE_H
+#define FLEET_DATA_MANAGER_STORAGE_CHUNK_STORE_H
+
+#include "CancellationToken.h"
+#include "Chunker.h"
+#include "DataBlock.h"
+#include "IntegrityCheck.h"
+#include "LogStructuredStore.h"
+#include "MappedDataBlock.h"
+#include "PluginContext.h"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+/// 分块哈希，分块内容的BLAKE3摘要
+using ChunkHash = std::array<uint8_t, 32>;
+
+/**
+ * @brief 分块清单中的一项
+ */
+struct ChunkReference {
+    /// 分块哈希
+    ChunkHash hash;
+    /// 分块大小
+    uint32_t size;
+};
+
+/**
+ * @brief 分块统计信息
+ */
+struct ChunkStatistics {
+    /// 以分块清单保存的数据数
+    uint64_t manifests = 0;
+    /// 被引用的分块数
+    uint64_t chunks = 0;
+    /// 被引用的分块的总字节数，每个分块只计一次
+    uint64_t storedBytes = 0;
+    /// 所有分块清单表示的数据总字节数
+    uint64_t referencedBytes = 0;
+};
+
+/**
+ * @brief 分块去重存储类
+ * @details 分块以“0、chunk、0、哈希的十六进制”为键保存，不带过期时间。
+ * 分块保存的数据在原来的键下写入分块清单，清单以魔数开头、以CRC32C结尾，依次记录原始大小和各分块的哈希与大小，
+ * 同时写入以“0、manifest、0、键的BLAKE3摘要的十六进制”为键、以原来的键为值的标记，过期时间与清单相同。
+ * 这些内部键的0少于编码后的数据键，不会与数据键冲突。
+ * 分块的引用计数只保存在内存中，打开时按标记读取所有清单重建，未被引用的分块在打开时删除。
+ * 写入依次追加标记、缺失的分块和清单，删除依次删除清单和标记，引用计数归0的分块随即删除，
+ * 任何一步中断都只会留下打开时可以清理的标记或分块，不会删除仍被引用的分块。
+ * 直接写入的数据恰好是合法的分块清单时必须分块保存，否则读取时会被当作清单解析
+ * @note 线程安全，修改由互斥锁串行化，读取只在持有和释放分块时短暂加锁，拼接期间分块不会被删除
+ */
+class ChunkStore {
+  public:
+    /**
+     * @brief 构造分块去重存储
+     * @param[in] pluginContext 插件上下文，用于日志记录
+     * @param[in] store 设备上的日志结构存储
+     */
+    ChunkStore(const std::shared_ptr<Core::PluginContext> &pluginContext,
+               const std::shared_ptr<LogStructuredStore> &store);
+
+    /**
+     * @brief 析构函数
+     */
+    virtual ~ChunkStore() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    ChunkStore(const ChunkStore &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    ChunkStore &operator=(const ChunkStore &) = delete;
+
+    /**
+     * @brief 重建引用计数并删除未被引用的分块
+     * @details 在日志结构存储打开后调用
+     * @return 总是返回true，无法读取的清单及其标记被删除
+     */
+    bool Open();
+
+    /**
+     * @brief 直接写入数据
+     * @details 键原来保存的分块清单不再引用其分块
+     * @param[in] key 键
+     * @param[in] data 数据
+     * @param[in] size 数据大小
+     * @param[in] algorithm 校验算法
+     * @param[in] expiry 过期时间，为0时不过期
+     * @param[in] durability 持久化级别
+     * @param[in] writeId 写入标识，为0时不记录
+     * @return 写入并按要求落盘成功返回true，否则返回false
+     */
+    bool Put(const std::string &key, const char *data, uint64_t size,
+             IntegrityAlgorithm algorithm, uint64_t expiry, Durability durability,
+             uint64_t writeId);
+
+    /**
+     * @brief 分块写入数据
+     * @details 设备上已有的分块不再写入
+     * @param[in] key 键
+     * @param[in] data 数据，大小为各分块大小之和
+     * @param[in] chunks 分块清单
+     * @param[in] algorithm 校验算法，用于分块和清单
+     * @param[in] expiry 过期时间，为0时不过期，只作用于清单和标记
+     * @param[in] durability 持久化级别，标记和分块随清单一起落盘
+     * @param[in] writeId 写入标识，只作用于清单，为0时不记录
+     * @return 写入并按要求落盘成功返回true，否则返回false
+     */
+    bool PutChunked(const std::string &key, const char *data,
+                    const std::vector<ChunkReference> &chunks, IntegrityAlgorithm algorithm,
+                    uint64_t expiry, Durability durability, uint64_t writeId);
+
+    /**
+     * @brief 读取数据，分块保存的数据被拼接为原始数据
+     * @param[in] key 键
+     * @param[in] token 取消令牌，允许为nullptr
+     * @return 数据块对象指针，未找到、校验失败、分块缺失或已取消返回nullptr
+     */
+    std::shared_ptr<DataBlock> Get(const std::string &key,
+                                   const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 以内存映射方式读取数据
+     * @details 分块保存的数据无法映射，拼接后返回普通数据块
+     * @param[in] key 键
+     * @param[in] advice 访问模式提示
+     * @return 数据块对象指针，未找到或读取失败返回nullptr
+     */
+    std::shared_ptr<DataBlock> GetMapped(const std::string &key, MapAdvice advice);
+
+    /**
+     * @brief 删除数据
+     * @details 分块保存的数据同时删除标记，引用计数归0的分块随即删除
+     * @param[in] key 键
+     * @return 键存在且删除成功返回true，否则返回false
+     */
+    bool Remove(const std::string &key);
+
+    /**
+     * @brief 释放已被日志结构存储删除的清单对分块的引用
+     * @details 用于过期删除的回调，重新写入的键不受影响
+     * @param[in] keys 已删除的键
+     */
+    void Release(const std::vector<std::string> &keys);
+
+    /**
+     * @brief 读取分块并按哈希校验
+     * @param[in] chunkKey 分块的键
+     * @return 数据块对象指针，未找到或与哈希不符返回nullptr
+     */
+    std::shared_ptr<DataBlock> GetChunk(const std::string &chunkKey);
+
+    /**
+     * @brief 补写被引用但缺失或损坏的分块
+     * @param[in] chunkKey 分块的键
+     * @param[in] dataBlock 分块内容，必须与哈希相符
+     * @param[in] algorithm 校验算法
+     * @return 补写成功或分块不再被引用返回true，否则返回false
+     */
+    bool RepairChunk(const std::string &chunkKey, const std::shared_ptr<DataBlock> &dataBlock,
+                     IntegrityAlgorithm algorithm);
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计信息
+     */
+    ChunkStatistics GetStatistics();
+
+    /**
+     * @brief 获取日志结构存储
+     * @return 日志结构存储
+     */
+    LogStructuredStore &GetStore();
+
+    /**
+     * @brief 切分数据并计算各分块的哈希
+     * @param[in] chunker 分块器
+     * @param[in] data 数据
+     * @param[in] size 数据大小
+     * @param[out] chunks 分块清单
+     */
+    static void Split(const Chunker &chunker, const char *data, uint64_t size,
+                      std::vector<ChunkReference> &chunks);
+
+    /**
+     * @brief 判断数据是否为合法的分块清单
+     * @param[in] data 数据
+     * @param[in] size 数据大小
+     * @return 是合法的分块清单返回true，否则返回false
+     */
+    static bool IsManifest(const char *data, uint64_t size);
+
+    /**
+     * @brief 判断键是否为分块的键
+     * @param[in] key 键
+     * @return 是分块的键返回true，否则返回false
+     */
+    static bool IsChunkKey(const std::string &key);
+
+  private:
+    /**
+     * @brief 分块的引用信息
+     */
+    struct ChunkEntry {
+        /// 引用计数，同一清单多次引用时计多次
+        uint64_t references = 0;
+        /// 正在拼接的读取持有的计数，引用计数归0后分块保留到读取结束
+        uint64_t pins = 0;
+        /// 分块大小
+        uint32_t size = 0;
+    };
+
+    /// 插件上下文
+    std::shared_ptr<Core::PluginContext> pluginContext;
+
+    /// 日志结构存储
+    std::shared_ptr<LogStructuredStore> store;
+
+    /// 互斥锁，串行化修改并保护以下成员
+    std::mutex mutex;
+
+    /// 分块哈希到引用信息的映射
+    std::map<ChunkHash, ChunkEntry> chunks;
+
+    /// 分块保存的键到其分块清单的映射
+    std::map<std::string, std::vector<ChunkHash>> manifests;
+
+    /// 统计信息
+    ChunkStatistics statistics;
+
+    /**
+     * @brief 增加清单中各分块的引用计数并登记清单，调用者持有互斥锁
+     * @param[in] key 键
+     * @param[in] references 分块清单
+     */
+    void Acquire(const std::string &key, const std::vector<ChunkReference> &references);
+
+    /**
+     * @brief 注销键的清单并删除其标记，减少其分块的引用计数，调用者持有互斥锁
+     * @param[in] key 键
+     */
+    void Drop(const std::string &key);
+
+    /**
+     * @brief 减少各分块的引用计数并删除归0且未被读取持有的分块，调用者持有互斥锁
+     * @param[in] hashes 分块哈希，同一分块出现几次减几次
+     */
+    void Unreference(const std::vector<ChunkHash> &hashes);
+
+    /**
+     * @brief 删除写入失败后未被任何清单引用的分块，调用者持有互斥锁
+     * @param[in] references 写入失败的分块清单
+     */
+    void Collect(const std::vector<ChunkReference> &references);
+
+    /**
+     * @brief 读取数据，分块保存的数据在拼接期间持有其分块
+     * @details 读到清单之后、持有分块之前清单被覆盖或删除时重读一次
+     * @param[in] key 键
+     * @param[in] read 从日志结构存储读取键的函数
+     * @param[in] token 取消令牌，允许为nullptr
+     * @return 数据块对象指针，未找到、分块缺失、清单连续变化或已取消返回nullptr
+     */
+    std::shared_ptr<DataBlock> Read(const std::string &key,
+                                    const std::function<std::shared_ptr<DataBlock>()> &read,
+                                    const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 清单仍为键的当前清单时持有其分块，防止拼接期间被删除
+     * @param[in] key 键
+     * @param[in] references 读到的分块清单
+     * @return 持有成功返回true，清单已被覆盖或删除返回false
+     */
+    bool Pin(const std::string &key, const std::vector<ChunkReference> &references);
+
+    /**
+     * @brief 释放Pin持有的分块，删除不再被引用的分块
+     * @param[in] references 分块清单
+     */
+    void Unpin(const std::vector<ChunkReference> &references);
+
+    /**
+     * @brief 读取清单引用的分块并拼接
+     * @param[in] references 分块清单
+     * @param[in] total 原始数据大小
+     * @param[in] token 取消令牌，允许为nullptr
+     * @return 原始数据，分块缺失或已取消返回nullptr
+     */
+    std::shared_ptr<DataBlock> Assemble(const std::vector<ChunkReference> &references,
+                                        uint64_t total,
+                                        const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 编码分块清单
+     * @param[in] references 分块清单
+     * @param[out] manifest 清单
+     */
+    static void EncodeManifest(const std::vector<ChunkReference> &references,
+                               std::vector<char> &manifest);
+
+    /**
+     * @brief 解码分块清单
+     * @param[in] data 清单
+     * @param[in] size 清单大小
+     * @param[out] references 分块清单
+     * @param[out] total 原始数据大小
+     * @return 是合法的分块清单返回true，否则返回false
+     */
+    static bool DecodeManifest(const char *data, uint64_t size,
+                               std::vector<ChunkReference> &references, uint64_t &total);
+
+    /**
+     * @brief 生成分块的键
+     * @param[in] hash 分块哈希
+     * @return 分块的键
+     */
+    static std::string ChunkKey(const ChunkHash &hash);
+
+    /**
+     * @brief 生成键的标记
+     * @param[in] key 键
+     * @return 标记的键
+     */
+    static std::string MarkerKey(const std::string &key);
+
+    /**
+     * @brief 解析分块的键
+     * @param[in] key 分块的键
+     * @param[out] hash 分块哈希
+     * @return 是分块的键返回true，否则返回false
+     */
+    static bool ParseChunkKey(const std::string &key, ChunkHash &hash);
+};
+} // namespace Fleet::DataManager::Storage
+#endif // FLEET_DATA_MANAGER_STORAGE_CHUNK_STORE_H
@@ -0,0 +1,101 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#include "Chunker.h"
+#include <algorithm>
+#include <array>
+
+namespace Fleet::DataManager::Storage {
+namespace {
+/// 指纹覆盖的窗口长度，也是最小分块大小的下限
+constexpr uint32_t WindowSize = 64;
+
+/// 平均大小两侧的掩码与平均大小相差的位数
+constexpr uint32_t NormalizationLevel = 2;
+
+/**
+ * @brief 以SplitMix64从固定种子生成Gear表，不能修改
+ */
+constexpr std::array<uint64_t, 256> MakeGearTable() {
+    std::array<uint64_t, 256> table{};
+    uint64_t state = 0x4645455443444321ull;
+    for (auto &entry : table) {
+        state += 0x9e3779b97f4a7c15ull;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        entry = z ^ (z >> 31);
+    }
+    return table;
+}
+
+constexpr std::array<uint64_t, 256> GearTable = MakeGearTable();
+
+/**
+ * @brief 生成最高bits位为1的掩码，指纹的高位覆盖的窗口最长
+ */
+uint64_t HighMask(uint32_t bits) {
+    return bits == 0 ? 0 : ~0ull << (64 - bits);
+}
+} // namespace
+
+Chunker::Chunker(uint32_t minimumSize, uint32_t averageSize, uint32_t maximumSize) {
+    uint32_t bits = 0;
+    while (bits < 30 && (2u << bits) <= std::max(averageSize, WindowSize)) {
+        ++bits;
+    }
+    this->averageSize = 1u << bits;
+    this->minimumSize = std::min(std::max(minimumSize, WindowSize), this->averageSize);
+    this->maximumSize = std::max(maximumSize, this->averageSize);
+    this->smallMask = HighMask(bits + NormalizationLevel);
+    this->largeMask = HighMask(bits > NormalizationLevel ? bits - NormalizationLevel : 1);
+}
+
+uint64_t Chunker::FindBoundary(const char *data, uint64_t size) const {
+    uint64_t limit = std::min<uint64_t>(size, this->maximumSize);
+    if (limit <= this->minimumSize) {
+        return limit;
+    }
+    const auto *bytes = reinterpret_cast<const uint8_t *>(data);
+    uint64_t normal = std::min<uint64_t>(limit, this->averageSize);
+    uint64_t fingerprint = 0;
+    uint64_t i = this->minimumSize;
+    for (; i < normal; ++i) {
+        fingerprint = (fingerprint << 1) + GearTable[bytes[i]];
+        if ((fingerprint & this->smallMask) == 0) {
+            return i + 1;
+        }
+    }
+    for (; i < limit; ++i) {
+        fingerprint = (fingerprint << 1) + GearTable[bytes[i]];
+        if ((fingerprint & this->largeMask) == 0) {
+            return i + 1;
+        }
+    }
+    return limit;
+}
+
+void Chunker::Split(const char *data, uint64_t size, std::vector<uint32_t> &sizes) const {
+    sizes.clear();
+    sizes.reserve(size / this->averageSize + 1);
+    uint64_t offset = 0;
+    while (offset < size) {
+        uint64_t length = this->FindBoundary(data + offset, size - offset);
+        sizes.push_back((uint32_t) length);
+        offset += length;
+    }
+}
+
+uint32_t Chunker::GetMinimumSize() const {
+    return this->minimumSize;
+}
+
+uint32_t Chunker::GetAverageSize() const {
+    return this->averageSize;
+}
+
+uint32_t Chunker::GetMaximumSize() const {
+    return this->maximumSize;
+}
+} // namespace Fleet::DataManager::Storage
@@ -0,0 +1,101 @@
+/**
+ * @file Chunker.h
+ * @brief 内容定义分块
+ * @details 基于Gear滚动哈希的FastCDC分块，分块边界只取决于边界附近的内容，数据局部修改后其余分块保持不变
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_CHUNKER_H
+#define FLEET_DATA_MANAGER_STORAGE_CHUNKER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief 分块类
+ * @details 逐字节更新指纹fp = (fp << 1) + Gear[b]，指纹的高位取决于最近64个字节。
+ * 跳过最小分块大小后开始判断边界，未达到平均大小前使用多两位的掩码，之后使用少两位的掩码，
+ * 分块大小集中在平均大小附近，达到最大分块大小时强制切分。
+ * Gear表由固定种子生成，修改种子会改变所有分块边界，已存储的数据仍可读取但不再与新数据去重
+ * @note 分块为只读操作，同一对象可被多个线程同时使用
+ */
+class Chunker {
+  public:
+    /**
+     * @brief 构造分块器
+     * @details 平均大小向下取2的幂，最小大小不小于64字节且不超过平均大小，最大大小不小于平均大小
+     * @param[in] minimumSize 最小分块大小，单位字节
+     * @param[in] averageSize 平均分块大小，单位字节
+     * @param[in] maximumSize 最大分块大小，单位字节
+     */
+    Chunker(uint32_t minimumSize, uint32_t averageSize, uint32_t maximumSize);
+
+    /**
+     * @brief 析构函数
+     */
+    virtual ~Chunker() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    Chunker(const Chunker &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    Chunker &operator=(const Chunker &) = delete;
+
+    /**
+     * @brief 查找第一个分块的边界
+     * @param[in] data 数据
+     * @param[in] size 数据大小
+     * @return 第一个分块的大小，size为0时返回0
+     */
+    uint64_t FindBoundary(const char *data, uint64_t size) const;
+
+    /**
+     * @brief 将数据切分为分块
+     * @param[in] data 数据
+     * @param[in] size 数据大小
+     * @param[out] sizes 各分块的大小，依次拼接即为原始数据
+     */
+    void Split(const char *data, uint64_t size, std::vector<uint32_t> &sizes) const;
+
+    /**
+     * @brief 获取最小分块大小
+     * @return 最小分块大小，单位字节
+     */
+    uint32_t GetMinimumSize() const;
+
+    /**
+     * @brief 获取平均分块大小
+     * @return 平均分块大小，单位字节
+     */
+    uint32_t GetAverageSize() const;
+
+    /**
+     * @brief 获取最大分块大小
+     * @return 最大分块大小，单位字节
+     */
+    uint32_t GetMaximumSize() const;
+
+  private:
+    /// 最小分块大小
+    uint32_t minimumSize;
+
+    /// 平均分块大小
+    uint32_t averageSize;
+
+    /// 最大分块大小
+    uint32_t maximumSize;
+
+    /// 未达到平均大小时使用的掩码，位数较多，不容易命中
+    uint64_t smallMask;
+
+    /// 达到平均大小后使用的掩码，位数较少，容易命中
+    uint64_t largeMask;
+};
+} // namespace Fleet::DataManager::Storage
+#endif // FLEET_DATA_MANAGER_STORAGE_CHUNKER_H
@@ -0,0 +1,948 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#include "Codec.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+// 头文件可见即启用对应编解码器，构建时找不到库可以定义FLEET_CODEC_NO_LZ4或FLEET_CODEC_NO_ZSTD关闭
+#if !defined(FLEET_CODEC_NO_LZ4) && __has_include(<lz4frame.h>)
+#include <lz4frame.h>
+#define FLEET_CODEC_LZ4
+#endif
+
+#if !defined(FLEET_CODEC_NO_ZSTD) && __has_include(<zstd.h>) && __has_include(<zdict.h>)
+#include <zdict.h>
+#include <zstd.h>
+#define FLEET_CODEC_ZSTD
+#endif
+
+namespace Fleet::DataManager::Storage {
+namespace {
+std::string ToLower(const std::string &value) {
+    std::string ret(value);
+    std::transform(ret.begin(), ret.end(), ret.begin(),
+                   [](unsigned char c) { return (char) std::tolower(c); });
+    return ret;
+}
+
+#if defined(FLEET_CODEC_LZ4) || defined(FLEET_CODEC_ZSTD)
+bool HasMagic(const char *data, uint64_t size, uint32_t magic) {
+    uint32_t value = 0;
+    if (size < sizeof(value)) {
+        return false;
+    }
+    memcpy(&value, data, sizeof(value));
+    return value == magic;
+}
+#endif
+
+/**
+ * @brief 不压缩的编解码流，输入原样交给输出函数
+ */
+class PassThroughStream : public CodecStream {
+  public:
+    explicit PassThroughStream(CodecSink sink) : sink(std::move(sink)) {
+    }
+
+    bool Write(const char *data, uint64_t size) override {
+        return size == 0 || this->sink(data, size);
+    }
+
+    bool Finish() override {
+        return true;
+    }
+
+  private:
+    CodecSink sink;
+};
+
+/**
+ * @brief 不压缩的编解码器
+ */
+class NoneCodec : public Codec {
+  public:
+    const char *GetName() const override {
+        return "none";
+    }
+
+    std::unique_ptr<CodecStream> CreateEncoder(int, const std::shared_ptr<CodecDictionary> &,
+                                               uint64_t, CodecSink sink) override {
+        return std::make_unique<PassThroughStream>(std::move(sink));
+    }
+
+    std::unique_ptr<CodecStream> CreateDecoder(const DictionaryResolver &,
+                                               CodecSink sink) override {
+        return std::make_unique<PassThroughStream>(std::move(sink));
+    }
+};
+
+/// 每种编解码状态最多缓存的数量
+constexpr size_t MaxPooledStates = 16;
+
+/**
+ * @brief 编解码状态池
+ * @details 压缩上下文和输出缓冲区的创建开销远大于压缩一个小数据，流结束后状态归还到池中复用
+ */
+template <typename State> class StatePool {
+  public:
+    std::unique_ptr<State> Acquire() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (!this->states.empty()) {
+                auto ret = std::move(this->states.back());
+                this->states.pop_back();
+                return ret;
+            }
+        }
+        auto ret = std::make_unique<State>();
+        return ret->IsValid() ? std::move(ret) : nullptr;
+    }
+
+    void Release(std::unique_ptr<State> state) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->states.size() < MaxPooledStates) {
+            this->states.push_back(std::move(state));
+        }
+    }
+
+  private:
+    std::mutex mutex;
+    std::vector<std::unique_ptr<State>> states;
+};
+
+#ifdef FLEET_CODEC_LZ4
+/// LZ4帧魔数
+constexpr uint32_t Lz4Magic = 0x184D2204;
+/// LZ4每次压缩的输入大小，与帧的最大块大小一致
+constexpr uint64_t Lz4ChunkSize = 64 * 1024;
+
+/**
+ * @brief LZ4压缩状态
+ */
+struct Lz4CompressState {
+    LZ4F_cctx *context = nullptr;
+    std::vector<char> output;
+
+    Lz4CompressState() {
+        if (LZ4F_isError(LZ4F_createCompressionContext(&this->context, LZ4F_VERSION))) {
+            this->context = nullptr;
+        }
+    }
+
+    ~Lz4CompressState() {
+        LZ4F_freeCompressionContext(this->context);
+    }
+
+    bool IsValid() const {
+        return this->context != nullptr;
+    }
+};
+
+/**
+ * @brief LZ4解压状态
+ */
+struct Lz4DecompressState {
+    LZ4F_dctx *context = nullptr;
+    std::vector<char> output;
+
+    Lz4DecompressState() : output(Lz4ChunkSize) {
+        if (LZ4F_isError(LZ4F_createDecompressionContext(&this->context, LZ4F_VERSION))) {
+            this->context = nullptr;
+        }
+    }
+
+    ~Lz4DecompressState() {
+        LZ4F_freeDecompressionContext(this->context);
+    }
+
+    bool IsValid() const {
+        return this->context != nullptr;
+    }
+};
+
+/**
+ * @brief LZ4帧格式编码流
+ */
+class Lz4Encoder : public CodecStream {
+  public:
+    Lz4Encoder(const std::shared_ptr<StatePool<Lz4CompressState>> &pool,
+               std::unique_ptr<Lz4CompressState> state, CodecSink sink)
+        : pool(pool), state(std::move(state)), sink(std::move(sink)) {
+    }
+
+    ~Lz4Encoder() override {
+        // 压缩上下文在下一次compressBegin时重置
+        this->pool->Release(std::move(this->state));
+    }
+
+    bool Init(int level, uint64_t contentSize) {
+        LZ4F_preferences_t preferences;
+        memset(&preferences, 0, sizeof(preferences));
+        preferences.compressionLevel = level;
+        preferences.frameInfo.blockSizeID = LZ4F_max64KB;
+        if (contentSize != UnknownContentSize) {
+            preferences.frameInfo.contentSize = contentSize;
+        }
+        auto &output = this->state->output;
+        output.resize(
+            std::max<size_t>(LZ4F_compressBound(Lz4ChunkSize, &preferences), LZ4F_HEADER_SIZE_MAX));
+        size_t written =
+            LZ4F_compressBegin(this->state->context, output.data(), output.size(), &preferences);
+        return !LZ4F_isError(written) && this->sink(output.data(), written);
+    }
+
+    bool Write(const char *data, uint64_t size) override {
+        auto &output = this->state->output;
+        for (uint64_t position = 0; position < size; position += Lz4ChunkSize) {
+            size_t length = std::min(Lz4ChunkSize, size - position);
+            size_t written = LZ4F_compressUpdate(this->state->context, output.data(),
+                                                 output.size(), data + position, length, nullptr);
+            if (LZ4F_isError(written) || (written > 0 && !this->sink(output.data(), written))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Finish() override {
+        auto &output = this->state->output;
+        size_t written =
+            LZ4F_compressEnd(this->state->context, output.data(), output.size(), nullptr);
+        return !LZ4F_isError(written) && this->sink(output.data(), written);
+    }
+
+  private:
+    std::shared_ptr<StatePool<Lz4CompressState>> pool;
+    std::unique_ptr<Lz4CompressState> state;
+    CodecSink sink;
+};
+
+/**
+ * @brief LZ4帧格式解码流
+ */
+class Lz4Decoder : public CodecStream {
+  public:
+    Lz4Decoder(const std::shared_ptr<StatePool<Lz4DecompressState>> &pool,
+               std::unique_ptr<Lz4DecompressState> state, CodecSink sink)
+        : pool(pool), state(std::move(state)), sink(std::move(sink)), remaining(1) {
+    }
+
+    ~Lz4Decoder() override {
+        // 解码可能停在帧中间，归还前重置
+        LZ4F_resetDecompressionContext(this->state->context);
+        this->pool->Release(std::move(this->state));
+    }
+
+    bool Write(const char *data, uint64_t size) override {
+        auto &output = this->state->output;
+        uint64_t position = 0;
+        while (true) {
+            size_t consumed = size - position;
+            size_t produced = output.size();
+            size_t hint = LZ4F_decompress(this->state->context, output.data(), &produced,
+                                          data + position, &consumed, nullptr);
+            if (LZ4F_isError(hint) || (produced > 0 && !this->sink(output.data(), produced))) {
+                return false;
+            }
+            // 帧结束后不带输入的调用返回下一帧的帧头大小，不能覆盖帧已结束的状态
+            if (consumed > 0 || produced > 0) {
+                this->remaining = hint;
+            }
+            position += consumed;
+            // 输出缓冲区写满时可能还有未取出的数据
+            if (position == size && produced < output.size()) {
+                return true;
+            }
+        }
+    }
+
+    bool Finish() override {
+        return this->remaining == 0;
+    }
+
+  private:
+    std::shared_ptr<StatePool<Lz4DecompressState>> pool;
+    std::unique_ptr<Lz4DecompressState> state;
+    CodecSink sink;
+    size_t remaining;
+};
+
+/**
+ * @brief LZ4编解码器，使用帧格式，级别大于等于3时使用高压缩率模式
+ */
+class Lz4Codec : public Codec {
+  public:
+    Lz4Codec()
+        : compressStates(std::make_shared<StatePool<Lz4CompressState>>()),
+          decompressStates(std::make_shared<StatePool<Lz4DecompressState>>()) {
+    }
+
+    const char *GetName() const override {
+        return "lz4";
+    }
+
+    bool Recognize(const char *data, uint64_t size) const override {
+        return HasMagic(data, size, Lz4Magic);
+    }
+
+    bool GetContentSize(const char *data, uint64_t size, uint64_t &contentSize) const override {
+        auto state = this->decompressStates->Acquire();
+        if (state == nullptr) {
+            return false;
+        }
+        LZ4F_frameInfo_t info;
+        memset(&info, 0, sizeof(info));
+        size_t consumed = size;
+        size_t result = LZ4F_getFrameInfo(state->context, &info, data, &consumed);
+        LZ4F_resetDecompressionContext(state->context);
+        this->decompressStates->Release(std::move(state));
+        // 帧头中的0表示未记录大小
+        if (LZ4F_isError(result) || info.contentSize == 0) {
+            return false;
+        }
+        contentSize = info.contentSize;
+        return true;
+    }
+
+    std::unique_ptr<CodecStream> CreateEncoder(int level, const std::shared_ptr<CodecDictionary> &,
+                                               uint64_t contentSize, CodecSink sink) override {
+        auto state = this->compressStates->Acquire();
+        if (state == nullptr) {
+            return nullptr;
+        }
+        auto ret = std::make_unique<Lz4Encoder>(this->compressStates, std::move(state),
+                                                std::move(sink));
+        if (!ret->Init(level, contentSize)) {
+            return nullptr;
+        }
+        return ret;
+    }
+
+    std::unique_ptr<CodecStream> CreateDecoder(const DictionaryResolver &,
+                                               CodecSink sink) override {
+        auto state = this->decompressStates->Acquire();
+        if (state == nullptr) {
+            return nullptr;
+        }
+        return std::make_unique<Lz4Decoder>(this->decompressStates, std::move(state),
+                                            std::move(sink));
+    }
+
+  private:
+    std::shared_ptr<StatePool<Lz4CompressState>> compressStates;
+    std::shared_ptr<StatePool<Lz4DecompressState>> decompressStates;
+};
+#endif
+
+#ifdef FLEET_CODEC_ZSTD
+/// Zstandard帧头的最大长度，读到这么多数据后即可取得字典编号
+constexpr size_t ZstdFrameHeaderSizeMax = 18;
+
+/**
+ * @brief 预处理过的Zstandard字典
+ * @details 解码字典在加载时创建，编码字典按压缩级别在首次使用时创建
+ */
+class ZstdDictionary : public CodecDictionary {
+  public:
+    ZstdDictionary(uint32_t id, const std::string &content, ZSTD_DDict *decompression)
+        : CodecDictionary(id, content), decompression(decompression) {
+    }
+
+    ~ZstdDictionary() override {
+        for (const auto &elem : this->compression) {
+            ZSTD_freeCDict(elem.second);
+        }
+        ZSTD_freeDDict(this->decompression);
+    }
+
+    ZSTD_CDict *GetCompression(int level) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto iter = this->compression.find(level);
+        if (iter != this->compression.end()) {
+            return iter->second;
+        }
+        ZSTD_CDict *ret =
+            ZSTD_createCDict(this->GetContent().data(), this->GetContent().size(), level);
+        if (ret != nullptr) {
+            this->compression[level] = ret;
+        }
+        return ret;
+    }
+
+    ZSTD_DDict *GetDecompression() const {
+        return this->decompression;
+    }
+
+  private:
+    std::mutex mutex;
+    std::map<int, ZSTD_CDict *> compression;
+    ZSTD_DDict *decompression;
+};
+
+/**
+ * @brief Zstandard压缩状态
+ */
+struct ZstdCompressState {
+    ZSTD_CCtx *context;
+    std::vector<char> output;
+
+    ZstdCompressState() : context(ZSTD_createCCtx()), output(ZSTD_CStreamOutSize()) {
+    }
+
+    ~ZstdCompressState() {
+        ZSTD_freeCCtx(this->context);
+    }
+
+    bool IsValid() const {
+        return this->context != nullptr;
+    }
+};
+
+/**
+ * @brief Zstandard解压状态
+ */
+struct ZstdDecompressState {
+    ZSTD_DCtx *context;
+    std::vector<char> output;
+
+    ZstdDecompressState() : context(ZSTD_createDCtx()), output(ZSTD_DStreamOutSize()) {
+    }
+
+    ~ZstdDecompressState() {
+        ZSTD_freeDCtx(this->context);
+    }
+
+    bool IsValid() const {
+        return this->context != nullptr;
+    }
+};
+
+/**
+ * @brief Zstandard编码流
+ */
+class ZstdEncoder : public CodecStream {
+  public:
+    ZstdEncoder(const std::shared_ptr<StatePool<ZstdCompressState>> &pool,
+                std::unique_ptr<ZstdCompressState> state, CodecSink sink)
+        : pool(pool), state(std::move(state)), sink(std::move(sink)) {
+    }
+
+    ~ZstdEncoder() override {
+        this->pool->Release(std::move(this->state));
+    }
+
+    bool Init(int level, const std::shared_ptr<CodecDictionary> &dictionary,
+              uint64_t contentSize) {
+        // 复用的上下文可能带有上一个流的参数和字典
+        ZSTD_CCtx *context = this->state->context;
+        if (ZSTD_isError(ZSTD_CCtx_reset(context, ZSTD_reset_session_and_parameters))) {
+            return false;
+        }
+        auto *prepared = dynamic_cast<ZstdDictionary *>(dictionary.get());
+        if (prepared != nullptr) {
+            // 编码字典已包含压缩级别
+            ZSTD_CDict *compression = prepared->GetCompression(level);
+            if (compression == nullptr || ZSTD_isError(ZSTD_CCtx_refCDict(context, compression))) {
+                return false;
+            }
+        } else if (ZSTD_isError(ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, level))) {
+            return false;
+        }
+        return contentSize == UnknownContentSize ||
+               !ZSTD_isError(ZSTD_CCtx_setPledgedSrcSize(context, contentSize));
+    }
+
+    bool Write(const char *data, uint64_t size) override {
+        ZSTD_inBuffer input{data, size, 0};
+        while (input.pos < input.size) {
+            if (!this->Compress(input, ZSTD_e_continue)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Finish() override {
+        ZSTD_inBuffer input{nullptr, 0, 0};
+        size_t remaining = 1;
+        while (remaining != 0) {
+            if (!this->Compress(input, ZSTD_e_end, &remaining)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    std::shared_ptr<StatePool<ZstdCompressState>> pool;
+    std::unique_ptr<ZstdCompressState> state;
+    CodecSink sink;
+
+    bool Compress(ZSTD_inBuffer &input, ZSTD_EndDirective directive,
+                  size_t *remaining = nullptr) {
+        auto &output = this->state->output;
+        ZSTD_outBuffer buffer{output.data(), output.size(), 0};
+        size_t result = ZSTD_compressStream2(this->state->context, &buffer, &input, directive);
+        if (ZSTD_isError(result) || (buffer.pos > 0 && !this->sink(output.data(), buffer.pos))) {
+            return false;
+        }
+        if (remaining != nullptr) {
+            *remaining = result;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Zstandard解码流
+ * @details 先缓存帧头，取得字典编号并引用对应的字典后再开始解码
+ */
+class ZstdDecoder : public CodecStream {
+  public:
+    ZstdDecoder(const std::shared_ptr<StatePool<ZstdDecompressState>> &pool,
+                std::unique_ptr<ZstdDecompressState> state,
+                const Codec::DictionaryResolver &resolver, CodecSink sink)
+        : pool(pool), state(std::move(state)), resolver(resolver), sink(std::move(sink)),
+          started(false), remaining(1) {
+    }
+
+    ~ZstdDecoder() override {
+        this->pool->Release(std::move(this->state));
+    }
+
+    bool Init() {
+        return !ZSTD_isError(
+            ZSTD_DCtx_reset(this->state->context, ZSTD_reset_session_and_parameters));
+    }
+
+    bool Write(const char *data, uint64_t size) override {
+        if (this->started) {
+            return this->Decompress(data, size);
+        }
+        this->header.append(data, size);
+        if (this->header.size() < ZstdFrameHeaderSizeMax) {
+            return true;
+        }
+        return this->Start();
+    }
+
+    bool Finish() override {
+        if (!this->started && !this->Start()) {
+            return false;
+        }
+        return this->remaining == 0;
+    }
+
+  private:
+    std::shared_ptr<StatePool<ZstdDecompressState>> pool;
+    std::unique_ptr<ZstdDecompressState> state;
+    Codec::DictionaryResolver resolver;
+    CodecSink sink;
+    std::string header;
+    bool started;
+    size_t remaining;
+
+    bool Start() {
+        this->started = true;
+        unsigned id = ZSTD_getDictID_fromFrame(this->header.data(), this->header.size());
+        if (id != 0) {
+            auto dictionary = this->resolver ? this->resolver(id) : nullptr;
+            auto *prepared = dynamic_cast<ZstdDictionary *>(dictionary.get());
+            if (prepared == nullptr ||
+                ZSTD_isError(
+                    ZSTD_DCtx_refDDict(this->state->context, prepared->GetDecompression()))) {
+                return false;
+            }
+        }
+        std::string buffered;
+        buffered.swap(this->header);
+        return this->Decompress(buffered.data(), buffered.size());
+    }
+
+    bool Decompress(const char *data, uint64_t size) {
+        auto &output = this->state->output;
+        ZSTD_inBuffer input{data, size, 0};
+        while (true) {
+            ZSTD_outBuffer buffer{output.data(), output.size(), 0};
+            size_t position = input.pos;
+            size_t result = ZSTD_decompressStream(this->state->context, &buffer, &input);
+            if (ZSTD_isError(result) ||
+                (buffer.pos > 0 && !this->sink(output.data(), buffer.pos))) {
+                return false;
+            }
+            if (input.pos > position || buffer.pos > 0) {
+                this->remaining = result;
+            }
+            // 输出缓冲区写满时可能还有未取出的数据
+            if (input.pos == input.size && buffer.pos < buffer.size) {
+                return true;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Zstandard编解码器，支持训练和使用字典
+ */
+class ZstdCodec : public Codec {
+  public:
+    ZstdCodec()
+        : compressStates(std::make_shared<StatePool<ZstdCompressState>>()),
+          decompressStates(std::make_shared<StatePool<ZstdDecompressState>>()) {
+    }
+
+    const char *GetName() const override {
+        return "zstd";
+    }
+
+    int GetDefaultLevel() const override {
+        return ZSTD_CLEVEL_DEFAULT;
+    }
+
+    bool Recognize(const char *data, uint64_t size) const override {
+        return HasMagic(data, size, ZSTD_MAGICNUMBER);
+    }
+
+    bool GetContentSize(const char *data, uint64_t size, uint64_t &contentSize) const override {
+        unsigned long long result = ZSTD_getFrameContentSize(data, size);
+        if (result == ZSTD_CONTENTSIZE_UNKNOWN || result == ZSTD_CONTENTSIZE_ERROR) {
+            return false;
+        }
+        contentSize = result;
+        return true;
+    }
+
+    std::unique_ptr<CodecStream> CreateEncoder(int level,
+                                               const std::shared_ptr<CodecDictionary> &dictionary,
+                                               uint64_t contentSize, CodecSink sink) override {
+        auto state = this->compressStates->Acquire();
+        if (state == nullptr) {
+            return nullptr;
+        }
+        auto ret = std::make_unique<ZstdEncoder>(this->compressStates, std::move(state),
+                                                 std::move(sink));
+        if (!ret->Init(level, dictionary, contentSize)) {
+            return nullptr;
+        }
+        return ret;
+    }
+
+    std::unique_ptr<CodecStream> CreateDecoder(const DictionaryResolver &resolver,
+                                               CodecSink sink) override {
+        auto state = this->decompressStates->Acquire();
+        if (state == nullptr) {
+            return nullptr;
+        }
+        auto ret = std::make_unique<ZstdDecoder>(this->decompressStates, std::move(state),
+                                                 resolver, std::move(sink));
+        if (!ret->Init()) {
+            return nullptr;
+        }
+        return ret;
+    }
+
+    bool TrainDictionary(const std::vector<std::string> &samples, uint64_t capacity,
+                         std::string &content) override {
+        std::string buffer;
+        std::vector<size_t> sizes;
+        sizes.reserve(samples.size());
+        for (const auto &sample : samples) {
+            buffer.append(sample);
+            sizes.push_back(sample.size());
+        }
+        content.resize(capacity);
+        size_t result = ZDICT_trainFromBuffer(content.data(), content.size(), buffer.data(),
+                                              sizes.data(), (unsigned) sizes.size());
+        if (ZDICT_isError(result)) {
+            content.clear();
+            return false;
+        }
+        content.resize(result);
+        return true;
+    }
+
+    std::shared_ptr<CodecDictionary> LoadDictionary(const std::string &content) override {
+        // 没有字典头的原始内容无法写入字典编号，解码时找不到对应的字典
+        unsigned id = ZDICT_getDictID(content.data(), content.size());
+        if (id == 0) {
+            return nullptr;
+        }
+        ZSTD_DDict *decompression = ZSTD_createDDict(content.data(), content.size());
+        if (decompression == nullptr) {
+            return nullptr;
+        }
+        return std::make_shared<ZstdDictionary>(id, content, decompression);
+    }
+
+  private:
+    std::shared_ptr<StatePool<ZstdCompressState>> compressStates;
+    std::shared_ptr<StatePool<ZstdDecompressState>> decompressStates;
+};
+#endif
+} // namespace
+
+CodecRegistry::CodecRegistry(const std::shared_ptr<Core::PluginContext> &pluginContext)
+    : pluginContext(pluginContext) {
+    this->Register(std::make_shared<NoneCodec>());
+#ifdef FLEET_CODEC_LZ4
+    this->Register(std::make_shared<Lz4Codec>());
+#endif
+#ifdef FLEET_CODEC_ZSTD
+    this->Register(std::make_shared<ZstdCodec>());
+#endif
+}
+
+bool CodecRegistry::Register(const std::shared_ptr<Codec> &codec) {
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    return this->codecs.emplace(ToLower(codec->GetName()), codec).second;
+}
+
+std::shared_ptr<Codec> CodecRegistry::Find(const std::string &name) {
+    std::shared_lock<std::shared_mutex> lock(this->mutex);
+    auto iter = this->codecs.find(ToLower(name));
+    return iter == this->codecs.end() ? nullptr : iter->second;
+}
+
+std::vector<std::string> CodecRegistry::GetNames() {
+    std::shared_lock<std::shared_mutex> lock(this->mutex);
+    std::vector<std::string> ret;
+    for (const auto &elem : this->codecs) {
+        ret.push_back(elem.first);
+    }
+    return ret;
+}
+
+bool CodecRegistry::SetDataTypeCodec(const std::string &dataType,
+                                     const std::string &description) {
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    if (description.empty()) {
+        this->dataTypes.erase(dataType);
+        return true;
+    }
+    Selection selection;
+    if (!this->ParseDescription(description, selection)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "数据类型 {} 的编解码器 {} 不合法",
+                                      dataType, description);
+        return false;
+    }
+    // 编解码器不变时保留已有的字典
+    auto iter = this->dataTypes.find(dataType);
+    if (iter != this->dataTypes.end() && iter->second.codec == selection.codec) {
+        selection.dictionary = iter->second.dictionary;
+    }
+    this->dataTypes[dataType] = selection;
+    return true;
+}
+
+bool CodecRegistry::TrainDictionary(const std::string &dataType,
+                                    const std::vector<std::string> &samples, uint64_t capacity) {
+    std::shared_ptr<Codec> codec;
+    {
+        std::shared_lock<std::shared_mutex> lock(this->mutex);
+        auto iter = this->dataTypes.find(dataType);
+        if (iter != this->dataTypes.end()) {
+            codec = iter->second.codec;
+        }
+    }
+    if (codec == nullptr) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "数据类型 {} 未设置编解码器", dataType);
+        return false;
+    }
+    std::string content;
+    if (!codec->TrainDictionary(samples, capacity, content)) {
+        this->pluginContext->LogError(SOURCE_LOCATION,
+                                      "无法用 {} 个样本为数据类型 {} 训练 {} 字典",
+                                      samples.size(), dataType, codec->GetName());
+        return false;
+    }
+    return this->AddDictionary(dataType, content);
+}
+
+bool CodecRegistry::AddDictionary(const std::string &dataType, const std::string &content) {
+    std::shared_ptr<Codec> codec;
+    {
+        std::shared_lock<std::shared_mutex> lock(this->mutex);
+        auto iter = this->dataTypes.find(dataType);
+        if (iter != this->dataTypes.end()) {
+            codec = iter->second.codec;
+        }
+    }
+    auto dictionary = codec == nullptr ? nullptr : codec->LoadDictionary(content);
+    if (dictionary == nullptr) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "无法为数据类型 {} 加载字典", dataType);
+        return false;
+    }
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    this->dictionaries[std::make_pair(std::string(codec->GetName()), dictionary->GetId())] =
+        dictionary;
+    auto iter = this->dataTypes.find(dataType);
+    if (iter != this->dataTypes.end() && iter->second.codec == codec) {
+        iter->second.dictionary = dictionary;
+    }
+    this->pluginContext->LogInfo(SOURCE_LOCATION, "数据类型 {} 使用 {} 字典 {}, 大小 {} 字节",
+                                 dataType, codec->GetName(), dictionary->GetId(),
+                                 content.size());
+    return true;
+}
+
+bool CodecRegistry::GetDictionary(const std::string &dataType, std::string &content) {
+    std::shared_lock<std::shared_mutex> lock(this->mutex);
+    auto iter = this->dataTypes.find(dataType);
+    if (iter == this->dataTypes.end() || iter->second.dictionary == nullptr) {
+        return false;
+    }
+    content = iter->second.dictionary->GetContent();
+    return true;
+}
+
+std::unique_ptr<CodecStream> CodecRegistry::CreateEncoder(const std::string &type,
+                                                          uint64_t contentSize, CodecSink sink) {
+    Selection selection;
+    if (!this->Resolve(type, selection)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "编码类型 {} 不合法", type);
+        return nullptr;
+    }
+    auto ret = selection.codec->CreateEncoder(selection.level, selection.dictionary, contentSize,
+                                              std::move(sink));
+    if (ret == nullptr) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "无法创建 {} 编码流",
+                                      selection.codec->GetName());
+    }
+    return ret;
+}
+
+std::unique_ptr<CodecStream> CodecRegistry::CreateDecoder(const std::string &type,
+                                                          CodecSink sink) {
+    Selection selection;
+    if (!this->Resolve(type, selection)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "编码类型 {} 不合法", type);
+        return nullptr;
+    }
+    auto ret = selection.codec->CreateDecoder(this->GetResolver(selection.codec), std::move(sink));
+    if (ret == nullptr) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "无法创建 {} 解码流",
+                                      selection.codec->GetName());
+    }
+    return ret;
+}
+
+std::shared_ptr<DataBlock> CodecRegistry::Encode(const char *data, uint64_t size,
+                                                 const std::string &type) {
+    std::vector<char> output;
+    auto stream = this->CreateEncoder(type, size, [&output](const char *chunk, uint64_t length) {
+        output.insert(output.end(), chunk, chunk + length);
+        return true;
+    });
+    if (stream == nullptr) {
+        return nullptr;
+    }
+    if (!stream->Write(data, size) || !stream->Finish()) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "以类型 {} 编码 {} 字节数据失败", type,
+                                      size);
+        return nullptr;
+    }
+    if (output.empty()) {
+        return std::make_shared<DataBlock>(0);
+    }
+    return std::make_shared<DataBlock>(output.size(), output.data());
+}
+
+std::shared_ptr<DataBlock> CodecRegistry::Decode(const char *data, uint64_t size,
+                                                 const std::string &type) {
+    Selection selection;
+    if (!this->Resolve(type, selection)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "编码类型 {} 不合法", type);
+        return nullptr;
+    }
+    auto codec = selection.codec;
+    if (std::string(codec->GetName()) != "none" && !codec->Recognize(data, size)) {
+        std::shared_lock<std::shared_mutex> lock(this->mutex);
+        for (const auto &elem : this->codecs) {
+            if (elem.second->Recognize(data, size)) {
+                codec = elem.second;
+                break;
+            }
+        }
+    }
+
+    uint64_t contentSize = 0;
+    bool sized = codec->GetContentSize(data, size, contentSize);
+    std::shared_ptr<DataBlock> ret;
+    std::vector<char> output;
+    uint64_t position = 0;
+    if (sized) {
+        ret = std::make_shared<DataBlock>(contentSize);
+    }
+    auto stream = codec->CreateDecoder(
+        this->GetResolver(codec), [&](const char *chunk, uint64_t length) {
+            if (!sized) {
+                output.insert(output.end(), chunk, chunk + length);
+                return true;
+            }
+            if (length > contentSize - position) {
+                return false;
+            }
+            memcpy(ret->GetMutableData() + position, chunk, length);
+            position += length;
+            return true;
+        });
+    if (stream == nullptr || !stream->Write(data, size) || !stream->Finish() ||
+        (sized && position != contentSize)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "以 {} 解码 {} 字节数据失败",
+                                      codec->GetName(), size);
+        return nullptr;
+    }
+    if (!sized) {
+        ret = output.empty() ? std::make_shared<DataBlock>(0)
+                             : std::make_shared<DataBlock>(output.size(), output.data());
+    }
+    return ret;
+}
+
+bool CodecRegistry::Resolve(const std::string &type, Selection &selection) {
+    std::shared_lock<std::shared_mutex> lock(this->mutex);
+    auto iter = this->dataTypes.find(type);
+    if (iter != this->dataTypes.end()) {
+        selection = iter->second;
+        return true;
+    }
+    return this->ParseDescription(type.empty() ? "none" : type, selection);
+}
+
+bool CodecRegistry::ParseDescription(const std::string &description, Selection &selection) {
+    size_t separator = description.find(':');
+    auto iter = this->codecs.find(ToLower(description.substr(0, separator)));
+    if (iter == this->codecs.end()) {
+        return false;
+    }
+    selection.codec = iter->second;
+    selection.level = iter->second->GetDefaultLevel();
+    selection.dictionary = nullptr;
+    if (separator == std::string::npos) {
+        return true;
+    }
+    const char *cursor = description.c_str() + separator + 1;
+    char *end = nullptr;
+    long level = strtol(cursor, &end, 10);
+    if (end == cursor || *end != '\0' || level < INT_MIN || level > INT_MAX) {
+        return false;
+    }
+    selection.level = (int) level;
+    return true;
+}
+
+Codec::DictionaryResolver CodecRegistry::GetResolver(const std::shared_ptr<Codec> &codec) {
+    std::string name(codec->GetName());
+    return [this, name](uint32_t id) -> std::shared_ptr<CodecDictionary> {
+        std::shared_lock<std::shared_mutex> lock(this->mutex);
+        auto iter = this->dictionaries.find(std::make_pair(name, id));
+        return iter == this->dictionaries.end() ? nullptr : iter->second;
+    };
+}
+} // namespace Fleet::DataManager::Storage
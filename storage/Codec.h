@@ -0,0 +1,422 @@
+/**
+ * @file Codec.h
+ * @brief 数据压缩编解码
+ * @details 提供可注册的流式压缩编解码器，内置不压缩、LZ4和Zstandard三种实现，支持按数据类型选择编解码器和训练Zstandard字典
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_CODEC_H
+#define FLEET_DATA_MANAGER_STORAGE_CODEC_H
+
+#include "DataBlock.h"
+#include "PluginContext.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+/// 编解码输出函数，参数为一段输出数据，返回false时中止编解码
+using CodecSink = std::function<bool(const char *, uint64_t)>;
+
+/// 写入编码流的数据总量未知
+constexpr uint64_t UnknownContentSize = UINT64_MAX;
+
+/**
+ * @brief 流式编解码接口
+ * @details 输入可以分成任意大小的多段写入，输出按编解码器内部缓冲区的大小分段交给输出函数，
+ * 编解码过程中只占用固定大小的缓冲区
+ * @note 非线程安全，每个流只能由一个线程使用
+ */
+class CodecStream {
+  public:
+    /**
+     * @brief 构造流
+     */
+    CodecStream() = default;
+
+    /**
+     * @brief 析构函数
+     */
+    virtual ~CodecStream() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    CodecStream(const CodecStream &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    CodecStream &operator=(const CodecStream &) = delete;
+
+    /**
+     * @brief 写入一段输入
+     * @param[in] data 输入数据
+     * @param[in] size 输入大小，单位字节
+     * @return 处理成功返回true，数据格式错误或输出函数返回false时返回false
+     */
+    virtual bool Write(const char *data, uint64_t size) = 0;
+
+    /**
+     * @brief 结束输入并输出剩余数据
+     * @return 处理成功返回true，解码时输入不完整也返回false
+     */
+    virtual bool Finish() = 0;
+};
+
+/**
+ * @brief 压缩字典
+ * @details 保存字典内容和编号，具体的编解码器可以派生出预处理过的字典，避免每次编解码时重新加载
+ * @note 线程安全，同一字典可被多个流同时使用
+ */
+class CodecDictionary {
+  public:
+    /**
+     * @brief 构造字典
+     * @param[in] id 字典编号，写入压缩数据，解码时用于查找字典
+     * @param[in] content 字典内容
+     */
+    CodecDictionary(uint32_t id, const std::string &content) : id(id), content(content) {
+    }
+
+    /**
+     * @brief 析构函数
+     */
+    virtual ~CodecDictionary() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    CodecDictionary(const CodecDictionary &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    CodecDictionary &operator=(const CodecDictionary &) = delete;
+
+    /**
+     * @brief 获取字典编号
+     * @return 字典编号
+     */
+    uint32_t GetId() const {
+        return this->id;
+    }
+
+    /**
+     * @brief 获取字典内容
+     * @return 字典内容
+     */
+    const std::string &GetContent() const {
+        return this->content;
+    }
+
+  private:
+    /// 字典编号
+    uint32_t id;
+
+    /// 字典内容
+    std::string content;
+};
+
+/**
+ * @brief 编解码器接口
+ * @note 实现必须是线程安全的，同一编解码器可以同时创建多个流
+ */
+class Codec {
+  public:
+    /// 按编号查找解码字典的函数类型，找不到时返回nullptr
+    using DictionaryResolver = std::function<std::shared_ptr<CodecDictionary>(uint32_t)>;
+
+    /**
+     * @brief 构造编解码器
+     */
+    Codec() = default;
+
+    /**
+     * @brief 析构函数
+     */
+    virtual ~Codec() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    Codec(const Codec &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    Codec &operator=(const Codec &) = delete;
+
+    /**
+     * @brief 获取编解码器名称
+     * @return 小写的名称
+     */
+    virtual const char *GetName() const = 0;
+
+    /**
+     * @brief 获取默认压缩级别
+     * @return 压缩级别
+     */
+    virtual int GetDefaultLevel() const {
+        return 0;
+    }
+
+    /**
+     * @brief 判断数据是否是本编解码器的输出
+     * @param[in] data 编码数据的开头
+     * @param[in] size 数据大小
+     * @return 以本编解码器的帧魔数开头返回true，否则返回false
+     */
+    virtual bool Recognize(const char *data, uint64_t size) const {
+        (void) data;
+        (void) size;
+        return false;
+    }
+
+    /**
+     * @brief 从编码数据的帧头读取原始数据大小
+     * @param[in] data 编码数据
+     * @param[in] size 编码数据大小
+     * @param[out] contentSize 原始数据大小
+     * @return 帧头记录了原始数据大小返回true，否则返回false
+     */
+    virtual bool GetContentSize(const char *data, uint64_t size, uint64_t &contentSize) const {
+        (void) data;
+        (void) size;
+        (void) contentSize;
+        return false;
+    }
+
+    /**
+     * @brief 创建编码流
+     * @param[in] level 压缩级别
+     * @param[in] dictionary 压缩字典，为nullptr时不使用字典，不支持字典的编解码器忽略该参数
+     * @param[in] contentSize 将要写入的数据总量，已知时写入帧头，未知时为UnknownContentSize
+     * @param[in] sink 输出函数
+     * @return 编码流，创建失败返回nullptr
+     */
+    virtual std::unique_ptr<CodecStream>
+    CreateEncoder(int level, const std::shared_ptr<CodecDictionary> &dictionary,
+                  uint64_t contentSize, CodecSink sink) = 0;
+
+    /**
+     * @brief 创建解码流
+     * @param[in] resolver 按帧头中的字典编号查找字典
+     * @param[in] sink 输出函数
+     * @return 解码流，创建失败返回nullptr
+     */
+    virtual std::unique_ptr<CodecStream> CreateDecoder(const DictionaryResolver &resolver,
+                                                       CodecSink sink) = 0;
+
+    /**
+     * @brief 从样本训练字典
+     * @param[in] samples 样本，每个样本是一个完整的数据
+     * @param[in] capacity 字典大小上限，单位字节
+     * @param[out] content 字典内容
+     * @return 训练成功返回true，不支持字典或样本不足时返回false
+     */
+    virtual bool TrainDictionary(const std::vector<std::string> &samples, uint64_t capacity,
+                                 std::string &content) {
+        (void) samples;
+        (void) capacity;
+        (void) content;
+        return false;
+    }
+
+    /**
+     * @brief 加载字典
+     * @param[in] content 字典内容
+     * @return 预处理后的字典，不支持字典或内容不合法时返回nullptr
+     */
+    virtual std::shared_ptr<CodecDictionary> LoadDictionary(const std::string &content) {
+        (void) content;
+        return nullptr;
+    }
+};
+
+/**
+ * @brief 编解码器注册表
+ * @details 按名称注册编解码器，构造时注册不压缩的none，以及编译时找到对应库的lz4和zstd。
+ * 编码类型可以是“名称”或“名称:级别”形式的编解码器描述，也可以是设置过编解码器的数据类型，
+ * 数据类型优先。数据类型可以训练或加载字典，编码时使用最新的字典，
+ * 所有加载过的字典都保留用于解码，解码时按帧头中的字典编号查找。
+ * 解码时如果数据不是编码类型对应的编解码器的输出，改用识别出帧魔数的编解码器，
+ * 数据类型更换编解码器后仍能读取之前写入的数据
+ * @note 线程安全
+ */
+class CodecRegistry {
+  public:
+    /**
+     * @brief 构造注册表并注册内置的编解码器
+     * @param[in] pluginContext 插件上下文，用于日志记录
+     */
+    explicit CodecRegistry(const std::shared_ptr<Core::PluginContext> &pluginContext);
+
+    /**
+     * @brief 析构函数
+     */
+    virtual ~CodecRegistry() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    CodecRegistry(const CodecRegistry &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    CodecRegistry &operator=(const CodecRegistry &) = delete;
+
+    /**
+     * @brief 注册编解码器
+     * @param[in] codec 编解码器
+     * @return 注册成功返回true，同名的编解码器已存在返回false
+     */
+    bool Register(const std::shared_ptr<Codec> &codec);
+
+    /**
+     * @brief 按名称查找编解码器
+     * @param[in] name 名称，不区分大小写
+     * @return 编解码器，不存在返回nullptr
+     */
+    std::shared_ptr<Codec> Find(const std::string &name);
+
+    /**
+     * @brief 获取已注册的编解码器名称
+     * @return 名称列表
+     */
+    std::vector<std::string> GetNames();
+
+    /**
+     * @brief 设置数据类型使用的编解码器
+     * @param[in] dataType 数据类型
+     * @param[in] description 编解码器描述，形如zstd或zstd:19，为空时删除设置
+     * @return 设置成功返回true，编解码器不存在或级别不合法返回false
+     */
+    bool SetDataTypeCodec(const std::string &dataType, const std::string &description);
+
+    /**
+     * @brief 用数据类型的样本训练字典，训练成功后该数据类型的编码使用新字典
+     * @param[in] dataType 已设置编解码器的数据类型
+     * @param[in] samples 样本，每个样本是一个完整的数据
+     * @param[in] capacity 字典大小上限，单位字节
+     * @return 训练成功返回true，否则返回false
+     */
+    bool TrainDictionary(const std::string &dataType, const std::vector<std::string> &samples,
+                         uint64_t capacity);
+
+    /**
+     * @brief 加载之前训练并保存的字典，加载后该数据类型的编码使用该字典
+     * @details 恢复多个字典时按训练的先后顺序加载，最后加载的字典用于编码
+     * @param[in] dataType 已设置编解码器的数据类型
+     * @param[in] content 字典内容
+     * @return 加载成功返回true，否则返回false
+     */
+    bool AddDictionary(const std::string &dataType, const std::string &content);
+
+    /**
+     * @brief 获取数据类型当前用于编码的字典，用于持久化
+     * @param[in] dataType 数据类型
+     * @param[out] content 字典内容
+     * @return 数据类型有字典返回true，否则返回false
+     */
+    bool GetDictionary(const std::string &dataType, std::string &content);
+
+    /**
+     * @brief 创建编码流
+     * @param[in] type 编码类型，数据类型或编解码器描述
+     * @param[in] contentSize 将要写入的数据总量，未知时为UnknownContentSize
+     * @param[in] sink 输出函数
+     * @return 编码流，类型不合法或创建失败返回nullptr
+     */
+    std::unique_ptr<CodecStream> CreateEncoder(const std::string &type, uint64_t contentSize,
+                                               CodecSink sink);
+
+    /**
+     * @brief 创建解码流
+     * @details 流式解码在创建时确定编解码器，不按帧魔数识别
+     * @param[in] type 编码类型，数据类型或编解码器描述
+     * @param[in] sink 输出函数
+     * @return 解码流，类型不合法或创建失败返回nullptr
+     */
+    std::unique_ptr<CodecStream> CreateDecoder(const std::string &type, CodecSink sink);
+
+    /**
+     * @brief 编码整块数据
+     * @details 压缩输出逐段收集后一次复制到返回的数据块，额外占用的内存为压缩后的大小
+     * @param[in] data 原始数据
+     * @param[in] size 原始数据大小
+     * @param[in] type 编码类型，数据类型或编解码器描述
+     * @return 编码后的数据块，失败返回nullptr
+     */
+    std::shared_ptr<DataBlock> Encode(const char *data, uint64_t size, const std::string &type);
+
+    /**
+     * @brief 解码整块数据
+     * @details 帧头记录了原始数据大小时直接解码到返回的数据块，不需要中间缓冲区
+     * @param[in] data 编码数据
+     * @param[in] size 编码数据大小
+     * @param[in] type 编码类型，数据类型或编解码器描述
+     * @return 解码后的数据块，失败返回nullptr
+     */
+    std::shared_ptr<DataBlock> Decode(const char *data, uint64_t size, const std::string &type);
+
+  private:
+    /**
+     * @brief 编码选择
+     */
+    struct Selection {
+        /// 编解码器
+        std::shared_ptr<Codec> codec;
+        /// 压缩级别
+        int level = 0;
+        /// 编码使用的字典，可以为nullptr
+        std::shared_ptr<CodecDictionary> dictionary;
+    };
+
+    /// 插件上下文
+    std::shared_ptr<Core::PluginContext> pluginContext;
+
+    /// 读写锁，保护以下的表
+    std::shared_mutex mutex;
+
+    /// 名称到编解码器的映射
+    std::map<std::string, std::shared_ptr<Codec>> codecs;
+
+    /// 数据类型到编码选择的映射
+    std::map<std::string, Selection> dataTypes;
+
+    /// 编解码器名称和字典编号到字典的映射
+    std::map<std::pair<std::string, uint32_t>, std::shared_ptr<CodecDictionary>> dictionaries;
+
+    /**
+     * @brief 解析编码类型
+     * @param[in] type 编码类型，数据类型或编解码器描述
+     * @param[out] selection 编码选择
+     * @return 解析成功返回true，否则返回false
+     */
+    bool Resolve(const std::string &type, Selection &selection);
+
+    /**
+     * @brief 解析编解码器描述，调用者持有读锁
+     * @param[in] description 编解码器描述
+     * @param[out] selection 编码选择，不包含字典
+     * @return 解析成功返回true，否则返回false
+     */
+    bool ParseDescription(const std::string &description, Selection &selection);
+
+    /**
+     * @brief 创建按编号查找某个编解码器字典的函数
+     * @param[in] codec 编解码器
+     * @return 查找函数
+     */
+    Codec::DictionaryResolver GetResolver(const std::shared_ptr<Codec> &codec);
+};
+} // namespace Fleet::DataManager::Storage
+#endif // FLEET_DATA_MANAGER_STORAGE_CODEC_H
@@ -0,0 +1,404 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#include "ErasureCode.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FLEET_ERASURE_CODE_X86
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define FLEET_ERASURE_CODE_NEON
+#endif
+
+namespace Fleet::DataManager::Storage {
+namespace {
+/**
+ * @brief GF(2^8)运算表，本原多项式为x^8 + x^4 + x^3 + x^2 + 1
+ */
+struct GaloisTables {
+    /// 指数表，长度加倍以省去乘法中的取模
+    uint8_t exp[512];
+    /// 对数表
+    uint8_t log[256];
+    /// 完整乘法表，供标量实现使用
+    uint8_t multiply[256][256];
+    /// 乘数与低半字节的乘积表
+    alignas(16) uint8_t low[256][16];
+    /// 乘数与高半字节的乘积表
+    alignas(16) uint8_t high[256][16];
+
+    GaloisTables() {
+        uint32_t value = 1;
+        for (uint32_t i = 0; i < 255; ++i) {
+            this->exp[i] = (uint8_t) value;
+            this->exp[i + 255] = (uint8_t) value;
+            this->log[value] = (uint8_t) i;
+            value <<= 1;
+            if (value & 0x100) {
+                value ^= 0x11D;
+            }
+        }
+        this->exp[510] = this->exp[0];
+        this->exp[511] = this->exp[1];
+        this->log[0] = 0;
+        for (uint32_t a = 0; a < 256; ++a) {
+            for (uint32_t b = 0; b < 256; ++b) {
+                this->multiply[a][b] =
+                    (a == 0 || b == 0) ? 0 : this->exp[this->log[a] + this->log[b]];
+            }
+            for (uint32_t n = 0; n < 16; ++n) {
+                this->low[a][n] = this->multiply[a][n];
+                this->high[a][n] = this->multiply[a][n << 4];
+            }
+        }
+    }
+};
+
+const GaloisTables &Tables() {
+    static const GaloisTables tables;
+    return tables;
+}
+
+uint8_t Multiply(uint8_t a, uint8_t b) {
+    return Tables().multiply[a][b];
+}
+
+uint8_t Inverse(uint8_t a) {
+    return Tables().exp[255 - Tables().log[a]];
+}
+
+/// 乘加运算：dst ^= coefficient * src
+using MultiplyAddFunction = void (*)(uint8_t *dst, const uint8_t *src, uint8_t coefficient,
+                                     size_t size);
+
+void MultiplyAddScalar(uint8_t *dst, const uint8_t *src, uint8_t coefficient, size_t size) {
+    const uint8_t *row = Tables().multiply[coefficient];
+    for (size_t i = 0; i < size; ++i) {
+        dst[i] ^= row[src[i]];
+    }
+}
+
+#ifdef FLEET_ERASURE_CODE_X86
+__attribute__((target("ssse3"))) void MultiplyAddSsse3(uint8_t *dst, const uint8_t *src,
+                                                        uint8_t coefficient, size_t size) {
+    const __m128i low = _mm_load_si128((const __m128i *) Tables().low[coefficient]);
+    const __m128i high = _mm_load_si128((const __m128i *) Tables().high[coefficient]);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i product =
+            _mm_xor_si128(_mm_shuffle_epi8(low, _mm_and_si128(in, mask)),
+                          _mm_shuffle_epi8(high, _mm_and_si128(_mm_srli_epi64(in, 4), mask)));
+        __m128i out = _mm_loadu_si128((const __m128i *) (dst + i));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_xor_si128(out, product));
+    }
+    MultiplyAddScalar(dst + i, src + i, coefficient, size - i);
+}
+
+__attribute__((target("avx2"))) void MultiplyAddAvx2(uint8_t *dst, const uint8_t *src,
+                                                      uint8_t coefficient, size_t size) {
+    const __m256i low = _mm256_broadcastsi128_si256(
+        _mm_load_si128((const __m128i *) Tables().low[coefficient]));
+    const __m256i high = _mm256_broadcastsi128_si256(
+        _mm_load_si128((const __m128i *) Tables().high[coefficient]));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i *) (src + i));
+        __m256i product = _mm256_xor_si256(
+            _mm256_shuffle_epi8(low, _mm256_and_si256(in, mask)),
+            _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi64(in, 4), mask)));
+        __m256i out = _mm256_loadu_si256((const __m256i *) (dst + i));
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_xor_si256(out, product));
+    }
+    MultiplyAddScalar(dst + i, src + i, coefficient, size - i);
+}
+#endif
+
+#ifdef FLEET_ERASURE_CODE_NEON
+void MultiplyAddNeon(uint8_t *dst, const uint8_t *src, uint8_t coefficient, size_t size) {
+    const uint8x16_t low = vld1q_u8(Tables().low[coefficient]);
+    const uint8x16_t high = vld1q_u8(Tables().high[coefficient]);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t in = vld1q_u8(src + i);
+        uint8x16_t product = veorq_u8(vqtbl1q_u8(low, vandq_u8(in, mask)),
+                                      vqtbl1q_u8(high, vshrq_n_u8(in, 4)));
+        vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), product));
+    }
+    MultiplyAddScalar(dst + i, src + i, coefficient, size - i);
+}
+#endif
+
+/**
+ * @brief 乘加运算实现
+ */
+struct Kernel {
+    /// 实现名称
+    const char *name;
+    /// 乘加函数
+    MultiplyAddFunction function;
+    /// CPU是否支持
+    bool supported;
+};
+
+std::vector<Kernel> Kernels() {
+    std::vector<Kernel> ret;
+#ifdef FLEET_ERASURE_CODE_X86
+    __builtin_cpu_init();
+    ret.push_back(Kernel{"avx2", MultiplyAddAvx2, (bool) __builtin_cpu_supports("avx2")});
+    ret.push_back(Kernel{"ssse3", MultiplyAddSsse3, (bool) __builtin_cpu_supports("ssse3")});
+#endif
+#ifdef FLEET_ERASURE_CODE_NEON
+    ret.push_back(Kernel{"neon", MultiplyAddNeon, true});
+#endif
+    ret.push_back(Kernel{"scalar", MultiplyAddScalar, true});
+    return ret;
+}
+
+const std::vector<Kernel> &KernelList() {
+    static const std::vector<Kernel> kernels = Kernels();
+    return kernels;
+}
+
+/// 当前使用的乘加运算实现在KernelList()中的下标，默认为CPU支持的第一个实现
+std::atomic<size_t> &CurrentKernel() {
+    static std::atomic<size_t> current([]() {
+        const auto &kernels = KernelList();
+        size_t ret = 0;
+        while (!kernels[ret].supported) {
+            ++ret;
+        }
+        return ret;
+    }());
+    return current;
+}
+
+void MultiplyAdd(uint8_t *dst, const uint8_t *src, uint8_t coefficient, size_t size) {
+    if (coefficient == 0 || size == 0) {
+        return;
+    }
+    if (coefficient == 1) {
+        for (size_t i = 0; i < size; ++i) {
+            dst[i] ^= src[i];
+        }
+        return;
+    }
+    KernelList()[CurrentKernel().load(std::memory_order_relaxed)].function(dst, src,
+                                                                            coefficient, size);
+}
+} // namespace
+
+ErasureCode::ErasureCode(uint32_t dataFragments, uint32_t parityFragments)
+    : dataFragments(dataFragments), parityFragments(parityFragments) {
+    uint32_t total = dataFragments + parityFragments;
+    this->matrix.assign((size_t) total * dataFragments, 0);
+    for (uint32_t i = 0; i < dataFragments; ++i) {
+        this->matrix[(size_t) i * dataFragments + i] = 1;
+    }
+    // Cauchy矩阵：第i个校验行第j列为1 / (x_i + y_j)，x_i = k + i，y_j = j，两组元素互不相同
+    for (uint32_t i = 0; i < parityFragments; ++i) {
+        for (uint32_t j = 0; j < dataFragments; ++j) {
+            this->matrix[(size_t) (dataFragments + i) * dataFragments + j] =
+                Inverse((uint8_t) ((dataFragments + i) ^ j));
+        }
+    }
+}
+
+bool ErasureCode::Parse(const std::string &algorithm, uint32_t &dataFragments,
+                        uint32_t &parityFragments) {
+    std::string lower(algorithm);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return (char) std::tolower(c); });
+    if (lower.compare(0, 3, "rs-") != 0) {
+        return false;
+    }
+    const char *cursor = lower.c_str() + 3;
+    char *end = nullptr;
+    unsigned long k = strtoul(cursor, &end, 10);
+    if (end == cursor || *end != '-') {
+        return false;
+    }
+    cursor = end + 1;
+    unsigned long m = strtoul(cursor, &end, 10);
+    if (end == cursor || *end != '\0') {
+        return false;
+    }
+    if (k < 1 || m < 1 || k + m > 255) {
+        return false;
+    }
+    dataFragments = (uint32_t) k;
+    parityFragments = (uint32_t) m;
+    return true;
+}
+
+uint32_t ErasureCode::GetDataFragments() const {
+    return this->dataFragments;
+}
+
+uint32_t ErasureCode::GetParityFragments() const {
+    return this->parityFragments;
+}
+
+uint64_t ErasureCode::GetFragmentSize(uint64_t size) const {
+    return (size + this->dataFragments - 1) / this->dataFragments;
+}
+
+bool ErasureCode::Encode(const char *data, uint64_t size,
+                         const std::vector<char *> &fragments) const {
+    if (fragments.size() != this->dataFragments + this->parityFragments) {
+        return false;
+    }
+    uint64_t fragmentSize = this->GetFragmentSize(size);
+    if (fragmentSize == 0) {
+        return true;
+    }
+    for (uint32_t j = 0; j < this->dataFragments; ++j) {
+        uint64_t offset = j * fragmentSize;
+        uint64_t length = offset < size ? std::min(fragmentSize, size - offset) : 0;
+        if (length > 0) {
+            memcpy(fragments[j], data + offset, length);
+        }
+        memset(fragments[j] + length, 0, fragmentSize - length);
+    }
+    for (uint32_t i = 0; i < this->parityFragments; ++i) {
+        uint8_t *parity = (uint8_t *) fragments[this->dataFragments + i];
+        memset(parity, 0, fragmentSize);
+        const uint8_t *row = &this->matrix[(size_t) (this->dataFragments + i) * this->dataFragments];
+        for (uint32_t j = 0; j < this->dataFragments; ++j) {
+            MultiplyAdd(parity, (const uint8_t *) fragments[j], row[j], fragmentSize);
+        }
+    }
+    return true;
+}
+
+bool ErasureCode::Decode(const std::vector<const char *> &fragments, uint64_t fragmentSize,
+                         char *output, uint64_t size) const {
+    uint32_t k = this->dataFragments;
+    if (fragments.size() != k + this->parityFragments ||
+        fragmentSize != this->GetFragmentSize(size)) {
+        return false;
+    }
+    if (size == 0) {
+        return true;
+    }
+
+    // 优先选用数据分片，缺失的数据分片由校验分片补足
+    std::vector<uint32_t> rows;
+    std::vector<uint32_t> missing;
+    for (uint32_t j = 0; j < k; ++j) {
+        if (fragments[j] != nullptr) {
+            rows.push_back(j);
+        } else {
+            missing.push_back(j);
+        }
+    }
+    for (uint32_t i = k; i < fragments.size() && rows.size() < k; ++i) {
+        if (fragments[i] != nullptr) {
+            rows.push_back(i);
+        }
+    }
+    if (rows.size() < k) {
+        return false;
+    }
+
+    for (uint32_t j = 0; j < k; ++j) {
+        if (fragments[j] == nullptr) {
+            continue;
+        }
+        uint64_t offset = j * fragmentSize;
+        if (offset < size) {
+            memcpy(output + offset, fragments[j], std::min(fragmentSize, size - offset));
+        }
+    }
+    if (missing.empty()) {
+        return true;
+    }
+
+    std::vector<uint8_t> square((size_t) k * k);
+    for (uint32_t r = 0; r < k; ++r) {
+        memcpy(&square[(size_t) r * k], &this->matrix[(size_t) rows[r] * k], k);
+    }
+    std::vector<uint8_t> inverse;
+    if (!this->Invert(square, inverse)) {
+        return false;
+    }
+    std::vector<uint8_t> recovered(fragmentSize);
+    for (uint32_t j : missing) {
+        uint64_t offset = j * fragmentSize;
+        if (offset >= size) {
+            continue;
+        }
+        std::fill(recovered.begin(), recovered.end(), 0);
+        for (uint32_t r = 0; r < k; ++r) {
+            MultiplyAdd(recovered.data(), (const uint8_t *) fragments[rows[r]],
+                        inverse[(size_t) j * k + r], fragmentSize);
+        }
+        memcpy(output + offset, recovered.data(), std::min(fragmentSize, size - offset));
+    }
+    return true;
+}
+
+std::string ErasureCode::GetKernelName() {
+    return KernelList()[CurrentKernel().load()].name;
+}
+
+bool ErasureCode::SetKernel(const std::string &name) {
+    const auto &kernels = KernelList();
+    for (size_t i = 0; i < kernels.size(); ++i) {
+        if (name == kernels[i].name && kernels[i].supported) {
+            CurrentKernel().store(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ErasureCode::Invert(std::vector<uint8_t> &square, std::vector<uint8_t> &inverse) const {
+    uint32_t k = this->dataFragments;
+    inverse.assign((size_t) k * k, 0);
+    for (uint32_t i = 0; i < k; ++i) {
+        inverse[(size_t) i * k + i] = 1;
+    }
+    for (uint32_t column = 0; column < k; ++column) {
+        uint32_t pivot = column;
+        while (pivot < k && square[(size_t) pivot * k + column] == 0) {
+            ++pivot;
+        }
+        if (pivot == k) {
+            return false;
+        }
+        if (pivot != column) {
+            std::swap_ranges(&square[(size_t) pivot * k], &square[(size_t) pivot * k] + k,
+                             &square[(size_t) column * k]);
+            std::swap_ranges(&inverse[(size_t) pivot * k], &inverse[(size_t) pivot * k] + k,
+                             &inverse[(size_t) column * k]);
+        }
+        uint8_t scale = Inverse(square[(size_t) column * k + column]);
+        for (uint32_t j = 0; j < k; ++j) {
+            square[(size_t) column * k + j] = Multiply(square[(size_t) column * k + j], scale);
+            inverse[(size_t) column * k + j] = Multiply(inverse[(size_t) column * k + j], scale);
+        }
+        for (uint32_t row = 0; row < k; ++row) {
+            uint8_t factor = square[(size_t) row * k + column];
+            if (row == column || factor == 0) {
+                continue;
+            }
+            for (uint32_t j = 0; j < k; ++j) {
+                square[(size_t) row * k + j] ^= Multiply(factor, square[(size_t) column * k + j]);
+                inverse[(size_t) row * k + j] ^= Multiply(factor, inverse[(size_t) column * k + j]);
+            }
+        }
+    }
+    return true;
+}
+} // namespace Fleet::DataManager::Storage
@@ -0,0 +1,132 @@
+/**
+ * @file ErasureCode.h
+ * @brief 纠删码
+ * @details 基于GF(2^8)的系统Reed-Solomon编码，将数据切分为k个数据分片并生成m个校验分片，任意k个分片即可恢复原始数据
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_ERASURE_CODE_H
+#define FLEET_DATA_MANAGER_STORAGE_ERASURE_CODE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief 纠删码类
+ * @details 编码矩阵上部为单位矩阵，下部为Cauchy矩阵，任意k行组成的子矩阵均可逆。
+ * 分片的乘加运算按CPU能力在运行时选择AVX2、SSSE3、NEON或标量实现，
+ * 向量实现使用按半字节拆分的乘法查找表
+ * @note 编码和解码为只读操作，同一对象可被多个线程同时使用
+ */
+class ErasureCode {
+  public:
+    /**
+     * @brief 构造纠删码
+     * @param[in] dataFragments 数据分片数量k，至少为1
+     * @param[in] parityFragments 校验分片数量m，k + m不超过255
+     */
+    ErasureCode(uint32_t dataFragments, uint32_t parityFragments);
+
+    /**
+     * @brief 析构函数
+     */
+    virtual ~ErasureCode() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    ErasureCode(const ErasureCode &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    ErasureCode &operator=(const ErasureCode &) = delete;
+
+    /**
+     * @brief 解析存储策略的容错纠错算法
+     * @details 纠删码的算法名称形如rs-k-m，例如rs-4-2表示4个数据分片和2个校验分片，不区分大小写
+     * @param[in] algorithm 容错纠错算法名称
+     * @param[out] dataFragments 数据分片数量
+     * @param[out] parityFragments 校验分片数量
+     * @return 是合法的纠删码算法名称返回true，否则返回false
+     */
+    static bool Parse(const std::string &algorithm, uint32_t &dataFragments,
+                      uint32_t &parityFragments);
+
+    /**
+     * @brief 获取数据分片数量
+     * @return 数据分片数量k
+     */
+    uint32_t GetDataFragments() const;
+
+    /**
+     * @brief 获取校验分片数量
+     * @return 校验分片数量m
+     */
+    uint32_t GetParityFragments() const;
+
+    /**
+     * @brief 计算分片大小
+     * @param[in] size 原始数据大小
+     * @return 每个分片的大小，最后一个数据分片不足的部分以0填充
+     */
+    uint64_t GetFragmentSize(uint64_t size) const;
+
+    /**
+     * @brief 编码
+     * @param[in] data 原始数据
+     * @param[in] size 原始数据大小
+     * @param[out] fragments k + m个分片缓冲区，每个大小为GetFragmentSize(size)
+     * @return 编码成功返回true，分片数量不符返回false
+     */
+    bool Encode(const char *data, uint64_t size, const std::vector<char *> &fragments) const;
+
+    /**
+     * @brief 解码
+     * @details 数据分片齐全时直接拼接，否则选取k个可用分片求逆矩阵恢复缺失的数据分片
+     * @param[in] fragments k + m个分片，缺失的分片为nullptr
+     * @param[in] fragmentSize 分片大小
+     * @param[out] output 原始数据输出缓冲区
+     * @param[in] size 原始数据大小
+     * @return 解码成功返回true，可用分片少于k个或参数不符返回false
+     */
+    bool Decode(const std::vector<const char *> &fragments, uint64_t fragmentSize, char *output,
+                uint64_t size) const;
+
+    /**
+     * @brief 获取当前使用的乘加运算实现
+     * @return 实现名称，为avx2、ssse3、neon或scalar
+     */
+    static std::string GetKernelName();
+
+    /**
+     * @brief 指定乘加运算实现
+     * @details 用于排查问题或对比性能，默认按CPU能力自动选择
+     * @param[in] name 实现名称
+     * @return CPU支持该实现返回true，否则返回false且不改变当前实现
+     */
+    static bool SetKernel(const std::string &name);
+
+  private:
+    /// 数据分片数量
+    uint32_t dataFragments;
+
+    /// 校验分片数量
+    uint32_t parityFragments;
+
+    /// 编码矩阵，(k + m)行k列，按行存放
+    std::vector<uint8_t> matrix;
+
+    /**
+     * @brief 求k阶方阵的逆
+     * @param[in,out] square 方阵，按行存放，求逆后内容被破坏
+     * @param[out] inverse 逆矩阵
+     * @return 方阵可逆返回true，否则返回false
+     */
+    bool Invert(std::vector<uint8_t> &square, std::vector<uint8_t> &inverse) const;
+};
+} // namespace Fleet::DataManager::Storage
+#endif // FLEET_DATA_MANAGER_STORAGE_ERASURE_CODE_H
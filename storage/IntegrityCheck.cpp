@@ -0,0 +1,841 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#include "IntegrityCheck.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FLEET_INTEGRITY_CHECK_X86
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#define FLEET_INTEGRITY_CHECK_ARM
+#endif
+
+namespace Fleet::DataManager::Storage {
+namespace {
+uint32_t ReadUInt32(const uint8_t *data) {
+    uint32_t ret = 0;
+    memcpy(&ret, data, sizeof(ret));
+    return ret;
+}
+
+uint64_t ReadUInt64(const uint8_t *data) {
+    uint64_t ret = 0;
+    memcpy(&ret, data, sizeof(ret));
+    return ret;
+}
+
+uint64_t RotateLeft64(uint64_t value, uint32_t bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint32_t RotateRight32(uint32_t value, uint32_t bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+// ---------------------------------------------------------------------------
+// CRC32C，多项式0x1EDC6F41，按位反转形式为0x82F63B78
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief CRC32C的slicing-by-8查找表，供不支持硬件指令的CPU使用
+ */
+struct Crc32cTables {
+    /// 第k张表为单字节后跟k个零字节的CRC
+    uint32_t table[8][256];
+
+    Crc32cTables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+            }
+            this->table[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int k = 1; k < 8; ++k) {
+                uint32_t previous = this->table[k - 1][i];
+                this->table[k][i] = (previous >> 8) ^ this->table[0][previous & 0xFF];
+            }
+        }
+    }
+};
+
+const Crc32cTables &Crc32cTable() {
+    static const Crc32cTables tables;
+    return tables;
+}
+
+/// CRC32C计算函数，destination不为nullptr时同时复制数据，crc为取反后的中间值
+using Crc32cFunction = uint32_t (*)(uint32_t crc, char *destination, const uint8_t *source,
+                                    size_t size);
+
+uint32_t Crc32cScalar(uint32_t crc, char *destination, const uint8_t *source, size_t size) {
+    const auto &table = Crc32cTable().table;
+    if (destination != nullptr) {
+        memcpy(destination, source, size);
+    }
+    while (size >= 8) {
+        uint32_t low = ReadUInt32(source) ^ crc;
+        uint32_t high = ReadUInt32(source + 4);
+        crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^
+              table[4][low >> 24] ^ table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^
+              table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+        source += 8;
+        size -= 8;
+    }
+    while (size > 0) {
+        crc = table[0][(crc ^ *source) & 0xFF] ^ (crc >> 8);
+        ++source;
+        --size;
+    }
+    return crc;
+}
+
+#if defined(FLEET_INTEGRITY_CHECK_X86) && defined(__x86_64__)
+__attribute__((target("sse4.2"))) uint32_t Crc32cSse42(uint32_t crc, char *destination,
+                                                        const uint8_t *source, size_t size) {
+    uint64_t value = crc;
+    if (destination != nullptr) {
+        // 每个8字节字在寄存器中同时完成校验和写出，数据只读取一次
+        while (size >= 8) {
+            uint64_t word = ReadUInt64(source);
+            value = _mm_crc32_u64(value, word);
+            memcpy(destination, &word, sizeof(word));
+            source += 8;
+            destination += 8;
+            size -= 8;
+        }
+        memcpy(destination, source, size);
+    } else {
+        while (size >= 8) {
+            value = _mm_crc32_u64(value, ReadUInt64(source));
+            source += 8;
+            size -= 8;
+        }
+    }
+    crc = (uint32_t) value;
+    while (size > 0) {
+        crc = _mm_crc32_u8(crc, *source);
+        ++source;
+        --size;
+    }
+    return crc;
+}
+#endif
+
+#ifdef FLEET_INTEGRITY_CHECK_ARM
+__attribute__((target("+crc"))) uint32_t Crc32cArmv8(uint32_t crc, char *destination,
+                                                      const uint8_t *source, size_t size) {
+    if (destination != nullptr) {
+        while (size >= 8) {
+            uint64_t word = ReadUInt64(source);
+            crc = __crc32cd(crc, word);
+            memcpy(destination, &word, sizeof(word));
+            source += 8;
+            destination += 8;
+            size -= 8;
+        }
+        memcpy(destination, source, size);
+    } else {
+        while (size >= 8) {
+            crc = __crc32cd(crc, ReadUInt64(source));
+            source += 8;
+            size -= 8;
+        }
+    }
+    while (size > 0) {
+        crc = __crc32cb(crc, *source);
+        ++source;
+        --size;
+    }
+    return crc;
+}
+#endif
+
+/**
+ * @brief CRC32C实现
+ */
+struct Crc32cKernel {
+    /// 实现名称
+    const char *name;
+    /// 计算函数
+    Crc32cFunction function;
+};
+
+const Crc32cKernel &CurrentCrc32cKernel() {
+    static const Crc32cKernel kernel = []() {
+#if defined(FLEET_INTEGRITY_CHECK_X86) && defined(__x86_64__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse4.2")) {
+            return Crc32cKernel{"sse4.2", Crc32cSse42};
+        }
+#endif
+#ifdef FLEET_INTEGRITY_CHECK_ARM
+        if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+            return Crc32cKernel{"armv8", Crc32cArmv8};
+        }
+#endif
+        return Crc32cKernel{"scalar", Crc32cScalar};
+    }();
+    return kernel;
+}
+
+// ---------------------------------------------------------------------------
+// XXH3 64位，种子为0
+// ---------------------------------------------------------------------------
+
+/// XXH3默认密钥
+alignas(64) constexpr uint8_t Xxh3Secret[192] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+constexpr uint64_t Prime32_1 = 0x9E3779B1u;
+constexpr uint64_t Prime32_2 = 0x85EBCA77u;
+constexpr uint64_t Prime32_3 = 0xC2B2AE3Du;
+constexpr uint64_t Prime64_1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t Prime64_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t Prime64_3 = 0x165667B19E3779F9ull;
+constexpr uint64_t Prime64_4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64_t Prime64_5 = 0x27D4EB2F165667C5ull;
+constexpr uint64_t PrimeMx1 = 0x165667919E3779F9ull;
+constexpr uint64_t PrimeMx2 = 0x9FB21C651E98DF25ull;
+
+/// 每个条带的长度
+constexpr size_t Xxh3StripeSize = 64;
+/// 每个块包含的条带数，(密钥长度 - 条带长度) / 8
+constexpr size_t Xxh3StripesPerBlock = (sizeof(Xxh3Secret) - Xxh3StripeSize) / 8;
+
+uint64_t Multiply128Fold64(uint64_t left, uint64_t right) {
+    __uint128_t product = (__uint128_t) left * right;
+    return (uint64_t) product ^ (uint64_t) (product >> 64);
+}
+
+uint64_t Xxh64Avalanche(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= Prime64_2;
+    hash ^= hash >> 29;
+    hash *= Prime64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t Xxh3Avalanche(uint64_t hash) {
+    hash ^= hash >> 37;
+    hash *= PrimeMx1;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t Xxh3Rrmxmx(uint64_t hash, uint64_t size) {
+    hash ^= RotateLeft64(hash, 49) ^ RotateLeft64(hash, 24);
+    hash *= PrimeMx2;
+    hash ^= (hash >> 35) + size;
+    hash *= PrimeMx2;
+    return hash ^ (hash >> 28);
+}
+
+uint64_t Xxh3Mix16(const uint8_t *input, const uint8_t *secret) {
+    return Multiply128Fold64(ReadUInt64(input) ^ ReadUInt64(secret),
+                             ReadUInt64(input + 8) ^ ReadUInt64(secret + 8));
+}
+
+uint64_t Xxh3Short(const uint8_t *input, size_t size) {
+    const uint8_t *secret = Xxh3Secret;
+    if (size > 8) {
+        uint64_t low = ReadUInt64(input) ^ (ReadUInt64(secret + 24) ^ ReadUInt64(secret + 32));
+        uint64_t high =
+            ReadUInt64(input + size - 8) ^ (ReadUInt64(secret + 40) ^ ReadUInt64(secret + 48));
+        uint64_t acc = size + __builtin_bswap64(low) + high + Multiply128Fold64(low, high);
+        return Xxh3Avalanche(acc);
+    }
+    if (size >= 4) {
+        uint64_t combined = ReadUInt32(input + size - 4) + ((uint64_t) ReadUInt32(input) << 32);
+        uint64_t keyed = combined ^ (ReadUInt64(secret + 8) ^ ReadUInt64(secret + 16));
+        return Xxh3Rrmxmx(keyed, size);
+    }
+    if (size > 0) {
+        uint32_t combined = ((uint32_t) input[0] << 16) | ((uint32_t) input[size >> 1] << 24) |
+                            (uint32_t) input[size - 1] | ((uint32_t) size << 8);
+        uint64_t keyed = (uint64_t) combined ^ (ReadUInt32(secret) ^ ReadUInt32(secret + 4));
+        return Xxh64Avalanche(keyed);
+    }
+    return Xxh64Avalanche(ReadUInt64(secret + 56) ^ ReadUInt64(secret + 64));
+}
+
+uint64_t Xxh3Medium(const uint8_t *input, size_t size) {
+    const uint8_t *secret = Xxh3Secret;
+    uint64_t acc = size * Prime64_1;
+    if (size <= 128) {
+        if (size > 32) {
+            if (size > 64) {
+                if (size > 96) {
+                    acc += Xxh3Mix16(input + 48, secret + 96);
+                    acc += Xxh3Mix16(input + size - 64, secret + 112);
+                }
+                acc += Xxh3Mix16(input + 32, secret + 64);
+                acc += Xxh3Mix16(input + size - 48, secret + 80);
+            }
+            acc += Xxh3Mix16(input + 16, secret + 32);
+            acc += Xxh3Mix16(input + size - 32, secret + 48);
+        }
+        acc += Xxh3Mix16(input, secret);
+        acc += Xxh3Mix16(input + size - 16, secret + 16);
+        return Xxh3Avalanche(acc);
+    }
+    size_t rounds = size / 16;
+    for (size_t i = 0; i < 8; ++i) {
+        acc += Xxh3Mix16(input + 16 * i, secret + 16 * i);
+    }
+    acc = Xxh3Avalanche(acc);
+    for (size_t i = 8; i < rounds; ++i) {
+        acc += Xxh3Mix16(input + 16 * i, secret + 16 * (i - 8) + 3);
+    }
+    acc += Xxh3Mix16(input + size - 16, secret + 136 - 17);
+    return Xxh3Avalanche(acc);
+}
+
+/// 累加若干条带，第s个条带使用从secret + 8 * s开始的密钥
+using Xxh3AccumulateFunction = void (*)(uint64_t *acc, const uint8_t *input,
+                                        const uint8_t *secret, size_t stripes);
+/// 每处理完一个块后打乱累加器
+using Xxh3ScrambleFunction = void (*)(uint64_t *acc, const uint8_t *secret);
+
+void Xxh3AccumulateScalar(uint64_t *acc, const uint8_t *input, const uint8_t *secret,
+                          size_t stripes) {
+    for (size_t s = 0; s < stripes; ++s) {
+        const uint8_t *stripe = input + s * Xxh3StripeSize;
+        const uint8_t *key = secret + s * 8;
+        for (size_t i = 0; i < 8; ++i) {
+            uint64_t value = ReadUInt64(stripe + 8 * i);
+            uint64_t keyed = value ^ ReadUInt64(key + 8 * i);
+            acc[i ^ 1] += value;
+            acc[i] += (keyed & 0xFFFFFFFFu) * (keyed >> 32);
+        }
+    }
+}
+
+void Xxh3ScrambleScalar(uint64_t *acc, const uint8_t *secret) {
+    for (size_t i = 0; i < 8; ++i) {
+        uint64_t value = acc[i];
+        value ^= value >> 47;
+        value ^= ReadUInt64(secret + 8 * i);
+        acc[i] = value * Prime32_1;
+    }
+}
+
+#ifdef FLEET_INTEGRITY_CHECK_X86
+__attribute__((target("avx2"))) void Xxh3AccumulateAvx2(uint64_t *acc, const uint8_t *input,
+                                                         const uint8_t *secret, size_t stripes) {
+    __m256i acc0 = _mm256_load_si256((const __m256i *) acc);
+    __m256i acc1 = _mm256_load_si256((const __m256i *) (acc + 4));
+    for (size_t s = 0; s < stripes; ++s) {
+        const uint8_t *stripe = input + s * Xxh3StripeSize;
+        const uint8_t *key = secret + s * 8;
+        __m256i value0 = _mm256_loadu_si256((const __m256i *) stripe);
+        __m256i value1 = _mm256_loadu_si256((const __m256i *) (stripe + 32));
+        __m256i keyed0 = _mm256_xor_si256(value0, _mm256_loadu_si256((const __m256i *) key));
+        __m256i keyed1 =
+            _mm256_xor_si256(value1, _mm256_loadu_si256((const __m256i *) (key + 32)));
+        __m256i product0 = _mm256_mul_epu32(keyed0, _mm256_srli_epi64(keyed0, 32));
+        __m256i product1 = _mm256_mul_epu32(keyed1, _mm256_srli_epi64(keyed1, 32));
+        // 相邻的两个64位数据交换位置后累加，对应标量实现中的acc[i ^ 1] += value
+        __m256i swapped0 = _mm256_shuffle_epi32(value0, _MM_SHUFFLE(1, 0, 3, 2));
+        __m256i swapped1 = _mm256_shuffle_epi32(value1, _MM_SHUFFLE(1, 0, 3, 2));
+        acc0 = _mm256_add_epi64(acc0, _mm256_add_epi64(product0, swapped0));
+        acc1 = _mm256_add_epi64(acc1, _mm256_add_epi64(product1, swapped1));
+    }
+    _mm256_store_si256((__m256i *) acc, acc0);
+    _mm256_store_si256((__m256i *) (acc + 4), acc1);
+}
+
+__attribute__((target("avx2"))) void Xxh3ScrambleAvx2(uint64_t *acc, const uint8_t *secret) {
+    const __m256i prime = _mm256_set1_epi32((int) Prime32_1);
+    for (size_t i = 0; i < 2; ++i) {
+        __m256i value = _mm256_load_si256((const __m256i *) (acc + 4 * i));
+        value = _mm256_xor_si256(value, _mm256_srli_epi64(value, 47));
+        value =
+            _mm256_xor_si256(value, _mm256_loadu_si256((const __m256i *) (secret + 32 * i)));
+        __m256i high = _mm256_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1));
+        __m256i productLow = _mm256_mul_epu32(value, prime);
+        __m256i productHigh = _mm256_mul_epu32(high, prime);
+        _mm256_store_si256((__m256i *) (acc + 4 * i),
+                           _mm256_add_epi64(productLow, _mm256_slli_epi64(productHigh, 32)));
+    }
+}
+#endif
+
+/**
+ * @brief XXH3长输入实现
+ */
+struct Xxh3Kernel {
+    /// 实现名称
+    const char *name;
+    /// 条带累加函数
+    Xxh3AccumulateFunction accumulate;
+    /// 累加器打乱函数
+    Xxh3ScrambleFunction scramble;
+};
+
+const Xxh3Kernel &CurrentXxh3Kernel() {
+    static const Xxh3Kernel kernel = []() {
+#ifdef FLEET_INTEGRITY_CHECK_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return Xxh3Kernel{"avx2", Xxh3AccumulateAvx2, Xxh3ScrambleAvx2};
+        }
+#endif
+        return Xxh3Kernel{"scalar", Xxh3AccumulateScalar, Xxh3ScrambleScalar};
+    }();
+    return kernel;
+}
+
+uint64_t Xxh3Long(const uint8_t *input, size_t size) {
+    const auto &kernel = CurrentXxh3Kernel();
+    const uint8_t *secret = Xxh3Secret;
+    alignas(32) uint64_t acc[8] = {Prime32_3, Prime64_1, Prime64_2, Prime64_3,
+                                   Prime64_4, Prime32_2, Prime64_5, Prime32_1};
+    size_t blockSize = Xxh3StripeSize * Xxh3StripesPerBlock;
+    size_t blocks = (size - 1) / blockSize;
+    for (size_t n = 0; n < blocks; ++n) {
+        kernel.accumulate(acc, input + n * blockSize, secret, Xxh3StripesPerBlock);
+        kernel.scramble(acc, secret + sizeof(Xxh3Secret) - Xxh3StripeSize);
+    }
+    size_t stripes = ((size - 1) - blockSize * blocks) / Xxh3StripeSize;
+    kernel.accumulate(acc, input + blocks * blockSize, secret, stripes);
+    kernel.accumulate(acc, input + size - Xxh3StripeSize,
+                      secret + sizeof(Xxh3Secret) - Xxh3StripeSize - 7, 1);
+
+    uint64_t ret = size * Prime64_1;
+    for (size_t i = 0; i < 4; ++i) {
+        ret += Multiply128Fold64(acc[2 * i] ^ ReadUInt64(secret + 11 + 16 * i),
+                                 acc[2 * i + 1] ^ ReadUInt64(secret + 11 + 16 * i + 8));
+    }
+    return Xxh3Avalanche(ret);
+}
+
+// ---------------------------------------------------------------------------
+// BLAKE3，输出32字节
+// ---------------------------------------------------------------------------
+
+constexpr uint32_t Blake3Iv[8] = {0x6A09E667u, 0xBB67AE85u, 0x3C6EF372u, 0xA54FF53Au,
+                                  0x510E527Fu, 0x9B05688Cu, 0x1F83D9ABu, 0x5BE0CD19u};
+
+/// 每轮使用的消息字顺序
+constexpr uint8_t Blake3Schedule[7][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8},
+    {3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1},
+    {10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6},
+    {12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4},
+    {9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7},
+    {11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13},
+};
+
+constexpr uint32_t Blake3BlockSize = 64;
+constexpr uint32_t Blake3ChunkSize = 1024;
+constexpr uint8_t Blake3ChunkStart = 1;
+constexpr uint8_t Blake3ChunkEnd = 2;
+constexpr uint8_t Blake3Parent = 4;
+constexpr uint8_t Blake3Root = 8;
+
+void Blake3G(uint32_t *state, int a, int b, int c, int d, uint32_t x, uint32_t y) {
+    state[a] = state[a] + state[b] + x;
+    state[d] = RotateRight32(state[d] ^ state[a], 16);
+    state[c] = state[c] + state[d];
+    state[b] = RotateRight32(state[b] ^ state[c], 12);
+    state[a] = state[a] + state[b] + y;
+    state[d] = RotateRight32(state[d] ^ state[a], 8);
+    state[c] = state[c] + state[d];
+    state[b] = RotateRight32(state[b] ^ state[c], 7);
+}
+
+/**
+ * @brief 压缩函数，结果写回cv
+ * @param[in,out] cv 链接值
+ * @param[in] block 64字节的消息块，不足部分以0填充
+ */
+void Blake3Compress(uint32_t *cv, const uint8_t *block, uint32_t blockSize, uint64_t counter,
+                    uint8_t flags) {
+    uint32_t message[16];
+    for (int i = 0; i < 16; ++i) {
+        message[i] = ReadUInt32(block + 4 * i);
+    }
+    uint32_t state[16] = {cv[0],       cv[1],       cv[2],
+                          cv[3],       cv[4],       cv[5],
+                          cv[6],       cv[7],       Blake3Iv[0],
+                          Blake3Iv[1], Blake3Iv[2], Blake3Iv[3],
+                          (uint32_t) counter,       (uint32_t) (counter >> 32),
+                          blockSize,   flags};
+    for (const auto &schedule : Blake3Schedule) {
+        Blake3G(state, 0, 4, 8, 12, message[schedule[0]], message[schedule[1]]);
+        Blake3G(state, 1, 5, 9, 13, message[schedule[2]], message[schedule[3]]);
+        Blake3G(state, 2, 6, 10, 14, message[schedule[4]], message[schedule[5]]);
+        Blake3G(state, 3, 7, 11, 15, message[schedule[6]], message[schedule[7]]);
+        Blake3G(state, 0, 5, 10, 15, message[schedule[8]], message[schedule[9]]);
+        Blake3G(state, 1, 6, 11, 12, message[schedule[10]], message[schedule[11]]);
+        Blake3G(state, 2, 7, 8, 13, message[schedule[12]], message[schedule[13]]);
+        Blake3G(state, 3, 4, 9, 14, message[schedule[14]], message[schedule[15]]);
+    }
+    for (int i = 0; i < 8; ++i) {
+        cv[i] = state[i] ^ state[i + 8];
+    }
+}
+
+/**
+ * @brief 计算单个数据块组(chunk)的链接值
+ * @param[in] input 数据，长度不超过1024字节
+ * @param[in] size 数据长度
+ * @param[in] counter 数据块组序号
+ * @param[in] rootFlags 最后一次压缩附加的标志，整个输入只有一个数据块组时为Blake3Root
+ * @param[out] cv 链接值
+ */
+void Blake3Chunk(const uint8_t *input, size_t size, uint64_t counter, uint8_t rootFlags,
+                 uint32_t *cv) {
+    memcpy(cv, Blake3Iv, sizeof(Blake3Iv));
+    size_t blocks = std::max<size_t>(1, (size + Blake3BlockSize - 1) / Blake3BlockSize);
+    for (size_t b = 0; b < blocks; ++b) {
+        size_t length = std::min<size_t>(Blake3BlockSize, size - b * Blake3BlockSize);
+        uint8_t block[Blake3BlockSize] = {};
+        if (length > 0) {
+            memcpy(block, input + b * Blake3BlockSize, length);
+        }
+        uint8_t flags = (b == 0 ? Blake3ChunkStart : 0) |
+                        (b + 1 == blocks ? Blake3ChunkEnd | rootFlags : 0);
+        Blake3Compress(cv, block, (uint32_t) length, counter, flags);
+    }
+}
+
+/// 同时计算8个完整数据块组的链接值，结果依次写入cvs
+using Blake3Chunks8Function = void (*)(const uint8_t *input, uint64_t counter, uint32_t *cvs);
+
+#ifdef FLEET_INTEGRITY_CHECK_X86
+__attribute__((target("avx2"))) inline __m256i Blake3RotateRight16(__m256i value) {
+    return _mm256_shuffle_epi8(value, _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14,
+                                                       15, 12, 13, 2, 3, 0, 1, 6, 7, 4, 5, 10,
+                                                       11, 8, 9, 14, 15, 12, 13));
+}
+
+__attribute__((target("avx2"))) inline __m256i Blake3RotateRight8(__m256i value) {
+    return _mm256_shuffle_epi8(value, _mm256_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13,
+                                                       14, 15, 12, 1, 2, 3, 0, 5, 6, 7, 4, 9,
+                                                       10, 11, 8, 13, 14, 15, 12));
+}
+
+__attribute__((target("avx2"))) inline void Blake3GAvx2(__m256i *state, int a, int b, int c,
+                                                        int d, __m256i x, __m256i y) {
+    state[a] = _mm256_add_epi32(_mm256_add_epi32(state[a], state[b]), x);
+    state[d] = Blake3RotateRight16(_mm256_xor_si256(state[d], state[a]));
+    state[c] = _mm256_add_epi32(state[c], state[d]);
+    __m256i bc = _mm256_xor_si256(state[b], state[c]);
+    state[b] = _mm256_or_si256(_mm256_srli_epi32(bc, 12), _mm256_slli_epi32(bc, 20));
+    state[a] = _mm256_add_epi32(_mm256_add_epi32(state[a], state[b]), y);
+    state[d] = Blake3RotateRight8(_mm256_xor_si256(state[d], state[a]));
+    state[c] = _mm256_add_epi32(state[c], state[d]);
+    bc = _mm256_xor_si256(state[b], state[c]);
+    state[b] = _mm256_or_si256(_mm256_srli_epi32(bc, 7), _mm256_slli_epi32(bc, 25));
+}
+
+__attribute__((target("avx2"))) void Blake3Chunks8Avx2(const uint8_t *input, uint64_t counter,
+                                                        uint32_t *cvs) {
+    // 每个向量的8个32位通道分别对应8个数据块组的同一个状态字
+    const __m256i offsets = _mm256_setr_epi32(0, 1024, 2048, 3072, 4096, 5120, 6144, 7168);
+    alignas(32) uint32_t counterLow[8];
+    alignas(32) uint32_t counterHigh[8];
+    for (uint32_t lane = 0; lane < 8; ++lane) {
+        counterLow[lane] = (uint32_t) (counter + lane);
+        counterHigh[lane] = (uint32_t) ((counter + lane) >> 32);
+    }
+    __m256i cv[8];
+    for (int i = 0; i < 8; ++i) {
+        cv[i] = _mm256_set1_epi32((int) Blake3Iv[i]);
+    }
+    for (uint32_t b = 0; b < Blake3ChunkSize / Blake3BlockSize; ++b) {
+        __m256i message[16];
+        for (int w = 0; w < 16; ++w) {
+            message[w] = _mm256_i32gather_epi32(
+                (const int *) (input + b * Blake3BlockSize + 4 * w), offsets, 1);
+        }
+        uint8_t flags = (b == 0 ? Blake3ChunkStart : 0) |
+                        (b + 1 == Blake3ChunkSize / Blake3BlockSize ? Blake3ChunkEnd : 0);
+        __m256i state[16];
+        for (int i = 0; i < 8; ++i) {
+            state[i] = cv[i];
+        }
+        for (int i = 0; i < 4; ++i) {
+            state[8 + i] = _mm256_set1_epi32((int) Blake3Iv[i]);
+        }
+        state[12] = _mm256_load_si256((const __m256i *) counterLow);
+        state[13] = _mm256_load_si256((const __m256i *) counterHigh);
+        state[14] = _mm256_set1_epi32((int) Blake3BlockSize);
+        state[15] = _mm256_set1_epi32(flags);
+        for (const auto &schedule : Blake3Schedule) {
+            Blake3GAvx2(state, 0, 4, 8, 12, message[schedule[0]], message[schedule[1]]);
+            Blake3GAvx2(state, 1, 5, 9, 13, message[schedule[2]], message[schedule[3]]);
+            Blake3GAvx2(state, 2, 6, 10, 14, message[schedule[4]], message[schedule[5]]);
+            Blake3GAvx2(state, 3, 7, 11, 15, message[schedule[6]], message[schedule[7]]);
+            Blake3GAvx2(state, 0, 5, 10, 15, message[schedule[8]], message[schedule[9]]);
+            Blake3GAvx2(state, 1, 6, 11, 12, message[schedule[10]], message[schedule[11]]);
+            Blake3GAvx2(state, 2, 7, 8, 13, message[schedule[12]], message[schedule[13]]);
+            Blake3GAvx2(state, 3, 4, 9, 14, message[schedule[14]], message[schedule[15]]);
+        }
+        for (int i = 0; i < 8; ++i) {
+            cv[i] = _mm256_xor_si256(state[i], state[i + 8]);
+        }
+    }
+    alignas(32) uint32_t words[8][8];
+    for (int i = 0; i < 8; ++i) {
+        _mm256_store_si256((__m256i *) words[i], cv[i]);
+    }
+    for (int lane = 0; lane < 8; ++lane) {
+        for (int i = 0; i < 8; ++i) {
+            cvs[lane * 8 + i] = words[i][lane];
+        }
+    }
+}
+#endif
+
+/**
+ * @brief BLAKE3实现
+ */
+struct Blake3Kernel {
+    /// 实现名称
+    const char *name;
+    /// 8路并行的数据块组函数，为nullptr时逐个计算
+    Blake3Chunks8Function chunks8;
+};
+
+const Blake3Kernel &CurrentBlake3Kernel() {
+    static const Blake3Kernel kernel = []() {
+#ifdef FLEET_INTEGRITY_CHECK_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return Blake3Kernel{"avx2", Blake3Chunks8Avx2};
+        }
+#endif
+        return Blake3Kernel{"scalar", nullptr};
+    }();
+    return kernel;
+}
+
+/**
+ * @brief 由数据块组的链接值自底向上合并出父节点的链接值
+ * @details 左子树包含小于count的最大2的幂个数据块组，与BLAKE3的树结构一致
+ */
+void Blake3Merge(const uint32_t *cvs, size_t count, uint8_t rootFlags, uint32_t *cv) {
+    if (count == 1) {
+        memcpy(cv, cvs, 8 * sizeof(uint32_t));
+        return;
+    }
+    size_t left = 1;
+    while (left * 2 < count) {
+        left *= 2;
+    }
+    uint32_t children[16];
+    Blake3Merge(cvs, left, 0, children);
+    Blake3Merge(cvs + 8 * left, count - left, 0, children + 8);
+    memcpy(cv, Blake3Iv, sizeof(Blake3Iv));
+    Blake3Compress(cv, (const uint8_t *) children, Blake3BlockSize, 0, Blake3Parent | rootFlags);
+}
+
+// ---------------------------------------------------------------------------
+
+void ComputeDigest(IntegrityAlgorithm algorithm, const char *data, uint64_t size,
+                   uint8_t *digest) {
+    switch (algorithm) {
+    case IntegrityAlgorithm::Crc32c: {
+        uint32_t crc = IntegrityCheck::Crc32c(0, data, size);
+        memcpy(digest, &crc, sizeof(crc));
+        break;
+    }
+    case IntegrityAlgorithm::Xxh3: {
+        uint64_t hash = IntegrityCheck::Xxh3(data, size);
+        memcpy(digest, &hash, sizeof(hash));
+        break;
+    }
+    case IntegrityAlgorithm::Blake3:
+        IntegrityCheck::Blake3(data, size, digest);
+        break;
+    default:
+        break;
+    }
+}
+} // namespace
+
+bool IntegrityCheck::Parse(const std::string &name, IntegrityAlgorithm &algorithm) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return (char) std::tolower(c); });
+    if (lower.empty() || lower == "none") {
+        algorithm = IntegrityAlgorithm::None;
+    } else if (lower == "crc32c") {
+        algorithm = IntegrityAlgorithm::Crc32c;
+    } else if (lower == "xxh3") {
+        algorithm = IntegrityAlgorithm::Xxh3;
+    } else if (lower == "blake3") {
+        algorithm = IntegrityAlgorithm::Blake3;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char *IntegrityCheck::GetName(IntegrityAlgorithm algorithm) {
+    switch (algorithm) {
+    case IntegrityAlgorithm::Crc32c:
+        return "crc32c";
+    case IntegrityAlgorithm::Xxh3:
+        return "xxh3";
+    case IntegrityAlgorithm::Blake3:
+        return "blake3";
+    default:
+        return "none";
+    }
+}
+
+uint32_t IntegrityCheck::GetDigestSize(IntegrityAlgorithm algorithm) {
+    switch (algorithm) {
+    case IntegrityAlgorithm::Crc32c:
+        return 4;
+    case IntegrityAlgorithm::Xxh3:
+        return 8;
+    case IntegrityAlgorithm::Blake3:
+        return 32;
+    default:
+        return 0;
+    }
+}
+
+uint64_t IntegrityCheck::GetBlockCount(uint64_t size, uint64_t blockSize) {
+    return (size + blockSize - 1) / blockSize;
+}
+
+void IntegrityCheck::Compute(IntegrityAlgorithm algorithm, const char *data, uint64_t size,
+                             uint8_t *digest) {
+    ComputeDigest(algorithm, data, size, digest);
+}
+
+void IntegrityCheck::CopyAndCompute(IntegrityAlgorithm algorithm, char *destination,
+                                    const char *source, uint64_t size, uint64_t blockSize,
+                                    uint8_t *digests) {
+    if (algorithm == IntegrityAlgorithm::None) {
+        if (size > 0) {
+            memcpy(destination, source, size);
+        }
+        return;
+    }
+    uint32_t digestSize = GetDigestSize(algorithm);
+    const auto &crc32c = CurrentCrc32cKernel();
+    for (uint64_t offset = 0; offset < size; offset += blockSize) {
+        uint64_t length = std::min(blockSize, size - offset);
+        if (algorithm == IntegrityAlgorithm::Crc32c) {
+            uint32_t crc = ~crc32c.function(~0u, destination + offset,
+                                            (const uint8_t *) source + offset, length);
+            memcpy(digests, &crc, sizeof(crc));
+        } else {
+            // 块大小远小于末级缓存，刚复制的数据在缓存中完成摘要计算
+            memcpy(destination + offset, source + offset, length);
+            ComputeDigest(algorithm, destination + offset, length, digests);
+        }
+        digests += digestSize;
+    }
+}
+
+bool IntegrityCheck::Verify(IntegrityAlgorithm algorithm, const char *data, uint64_t size,
+                            uint64_t blockSize, const uint8_t *digests, uint64_t &badBlock) {
+    if (algorithm == IntegrityAlgorithm::None) {
+        return true;
+    }
+    uint32_t digestSize = GetDigestSize(algorithm);
+    uint8_t digest[32];
+    uint64_t block = 0;
+    for (uint64_t offset = 0; offset < size; offset += blockSize, ++block) {
+        ComputeDigest(algorithm, data + offset, std::min(blockSize, size - offset), digest);
+        if (memcmp(digest, digests + block * digestSize, digestSize) != 0) {
+            badBlock = block;
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t IntegrityCheck::Crc32c(uint32_t crc, const char *data, uint64_t size) {
+    return ~CurrentCrc32cKernel().function(~crc, nullptr, (const uint8_t *) data, size);
+}
+
+uint64_t IntegrityCheck::Xxh3(const char *data, uint64_t size) {
+    const auto *input = (const uint8_t *) data;
+    if (size <= 16) {
+        return Xxh3Short(input, size);
+    }
+    if (size <= 240) {
+        return Xxh3Medium(input, size);
+    }
+    return Xxh3Long(input, size);
+}
+
+void IntegrityCheck::Blake3(const char *data, uint64_t size, uint8_t *digest) {
+    const auto *input = (const uint8_t *) data;
+    uint32_t cv[8];
+    if (size <= Blake3ChunkSize) {
+        Blake3Chunk(input, size, 0, Blake3Root, cv);
+        memcpy(digest, cv, sizeof(cv));
+        return;
+    }
+    size_t chunks = (size + Blake3ChunkSize - 1) / Blake3ChunkSize;
+    // 默认的64KiB校验块只有64个数据块组，链接值放在栈上
+    uint32_t local[64 * 8];
+    std::vector<uint32_t> heap;
+    uint32_t *cvs = local;
+    if (chunks > 64) {
+        heap.resize(chunks * 8);
+        cvs = heap.data();
+    }
+    const auto &kernel = CurrentBlake3Kernel();
+    size_t done = 0;
+    if (kernel.chunks8 != nullptr) {
+        // 只批量处理完整的数据块组，最后不满的数据块组单独计算
+        for (; done + 8 <= size / Blake3ChunkSize; done += 8) {
+            kernel.chunks8(input + done * Blake3ChunkSize, done, cvs + done * 8);
+        }
+    }
+    for (; done < chunks; ++done) {
+        size_t offset = done * Blake3ChunkSize;
+        Blake3Chunk(input + offset, std::min<size_t>(Blake3ChunkSize, size - offset), done, 0,
+                    cvs + done * 8);
+    }
+    Blake3Merge(cvs, chunks, Blake3Root, cv);
+    memcpy(digest, cv, sizeof(cv));
+}
+
+std::string IntegrityCheck::GetKernelName(IntegrityAlgorithm algorithm) {
+    switch (algorithm) {
+    case IntegrityAlgorithm::Crc32c:
+        return CurrentCrc32cKernel().name;
+    case IntegrityAlgorithm::Xxh3:
+        return CurrentXxh3Kernel().name;
+    case IntegrityAlgorithm::Blake3:
+        return CurrentBlake3Kernel().name;
+    default:
+        return "none";
+    }
+}
+} // namespace Fleet::DataManager::Storage
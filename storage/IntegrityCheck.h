@@ -0,0 +1,144 @@
+/**
+ * @file IntegrityCheck.h
+ * @brief 完整性校验
+ * @details 提供CRC32C、XXH3和BLAKE3三种按块计算的校验算法，供段文件记录保存数据的逐块摘要
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_INTEGRITY_CHECK_H
+#define FLEET_DATA_MANAGER_STORAGE_INTEGRITY_CHECK_H
+
+#include <cstdint>
+#include <string>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief 完整性校验算法，取值写入段文件，不能修改已有的值
+ */
+enum class IntegrityAlgorithm : uint8_t {
+    /// 不校验数据
+    None = 0,
+    /// CRC32C，4字节摘要，x86使用SSE4.2指令，ARMv8使用CRC扩展指令
+    Crc32c = 1,
+    /// XXH3 64位，8字节摘要，x86按CPU能力使用AVX2
+    Xxh3 = 2,
+    /// BLAKE3，32字节摘要，x86按CPU能力使用AVX2同时处理8个数据块
+    Blake3 = 3,
+};
+
+/**
+ * @brief 完整性校验类
+ * @details 数据按固定大小切分为块，每块单独计算摘要，校验失败时可以定位到具体的块。
+ * 写入时在复制数据的同时计算摘要，每块复制后立即在缓存中完成计算，不需要再次遍历全部数据
+ * @note 所有方法均为无状态的静态方法，可被多个线程同时调用
+ */
+class IntegrityCheck {
+  public:
+    /**
+     * @brief 禁用构造函数
+     */
+    IntegrityCheck() = delete;
+
+    /**
+     * @brief 解析存储策略的完整性校验算法
+     * @details 名称不区分大小写，为crc32c、xxh3或blake3，空字符串和none表示不校验
+     * @param[in] name 完整性校验算法名称
+     * @param[out] algorithm 校验算法
+     * @return 是合法的算法名称返回true，否则返回false
+     */
+    static bool Parse(const std::string &name, IntegrityAlgorithm &algorithm);
+
+    /**
+     * @brief 获取校验算法名称
+     * @param[in] algorithm 校验算法
+     * @return 算法名称
+     */
+    static const char *GetName(IntegrityAlgorithm algorithm);
+
+    /**
+     * @brief 获取单个块的摘要长度
+     * @param[in] algorithm 校验算法
+     * @return 摘要长度，单位字节，不校验时为0
+     */
+    static uint32_t GetDigestSize(IntegrityAlgorithm algorithm);
+
+    /**
+     * @brief 计算数据的块数
+     * @param[in] size 数据大小
+     * @param[in] blockSize 块大小
+     * @return 块数，最后一块可以不满
+     */
+    static uint64_t GetBlockCount(uint64_t size, uint64_t blockSize);
+
+    /**
+     * @brief 计算单块数据的摘要
+     * @param[in] algorithm 校验算法
+     * @param[in] data 数据
+     * @param[in] size 数据大小
+     * @param[out] digest 摘要输出缓冲区，长度为GetDigestSize(algorithm)
+     */
+    static void Compute(IntegrityAlgorithm algorithm, const char *data, uint64_t size,
+                        uint8_t *digest);
+
+    /**
+     * @brief 复制数据并逐块计算摘要
+     * @details 每复制一块立即计算该块的摘要，CRC32C在同一个循环中完成读取、校验和写入
+     * @param[in] algorithm 校验算法
+     * @param[out] destination 目标缓冲区
+     * @param[in] source 源数据
+     * @param[in] size 数据大小
+     * @param[in] blockSize 块大小
+     * @param[out] digests 摘要输出缓冲区，长度为块数乘以摘要长度
+     */
+    static void CopyAndCompute(IntegrityAlgorithm algorithm, char *destination,
+                               const char *source, uint64_t size, uint64_t blockSize,
+                               uint8_t *digests);
+
+    /**
+     * @brief 逐块校验数据
+     * @param[in] algorithm 校验算法
+     * @param[in] data 数据，起始位置必须与块边界对齐
+     * @param[in] size 数据大小
+     * @param[in] blockSize 块大小
+     * @param[in] digests data第一块对应的摘要
+     * @param[out] badBlock 第一个校验失败的块相对data的序号
+     * @return 全部块校验通过返回true，否则返回false
+     */
+    static bool Verify(IntegrityAlgorithm algorithm, const char *data, uint64_t size,
+                       uint64_t blockSize, const uint8_t *digests, uint64_t &badBlock);
+
+    /**
+     * @brief 计算CRC32C
+     * @param[in] crc 之前数据的CRC32C，首次计算时为0
+     * @param[in] data 数据
+     * @param[in] size 数据大小
+     * @return 拼接上本段数据后的CRC32C
+     */
+    static uint32_t Crc32c(uint32_t crc, const char *data, uint64_t size);
+
+    /**
+     * @brief 计算XXH3 64位哈希，种子为0，使用默认密钥
+     * @param[in] data 数据
+     * @param[in] size 数据大小
+     * @return 哈希值
+     */
+    static uint64_t Xxh3(const char *data, uint64_t size);
+
+    /**
+     * @brief 计算BLAKE3哈希，输出32字节
+     * @param[in] data 数据
+     * @param[in] size 数据大小
+     * @param[out] digest 32字节的哈希输出缓冲区
+     */
+    static void Blake3(const char *data, uint64_t size, uint8_t *digest);
+
+    /**
+     * @brief 获取校验算法当前使用的实现
+     * @param[in] algorithm 校验算法
+     * @return 实现名称，例如sse4.2、avx2、armv8或scalar
+     */
+    static std::string GetKernelName(IntegrityAlgorithm algorithm);
+};
+} // namespace Fleet::DataManager::Storage
+#endif // FLEET_DATA_MANAGER_STORAGE_INTEGRITY_CHECK_H
@@ -0,0 +1,786 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#include "IoBackend.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <mutex>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#if defined(IORING_FEAT_RW_CUR_POS)
+#include <set>
+#include <shared_mutex>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unordered_map>
+#define FLEET_IO_URING
+#endif
+#endif
+
+namespace Fleet::DataManager::Storage {
+namespace {
+/**
+ * @brief 在调用线程上执行系统调用的后端
+ */
+class BlockingIoBackend : public IoBackend {
+  public:
+    const char *GetName() const override {
+        return "blocking";
+    }
+
+    uint32_t GetQueueDepth() const override {
+        return 1;
+    }
+
+    void RegisterFile(int) override {
+    }
+
+    void UnregisterFile(int) override {
+    }
+
+    bool Read(int fd, char *data, uint64_t size, uint64_t offset) override {
+        while (size > 0) {
+            ssize_t count = pread(fd, data, size, (off_t) offset);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            if (count == 0) {
+                errno = EIO;
+                return false;
+            }
+            data += count;
+            size -= count;
+            offset += count;
+        }
+        return true;
+    }
+
+    bool ReadBatch(const std::vector<IoRequest> &requests) override {
+        for (const auto &request : requests) {
+            if (!this->Read(request.fd, request.data, request.size, request.offset)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Write(int fd, const char *data, uint64_t size, uint64_t offset, bool sync) override {
+        while (size > 0) {
+            ssize_t written = pwrite(fd, data, size, (off_t) offset);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            size -= written;
+            offset += written;
+        }
+        return !sync || this->Sync(fd);
+    }
+
+    bool Sync(int fd) override {
+        return fdatasync(fd) == 0;
+    }
+};
+
+#ifdef FLEET_IO_URING
+/// 每个环的提交队列长度
+constexpr uint32_t RingEntries = 64;
+/// 每个环注册的固定缓冲区数量
+constexpr uint32_t FixedBufferCount = 8;
+/// 固定缓冲区的大小，不超过该大小的读取经由固定缓冲区
+constexpr uint64_t FixedBufferSize = 64 * 1024;
+/// 固定文件表的容量，超出后登记的文件以普通文件描述符提交
+constexpr uint32_t FixedFileCount = 4096;
+/// 单个请求的最大长度，更长的读写拆分为多次提交
+constexpr uint64_t MaxTransferSize = 1ull << 30;
+
+/**
+ * @brief 提交到环的一个操作
+ */
+struct RingOperation {
+    /// 操作码
+    uint8_t opcode;
+    /// 文件描述符
+    int fd;
+    /// 固定文件表中的位置，未注册时为-1
+    int slot;
+    /// 读写的缓冲区
+    char *data;
+    /// 读写的字节数
+    uint64_t size;
+    /// 文件内的偏移
+    uint64_t offset;
+    /// 使用的固定缓冲区序号，不使用时为-1
+    int buffer;
+    /// 是否与下一个操作链接，本操作成功后才执行下一个
+    bool link;
+    /// 已完成的字节数
+    uint64_t done;
+    /// 结果，成功为0，失败为负的错误码
+    int result;
+};
+
+/**
+ * @brief 单个io_uring
+ * @details 提交队列、完成队列和提交队列项通过mmap与内核共享，提交和等待合并为一次io_uring_enter
+ * @note 非线程安全，只由创建它的线程提交，固定文件表可由其他线程更新
+ */
+class Ring {
+  public:
+    Ring() = default;
+
+    ~Ring() {
+        if (this->sqes != nullptr) {
+            munmap(this->sqes, this->sqesSize);
+        }
+        if (this->cqRing != nullptr && this->cqRing != this->sqRing) {
+            munmap(this->cqRing, this->cqRingSize);
+        }
+        if (this->sqRing != nullptr) {
+            munmap(this->sqRing, this->sqRingSize);
+        }
+        if (this->fd >= 0) {
+            close(this->fd);
+        }
+        free(this->buffers);
+    }
+
+    Ring(const Ring &) = delete;
+
+    Ring &operator=(const Ring &) = delete;
+
+    /**
+     * @brief 创建环并注册固定文件和固定缓冲区
+     * @param[in] files 固定文件表，未使用的位置为-1
+     * @return 创建成功返回true，注册失败时不使用相应的固定资源
+     */
+    bool Setup(const std::vector<int> &files) {
+        io_uring_params params{};
+        this->fd = (int) syscall(__NR_io_uring_setup, RingEntries, &params);
+        if (this->fd < 0) {
+            return false;
+        }
+        this->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        this->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) {
+            this->sqRingSize = this->cqRingSize = std::max(this->sqRingSize, this->cqRingSize);
+        }
+        this->sqRing = Map(this->sqRingSize, IORING_OFF_SQ_RING);
+        if (this->sqRing == nullptr) {
+            return false;
+        }
+        this->cqRing = singleMap ? this->sqRing : Map(this->cqRingSize, IORING_OFF_CQ_RING);
+        this->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        this->sqes = (io_uring_sqe *) Map(this->sqesSize, IORING_OFF_SQES);
+        if (this->cqRing == nullptr || this->sqes == nullptr) {
+            return false;
+        }
+        auto *sq = (char *) this->sqRing;
+        auto *cq = (char *) this->cqRing;
+        this->sqHead = (unsigned *) (sq + params.sq_off.head);
+        this->sqTail = (unsigned *) (sq + params.sq_off.tail);
+        this->sqMask = *(unsigned *) (sq + params.sq_off.ring_mask);
+        this->sqArray = (unsigned *) (sq + params.sq_off.array);
+        this->entries = params.sq_entries;
+        this->cqHead = (unsigned *) (cq + params.cq_off.head);
+        this->cqTail = (unsigned *) (cq + params.cq_off.tail);
+        this->cqMask = *(unsigned *) (cq + params.cq_off.ring_mask);
+        this->cqes = (io_uring_cqe *) (cq + params.cq_off.cqes);
+
+        this->fixedFiles = syscall(__NR_io_uring_register, this->fd, IORING_REGISTER_FILES,
+                                   files.data(), (unsigned) files.size()) == 0;
+        // 内核5.12之前固定缓冲区计入RLIMIT_MEMLOCK，超出限制时不使用
+        if (posix_memalign((void **) &this->buffers, 4096, FixedBufferCount * FixedBufferSize) ==
+            0) {
+            iovec vectors[FixedBufferCount];
+            for (uint32_t i = 0; i < FixedBufferCount; ++i) {
+                vectors[i].iov_base = this->buffers + i * FixedBufferSize;
+                vectors[i].iov_len = FixedBufferSize;
+            }
+            this->fixedBuffers = syscall(__NR_io_uring_register, this->fd,
+                                         IORING_REGISTER_BUFFERS, vectors, FixedBufferCount) == 0;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 更新固定文件表的一个位置
+     * @param[in] slot 位置
+     * @param[in] file 文件描述符，为-1时清空该位置
+     */
+    void UpdateFile(uint32_t slot, int file) {
+        if (!this->fixedFiles) {
+            return;
+        }
+        io_uring_files_update update{};
+        update.offset = slot;
+        update.fds = (uint64_t) (uintptr_t) &file;
+        if (syscall(__NR_io_uring_register, this->fd, IORING_REGISTER_FILES_UPDATE, &update, 1) !=
+            1) {
+            // 无法保证固定文件表与登记的文件一致，之后全部以普通文件描述符提交
+            this->fixedFiles = false;
+        }
+    }
+
+    bool HasFixedFiles() const {
+        return this->fixedFiles;
+    }
+
+    bool HasFixedBuffers() const {
+        return this->fixedBuffers;
+    }
+
+    /**
+     * @brief 环是否已不可用
+     */
+    bool IsBroken() const {
+        return this->broken;
+    }
+
+    /**
+     * @brief 执行一组操作，返回前等待所有已提交的操作完成
+     * @details 短读短写的剩余部分以普通操作重新提交，读到文件末尾记为EIO。
+     * io_uring_enter意外失败时撤回内核尚未取走的操作，等待已取走的操作完成后将环标记为不可用
+     * @param[in,out] operations 操作，结果写入result
+     * @return 所有操作均成功返回true，否则返回false
+     */
+    bool Run(std::vector<RingOperation> &operations) {
+        std::vector<size_t> queue;
+        queue.reserve(operations.size());
+        for (size_t i = operations.size(); i > 0; --i) {
+            queue.push_back(i - 1);
+        }
+        uint32_t inFlight = 0;
+        bool success = true;
+        while (!queue.empty() || inFlight > 0) {
+            unsigned tail = *this->sqTail;
+            uint32_t prepared = 0;
+            // 链接的操作必须在同一次提交中，队列空间不足时整组推迟
+            while (!queue.empty() && inFlight + prepared + 2 <= this->entries) {
+                size_t index = queue.back();
+                queue.pop_back();
+                this->Prepare(operations[index], index, tail + prepared);
+                ++prepared;
+            }
+            __atomic_store_n(this->sqTail, tail + prepared, __ATOMIC_RELEASE);
+            inFlight += prepared;
+            unsigned pending = tail + prepared - __atomic_load_n(this->sqHead, __ATOMIC_ACQUIRE);
+            int ret = (int) syscall(__NR_io_uring_enter, this->fd, pending, 1,
+                                    IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                // 没有SQPOLL时内核只在io_uring_enter中读取提交队列，尚未取走的项可以直接撤回
+                int error = errno;
+                unsigned submitted = __atomic_load_n(this->sqHead, __ATOMIC_ACQUIRE);
+                inFlight -= tail + prepared - submitted;
+                __atomic_store_n(this->sqTail, submitted, __ATOMIC_RELEASE);
+                // 已取走的操作可能仍在读写调用者的缓冲区，完成之前不能返回
+                this->Drain(inFlight);
+                this->broken = true;
+                errno = error;
+                return false;
+            }
+            unsigned head = *this->cqHead;
+            while (head != __atomic_load_n(this->cqTail, __ATOMIC_ACQUIRE)) {
+                const io_uring_cqe &cqe = this->cqes[head & this->cqMask];
+                size_t index = (size_t) cqe.user_data;
+                int result = cqe.res;
+                ++head;
+                --inFlight;
+                if (!this->Complete(operations[index], result)) {
+                    queue.push_back(index);
+                } else if (operations[index].result != 0) {
+                    success = false;
+                }
+            }
+            __atomic_store_n(this->cqHead, head, __ATOMIC_RELEASE);
+        }
+        return success;
+    }
+
+    char *GetFixedBuffer(int index) const {
+        return this->buffers + index * FixedBufferSize;
+    }
+
+  private:
+    /// 环的文件描述符
+    int fd = -1;
+    /// 提交队列环的映射
+    void *sqRing = nullptr;
+    size_t sqRingSize = 0;
+    /// 完成队列环的映射，内核支持单次映射时与提交队列相同
+    void *cqRing = nullptr;
+    size_t cqRingSize = 0;
+    /// 提交队列项数组
+    io_uring_sqe *sqes = nullptr;
+    size_t sqesSize = 0;
+    unsigned *sqHead = nullptr;
+    unsigned *sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned *sqArray = nullptr;
+    unsigned entries = 0;
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe *cqes = nullptr;
+    /// 是否注册了固定文件表
+    bool fixedFiles = false;
+    /// 是否注册了固定缓冲区
+    bool fixedBuffers = false;
+    /// 固定缓冲区
+    char *buffers = nullptr;
+    /// io_uring_enter意外失败后不再使用
+    bool broken = false;
+
+    void *Map(size_t size, off_t offset) {
+        void *ret = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         this->fd, offset);
+        return ret == MAP_FAILED ? nullptr : ret;
+    }
+
+    /**
+     * @brief 丢弃已提交操作的完成事件，直到全部完成
+     * @param[in] inFlight 已被内核取走且尚未完成的操作数量
+     */
+    void Drain(uint32_t inFlight) {
+        while (true) {
+            unsigned head = *this->cqHead;
+            while (inFlight > 0 && head != __atomic_load_n(this->cqTail, __ATOMIC_ACQUIRE)) {
+                ++head;
+                --inFlight;
+            }
+            __atomic_store_n(this->cqHead, head, __ATOMIC_RELEASE);
+            if (inFlight == 0) {
+                return;
+            }
+            // 完成事件可能要等本线程进入内核时才写入完成队列，等待失败时以睡眠代替
+            if (syscall(__NR_io_uring_enter, this->fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr,
+                        0) < 0) {
+                timespec interval{0, 1000000};
+                nanosleep(&interval, nullptr);
+            }
+        }
+    }
+
+    void Prepare(const RingOperation &operation, size_t index, unsigned position) {
+        unsigned slot = position & this->sqMask;
+        io_uring_sqe *sqe = &this->sqes[slot];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = operation.opcode;
+        if (operation.slot >= 0 && this->fixedFiles) {
+            sqe->fd = operation.slot;
+            sqe->flags |= IOSQE_FIXED_FILE;
+        } else {
+            sqe->fd = operation.fd;
+        }
+        if (operation.link) {
+            sqe->flags |= IOSQE_IO_LINK;
+        }
+        if (operation.opcode == IORING_OP_FSYNC) {
+            sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+        } else if (operation.buffer >= 0) {
+            sqe->addr = (uint64_t) (uintptr_t) this->GetFixedBuffer(operation.buffer);
+            sqe->len = (uint32_t) operation.size;
+            sqe->off = operation.offset;
+            sqe->buf_index = (uint16_t) operation.buffer;
+        } else {
+            sqe->addr = (uint64_t) (uintptr_t) (operation.data + operation.done);
+            sqe->len = (uint32_t) std::min(operation.size - operation.done, MaxTransferSize);
+            sqe->off = operation.offset + operation.done;
+        }
+        sqe->user_data = index;
+        this->sqArray[slot] = slot;
+    }
+
+    /**
+     * @brief 处理一个完成事件
+     * @return 操作结束返回true，需要重新提交返回false
+     */
+    bool Complete(RingOperation &operation, int result) {
+        if (result == -EINTR || result == -EAGAIN) {
+            operation.link = false;
+            return false;
+        }
+        if (result < 0) {
+            operation.result = result;
+            return true;
+        }
+        if (operation.opcode == IORING_OP_FSYNC) {
+            operation.result = 0;
+            return true;
+        }
+        if (result == 0) {
+            operation.result = -EIO;
+            return true;
+        }
+        if (operation.buffer >= 0) {
+            memcpy(operation.data, this->GetFixedBuffer(operation.buffer), result);
+            // 剩余部分直接读入调用者的缓冲区
+            operation.buffer = -1;
+            operation.opcode = IORING_OP_READ;
+        }
+        operation.done += (uint64_t) result;
+        if (operation.done < operation.size) {
+            // 链接的后续操作已被取消，由调用者重新提交
+            operation.link = false;
+            return false;
+        }
+        operation.result = 0;
+        return true;
+    }
+};
+
+class UringIoBackend;
+
+/**
+ * @brief 线程的环，线程退出时从后端注销
+ */
+struct ThreadRing {
+    /// 所属的后端
+    std::weak_ptr<UringIoBackend> backend;
+    /// 环
+    std::unique_ptr<Ring> ring;
+    /// 创建失败后不再尝试
+    bool failed = false;
+
+    ~ThreadRing();
+};
+
+thread_local ThreadRing threadRing;
+
+/**
+ * @brief io_uring后端
+ * @details 每个发起I/O的线程使用自己的环，提交和收割不需要加锁。
+ * 登记的文件在所有环的固定文件表中占用同一个位置，新建的环注册当前的整张表。
+ * 环出错后销毁，该线程之后的I/O改用阻塞实现
+ */
+class UringIoBackend : public IoBackend, public std::enable_shared_from_this<UringIoBackend> {
+  public:
+    UringIoBackend() : files(FixedFileCount, -1) {
+    }
+
+    const char *GetName() const override {
+        return "io_uring";
+    }
+
+    uint32_t GetQueueDepth() const override {
+        return RingEntries / 2;
+    }
+
+    void RegisterFile(int fd) override {
+        std::unique_lock<std::shared_mutex> lock(this->mutex);
+        if (this->slots.find(fd) != this->slots.end()) {
+            return;
+        }
+        uint32_t slot = 0;
+        if (!this->freeSlots.empty()) {
+            slot = this->freeSlots.back();
+            this->freeSlots.pop_back();
+        } else if (this->nextSlot < FixedFileCount) {
+            slot = this->nextSlot++;
+        } else {
+            return;
+        }
+        this->slots[fd] = slot;
+        this->files[slot] = fd;
+        for (auto *ring : this->rings) {
+            ring->UpdateFile(slot, fd);
+        }
+    }
+
+    void UnregisterFile(int fd) override {
+        std::unique_lock<std::shared_mutex> lock(this->mutex);
+        auto iter = this->slots.find(fd);
+        if (iter == this->slots.end()) {
+            return;
+        }
+        uint32_t slot = iter->second;
+        this->slots.erase(iter);
+        this->files[slot] = -1;
+        for (auto *ring : this->rings) {
+            ring->UpdateFile(slot, -1);
+        }
+        this->freeSlots.push_back(slot);
+    }
+
+    bool Read(int fd, char *data, uint64_t size, uint64_t offset) override {
+        Ring *ring = this->GetRing();
+        if (ring == nullptr) {
+            return this->fallback.Read(fd, data, size, offset);
+        }
+        std::vector<RingOperation> operations(1);
+        this->PrepareRead(ring, operations[0], fd, data, size, offset, 0);
+        bool success = ring->Run(operations);
+        if (ring->IsBroken()) {
+            this->DiscardRing();
+            return this->fallback.Read(fd, data, size, offset);
+        }
+        return this->Finish(success, operations);
+    }
+
+    bool ReadBatch(const std::vector<IoRequest> &requests) override {
+        Ring *ring = this->GetRing();
+        if (ring == nullptr) {
+            return this->fallback.ReadBatch(requests);
+        }
+        std::vector<RingOperation> operations(requests.size());
+        int buffer = 0;
+        for (size_t i = 0; i < requests.size(); ++i) {
+            const auto &request = requests[i];
+            this->PrepareRead(ring, operations[i], request.fd, request.data, request.size,
+                              request.offset, buffer);
+            if (operations[i].buffer >= 0) {
+                ++buffer;
+            }
+        }
+        bool success = ring->Run(operations);
+        if (ring->IsBroken()) {
+            this->DiscardRing();
+            return this->fallback.ReadBatch(requests);
+        }
+        return this->Finish(success, operations);
+    }
+
+    bool Write(int fd, const char *data, uint64_t size, uint64_t offset, bool sync) override {
+        Ring *ring = this->GetRing();
+        if (ring == nullptr) {
+            return this->fallback.Write(fd, data, size, offset, sync);
+        }
+        int slot = this->GetSlot(fd);
+        std::vector<RingOperation> operations;
+        operations.push_back(RingOperation{IORING_OP_WRITE, fd, slot, const_cast<char *>(data),
+                                           size, offset, -1, sync, 0, 0});
+        if (sync) {
+            operations.push_back(
+                RingOperation{IORING_OP_FSYNC, fd, slot, nullptr, 0, 0, -1, false, 0, 0});
+        }
+        bool success = ring->Run(operations);
+        if (ring->IsBroken()) {
+            // 写入同一位置的同样内容，重做已完成的部分没有影响
+            this->DiscardRing();
+            return this->fallback.Write(fd, data, size, offset, sync);
+        }
+        if (success) {
+            return true;
+        }
+        // 短写后重新提交的剩余部分不再链接，被取消的落盘单独执行
+        if (sync && operations[0].result == 0 && operations[1].result == -ECANCELED) {
+            return this->Sync(fd);
+        }
+        return this->Finish(false, operations);
+    }
+
+    bool Sync(int fd) override {
+        Ring *ring = this->GetRing();
+        if (ring == nullptr) {
+            return this->fallback.Sync(fd);
+        }
+        std::vector<RingOperation> operations;
+        operations.push_back(
+            RingOperation{IORING_OP_FSYNC, fd, this->GetSlot(fd), nullptr, 0, 0, -1, false, 0, 0});
+        bool success = ring->Run(operations);
+        if (ring->IsBroken()) {
+            this->DiscardRing();
+            return this->fallback.Sync(fd);
+        }
+        return this->Finish(success, operations);
+    }
+
+    /**
+     * @brief 在调用线程上创建环并确认内核支持所需的操作
+     * @return 支持返回true，否则返回false
+     */
+    bool Probe() {
+        Ring *ring = this->GetRing();
+        if (ring == nullptr) {
+            return false;
+        }
+        // IORING_REGISTER_PROBE与IORING_OP_READ同时加入内核
+        std::vector<char> buffer(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op));
+        auto *probe = (io_uring_probe *) buffer.data();
+        io_uring_params params{};
+        int fd = (int) syscall(__NR_io_uring_setup, 1, &params);
+        if (fd < 0) {
+            return false;
+        }
+        bool supported =
+            syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) == 0;
+        close(fd);
+        for (uint8_t opcode : {(uint8_t) IORING_OP_READ, (uint8_t) IORING_OP_WRITE,
+                               (uint8_t) IORING_OP_READ_FIXED, (uint8_t) IORING_OP_FSYNC}) {
+            supported = supported && opcode <= probe->last_op &&
+                        (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;
+        }
+        return supported;
+    }
+
+    /**
+     * @brief 注销线程退出时销毁的环
+     * @param[in] ring 环
+     */
+    void Detach(Ring *ring) {
+        std::unique_lock<std::shared_mutex> lock(this->mutex);
+        this->rings.erase(ring);
+    }
+
+  private:
+    /// 互斥锁，保护固定文件表和环的集合
+    std::shared_mutex mutex;
+    /// 固定文件表，位置到文件描述符的映射，未使用的位置为-1
+    std::vector<int> files;
+    /// 文件描述符到固定文件表位置的映射
+    std::unordered_map<int, uint32_t> slots;
+    /// 注销后可以复用的位置
+    std::vector<uint32_t> freeSlots;
+    /// 从未使用过的最小位置
+    uint32_t nextSlot = 0;
+    /// 所有线程的环
+    std::set<Ring *> rings;
+    /// 无法创建环的线程使用的阻塞实现
+    BlockingIoBackend fallback;
+
+    Ring *GetRing() {
+        if (threadRing.ring != nullptr) {
+            return threadRing.ring.get();
+        }
+        if (threadRing.failed) {
+            return nullptr;
+        }
+        auto ring = std::make_unique<Ring>();
+        std::unique_lock<std::shared_mutex> lock(this->mutex);
+        if (!ring->Setup(this->files)) {
+            threadRing.failed = true;
+            return nullptr;
+        }
+        this->rings.insert(ring.get());
+        threadRing.backend = this->shared_from_this();
+        threadRing.ring = std::move(ring);
+        return threadRing.ring.get();
+    }
+
+    /**
+     * @brief 销毁本线程不可用的环，之后本线程改用阻塞实现
+     */
+    void DiscardRing() {
+        this->Detach(threadRing.ring.get());
+        threadRing.ring.reset();
+        threadRing.failed = true;
+    }
+
+    int GetSlot(int fd) {
+        std::shared_lock<std::shared_mutex> lock(this->mutex);
+        auto iter = this->slots.find(fd);
+        return iter == this->slots.end() ? -1 : (int) iter->second;
+    }
+
+    void PrepareRead(Ring *ring, RingOperation &operation, int fd, char *data, uint64_t size,
+                     uint64_t offset, int buffer) {
+        bool fixed = ring->HasFixedBuffers() && size <= FixedBufferSize &&
+                     buffer < (int) FixedBufferCount;
+        operation = RingOperation{fixed ? (uint8_t) IORING_OP_READ_FIXED : (uint8_t) IORING_OP_READ,
+                                  fd,
+                                  this->GetSlot(fd),
+                                  data,
+                                  size,
+                                  offset,
+                                  fixed ? buffer : -1,
+                                  false,
+                                  0,
+                                  0};
+    }
+
+    bool Finish(bool success, const std::vector<RingOperation> &operations) {
+        if (success) {
+            return true;
+        }
+        for (const auto &operation : operations) {
+            if (operation.result != 0) {
+                errno = -operation.result;
+                break;
+            }
+        }
+        return false;
+    }
+};
+
+ThreadRing::~ThreadRing() {
+    auto owner = this->backend.lock();
+    if (owner != nullptr && this->ring != nullptr) {
+        owner->Detach(this->ring.get());
+    }
+}
+#endif
+} // namespace
+
+std::shared_ptr<IoBackend>
+IoBackend::Create(IoBackendType type, const std::shared_ptr<Core::PluginContext> &pluginContext) {
+    if (type == IoBackendType::Blocking) {
+        return std::make_shared<BlockingIoBackend>();
+    }
+#ifdef FLEET_IO_URING
+    static std::mutex mutex;
+    static std::shared_ptr<UringIoBackend> shared;
+    static bool probed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!probed) {
+            probed = true;
+            auto backend = std::make_shared<UringIoBackend>();
+            if (backend->Probe()) {
+                shared = backend;
+            }
+        }
+        if (shared != nullptr) {
+            return shared;
+        }
+    }
+#endif
+    if (type == IoBackendType::Uring) {
+        pluginContext->LogWarn(SOURCE_LOCATION, "内核不支持io_uring, 使用阻塞I/O");
+    }
+    return std::make_shared<BlockingIoBackend>();
+}
+
+bool IoBackend::Parse(const std::string &name, IoBackendType &type) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return (char) std::tolower(c); });
+    if (lower == "blocking") {
+        type = IoBackendType::Blocking;
+    } else if (lower == "io_uring") {
+        type = IoBackendType::Uring;
+    } else if (lower == "auto") {
+        type = IoBackendType::Auto;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool IoBackend::SyncDirectory(const std::string &directory) {
+    int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool ret = fsync(fd) == 0;
+    int error = errno;
+    close(fd);
+    errno = error;
+    return ret;
+}
+} // namespace Fleet::DataManager::Storage
@@ -0,0 +1,159 @@
+/**
+ * @file IoBackend.h
+ * @brief 段文件I/O后端
+ * @details 为日志结构存储提供定位读写和落盘操作，内置阻塞系统调用和io_uring两种实现，内核不支持io_uring时退回阻塞实现
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_IO_BACKEND_H
+#define FLEET_DATA_MANAGER_STORAGE_IO_BACKEND_H
+
+#include "PluginContext.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief I/O后端类型
+ */
+enum class IoBackendType : uint8_t {
+    /// 在调用线程上执行pread、pwrite和fdatasync
+    Blocking = 0,
+    /// 每个线程一个io_uring，批量提交并收割完成事件
+    Uring = 1,
+    /// 内核支持时使用io_uring，否则使用阻塞实现
+    Auto = 2,
+};
+
+/**
+ * @brief 单个读请求
+ */
+struct IoRequest {
+    /// 文件描述符
+    int fd;
+    /// 读入的缓冲区
+    char *data;
+    /// 读取的字节数
+    uint64_t size;
+    /// 文件内的偏移
+    uint64_t offset;
+};
+
+/**
+ * @brief I/O后端接口
+ * @details 读写均为完整读写，短读和短写由后端续传，读到文件末尾视为失败。
+ * 失败时返回false并设置errno，调用者据此记录日志
+ * @note 线程安全，同一后端可被多个线程和多个存储同时使用
+ */
+class IoBackend {
+  public:
+    /**
+     * @brief 构造后端
+     */
+    IoBackend() = default;
+
+    /**
+     * @brief 析构函数
+     */
+    virtual ~IoBackend() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    IoBackend(const IoBackend &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    IoBackend &operator=(const IoBackend &) = delete;
+
+    /**
+     * @brief 获取后端名称
+     * @return 后端名称，blocking或io_uring
+     */
+    virtual const char *GetName() const = 0;
+
+    /**
+     * @brief 获取一次批量读取可以同时执行的请求数
+     * @return 同时执行的请求数，阻塞实现为1
+     */
+    virtual uint32_t GetQueueDepth() const = 0;
+
+    /**
+     * @brief 登记之后频繁读写的文件，io_uring实现将其注册为固定文件
+     * @param[in] fd 文件描述符
+     */
+    virtual void RegisterFile(int fd) = 0;
+
+    /**
+     * @brief 注销文件，必须在关闭文件描述符之前调用
+     * @param[in] fd 文件描述符
+     */
+    virtual void UnregisterFile(int fd) = 0;
+
+    /**
+     * @brief 完整读取
+     * @param[in] fd 文件描述符
+     * @param[out] data 读入的缓冲区
+     * @param[in] size 读取的字节数
+     * @param[in] offset 文件内的偏移
+     * @return 读满size字节返回true，否则返回false
+     */
+    virtual bool Read(int fd, char *data, uint64_t size, uint64_t offset) = 0;
+
+    /**
+     * @brief 批量完整读取
+     * @details io_uring实现一次提交所有请求，阻塞实现依次读取
+     * @param[in] requests 读请求，各请求的缓冲区互不重叠
+     * @return 所有请求均读满返回true，否则返回false
+     */
+    virtual bool ReadBatch(const std::vector<IoRequest> &requests) = 0;
+
+    /**
+     * @brief 完整写入
+     * @param[in] fd 文件描述符
+     * @param[in] data 数据
+     * @param[in] size 数据大小
+     * @param[in] offset 文件内的偏移
+     * @param[in] sync 写入后是否将数据刷到磁盘，io_uring实现与写入链接后一起提交
+     * @return 写入并按要求落盘成功返回true，否则返回false
+     */
+    virtual bool Write(int fd, const char *data, uint64_t size, uint64_t offset, bool sync) = 0;
+
+    /**
+     * @brief 将文件数据刷到磁盘
+     * @param[in] fd 文件描述符
+     * @return 成功返回true，否则返回false
+     */
+    virtual bool Sync(int fd) = 0;
+
+    /**
+     * @brief 创建后端
+     * @details io_uring实现在进程内共享，首次创建时探测内核支持，不支持时记录警告并返回阻塞实现
+     * @param[in] type 后端类型
+     * @param[in] pluginContext 插件上下文，用于日志记录
+     * @return 后端对象指针
+     */
+    static std::shared_ptr<IoBackend>
+    Create(IoBackendType type, const std::shared_ptr<Core::PluginContext> &pluginContext);
+
+    /**
+     * @brief 解析后端类型名称
+     * @param[in] name 后端类型名称，blocking、io_uring或auto，不区分大小写
+     * @param[out] type 后端类型
+     * @return 名称合法返回true，否则返回false
+     */
+    static bool Parse(const std::string &name, IoBackendType &type);
+
+    /**
+     * @brief 将目录落盘，使其中文件的创建、删除和重命名在掉电后仍然有效
+     * @param[in] directory 目录路径
+     * @return 成功返回true，否则返回false，errno保存失败原因
+     */
+    static bool SyncDirectory(const std::string &directory);
+};
+} // namespace Fleet::DataManager::Storage
+#endif // FLEET_DATA_MANAGER_STORAGE_IO_BACKEND_H
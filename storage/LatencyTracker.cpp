@@ -0,0 +1,103 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#include "LatencyTracker.h"
+
+namespace Fleet::DataManager::Storage {
+void LatencyTracker::Record(const std::string &deviceName, uint64_t nanoseconds) {
+    auto device = this->Find(deviceName, true);
+    std::lock_guard<std::mutex> lock(device->mutex);
+    if (device->samples == 0) {
+        device->average = nanoseconds;
+    } else {
+        // average += (sample - average) / 8，以有符号数计算避免下溢
+        device->average = (uint64_t) ((int64_t) device->average +
+                                      ((int64_t) nanoseconds - (int64_t) device->average) / 8);
+    }
+    ++device->buckets[GetBucket(nanoseconds)];
+    ++device->samples;
+    if (++device->sinceDecay < DecayInterval) {
+        return;
+    }
+    device->sinceDecay = 0;
+    device->samples = 0;
+    for (auto &bucket : device->buckets) {
+        bucket /= 2;
+        device->samples += bucket;
+    }
+}
+
+uint64_t LatencyTracker::GetAverage(const std::string &deviceName) {
+    auto device = this->Find(deviceName, false);
+    if (device == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(device->mutex);
+    return device->average;
+}
+
+uint64_t LatencyTracker::GetPercentile(const std::string &deviceName, double percentile) {
+    auto device = this->Find(deviceName, false);
+    if (device == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(device->mutex);
+    if (device->samples == 0) {
+        return 0;
+    }
+    double target = (double) device->samples * percentile / 100;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < BucketCount; ++i) {
+        seen += device->buckets[i];
+        if (seen > 0 && (double) seen >= target) {
+            return GetBucketLimit(i);
+        }
+    }
+    return GetBucketLimit(BucketCount - 1);
+}
+
+void LatencyTracker::Remove(const std::string &deviceName) {
+    std::unique_lock<std::shared_mutex> lock(this->devicesMutex);
+    this->devices.erase(deviceName);
+}
+
+std::shared_ptr<LatencyTracker::DeviceLatency> LatencyTracker::Find(const std::string &deviceName,
+                                                                    bool create) {
+    {
+        std::shared_lock<std::shared_mutex> lock(this->devicesMutex);
+        auto iter = this->devices.find(deviceName);
+        if (iter != this->devices.end()) {
+            return iter->second;
+        }
+    }
+    if (!create) {
+        return nullptr;
+    }
+    std::unique_lock<std::shared_mutex> lock(this->devicesMutex);
+    auto &device = this->devices[deviceName];
+    if (device == nullptr) {
+        device = std::make_shared<DeviceLatency>();
+    }
+    return device;
+}
+
+uint32_t LatencyTracker::GetBucket(uint64_t nanoseconds) {
+    if (nanoseconds < (1u << SubBucketBits)) {
+        return (uint32_t) nanoseconds;
+    }
+    uint32_t highest = 63 - (uint32_t) __builtin_clzll(nanoseconds);
+    uint32_t shift = highest - SubBucketBits;
+    return ((shift + 1) << SubBucketBits) +
+           (uint32_t) ((nanoseconds >> shift) & ((1u << SubBucketBits) - 1));
+}
+
+uint64_t LatencyTracker::GetBucketLimit(uint32_t bucket) {
+    if (bucket < (1u << SubBucketBits)) {
+        return bucket;
+    }
+    uint32_t shift = (bucket >> SubBucketBits) - 1;
+    uint64_t lower = ((1ull << SubBucketBits) + (bucket & ((1u << SubBucketBits) - 1))) << shift;
+    return lower + ((1ull << shift) - 1);
+}
+} // namespace Fleet::DataManager::Storage
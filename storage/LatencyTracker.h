@@ -0,0 +1,133 @@
+/**
+ * @file LatencyTracker.h
+ * @brief 设备读取延迟统计
+ * @details 按设备记录读取延迟的指数加权移动平均和近期分布，用于选择副本和确定对冲读取的等待时间
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_LATENCY_TRACKER_H
+#define FLEET_DATA_MANAGER_STORAGE_LATENCY_TRACKER_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief 延迟统计类
+ * @details 每个设备保存一个平滑系数为1/8的移动平均值和一个对数分桶的直方图。
+ * 每个2的幂区间再等分为4个桶，分位数的相对误差不超过25%。
+ * 每记录DecayInterval个样本后所有桶减半，使分布跟随设备状态的变化
+ * @note 线程安全
+ */
+class LatencyTracker {
+  public:
+    /**
+     * @brief 构造延迟统计
+     */
+    LatencyTracker() = default;
+
+    /**
+     * @brief 析构函数
+     */
+    virtual ~LatencyTracker() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    LatencyTracker(const LatencyTracker &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    LatencyTracker &operator=(const LatencyTracker &) = delete;
+
+    /**
+     * @brief 记录一次读取的延迟
+     * @param[in] deviceName 设备名称
+     * @param[in] nanoseconds 延迟，单位纳秒
+     */
+    void Record(const std::string &deviceName, uint64_t nanoseconds);
+
+    /**
+     * @brief 获取设备的平均延迟
+     * @param[in] deviceName 设备名称
+     * @return 移动平均延迟，单位纳秒，没有样本时返回0
+     */
+    uint64_t GetAverage(const std::string &deviceName);
+
+    /**
+     * @brief 获取设备近期延迟的分位数
+     * @param[in] deviceName 设备名称
+     * @param[in] percentile 百分位，介于0和100之间
+     * @return 分位数所在桶的上界，单位纳秒，没有样本时返回0
+     */
+    uint64_t GetPercentile(const std::string &deviceName, double percentile);
+
+    /**
+     * @brief 删除设备的统计
+     * @param[in] deviceName 设备名称
+     */
+    void Remove(const std::string &deviceName);
+
+  private:
+    /// 每个2的幂区间的桶数的对数
+    static constexpr uint32_t SubBucketBits = 2;
+
+    /// 桶数，覆盖64位纳秒值
+    static constexpr uint32_t BucketCount = 64 << SubBucketBits;
+
+    /// 直方图衰减的样本间隔
+    static constexpr uint32_t DecayInterval = 1024;
+
+    /**
+     * @brief 单个设备的统计
+     */
+    struct DeviceLatency {
+        /// 互斥锁
+        std::mutex mutex;
+        /// 移动平均延迟，单位纳秒
+        uint64_t average = 0;
+        /// 直方图中的样本数
+        uint64_t samples = 0;
+        /// 上次衰减后记录的样本数
+        uint32_t sinceDecay = 0;
+        /// 直方图
+        std::array<uint64_t, BucketCount> buckets{};
+    };
+
+    /// 设备表互斥锁
+    std::shared_mutex devicesMutex;
+
+    /// 设备名称到统计的映射
+    std::map<std::string, std::shared_ptr<DeviceLatency>> devices;
+
+    /**
+     * @brief 查找设备的统计
+     * @param[in] deviceName 设备名称
+     * @param[in] create 不存在时是否创建
+     * @return 设备的统计，不存在且不创建时返回nullptr
+     */
+    std::shared_ptr<DeviceLatency> Find(const std::string &deviceName, bool create);
+
+    /**
+     * @brief 计算延迟所在的桶
+     * @param[in] nanoseconds 延迟，单位纳秒
+     * @return 桶序号
+     */
+    static uint32_t GetBucket(uint64_t nanoseconds);
+
+    /**
+     * @brief 计算桶的上界
+     * @param[in] bucket 桶序号
+     * @return 桶内最大的延迟，单位纳秒
+     */
+    static uint64_t GetBucketLimit(uint32_t bucket);
+};
+} // namespace Fleet::DataManager::Storage
+#endif // FLEET_DATA_MANAGER_STORAGE_LATENCY_TRACKER_H
@@ -0,0 +1,1409 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#include "LogStructuredStore.h"
+#include "IntegrityCheck.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <filesystem>
+#include <future>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+namespace {
+/// 记录魔数
+constexpr uint32_t RecordMagic = 0x47534C46;
+/// 记录头长度。布局为：魔数(4) 校验和(4) 类型(1) 数据校验算法(1) 校验块大小的对数(1)
+/// 标志(1) 键区长度(4) 数据大小(8) 写入序号(8)，之后依次为键区、数据和摘要表
+constexpr uint64_t RecordHeaderSize = 32;
+/// 记录标志：键之后附带8字节的过期时间，计入键区长度
+constexpr uint8_t RecordFlagExpiry = 0x01;
+/// 记录标志：键和过期时间之后附带8字节的写入标识，计入键区长度
+constexpr uint8_t RecordFlagWriteId = 0x02;
+/// 过期时间的长度
+constexpr uint32_t ExpirySize = 8;
+/// 写入标识的长度
+constexpr uint32_t WriteIdSize = 8;
+/// 记录类型：数据
+constexpr uint8_t RecordTypePut = 0;
+/// 记录类型：墓碑
+constexpr uint8_t RecordTypeTombstone = 1;
+/// 校验块大小对数的下限
+constexpr uint8_t MinBlockShift = 9;
+/// 校验块大小对数的上限
+constexpr uint8_t MaxBlockShift = 30;
+/// 读取记录时每批读入的字节数，同时提交的几批读完立即校验，数据仍在缓存中
+constexpr uint64_t ReadBatchSize = 1024 * 1024;
+/// 段文件名前缀
+const char *const SegmentPrefix = "segment-";
+/// 段文件名后缀
+const char *const SegmentSuffix = ".log";
+
+/**
+ * @brief 计算记录头校验和，覆盖记录头中校验和之后的部分、键和摘要表
+ */
+uint32_t HeadChecksum(const char *headerAndKey, uint32_t keySize, const uint8_t *digests,
+                      uint64_t digestsSize) {
+    uint32_t crc = IntegrityCheck::Crc32c(0, headerAndKey + 8, RecordHeaderSize - 8 + keySize);
+    return IntegrityCheck::Crc32c(crc, (const char *) digests, digestsSize);
+}
+
+/**
+ * @brief 填写记录头中除校验和以外的字段
+ */
+void EncodeHead(char *record, uint8_t type, uint8_t flags, IntegrityAlgorithm algorithm,
+                uint8_t blockShift, uint32_t keySize, uint64_t valueSize, uint64_t sequence) {
+    memcpy(record, &RecordMagic, sizeof(RecordMagic));
+    record[8] = (char) type;
+    record[9] = (char) algorithm;
+    record[10] = (char) blockShift;
+    record[11] = (char) flags;
+    memcpy(record + 12, &keySize, sizeof(keySize));
+    memcpy(record + 16, &valueSize, sizeof(valueSize));
+    memcpy(record + 24, &sequence, sizeof(sequence));
+}
+
+/**
+ * @brief 从段文件名解析段编号，文件名必须为前缀、十进制数字和后缀，编号不超过32位
+ */
+bool ParseSegmentId(const std::string &fileName, uint32_t &id) {
+    size_t prefixSize = strlen(SegmentPrefix);
+    size_t suffixSize = strlen(SegmentSuffix);
+    if (fileName.size() <= prefixSize + suffixSize ||
+        fileName.compare(fileName.size() - suffixSize, suffixSize, SegmentSuffix) != 0) {
+        return false;
+    }
+    uint64_t value = 0;
+    for (size_t i = prefixSize; i < fileName.size() - suffixSize; ++i) {
+        if (fileName[i] < '0' || fileName[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (uint64_t) (fileName[i] - '0');
+        if (value > UINT32_MAX) {
+            return false;
+        }
+    }
+    id = (uint32_t) value;
+    return true;
+}
+
+/**
+ * @brief 获取当前的Unix时间戳，单位秒
+ */
+uint64_t Now() {
+    return (uint64_t) time(nullptr);
+}
+
+/**
+ * @brief 判断过期时间是否已到
+ */
+bool IsExpired(uint64_t expiry, uint64_t now) {
+    return expiry != 0 && expiry <= now;
+}
+
+/**
+ * @brief 计算键之后附带字段的长度
+ */
+uint32_t GetExtraSize(uint64_t expiry, uint64_t writeId) {
+    return (expiry != 0 ? ExpirySize : 0) + (writeId != 0 ? WriteIdSize : 0);
+}
+} // namespace
+
+LogStructuredStore::Segment::~Segment() {
+    if (this->directFd >= 0) {
+        this->io->UnregisterFile(this->directFd);
+        close(this->directFd);
+    }
+    if (this->fd >= 0) {
+        if (this->io != nullptr) {
+            this->io->UnregisterFile(this->fd);
+        }
+        close(this->fd);
+    }
+}
+
+LogStructuredStore::LogStructuredStore(const std::shared_ptr<Core::PluginContext> &pluginContext,
+                                       const std::string &directory,
+                                       const LogStructuredStoreOptions &options)
+    : pluginContext(pluginContext), directory(directory), options(options),
+      io(IoBackend::Create(options.ioBackend, pluginContext)),
+      readDepth(std::max(1u, std::min(options.readQueueDepth, this->io->GetQueueDepth()))),
+      bufferPool(options.directBufferPoolSize),
+      integrityBlockShift(MinBlockShift), nextSequence(1), stopping(false), commitStopping(true),
+      syncFailed(false), opened(false),
+      usedBytes(0) {
+    while (this->integrityBlockShift < MaxBlockShift &&
+           (2ull << this->integrityBlockShift) <= options.integrityBlockSize) {
+        ++this->integrityBlockShift;
+    }
+}
+
+LogStructuredStore::~LogStructuredStore() {
+    this->Close();
+}
+
+bool LogStructuredStore::Open() {
+    this->pluginContext->LogTrace(SOURCE_LOCATION, "调用");
+    std::error_code errorCode;
+    std::filesystem::create_directories(this->directory, errorCode);
+    if (errorCode) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "无法创建目录 {} ({})", this->directory,
+                                      errorCode.message());
+        this->pluginContext->LogTrace(SOURCE_LOCATION, "返回");
+        return false;
+    }
+
+    std::vector<uint32_t> ids;
+    for (const auto &entry : std::filesystem::directory_iterator(this->directory, errorCode)) {
+        std::string fileName = entry.path().filename().string();
+        if (fileName.rfind(SegmentPrefix, 0) != 0) {
+            continue;
+        }
+        uint32_t id = 0;
+        if (!ParseSegmentId(fileName, id)) {
+            this->pluginContext->LogWarn(SOURCE_LOCATION, "忽略目录 {} 中无法识别的文件 {}",
+                                         this->directory, fileName);
+            continue;
+        }
+        ids.push_back(id);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    std::map<std::string, uint64_t> tombstones;
+    for (const auto &id : ids) {
+        auto segment = std::make_shared<Segment>();
+        segment->id = id;
+        segment->path = this->SegmentPath(id);
+        segment->fd = open(segment->path.c_str(), O_RDWR | O_CLOEXEC);
+        if (segment->fd < 0) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "无法打开段文件 {} ({})",
+                                          segment->path, strerror(errno));
+            this->pluginContext->LogTrace(SOURCE_LOCATION, "返回");
+            return false;
+        }
+        segment->io = this->io;
+        this->io->RegisterFile(segment->fd);
+        struct stat fileStat {};
+        fstat(segment->fd, &fileStat);
+        segment->size = (uint64_t) fileStat.st_size;
+        this->segments[id] = segment;
+        if (!this->Recover(segment, tombstones, id == ids.back())) {
+            this->pluginContext->LogTrace(SOURCE_LOCATION, "返回");
+            return false;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->appendMutex);
+        if (!this->OpenSegment(ids.empty() ? 1 : ids.back() + 1)) {
+            this->pluginContext->LogTrace(SOURCE_LOCATION, "返回");
+            return false;
+        }
+    }
+    {
+        // 之后又被成功写入或删除的键不再需要修复
+        std::lock_guard<std::mutex> lock(this->damagedMutex);
+        for (auto iter = this->damaged.begin(); iter != this->damaged.end();) {
+            auto entry = this->index.find(iter->first);
+            auto deleted = tombstones.find(iter->first);
+            if ((entry != this->index.end() && entry->second.sequence > iter->second) ||
+                (deleted != tombstones.end() && deleted->second > iter->second)) {
+                iter = this->damaged.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+        if (!this->damaged.empty()) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "日志结构存储 {} 中有 {} 个键数据损坏",
+                                          this->directory, this->damaged.size());
+        }
+    }
+    this->pluginContext->LogInfo(SOURCE_LOCATION, "已打开日志结构存储 {}, 共 {} 个段, {} 条记录",
+                                 this->directory, this->segments.size(), this->index.size());
+
+    this->stopping = false;
+    this->syncFailed = false;
+    {
+        std::lock_guard<std::mutex> lock(this->commitMutex);
+        this->commitStopping = false;
+    }
+    // 恢复期间不累加共享计数，打开失败时不会留下偏差
+    if (this->usageCounter != nullptr) {
+        this->usageCounter->fetch_add(this->usedBytes.load(), std::memory_order_relaxed);
+    }
+    this->opened = true;
+    this->compactionThread = std::thread([this]() { this->CompactionLoop(); });
+    this->commitThread = std::thread([this]() { this->CommitLoop(); });
+    this->pluginContext->LogTrace(SOURCE_LOCATION, "返回");
+    return true;
+}
+
+void LogStructuredStore::Close() {
+    if (!this->opened) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->compactionMutex);
+        this->stopping = true;
+    }
+    this->compactionCondition.notify_all();
+    if (this->compactionThread.joinable()) {
+        this->compactionThread.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->commitMutex);
+        this->commitStopping = true;
+    }
+    // 提交线程退出前完成已接受的提交
+    this->commitCondition.notify_all();
+    if (this->commitThread.joinable()) {
+        this->commitThread.join();
+    }
+    std::lock_guard<std::mutex> appendLock(this->appendMutex);
+    if (this->activeSegment != nullptr) {
+        this->io->Sync(this->activeSegment->fd);
+        this->activeSegment.reset();
+    }
+    std::unique_lock<std::shared_mutex> indexLock(this->indexMutex);
+    this->expiries.clear();
+    this->index.clear();
+    this->shadowedPuts.clear();
+    this->segments.clear();
+    this->usage.clear();
+    if (this->usageCounter != nullptr) {
+        this->usageCounter->fetch_sub(this->usedBytes.load(), std::memory_order_relaxed);
+    }
+    this->usedBytes.store(0);
+    indexLock.unlock();
+    std::lock_guard<std::mutex> damagedLock(this->damagedMutex);
+    this->damaged.clear();
+    this->opened = false;
+}
+
+bool LogStructuredStore::Put(const std::string &key, const char *data, uint64_t size) {
+    return this->Put(key, data, size, this->options.integrityAlgorithm, 0,
+                     this->options.durability);
+}
+
+bool LogStructuredStore::Put(const std::string &key, const char *data, uint64_t size,
+                             IntegrityAlgorithm algorithm) {
+    return this->Put(key, data, size, algorithm, 0, this->options.durability);
+}
+
+bool LogStructuredStore::Put(const std::string &key, const char *data, uint64_t size,
+                             IntegrityAlgorithm algorithm, uint64_t expiry) {
+    return this->Put(key, data, size, algorithm, expiry, this->options.durability);
+}
+
+bool LogStructuredStore::Put(const std::string &key, const char *data, uint64_t size,
+                             IntegrityAlgorithm algorithm, uint64_t expiry,
+                             Durability durability) {
+    return this->Put(key, data, size, algorithm, expiry, durability, 0);
+}
+
+bool LogStructuredStore::Put(const std::string &key, const char *data, uint64_t size,
+                             IntegrityAlgorithm algorithm, uint64_t expiry, Durability durability,
+                             uint64_t writeId) {
+    if (!this->Append(key, data, size, false, 0, nullptr, algorithm, expiry, writeId,
+                      durability == Durability::Sync)) {
+        return false;
+    }
+    return durability != Durability::Batch || this->Commit();
+}
+
+bool LogStructuredStore::Commit() {
+    std::promise<bool> promise;
+    auto future = promise.get_future();
+    this->Commit([&promise](bool success) { promise.set_value(success); });
+    return future.get();
+}
+
+void LogStructuredStore::Commit(std::function<void(bool)> callback) {
+    {
+        std::lock_guard<std::mutex> lock(this->commitMutex);
+        if (!this->commitStopping) {
+            this->commits.push_back(std::move(callback));
+            this->commitCondition.notify_one();
+            return;
+        }
+    }
+    callback(false);
+}
+
+std::shared_ptr<DataBlock> LogStructuredStore::Get(const std::string &key) {
+    return this->Get(key, nullptr);
+}
+
+std::shared_ptr<DataBlock>
+LogStructuredStore::Get(const std::string &key,
+                        const std::shared_ptr<Core::CancellationToken> &token) {
+    IndexEntry entry;
+    {
+        std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+        auto iter = this->index.find(key);
+        if (iter == this->index.end() || IsExpired(iter->second.expiry, Now())) {
+            return nullptr;
+        }
+        entry = iter->second;
+    }
+
+    RecordHead head{};
+    std::vector<uint8_t> digests;
+    if (!this->LoadHead(entry, key, head, digests)) {
+        return nullptr;
+    }
+    auto ret = std::make_shared<DataBlock>(head.valueSize);
+    uint64_t batchSize = std::max(ReadBatchSize, head.blockSize) * this->readDepth;
+    for (uint64_t position = 0; position < head.valueSize; position += batchSize) {
+        if (Core::IsCancelled(token)) {
+            return nullptr;
+        }
+        uint64_t length = std::min(batchSize, head.valueSize - position);
+        if (!this->ReadBatch(entry, head, digests, position, length,
+                             ret->GetMutableData() + position)) {
+            return nullptr;
+        }
+    }
+    return ret;
+}
+
+void LogStructuredStore::TakeDamagedKeys(std::vector<std::string> &keys) {
+    keys.clear();
+    std::lock_guard<std::mutex> lock(this->damagedMutex);
+    for (const auto &elem : this->damaged) {
+        keys.push_back(elem.first);
+    }
+    this->damaged.clear();
+}
+
+uint64_t LogStructuredStore::GetExpiry(const std::string &key) {
+    std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+    auto iter = this->index.find(key);
+    return iter == this->index.end() ? 0 : iter->second.expiry;
+}
+
+uint64_t LogStructuredStore::GetWriteId(const std::string &key) {
+    std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+    auto iter = this->index.find(key);
+    return iter == this->index.end() ? 0 : iter->second.writeId;
+}
+
+bool LogStructuredStore::RemoveExpired(uint64_t now, size_t limit,
+                                       std::vector<std::string> &keys) {
+    keys.clear();
+    std::vector<IndexEntry> expected;
+    {
+        std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+        for (auto iter = this->expiries.begin();
+             iter != this->expiries.end() && iter->first <= now && keys.size() < limit; ++iter) {
+            keys.push_back(*iter->second);
+            expected.push_back(this->index.find(*iter->second)->second);
+        }
+    }
+    if (keys.empty()) {
+        return true;
+    }
+    if (!this->AppendTombstones(keys, expected)) {
+        keys.clear();
+        return false;
+    }
+    return true;
+}
+
+void LogStructuredStore::SetExpiryListener(
+    std::function<void(const std::vector<std::string> &)> listener) {
+    this->expiryListener = std::move(listener);
+}
+
+void LogStructuredStore::ListKeys(const std::string &after, size_t limit,
+                                  std::vector<std::string> &keys) {
+    keys.clear();
+    std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+    for (auto iter = this->index.upper_bound(after);
+         iter != this->index.end() && keys.size() < limit; ++iter) {
+        keys.push_back(iter->first);
+    }
+}
+
+bool LogStructuredStore::Verify(const std::string &key, std::vector<char> &buffer,
+                                uint64_t &size) {
+    size = 0;
+    IndexEntry entry;
+    {
+        std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+        auto iter = this->index.find(key);
+        if (iter == this->index.end() || IsExpired(iter->second.expiry, Now())) {
+            return true;
+        }
+        entry = iter->second;
+    }
+
+    RecordHead head{};
+    std::vector<uint8_t> digests;
+    if (!this->LoadHead(entry, key, head, digests)) {
+        return false;
+    }
+    uint64_t batchSize = std::max(ReadBatchSize, head.blockSize) * this->readDepth;
+    if (buffer.size() < std::min(batchSize, head.valueSize)) {
+        buffer.resize(std::min(batchSize, head.valueSize));
+    }
+    for (uint64_t position = 0; position < head.valueSize; position += batchSize) {
+        uint64_t length = std::min(batchSize, head.valueSize - position);
+        if (!this->ReadBatch(entry, head, digests, position, length, buffer.data())) {
+            return false;
+        }
+        size += length;
+    }
+    return true;
+}
+
+std::shared_ptr<DataBlock> LogStructuredStore::GetMapped(const std::string &key,
+                                                         MapAdvice advice) {
+    IndexEntry entry;
+    {
+        std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+        auto iter = this->index.find(key);
+        if (iter == this->index.end() || IsExpired(iter->second.expiry, Now())) {
+            return nullptr;
+        }
+        entry = iter->second;
+    }
+
+    // 只校验记录头、键和摘要表，逐块校验需要读入全部数据，与映射读取的目的相悖
+    RecordHead head{};
+    std::vector<uint8_t> digests;
+    if (!this->LoadHead(entry, key, head, digests)) {
+        return nullptr;
+    }
+    auto ret = MappedDataBlock::Map(entry.segment->fd,
+                                    entry.offset + RecordHeaderSize + head.keySize,
+                                    head.valueSize, advice);
+    if (ret == nullptr) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "映射段文件 {} 失败 ({})",
+                                      entry.segment->path, strerror(errno));
+    }
+    return ret;
+}
+
+bool LogStructuredStore::Remove(const std::string &key) {
+    if (!this->Contains(key)) {
+        return false;
+    }
+    Durability durability = this->options.durability;
+    if (!this->Append(key, nullptr, 0, true, 0, nullptr, IntegrityAlgorithm::None, 0, 0,
+                      durability == Durability::Sync)) {
+        return false;
+    }
+    return durability != Durability::Batch || this->Commit();
+}
+
+bool LogStructuredStore::Contains(const std::string &key) {
+    std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+    auto iter = this->index.find(key);
+    return iter != this->index.end() && !IsExpired(iter->second.expiry, Now());
+}
+
+void LogStructuredStore::Scan(const std::string &prefix,
+                              const std::function<bool(const std::string &, uint64_t)> &visitor) {
+    uint64_t now = Now();
+    std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+    for (auto iter = this->index.lower_bound(prefix);
+         iter != this->index.end() && iter->first.compare(0, prefix.size(), prefix) == 0;
+         ++iter) {
+        if (IsExpired(iter->second.expiry, now)) {
+            continue;
+        }
+        if (!visitor(iter->first, iter->second.sequence)) {
+            break;
+        }
+    }
+}
+
+bool LogStructuredStore::FindLatest(const std::string &prefix, std::string &key) {
+    uint64_t latest = 0;
+    this->Scan(prefix, [&](const std::string &candidate, uint64_t sequence) {
+        if (sequence > latest) {
+            latest = sequence;
+            key = candidate;
+        }
+        return true;
+    });
+    return latest != 0;
+}
+
+uint64_t LogStructuredStore::GetLiveBytes() {
+    return this->usedBytes.load(std::memory_order_relaxed);
+}
+
+void LogStructuredStore::SetUsageGroup(std::function<size_t(const std::string &)> group) {
+    this->usageGroup = std::move(group);
+}
+
+void LogStructuredStore::SetUsageCounter(
+    const std::shared_ptr<std::atomic<uint64_t>> &counter) {
+    this->usageCounter = counter;
+}
+
+void LogStructuredStore::GetUsage(std::map<std::string, uint64_t> &usage) {
+    std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+    usage.clear();
+    for (const auto &elem : this->usage) {
+        usage.emplace_hint(usage.end(), elem.first, elem.second);
+    }
+}
+
+bool LogStructuredStore::ReconcileUsage() {
+    std::unique_lock<std::shared_mutex> lock(this->indexMutex);
+    uint64_t total = 0;
+    std::map<std::string, uint64_t, std::less<>> groups;
+    for (const auto &elem : this->index) {
+        total += elem.second.recordSize;
+        if (this->usageGroup) {
+            groups[elem.first.substr(0, this->usageGroup(elem.first))] += elem.second.recordSize;
+        }
+    }
+    if (total == this->usedBytes.load() && groups == this->usage) {
+        return true;
+    }
+    this->pluginContext->LogWarn(SOURCE_LOCATION, "日志结构存储 {} 的存活字节数 {} 与索引 {} 不符",
+                                 this->directory, this->usedBytes.load(), total);
+    if (this->usageCounter != nullptr) {
+        this->usageCounter->fetch_add(total - this->usedBytes.load(), std::memory_order_relaxed);
+    }
+    this->usedBytes.store(total);
+    this->usage.swap(groups);
+    return false;
+}
+
+uint64_t LogStructuredStore::GetTotalBytes() {
+    std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+    uint64_t ret = 0;
+    for (const auto &elem : this->segments) {
+        ret += elem.second->size.load();
+    }
+    return ret;
+}
+
+const std::string &LogStructuredStore::GetDirectory() const {
+    return this->directory;
+}
+
+bool LogStructuredStore::Append(const std::string &key, const char *data, uint64_t size,
+                                bool tombstone, uint64_t sequence, const IndexEntry *expected,
+                                IntegrityAlgorithm algorithm, uint64_t expiry, uint64_t writeId,
+                                bool sync) {
+    uint64_t blockSize = 1ull << this->integrityBlockShift;
+    uint64_t digestsSize =
+        IntegrityCheck::GetBlockCount(size, blockSize) * IntegrityCheck::GetDigestSize(algorithm);
+    uint32_t keySize = key.size() + GetExtraSize(expiry, writeId);
+    uint64_t recordSize = RecordHeaderSize + keySize + size + digestsSize;
+    bool direct = this->options.directWriteThreshold > 0 &&
+                  recordSize >= this->options.directWriteThreshold;
+    std::vector<char> buffer;
+    std::shared_ptr<char> alignedBuffer;
+    if (direct) {
+        // 记录在缓冲区内的偏移与段内偏移模页大小相同，多出的一页容纳该偏移
+        alignedBuffer = this->bufferPool.Acquire(recordSize + AlignedBufferPool::Alignment);
+        direct = alignedBuffer != nullptr;
+    }
+    if (!direct) {
+        buffer.resize(recordSize);
+    }
+    uint8_t type = tombstone ? RecordTypeTombstone : RecordTypePut;
+
+    std::lock_guard<std::mutex> appendLock(this->appendMutex);
+    if (this->activeSegment == nullptr) {
+        return false;
+    }
+    if (expected != nullptr) {
+        // 索引只在持有追加锁时修改, 先核对再写入, 记录已被覆盖或删除时不再追加,
+        // 否则保留原序号的旧副本可能落在其墓碑之后的段中
+        std::shared_lock<std::shared_mutex> indexLock(this->indexMutex);
+        auto iter = this->index.find(key);
+        if (iter == this->index.end() || iter->second.segment != expected->segment ||
+            iter->second.offset != expected->offset) {
+            return true;
+        }
+    }
+    if (this->activeSegment->size.load() > 0 &&
+        this->activeSegment->size.load() + recordSize > this->options.segmentSize) {
+        if (!this->OpenSegment(this->activeSegment->id + 1)) {
+            return false;
+        }
+    }
+    if (sequence == 0) {
+        sequence = this->nextSequence.fetch_add(1);
+    }
+    auto segment = this->activeSegment;
+    uint64_t offset = segment->size.load();
+    if (direct && segment->directFd < 0) {
+        direct = false;
+        buffer.resize(recordSize);
+    }
+    char *record =
+        direct ? alignedBuffer.get() + offset % AlignedBufferPool::Alignment : buffer.data();
+
+    uint8_t flags = (expiry != 0 ? RecordFlagExpiry : 0) | (writeId != 0 ? RecordFlagWriteId : 0);
+    EncodeHead(record, type, flags, algorithm, this->integrityBlockShift, keySize, size,
+               sequence);
+    char *extra = record + RecordHeaderSize + key.size();
+    memcpy(record + RecordHeaderSize, key.data(), key.size());
+    if (expiry != 0) {
+        memcpy(extra, &expiry, sizeof(expiry));
+        extra += ExpirySize;
+    }
+    if (writeId != 0) {
+        memcpy(extra, &writeId, sizeof(writeId));
+    }
+    auto *digests = (uint8_t *) record + recordSize - digestsSize;
+    IntegrityCheck::CopyAndCompute(algorithm, record + RecordHeaderSize + keySize, data, size,
+                                   blockSize, digests);
+    uint32_t checksum = HeadChecksum(record, keySize, digests, digestsSize);
+    memcpy(record + 4, &checksum, sizeof(checksum));
+
+    if (!(direct ? this->WriteDirect(segment, record, recordSize, offset, sync)
+                 : this->io->Write(segment->fd, record, recordSize, offset, sync))) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "写入段文件 {} 失败 ({})", segment->path,
+                                      strerror(errno));
+        // 截掉可能写入了一部分的记录, 保持段文件末尾完整
+        if (ftruncate(segment->fd, (off_t) offset) != 0) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "截断段文件 {} 失败 ({})",
+                                          segment->path, strerror(errno));
+        }
+        return false;
+    }
+    segment->size.fetch_add(recordSize);
+
+    std::unique_lock<std::shared_mutex> indexLock(this->indexMutex);
+    auto iter = this->index.find(key);
+    if (expected == nullptr && iter != this->index.end() && iter->second.sequence > sequence) {
+        return true;
+    }
+    if (tombstone) {
+        if (iter != this->index.end()) {
+            this->EraseEntry(iter);
+        }
+    } else {
+        this->SetEntry(key, IndexEntry{segment, offset, recordSize, sequence, expiry, writeId});
+    }
+    return true;
+}
+
+bool LogStructuredStore::AppendTombstones(const std::vector<std::string> &keys,
+                                          const std::vector<IndexEntry> &expected) {
+    uint64_t totalSize = 0;
+    for (const auto &key : keys) {
+        totalSize += RecordHeaderSize + key.size();
+    }
+    std::vector<char> buffer(totalSize);
+
+    std::lock_guard<std::mutex> appendLock(this->appendMutex);
+    if (this->activeSegment == nullptr) {
+        return false;
+    }
+    if (this->activeSegment->size.load() > 0 &&
+        this->activeSegment->size.load() + totalSize > this->options.segmentSize) {
+        if (!this->OpenSegment(this->activeSegment->id + 1)) {
+            return false;
+        }
+    }
+    char *record = buffer.data();
+    for (const auto &key : keys) {
+        EncodeHead(record, RecordTypeTombstone, 0, IntegrityAlgorithm::None,
+                   this->integrityBlockShift, (uint32_t) key.size(), 0,
+                   this->nextSequence.fetch_add(1));
+        memcpy(record + RecordHeaderSize, key.data(), key.size());
+        uint32_t checksum = HeadChecksum(record, (uint32_t) key.size(), nullptr, 0);
+        memcpy(record + 4, &checksum, sizeof(checksum));
+        record += RecordHeaderSize + key.size();
+    }
+
+    auto segment = this->activeSegment;
+    uint64_t offset = segment->size.load();
+    if (!this->io->Write(segment->fd, buffer.data(), totalSize, offset,
+                         this->options.durability == Durability::Sync)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "写入段文件 {} 失败 ({})", segment->path,
+                                      strerror(errno));
+        if (ftruncate(segment->fd, (off_t) offset) != 0) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "截断段文件 {} 失败 ({})",
+                                          segment->path, strerror(errno));
+        }
+        return false;
+    }
+    segment->size.fetch_add(totalSize);
+
+    std::unique_lock<std::shared_mutex> indexLock(this->indexMutex);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto iter = this->index.find(keys[i]);
+        // 取出后被重新写入的键保留新的记录
+        if (iter != this->index.end() && iter->second.segment == expected[i].segment &&
+            iter->second.offset == expected[i].offset) {
+            this->EraseEntry(iter);
+        }
+    }
+    return true;
+}
+
+void LogStructuredStore::SetEntry(const std::string &key, const IndexEntry &entry) {
+    auto result = this->index.try_emplace(key, entry);
+    auto iter = result.first;
+    if (!result.second) {
+        iter->second.segment->liveBytes.fetch_sub(iter->second.recordSize);
+        if (iter->second.expiry != 0) {
+            this->expiries.erase(std::make_pair(iter->second.expiry, &iter->first));
+        }
+        this->UpdateUsage(key, iter->second.recordSize, false);
+        iter->second = entry;
+    }
+    entry.segment->liveBytes.fetch_add(entry.recordSize);
+    if (entry.expiry != 0) {
+        this->expiries.emplace(entry.expiry, &iter->first);
+    }
+    this->UpdateUsage(key, entry.recordSize, true);
+}
+
+void LogStructuredStore::EraseEntry(std::map<std::string, IndexEntry>::iterator iter) {
+    iter->second.segment->liveBytes.fetch_sub(iter->second.recordSize);
+    if (iter->second.expiry != 0) {
+        this->expiries.erase(std::make_pair(iter->second.expiry, &iter->first));
+    }
+    this->UpdateUsage(iter->first, iter->second.recordSize, false);
+    this->index.erase(iter);
+}
+
+void LogStructuredStore::UpdateUsage(const std::string &key, uint64_t bytes, bool add) {
+    if (add) {
+        this->usedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    } else {
+        this->usedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+    if (this->opened && this->usageCounter != nullptr) {
+        if (add) {
+            this->usageCounter->fetch_add(bytes, std::memory_order_relaxed);
+        } else {
+            this->usageCounter->fetch_sub(bytes, std::memory_order_relaxed);
+        }
+    }
+    if (!this->usageGroup) {
+        return;
+    }
+    std::string_view group(key.data(), std::min(this->usageGroup(key), key.size()));
+    auto iter = this->usage.find(group);
+    if (add) {
+        if (iter == this->usage.end()) {
+            iter = this->usage.emplace(std::string(group), 0).first;
+        }
+        iter->second += bytes;
+    } else if (iter != this->usage.end()) {
+        iter->second -= bytes;
+        if (iter->second == 0) {
+            this->usage.erase(iter);
+        }
+    }
+}
+
+bool LogStructuredStore::OpenSegment(uint32_t id) {
+    auto segment = std::make_shared<Segment>();
+    segment->id = id;
+    segment->path = this->SegmentPath(id);
+    segment->fd = open(segment->path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (segment->fd < 0) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "无法创建段文件 {} ({})", segment->path,
+                                      strerror(errno));
+        return false;
+    }
+    // 目录项落盘之后才能写入, 否则掉电后整个段可能消失, 压缩删除的旧段中的记录也随之丢失
+    if (!IoBackend::SyncDirectory(this->directory)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "目录 {} 落盘失败 ({})", this->directory,
+                                      strerror(errno));
+        unlink(segment->path.c_str());
+        return false;
+    }
+    segment->io = this->io;
+    this->io->RegisterFile(segment->fd);
+    if (this->options.directWriteThreshold > 0) {
+        segment->directFd = open(segment->path.c_str(), O_WRONLY | O_DIRECT | O_CLOEXEC);
+        if (segment->directFd < 0) {
+            this->pluginContext->LogWarn(SOURCE_LOCATION,
+                                         "无法以直接I/O打开段文件 {} ({}), 大记录经页缓存写入",
+                                         segment->path, strerror(errno));
+        } else {
+            this->io->RegisterFile(segment->directFd);
+        }
+    }
+    if (this->activeSegment != nullptr) {
+        // 封存段必须先落盘, 压缩删除旧段时依赖重写的记录已持久化
+        if (!this->io->Sync(this->activeSegment->fd)) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "段文件 {} 落盘失败 ({})",
+                                          this->activeSegment->path, strerror(errno));
+            this->syncFailed = true;
+        }
+        // 封存段不再写入, 不必为其保留直接I/O的文件描述符
+        if (this->activeSegment->directFd >= 0) {
+            this->io->UnregisterFile(this->activeSegment->directFd);
+            close(this->activeSegment->directFd);
+            this->activeSegment->directFd = -1;
+        }
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock(this->indexMutex);
+        this->segments[id] = segment;
+    }
+    this->activeSegment = segment;
+    return true;
+}
+
+bool LogStructuredStore::WriteDirect(const std::shared_ptr<Segment> &segment, const char *record,
+                                     uint64_t size, uint64_t offset, bool sync) {
+    uint64_t end = offset + size;
+    uint64_t alignedBegin = std::min(
+        (offset + AlignedBufferPool::Alignment - 1) / AlignedBufferPool::Alignment *
+            AlignedBufferPool::Alignment,
+        end);
+    uint64_t alignedEnd =
+        std::max(end / AlignedBufferPool::Alignment * AlignedBufferPool::Alignment, alignedBegin);
+    if (alignedBegin > offset &&
+        !this->io->Write(segment->fd, record, alignedBegin - offset, offset, false)) {
+        return false;
+    }
+    if (alignedEnd > alignedBegin &&
+        !this->io->Write(segment->directFd, record + (alignedBegin - offset),
+                         alignedEnd - alignedBegin, alignedBegin, false)) {
+        if (errno != EINVAL) {
+            return false;
+        }
+        // 设备的逻辑块大于页时不接受直接写入, 之后的记录经页缓存写入
+        this->pluginContext->LogWarn(SOURCE_LOCATION, "段文件 {} 不支持直接写入, 改为经页缓存写入",
+                                     segment->path);
+        this->io->UnregisterFile(segment->directFd);
+        close(segment->directFd);
+        segment->directFd = -1;
+        if (!this->io->Write(segment->fd, record + (alignedBegin - offset),
+                             alignedEnd - alignedBegin, alignedBegin, false)) {
+            return false;
+        }
+    }
+    if (end > alignedEnd &&
+        !this->io->Write(segment->fd, record + (alignedEnd - offset), end - alignedEnd, alignedEnd,
+                         false)) {
+        return false;
+    }
+    return !sync || this->io->Sync(segment->fd);
+}
+
+uint64_t LogStructuredStore::ReadSegment(const std::shared_ptr<Segment> &segment,
+                                         const std::function<bool(const Record &)> &visitor,
+                                         std::vector<std::pair<uint64_t, uint64_t>> &lost) {
+    uint64_t fileSize = segment->size.load();
+    uint64_t position = 0;
+    std::vector<char> buffer;
+    Record record{};
+    while (position + RecordHeaderSize <= fileSize) {
+        if (!this->LoadRecord(segment, position, fileSize, buffer, record)) {
+            // 记录头损坏, 之后可能仍有完好的记录, 从下一个校验通过的记录头继续
+            uint64_t next = this->FindRecord(segment, position + 1, fileSize, buffer, record);
+            if (next == fileSize) {
+                break;
+            }
+            this->pluginContext->LogError(SOURCE_LOCATION,
+                                          "段文件 {} 偏移 {} 至 {} 的内容无法解析, 已跳过",
+                                          segment->path, position, next);
+            lost.emplace_back(position, next);
+            position = next;
+        }
+        position += record.recordSize;
+        if (!visitor(record)) {
+            break;
+        }
+    }
+    return position;
+}
+
+bool LogStructuredStore::LoadRecord(const std::shared_ptr<Segment> &segment, uint64_t position,
+                                    uint64_t fileSize, std::vector<char> &buffer,
+                                    Record &record) {
+    char header[RecordHeaderSize];
+    if (position + RecordHeaderSize > fileSize ||
+        !this->io->Read(segment->fd, header, RecordHeaderSize, position)) {
+        return false;
+    }
+    RecordHead head{};
+    if (!ParseHead(header, head) || head.keySize > fileSize || head.valueSize > fileSize ||
+        head.digestsSize > fileSize ||
+        position + RecordHeaderSize + head.keySize + head.valueSize + head.digestsSize >
+            fileSize) {
+        return false;
+    }
+    uint64_t recordSize = RecordHeaderSize + head.keySize + head.valueSize + head.digestsSize;
+    buffer.resize(recordSize);
+    if (!this->io->Read(segment->fd, buffer.data(), recordSize, position)) {
+        return false;
+    }
+    const char *value = buffer.data() + RecordHeaderSize + head.keySize;
+    auto *digests = (const uint8_t *) value + head.valueSize;
+    uint32_t extraSize = ((head.flags & RecordFlagExpiry) != 0 ? ExpirySize : 0) +
+                         ((head.flags & RecordFlagWriteId) != 0 ? WriteIdSize : 0);
+    if (head.checksum != HeadChecksum(buffer.data(), head.keySize, digests, head.digestsSize)) {
+        return false;
+    }
+    uint64_t badBlock = 0;
+    record.tombstone = head.type == RecordTypeTombstone;
+    record.algorithm = head.algorithm;
+    record.corrupted = !IntegrityCheck::Verify(head.algorithm, value, head.valueSize,
+                                               head.blockSize, digests, badBlock);
+    if (record.corrupted) {
+        this->pluginContext->LogError(
+            SOURCE_LOCATION, "段文件 {} 偏移 {} 处的记录第 {} 块 (数据偏移 {}, {}) 校验失败",
+            segment->path, position, badBlock, badBlock * head.blockSize,
+            IntegrityCheck::GetName(head.algorithm));
+    }
+    record.sequence = head.sequence;
+    record.expiry = 0;
+    record.writeId = 0;
+    const char *extra = value - extraSize;
+    if ((head.flags & RecordFlagExpiry) != 0) {
+        memcpy(&record.expiry, extra, sizeof(record.expiry));
+        extra += ExpirySize;
+    }
+    if ((head.flags & RecordFlagWriteId) != 0) {
+        memcpy(&record.writeId, extra, sizeof(record.writeId));
+    }
+    record.key.assign(buffer.data() + RecordHeaderSize, head.keySize - extraSize);
+    record.value = value;
+    record.valueOffset = position + RecordHeaderSize + head.keySize;
+    record.valueSize = head.valueSize;
+    record.offset = position;
+    record.recordSize = recordSize;
+    return true;
+}
+
+uint64_t LogStructuredStore::FindRecord(const std::shared_ptr<Segment> &segment,
+                                        uint64_t position, uint64_t fileSize,
+                                        std::vector<char> &buffer, Record &record) {
+    std::vector<char> chunk;
+    while (position + RecordHeaderSize <= fileSize) {
+        uint64_t size = std::min(ReadBatchSize, fileSize - position);
+        chunk.resize(size);
+        if (!this->io->Read(segment->fd, chunk.data(), size, position)) {
+            break;
+        }
+        // 魔数可能出现在数据中, 候选位置还要通过记录头校验
+        for (uint64_t i = 0; i + sizeof(RecordMagic) <= size; ++i) {
+            if (memcmp(chunk.data() + i, &RecordMagic, sizeof(RecordMagic)) == 0 &&
+                this->LoadRecord(segment, position + i, fileSize, buffer, record)) {
+                return position + i;
+            }
+        }
+        // 相邻两批重叠魔数长度减一的字节, 跨越边界的魔数也能找到
+        position += size - sizeof(RecordMagic) + 1;
+    }
+    return fileSize;
+}
+
+bool LogStructuredStore::Recover(const std::shared_ptr<Segment> &segment,
+                                 std::map<std::string, uint64_t> &tombstones, bool newest) {
+    uint64_t maxSequence = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> lost;
+    uint64_t validSize = this->ReadSegment(segment, [&](const Record &record) {
+        maxSequence = std::max(maxSequence, record.sequence);
+        auto iter = this->index.find(record.key);
+        if (record.corrupted) {
+            // 数据损坏的记录像墓碑一样遮挡更早的版本, 由上层从其他副本或分片修复
+            std::lock_guard<std::mutex> lock(this->damagedMutex);
+            uint64_t &sequence = this->damaged[record.key];
+            sequence = std::max(sequence, record.sequence);
+        }
+        if (record.tombstone || record.corrupted) {
+            uint64_t &deleted = tombstones[record.key];
+            deleted = std::max(deleted, record.sequence);
+            if (iter != this->index.end() && iter->second.sequence < record.sequence) {
+                this->EraseEntry(iter);
+            }
+            return true;
+        }
+        auto deleted = tombstones.find(record.key);
+        if (deleted != tombstones.end() && deleted->second > record.sequence) {
+            // 墓碑之后出现了被它遮挡的旧记录, 该段回收之前墓碑不能丢弃
+            this->shadowedPuts[record.key] = segment->id;
+            return true;
+        }
+        if (iter != this->index.end() && iter->second.sequence >= record.sequence) {
+            return true;
+        }
+        this->SetEntry(record.key, IndexEntry{segment, record.offset, record.recordSize,
+                                              record.sequence, record.expiry, record.writeId});
+        return true;
+    }, lost);
+    if (maxSequence >= this->nextSequence.load()) {
+        this->nextSequence.store(maxSequence + 1);
+    }
+    if (validSize < segment->size.load() && !newest) {
+        // 封存段已经落盘, 末尾不会有写了一半的记录, 截断会丢掉可能仍能人工恢复的内容
+        lost.emplace_back(validSize, segment->size.load());
+        this->pluginContext->LogError(SOURCE_LOCATION,
+                                      "段文件 {} 偏移 {} 至 {} 的内容无法解析, 未截断",
+                                      segment->path, validSize, segment->size.load());
+    } else if (validSize < segment->size.load()) {
+        this->pluginContext->LogWarn(SOURCE_LOCATION, "段文件 {} 末尾 {} 字节不完整, 已截断",
+                                     segment->path, segment->size.load() - validSize);
+        if (ftruncate(segment->fd, (off_t) validSize) != 0) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "截断段文件 {} 失败 ({})",
+                                          segment->path, strerror(errno));
+            return false;
+        }
+        segment->size.store(validSize);
+    }
+    if (!lost.empty()) {
+        // 其中的键无从得知, 保留段文件, 之后的段中的墓碑也因此不会被丢弃
+        this->pluginContext->LogError(SOURCE_LOCATION,
+                                      "段文件 {} 中有 {} 处内容无法解析, 不再压缩该段",
+                                      segment->path, lost.size());
+        segment->retained.store(true);
+    }
+    return true;
+}
+
+bool LogStructuredStore::Compact() {
+    bool reclaimed = false;
+    while (true) {
+        uint32_t activeId = 0;
+        {
+            std::lock_guard<std::mutex> lock(this->appendMutex);
+            if (this->activeSegment == nullptr) {
+                return reclaimed;
+            }
+            activeId = this->activeSegment->id;
+        }
+        std::shared_ptr<Segment> candidate;
+        bool oldest = false;
+        {
+            std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+            for (const auto &elem : this->segments) {
+                const auto &segment = elem.second;
+                if (segment->id == activeId || segment->retained.load()) {
+                    continue;
+                }
+                if ((double) segment->liveBytes.load() <
+                    this->options.compactionThreshold * (double) segment->size.load()) {
+                    candidate = segment;
+                    oldest = segment->id == this->segments.begin()->first;
+                    break;
+                }
+            }
+        }
+        if (candidate == nullptr || !this->CompactSegment(candidate, oldest)) {
+            return reclaimed;
+        }
+        reclaimed = true;
+    }
+}
+
+bool LogStructuredStore::CompactSegment(const std::shared_ptr<Segment> &segment, bool oldest) {
+    uint64_t before = segment->size.load();
+    bool success = true;
+    std::vector<std::pair<uint64_t, uint64_t>> lost;
+    uint64_t validSize = this->ReadSegment(segment, [&](const Record &record) {
+        if (record.tombstone) {
+            if (oldest) {
+                // 更早的段已不存在, 重写时又会先核对索引, 被墓碑遮挡的旧记录不会出现在之后的段中,
+                // 除非打开时就已发现这样的记录
+                std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+                auto shadowed = this->shadowedPuts.find(record.key);
+                if (shadowed == this->shadowedPuts.end() ||
+                    this->segments.count(shadowed->second) == 0) {
+                    return true;
+                }
+            }
+            {
+                std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+                auto iter = this->index.find(record.key);
+                if (iter != this->index.end() && iter->second.sequence > record.sequence) {
+                    return true;
+                }
+            }
+            success = this->Append(record.key, nullptr, 0, true, record.sequence, nullptr,
+                                   IntegrityAlgorithm::None, 0, 0, false);
+            return success;
+        }
+        IndexEntry expected;
+        {
+            std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+            auto iter = this->index.find(record.key);
+            if (iter == this->index.end() || iter->second.segment != segment ||
+                iter->second.offset != record.offset) {
+                return true;
+            }
+            expected = iter->second;
+        }
+        if (record.corrupted) {
+            // 重写会为损坏的数据重新计算摘要, 只能以同一序号的墓碑代替, 避免重启后露出更早的版本,
+            // 由上层从其他副本或分片修复
+            {
+                std::lock_guard<std::mutex> lock(this->damagedMutex);
+                this->damaged[record.key] = record.sequence;
+            }
+            success = this->Append(record.key, nullptr, 0, true, record.sequence, &expected,
+                                   IntegrityAlgorithm::None, 0, 0, false);
+            return success;
+        }
+        if (record.expiry != 0 && record.expiry <= Now()) {
+            // 已过期的记录不再重写, 以墓碑代替
+            success = this->Append(record.key, nullptr, 0, true, record.sequence, &expected,
+                                   IntegrityAlgorithm::None, 0, 0, false);
+            return success;
+        }
+        success = this->Append(record.key, record.value, record.valueSize, false,
+                               record.sequence, &expected, record.algorithm, record.expiry,
+                               record.writeId, false);
+        return success;
+    }, lost);
+    if (!success) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "压缩段文件 {} 失败", segment->path);
+        return false;
+    }
+    if (validSize < before) {
+        lost.emplace_back(validSize, before);
+    }
+    if (!lost.empty()) {
+        return this->RetainSegment(segment, lost);
+    }
+
+    {
+        // 重写的记录先落盘, 再删除旧段
+        std::lock_guard<std::mutex> lock(this->appendMutex);
+        if (this->activeSegment != nullptr && !this->io->Sync(this->activeSegment->fd)) {
+            // 旧段保留到下次压缩, 重写的记录丢失时打开后仍可从旧段恢复
+            this->pluginContext->LogError(SOURCE_LOCATION, "段文件 {} 落盘失败 ({})",
+                                          this->activeSegment->path, strerror(errno));
+            this->syncFailed = true;
+            return false;
+        }
+    }
+    {
+        std::unique_lock<std::shared_mutex> lock(this->indexMutex);
+        this->segments.erase(segment->id);
+    }
+    // 正在读取该段的请求持有段的引用, 文件描述符在最后一个引用释放时关闭, 删除后仍可读取
+    if (unlink(segment->path.c_str()) != 0 || !IoBackend::SyncDirectory(this->directory)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "删除段文件 {} 失败 ({})", segment->path,
+                                      strerror(errno));
+        this->syncFailed = true;
+    }
+    this->pluginContext->LogInfo(SOURCE_LOCATION, "已压缩段文件 {}, 回收 {} 字节", segment->path,
+                                 before);
+    return true;
+}
+
+bool LogStructuredStore::RetainSegment(const std::shared_ptr<Segment> &segment,
+                                       const std::vector<std::pair<uint64_t, uint64_t>> &lost) {
+    this->pluginContext->LogError(SOURCE_LOCATION,
+                                  "段文件 {} 中有 {} 处内容无法读取, 保留该段且不再压缩",
+                                  segment->path, lost.size());
+    segment->retained.store(true);
+    // 打开后才损坏的记录仍在索引中, 以同一序号的墓碑代替, 由上层从其他副本或分片修复
+    std::vector<std::pair<std::string, IndexEntry>> entries;
+    {
+        std::shared_lock<std::shared_mutex> lock(this->indexMutex);
+        for (const auto &[key, entry] : this->index) {
+            if (entry.segment != segment) {
+                continue;
+            }
+            for (const auto &range : lost) {
+                if (entry.offset >= range.first && entry.offset < range.second) {
+                    entries.emplace_back(key, entry);
+                    break;
+                }
+            }
+        }
+    }
+    for (const auto &[key, entry] : entries) {
+        {
+            std::lock_guard<std::mutex> lock(this->damagedMutex);
+            uint64_t &sequence = this->damaged[key];
+            sequence = std::max(sequence, entry.sequence);
+        }
+        if (!this->Append(key, nullptr, 0, true, entry.sequence, &entry,
+                          IntegrityAlgorithm::None, 0, 0, false)) {
+            return false;
+        }
+    }
+    return false;
+}
+
+void LogStructuredStore::CommitLoop() {
+    std::unique_lock<std::mutex> lock(this->commitMutex);
+    while (true) {
+        this->commitCondition.wait(
+            lock, [this]() { return this->commitStopping || !this->commits.empty(); });
+        if (this->commits.empty()) {
+            break;
+        }
+        std::vector<std::function<void(bool)>> batch;
+        batch.swap(this->commits);
+        lock.unlock();
+        // 提交之前追加的记录要么在当前活动段中, 要么在切换活动段时已经落盘
+        std::shared_ptr<Segment> segment;
+        {
+            std::lock_guard<std::mutex> appendLock(this->appendMutex);
+            segment = this->activeSegment;
+        }
+        bool success = !this->syncFailed.load();
+        if (success && segment != nullptr && !this->io->Sync(segment->fd)) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "段文件 {} 落盘失败 ({})",
+                                          segment->path, strerror(errno));
+            this->syncFailed = true;
+            success = false;
+        }
+        for (const auto &callback : batch) {
+            callback(success);
+        }
+        lock.lock();
+    }
+}
+
+void LogStructuredStore::CompactionLoop() {
+    std::unique_lock<std::mutex> lock(this->compactionMutex);
+    while (!this->stopping) {
+        this->compactionCondition.wait_for(
+            lock, std::chrono::milliseconds(this->options.compactionIntervalMs),
+            [this]() { return this->stopping; });
+        if (this->stopping) {
+            break;
+        }
+        lock.unlock();
+        // 先追加过期记录的墓碑, 同一轮的压缩即可回收这些记录
+        std::vector<std::string> keys;
+        uint64_t removed = 0;
+        while (this->RemoveExpired(Now(), this->options.expiryBatchSize, keys) &&
+               !keys.empty()) {
+            removed += keys.size();
+            if (this->expiryListener) {
+                this->expiryListener(keys);
+            }
+            if (keys.size() < this->options.expiryBatchSize) {
+                break;
+            }
+        }
+        if (removed > 0) {
+            this->pluginContext->LogInfo(SOURCE_LOCATION, "日志结构存储 {} 删除了 {} 条过期记录",
+                                         this->directory, removed);
+        }
+        this->Compact();
+        lock.lock();
+    }
+}
+
+bool LogStructuredStore::ReadBatch(const IndexEntry &entry, const RecordHead &head,
+                                   const std::vector<uint8_t> &digests, uint64_t position,
+                                   uint64_t length, char *data) {
+    uint64_t valueOffset = entry.offset + RecordHeaderSize + head.keySize;
+    uint64_t batchSize = std::max(ReadBatchSize, head.blockSize);
+    std::vector<IoRequest> requests;
+    for (uint64_t done = 0; done < length; done += batchSize) {
+        requests.push_back(IoRequest{entry.segment->fd, data + done,
+                                     std::min(batchSize, length - done),
+                                     valueOffset + position + done});
+    }
+    if (!this->io->ReadBatch(requests)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "读取段文件 {} 失败 ({})",
+                                      entry.segment->path, strerror(errno));
+        return false;
+    }
+    uint32_t digestSize = IntegrityCheck::GetDigestSize(head.algorithm);
+    uint64_t firstBlock = position / head.blockSize;
+    uint64_t badBlock = 0;
+    if (!IntegrityCheck::Verify(head.algorithm, data, length, head.blockSize,
+                                digests.data() + firstBlock * digestSize, badBlock)) {
+        badBlock += firstBlock;
+        this->pluginContext->LogError(
+            SOURCE_LOCATION, "段文件 {} 偏移 {} 处的记录第 {} 块 (数据偏移 {}, {}) 校验失败",
+            entry.segment->path, entry.offset, badBlock, badBlock * head.blockSize,
+            IntegrityCheck::GetName(head.algorithm));
+        return false;
+    }
+    return true;
+}
+
+bool LogStructuredStore::LoadHead(const IndexEntry &entry, const std::string &key,
+                                  RecordHead &head, std::vector<uint8_t> &digests) {
+    uint32_t keySize = key.size() + GetExtraSize(entry.expiry, entry.writeId);
+    std::vector<char> header(RecordHeaderSize + keySize);
+    if (!this->io->Read(entry.segment->fd, header.data(), header.size(), entry.offset)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "读取段文件 {} 失败 ({})",
+                                      entry.segment->path, strerror(errno));
+        return false;
+    }
+    uint64_t expiry = 0;
+    uint64_t writeId = 0;
+    const char *extra = header.data() + RecordHeaderSize + key.size();
+    if (entry.expiry != 0) {
+        memcpy(&expiry, extra, sizeof(expiry));
+        extra += ExpirySize;
+    }
+    if (entry.writeId != 0) {
+        memcpy(&writeId, extra, sizeof(writeId));
+    }
+    if (!ParseHead(header.data(), head) || head.type != RecordTypePut ||
+        head.keySize != keySize || ((head.flags & RecordFlagExpiry) != 0) != (expiry != 0) ||
+        ((head.flags & RecordFlagWriteId) != 0) != (writeId != 0) || expiry != entry.expiry ||
+        writeId != entry.writeId ||
+        RecordHeaderSize + keySize + head.valueSize + head.digestsSize != entry.recordSize ||
+        memcmp(header.data() + RecordHeaderSize, key.data(), key.size()) != 0) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "段文件 {} 偏移 {} 处的记录头校验失败",
+                                      entry.segment->path, entry.offset);
+        return false;
+    }
+    digests.resize(head.digestsSize);
+    if (head.digestsSize > 0 &&
+        !this->io->Read(entry.segment->fd, (char *) digests.data(), head.digestsSize,
+                        entry.offset + entry.recordSize - head.digestsSize)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "读取段文件 {} 失败 ({})",
+                                      entry.segment->path, strerror(errno));
+        return false;
+    }
+    if (head.checksum != HeadChecksum(header.data(), head.keySize, digests.data(),
+                                      head.digestsSize)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "段文件 {} 偏移 {} 处的记录头校验失败",
+                                      entry.segment->path, entry.offset);
+        return false;
+    }
+    return true;
+}
+
+bool LogStructuredStore::ParseHead(const char *header, RecordHead &head) {
+    uint32_t magic = 0;
+    memcpy(&magic, header, sizeof(magic));
+    memcpy(&head.checksum, header + 4, sizeof(head.checksum));
+    head.type = (uint8_t) header[8];
+    head.algorithm = (IntegrityAlgorithm) header[9];
+    uint8_t blockShift = (uint8_t) header[10];
+    head.flags = (uint8_t) header[11];
+    memcpy(&head.keySize, header + 12, sizeof(head.keySize));
+    memcpy(&head.valueSize, header + 16, sizeof(head.valueSize));
+    memcpy(&head.sequence, header + 24, sizeof(head.sequence));
+    if (magic != RecordMagic || head.algorithm > IntegrityAlgorithm::Blake3 ||
+        blockShift < MinBlockShift || blockShift > MaxBlockShift ||
+        (head.flags & ~(RecordFlagExpiry | RecordFlagWriteId)) != 0 ||
+        head.keySize < ((head.flags & RecordFlagExpiry) != 0 ? ExpirySize : 0) +
+                           ((head.flags & RecordFlagWriteId) != 0 ? WriteIdSize : 0)) {
+        return false;
+    }
+    head.blockSize = 1ull << blockShift;
+    head.digestsSize = IntegrityCheck::GetBlockCount(head.valueSize, head.blockSize) *
+                       IntegrityCheck::GetDigestSize(head.algorithm);
+    return true;
+}
+
+std::string LogStructuredStore::SegmentPath(uint32_t id) const {
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "%s%08u%s", SegmentPrefix, id, SegmentSuffix);
+    return (std::filesystem::path(this->directory) / fileName).string();
+}
+} // namespace Fleet::DataManager::Storage
@@ -0,0 +1,764 @@
+/**
+ * @file LogStructuredStore.h
+ * @brief 日志结构存储
+ * @details 以追加写段文件的方式在单个设备上保存键值数据，内存索引定位记录，后台压缩回收旧版本占用的空间
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_LOG_STRUCTURED_STORE_H
+#define FLEET_DATA_MANAGER_STORAGE_LOG_STRUCTURED_STORE_H
+
+#include "AlignedBufferPool.h"
+#include "CancellationToken.h"
+#include "DataBlock.h"
+#include "IntegrityCheck.h"
+#include "IoBackend.h"
+#include "MappedDataBlock.h"
+#include "PluginContext.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief 写入的持久化级别
+ */
+enum class Durability : uint8_t {
+    /// 写入页缓存即返回，掉电可能丢失
+    None = 0,
+    /// 等待落盘后返回，同时等待的写入合并为一次fdatasync
+    Batch = 1,
+    /// 每次写入单独fdatasync，持有追加锁期间落盘
+    Sync = 2,
+};
+
+/**
+ * @brief 日志结构存储配置
+ */
+struct LogStructuredStoreOptions {
+    /// 单个段文件的大小上限，单位字节，超过后封存并切换到新段
+    uint64_t segmentSize = 64ull * 1024 * 1024;
+    /// 封存段的存活数据比例低于该值时进行压缩
+    double compactionThreshold = 0.5;
+    /// 后台压缩线程的检查间隔，单位毫秒
+    uint32_t compactionIntervalMs = 1000;
+    /// 未指定持久化级别的写入和删除使用的持久化级别
+    Durability durability = Durability::None;
+    /// 写入时未指定校验算法的记录使用的数据校验算法
+    IntegrityAlgorithm integrityAlgorithm = IntegrityAlgorithm::Crc32c;
+    /// 数据校验的块大小，单位字节，取不超过该值的2的幂，范围为512字节到1GiB
+    uint32_t integrityBlockSize = 64 * 1024;
+    /// 后台线程每批删除的过期记录数
+    uint32_t expiryBatchSize = 4096;
+    /// 段文件I/O后端
+    IoBackendType ioBackend = IoBackendType::Auto;
+    /// 读取一条记录时同时提交的批数，不超过I/O后端的队列深度
+    uint32_t readQueueDepth = 8;
+    /// 达到该大小的记录绕过页缓存直接写入段文件，单位字节，为0时不使用直接I/O
+    uint64_t directWriteThreshold = 0;
+    /// 直接写入使用的对齐缓冲区池缓存的字节数上限
+    uint64_t directBufferPoolSize = 64ull * 1024 * 1024;
+};
+
+/**
+ * @brief 日志结构存储类
+ * @details 每个设备目录下维护一组编号递增的段文件，写入总是追加到当前活动段，
+ * 删除写入墓碑记录。内存中的有序索引将键映射到记录所在的段、偏移和长度，
+ * 打开时顺序扫描所有段重建索引，末尾不完整的记录被截断。
+ * 记录的数据按块保存摘要，摘要表位于数据之后，记录头的CRC32C覆盖记录头、键和摘要表，
+ * 读取时逐块校验，损坏可以定位到具体的块，恢复和压缩时发现的损坏记录被移出索引并记录为损坏。
+ * 记录可以带有过期时间，索引之外按过期时间维护一个有序的过期表，后台线程只取出已过期的键，
+ * 批量追加墓碑后由压缩回收空间，不需要扫描存活的数据。
+ * 记录还可以带有调用方指定的写入标识，与过期时间一样保存在键之后，随索引保留，压缩时原样重写。
+ * 存活字节数随索引在同一把锁内增减，并按键前缀分组累计，查询用量不需要遍历索引或段文件。
+ * 后台线程挑选存活比例过低的封存段，将仍被索引引用的记录重新追加后删除该段。
+ * 段文件的读写和落盘经由I/O后端，段文件打开后登记到后端，读取大记录时按队列深度同时提交多批。
+ * 配置了直接写入阈值时，大记录在对齐缓冲区中编码，整页部分经O_DIRECT写入，不占用页缓存。
+ * 段文件本身即预写日志，批量持久化的写入追加后交给提交线程，提交线程一次fdatasync活动段
+ * 即可覆盖此前追加的所有记录，封存段在切换时已经落盘，崩溃后打开时重放段文件重建索引
+ * @note 线程安全，读操作只持有索引的共享锁，写操作由追加锁串行化
+ */
+class LogStructuredStore {
+  public:
+    /**
+     * @brief 构造日志结构存储
+     * @param[in] pluginContext 插件上下文，用于日志记录
+     * @param[in] directory 段文件所在目录
+     * @param[in] options 存储配置
+     */
+    LogStructuredStore(const std::shared_ptr<Core::PluginContext> &pluginContext,
+                       const std::string &directory, const LogStructuredStoreOptions &options);
+
+    /**
+     * @brief 析构函数，停止后台压缩并关闭段文件
+     */
+    virtual ~LogStructuredStore();
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    LogStructuredStore(const LogStructuredStore &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    LogStructuredStore &operator=(const LogStructuredStore &) = delete;
+
+    /**
+     * @brief 打开存储
+     * @details 创建目录，扫描已有段文件重建索引，打开新的活动段并启动后台压缩线程
+     * @return 打开成功返回true，失败返回false
+     */
+    bool Open();
+
+    /**
+     * @brief 关闭存储
+     * @details 停止后台压缩线程，刷新并关闭所有段文件
+     */
+    void Close();
+
+    /**
+     * @brief 写入记录，使用配置的数据校验算法
+     * @param[in] key 键
+     * @param[in] data 数据内容
+     * @param[in] size 数据大小，单位字节
+     * @return 写入成功返回true，失败返回false
+     */
+    bool Put(const std::string &key, const char *data, uint64_t size);
+
+    /**
+     * @brief 写入记录
+     * @details 数据复制到写缓冲区的同时逐块计算摘要
+     * @param[in] key 键
+     * @param[in] data 数据内容
+     * @param[in] size 数据大小，单位字节
+     * @param[in] algorithm 数据校验算法
+     * @return 写入成功返回true，失败返回false
+     */
+    bool Put(const std::string &key, const char *data, uint64_t size,
+             IntegrityAlgorithm algorithm);
+
+    /**
+     * @brief 写入带过期时间的记录
+     * @param[in] key 键
+     * @param[in] data 数据内容
+     * @param[in] size 数据大小，单位字节
+     * @param[in] algorithm 数据校验算法
+     * @param[in] expiry 过期时间，Unix时间戳，单位秒，为0时不过期
+     * @return 写入成功返回true，失败返回false
+     */
+    bool Put(const std::string &key, const char *data, uint64_t size,
+             IntegrityAlgorithm algorithm, uint64_t expiry);
+
+    /**
+     * @brief 按指定的持久化级别写入带过期时间的记录
+     * @param[in] key 键
+     * @param[in] data 数据内容
+     * @param[in] size 数据大小，单位字节
+     * @param[in] algorithm 数据校验算法
+     * @param[in] expiry 过期时间，Unix时间戳，单位秒，为0时不过期
+     * @param[in] durability 持久化级别
+     * @return 写入并按要求落盘成功返回true，失败返回false
+     */
+    bool Put(const std::string &key, const char *data, uint64_t size,
+             IntegrityAlgorithm algorithm, uint64_t expiry, Durability durability);
+
+    /**
+     * @brief 按指定的持久化级别写入带写入标识的记录
+     * @details 写入标识由调用方生成，同一次写入在各设备上的副本相同，之后的写入总是更大，
+     * 用于在副本之间区分新旧，存储本身不解释其取值
+     * @param[in] key 键
+     * @param[in] data 数据内容
+     * @param[in] size 数据大小，单位字节
+     * @param[in] algorithm 数据校验算法
+     * @param[in] expiry 过期时间，Unix时间戳，单位秒，为0时不过期
+     * @param[in] durability 持久化级别
+     * @param[in] writeId 写入标识，为0时不记录
+     * @return 写入并按要求落盘成功返回true，失败返回false
+     */
+    bool Put(const std::string &key, const char *data, uint64_t size,
+             IntegrityAlgorithm algorithm, uint64_t expiry, Durability durability,
+             uint64_t writeId);
+
+    /**
+     * @brief 等待此前追加的所有记录落盘
+     * @details 由提交线程执行，等待期间到达的提交合并为一次fdatasync
+     * @return 落盘成功返回true，落盘失败或存储未打开返回false
+     */
+    bool Commit();
+
+    /**
+     * @brief 此前追加的所有记录落盘后回调
+     * @details 回调在提交线程上执行，不能再调用Commit等待
+     * @param[in] callback 回调函数，参数为是否落盘成功，存储未打开时立即以false调用
+     */
+    void Commit(std::function<void(bool)> callback);
+
+    /**
+     * @brief 读取记录
+     * @details 数据分批直接读入返回的数据块，每批读完立即校验其中的块
+     * @param[in] key 键
+     * @return 数据块对象指针，未找到或校验失败返回nullptr
+     */
+    std::shared_ptr<DataBlock> Get(const std::string &key);
+
+    /**
+     * @brief 读取记录，可在读取过程中取消
+     * @details 每读完一批数据检查一次令牌，令牌取消后放弃剩余的读取
+     * @param[in] key 键
+     * @param[in] token 取消令牌，允许为nullptr
+     * @return 数据块对象指针，未找到、校验失败或已取消返回nullptr
+     */
+    std::shared_ptr<DataBlock> Get(const std::string &key,
+                                   const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 以内存映射方式读取记录
+     * @details 只校验记录头、键和摘要表，数据部分直接映射段文件而不读入内存，不校验数据块的摘要。
+     * 压缩只删除段文件而不截断，已建立的映射在段被回收后仍然有效
+     * @param[in] key 键
+     * @param[in] advice 访问模式提示
+     * @return 映射数据块，未找到、记录头校验失败或映射失败返回nullptr
+     */
+    std::shared_ptr<DataBlock> GetMapped(const std::string &key, MapAdvice advice);
+
+    /**
+     * @brief 删除记录
+     * @param[in] key 键
+     * @return 删除成功返回true，键不存在或写入墓碑失败返回false
+     */
+    bool Remove(const std::string &key);
+
+    /**
+     * @brief 判断键是否存在
+     * @param[in] key 键
+     * @return 存在返回true，否则返回false
+     */
+    bool Contains(const std::string &key);
+
+    /**
+     * @brief 按前缀遍历键
+     * @param[in] prefix 键前缀
+     * @param[in] visitor 访问函数，参数为键和写入序号，返回false时停止遍历
+     */
+    void Scan(const std::string &prefix,
+              const std::function<bool(const std::string &, uint64_t)> &visitor);
+
+    /**
+     * @brief 按顺序列出指定键之后的键
+     * @details 每次只在索引锁内复制一批键，调用者可以在两批之间执行耗时的操作
+     * @param[in] after 起始键，不包含在结果中，为空时从第一个键开始
+     * @param[in] limit 最多列出的键数
+     * @param[out] keys 键列表，为空表示已经到达末尾
+     */
+    void ListKeys(const std::string &after, size_t limit, std::vector<std::string> &keys);
+
+    /**
+     * @brief 读取记录并逐块校验，不保留数据
+     * @details 数据分批读入调用者提供的缓冲区，缓冲区可在多次调用之间复用
+     * @param[in] key 键
+     * @param[in,out] buffer 读取缓冲区，容量不足时自动扩大
+     * @param[out] size 已校验的数据大小
+     * @return 校验通过或键不存在返回true，读取失败或校验失败返回false
+     */
+    bool Verify(const std::string &key, std::vector<char> &buffer, uint64_t &size);
+
+    /**
+     * @brief 取出数据损坏而被移出索引的键
+     * @details 打开时恢复出的最新记录或压缩时遇到的存活记录数据损坏时，
+     * 该键像被删除一样移出索引，避免读到更早的版本，同时记录为损坏，取出后清空
+     * @param[out] keys 损坏的键
+     */
+    void TakeDamagedKeys(std::vector<std::string> &keys);
+
+    /**
+     * @brief 获取记录的过期时间
+     * @param[in] key 键
+     * @return 过期时间，Unix时间戳，单位秒，键不存在或不过期时返回0
+     */
+    uint64_t GetExpiry(const std::string &key);
+
+    /**
+     * @brief 获取记录的写入标识
+     * @param[in] key 键
+     * @return 写入标识，键不存在或写入时未指定返回0
+     */
+    uint64_t GetWriteId(const std::string &key);
+
+    /**
+     * @brief 删除已过期的记录
+     * @details 按过期时间从早到晚取出已过期的键，为其批量追加墓碑，只访问已过期的记录。
+     * 取出后又被重新写入的键不会被删除
+     * @param[in] now 当前时间，Unix时间戳，单位秒
+     * @param[in] limit 最多删除的记录数
+     * @param[out] keys 已删除的键
+     * @return 没有过期记录或墓碑追加成功返回true，失败返回false
+     */
+    bool RemoveExpired(uint64_t now, size_t limit, std::vector<std::string> &keys);
+
+    /**
+     * @brief 设置后台线程删除过期记录后的回调
+     * @param[in] listener 回调函数，参数为已删除的键，在后台线程中执行
+     * @note 必须在Open之前设置
+     */
+    void SetExpiryListener(std::function<void(const std::vector<std::string> &)> listener);
+
+    /**
+     * @brief 设置用量分组函数
+     * @param[in] group 分组函数，返回键中作为分组名的前缀长度
+     * @note 必须在Open之前设置，未设置时不分组统计
+     */
+    void SetUsageGroup(std::function<size_t(const std::string &)> group);
+
+    /**
+     * @brief 设置共享的存活字节数计数
+     * @details 打开后存活字节数的变化同时累加到该计数，关闭时减去剩余的字节数，
+     * 多个存储共用一个计数时无需逐个查询即可得到总用量
+     * @param[in] counter 共享计数，允许为nullptr
+     * @note 必须在Open之前设置
+     */
+    void SetUsageCounter(const std::shared_ptr<std::atomic<uint64_t>> &counter);
+
+    /**
+     * @brief 获取各分组的存活字节数
+     * @param[out] usage 分组名到索引引用的记录总字节数的映射
+     */
+    void GetUsage(std::map<std::string, uint64_t> &usage);
+
+    /**
+     * @brief 按索引重新计算存活字节数和各分组的用量
+     * @details 需要遍历整个索引，由巡检每轮调用一次，用于发现并纠正计数的偏差
+     * @return 计数与索引一致返回true，存在偏差并已纠正返回false
+     */
+    bool ReconcileUsage();
+
+    /**
+     * @brief 查找具有指定前缀且最后写入的键
+     * @param[in] prefix 键前缀
+     * @param[out] key 找到的键
+     * @return 找到返回true，否则返回false
+     */
+    bool FindLatest(const std::string &prefix, std::string &key);
+
+    /**
+     * @brief 立即执行一轮压缩
+     * @return 回收了至少一个段返回true，否则返回false
+     */
+    bool Compact();
+
+    /**
+     * @brief 获取存活数据的字节数
+     * @details 读取随索引维护的计数，不加锁
+     * @return 索引引用的记录总字节数
+     */
+    uint64_t GetLiveBytes();
+
+    /**
+     * @brief 获取段文件占用的字节数
+     * @return 所有段文件的总字节数
+     */
+    uint64_t GetTotalBytes();
+
+    /**
+     * @brief 获取段文件所在目录
+     * @return 目录路径
+     */
+    const std::string &GetDirectory() const;
+
+  private:
+    /**
+     * @brief 段文件
+     */
+    struct Segment {
+        /// 段编号
+        uint32_t id = 0;
+        /// 段文件路径
+        std::string path;
+        /// 文件描述符
+        int fd = -1;
+        /// 登记了该文件的I/O后端
+        std::shared_ptr<IoBackend> io;
+        /// 以O_DIRECT打开的文件描述符，只在启用直接写入的段作为活动段期间打开，否则为-1
+        int directFd = -1;
+        /// 已写入的字节数
+        std::atomic<uint64_t> size{0};
+        /// 仍被索引引用的记录字节数
+        std::atomic<uint64_t> liveBytes{0};
+        /// 段中有无法解析的内容，不再压缩，保留文件以便人工恢复
+        std::atomic<bool> retained{false};
+
+        /**
+         * @brief 析构函数，从I/O后端注销并关闭文件
+         */
+        ~Segment();
+    };
+
+    /**
+     * @brief 索引项
+     */
+    struct IndexEntry {
+        /// 记录所在的段
+        std::shared_ptr<Segment> segment;
+        /// 记录在段内的偏移
+        uint64_t offset;
+        /// 记录总长度，包括记录头、键和摘要表
+        uint64_t recordSize;
+        /// 写入序号，越大越新
+        uint64_t sequence;
+        /// 过期时间，为0时不过期
+        uint64_t expiry;
+        /// 写入标识，为0时未记录
+        uint64_t writeId;
+    };
+
+    /**
+     * @brief 记录头
+     */
+    struct RecordHead {
+        /// 记录头校验和
+        uint32_t checksum;
+        /// 记录类型
+        uint8_t type;
+        /// 记录标志
+        uint8_t flags;
+        /// 写入序号
+        uint64_t sequence;
+        /// 键区长度，包括键和键之后的过期时间、写入标识
+        uint32_t keySize;
+        /// 数据大小
+        uint64_t valueSize;
+        /// 数据校验算法
+        IntegrityAlgorithm algorithm;
+        /// 数据校验块大小
+        uint64_t blockSize;
+        /// 摘要表长度
+        uint64_t digestsSize;
+    };
+
+    /**
+     * @brief 段文件中的记录
+     */
+    struct Record {
+        /// 是否为墓碑记录
+        bool tombstone;
+        /// 数据校验算法
+        IntegrityAlgorithm algorithm;
+        /// 数据是否有块校验失败，记录头完好时长度可信，跳过该记录后可以继续读取
+        bool corrupted;
+        /// 写入序号
+        uint64_t sequence;
+        /// 过期时间，为0时不过期
+        uint64_t expiry;
+        /// 写入标识，为0时未记录
+        uint64_t writeId;
+        /// 键
+        std::string key;
+        /// 数据内容，仅在访问函数执行期间有效
+        const char *value;
+        /// 数据在段内的偏移
+        uint64_t valueOffset;
+        /// 数据大小
+        uint64_t valueSize;
+        /// 记录在段内的偏移
+        uint64_t offset;
+        /// 记录总长度
+        uint64_t recordSize;
+    };
+
+    /// 插件上下文
+    std::shared_ptr<Core::PluginContext> pluginContext;
+
+    /// 段文件所在目录
+    std::string directory;
+
+    /// 存储配置
+    LogStructuredStoreOptions options;
+
+    /// 段文件I/O后端
+    std::shared_ptr<IoBackend> io;
+
+    /// 读取一条记录时同时提交的批数
+    uint32_t readDepth;
+
+    /// 直接写入使用的对齐缓冲区池
+    AlignedBufferPool bufferPool;
+
+    /// 数据校验块大小的对数
+    uint8_t integrityBlockShift;
+
+    /// 索引读写锁
+    std::shared_mutex indexMutex;
+
+    /// 键到记录位置的有序索引
+    std::map<std::string, IndexEntry> index;
+
+    /// 段编号到段文件的映射，受indexMutex保护
+    std::map<uint32_t, std::shared_ptr<Segment>> segments;
+
+    /// 打开时发现墓碑之后的段中仍有被其遮挡的旧记录的键到最后一个此类段的编号的映射，
+    /// 该段回收之前墓碑不能丢弃，受indexMutex保护
+    std::map<std::string, uint32_t> shadowedPuts;
+
+    /// 追加锁，串行化写入、段切换和压缩的重写
+    std::mutex appendMutex;
+
+    /// 当前活动段，受appendMutex保护
+    std::shared_ptr<Segment> activeSegment;
+
+    /// 下一个写入序号
+    std::atomic<uint64_t> nextSequence;
+
+    /// 后台压缩线程
+    std::thread compactionThread;
+
+    /// 后台压缩线程的互斥锁
+    std::mutex compactionMutex;
+
+    /// 后台压缩线程的条件变量
+    std::condition_variable compactionCondition;
+
+    /// 停止标志
+    bool stopping;
+
+    /// 提交线程
+    std::thread commitThread;
+
+    /// 互斥锁，保护commits和commitStopping
+    std::mutex commitMutex;
+
+    /// 提交线程的条件变量
+    std::condition_variable commitCondition;
+
+    /// 等待落盘的回调
+    std::vector<std::function<void(bool)>> commits;
+
+    /// 提交线程是否停止接受新的提交
+    bool commitStopping;
+
+    /// 落盘曾经失败，页缓存中的数据可能已丢失，重新打开前的提交均失败
+    std::atomic<bool> syncFailed;
+
+    /// 是否已打开
+    bool opened;
+
+    /// 损坏键表的互斥锁
+    std::mutex damagedMutex;
+
+    /// 数据损坏而被移出索引的键到损坏记录序号的映射
+    std::map<std::string, uint64_t> damaged;
+
+    /// 过期表，按过期时间排序，键指向索引中的键，受indexMutex保护
+    std::set<std::pair<uint64_t, const std::string *>> expiries;
+
+    /// 删除过期记录后的回调
+    std::function<void(const std::vector<std::string> &)> expiryListener;
+
+    /// 索引引用的记录总字节数，在持有索引写锁时修改
+    std::atomic<uint64_t> usedBytes;
+
+    /// 用量分组函数
+    std::function<size_t(const std::string &)> usageGroup;
+
+    /// 共享的存活字节数计数，只在打开期间累加本存储的字节数
+    std::shared_ptr<std::atomic<uint64_t>> usageCounter;
+
+    /// 分组名到存活字节数的映射，受indexMutex保护
+    std::map<std::string, uint64_t, std::less<>> usage;
+
+    /**
+     * @brief 追加记录到活动段并更新索引
+     * @param[in] key 键
+     * @param[in] data 数据内容
+     * @param[in] size 数据大小
+     * @param[in] tombstone 是否为墓碑记录
+     * @param[in] sequence 写入序号
+     * @param[in] expected 压缩重写时要求索引仍指向的旧位置，在写入前核对，为nullptr表示普通写入
+     * @param[in] algorithm 数据校验算法
+     * @param[in] expiry 过期时间，为0时不过期
+     * @param[in] writeId 写入标识，为0时不记录
+     * @param[in] sync 是否在持有追加锁期间落盘
+     * @return 追加成功返回true，失败返回false
+     */
+    bool Append(const std::string &key, const char *data, uint64_t size, bool tombstone,
+                uint64_t sequence, const IndexEntry *expected, IntegrityAlgorithm algorithm,
+                uint64_t expiry, uint64_t writeId, bool sync);
+
+    /**
+     * @brief 一次写入多条墓碑记录
+     * @param[in] keys 键
+     * @param[in] expected 各键要求索引仍指向的位置，位置已变化的键不从索引中删除
+     * @return 追加成功返回true，失败返回false
+     */
+    bool AppendTombstones(const std::vector<std::string> &keys,
+                          const std::vector<IndexEntry> &expected);
+
+    /**
+     * @brief 写入或替换索引项，同时维护段的存活字节数和过期表，调用者持有索引写锁
+     * @param[in] key 键
+     * @param[in] entry 索引项
+     */
+    void SetEntry(const std::string &key, const IndexEntry &entry);
+
+    /**
+     * @brief 删除索引项，同时维护段的存活字节数和过期表，调用者持有索引写锁
+     * @param[in] iter 索引项
+     */
+    void EraseEntry(std::map<std::string, IndexEntry>::iterator iter);
+
+    /**
+     * @brief 增减键所在分组的用量，调用者持有索引写锁
+     * @param[in] key 键
+     * @param[in] bytes 记录字节数
+     * @param[in] add 为true时增加，否则减少
+     */
+    void UpdateUsage(const std::string &key, uint64_t bytes, bool add);
+
+    /**
+     * @brief 读取并校验记录头、键和摘要表
+     * @param[in] entry 索引项
+     * @param[in] key 键
+     * @param[out] head 记录头
+     * @param[out] digests 摘要表
+     * @return 校验通过返回true，否则返回false
+     */
+    bool LoadHead(const IndexEntry &entry, const std::string &key, RecordHead &head,
+                  std::vector<uint8_t> &digests);
+
+    /**
+     * @brief 读取并校验一批数据
+     * @details 数据按ReadBatchSize和校验块大小中的较大者切分，一次提交给I/O后端后整体校验
+     * @param[in] entry 索引项
+     * @param[in] head 记录头
+     * @param[in] digests 摘要表
+     * @param[in] position 本批数据在记录数据中的偏移，与块边界对齐
+     * @param[in] length 本批数据的长度
+     * @param[out] data 数据输出缓冲区
+     * @return 读取和校验均成功返回true，否则返回false
+     */
+    bool ReadBatch(const IndexEntry &entry, const RecordHead &head,
+                   const std::vector<uint8_t> &digests, uint64_t position, uint64_t length,
+                   char *data);
+
+    /**
+     * @brief 将记录写入段文件，整页部分绕过页缓存，需持有appendMutex
+     * @details 首尾不足一页的部分与相邻记录共享页，经页缓存写入，设备不接受直接写入时整条经页缓存写入
+     * @param[in] segment 活动段，directFd有效
+     * @param[in] record 记录，地址与offset模AlignedBufferPool::Alignment同余
+     * @param[in] size 记录大小
+     * @param[in] offset 段内偏移
+     * @param[in] sync 写入后是否落盘
+     * @return 写入并按要求落盘成功返回true，否则返回false
+     */
+    bool WriteDirect(const std::shared_ptr<Segment> &segment, const char *record, uint64_t size,
+                     uint64_t offset, bool sync);
+
+    /**
+     * @brief 创建新的活动段，需持有appendMutex
+     * @param[in] id 段编号
+     * @return 创建成功返回true，失败返回false
+     */
+    bool OpenSegment(uint32_t id);
+
+    /**
+     * @brief 顺序读取段中的记录
+     * @details 记录头损坏时向后查找下一个校验通过的记录头继续读取，跳过的范围记入lost
+     * @param[in] segment 段文件
+     * @param[in] visitor 访问函数，返回false时停止读取
+     * @param[out] lost 跳过的范围，为[起始偏移, 结束偏移)，不包括最后一个有效记录之后的内容
+     * @return 最后一个有效记录的结束偏移，其后的内容不完整或找不到校验通过的记录头
+     */
+    uint64_t ReadSegment(const std::shared_ptr<Segment> &segment,
+                         const std::function<bool(const Record &)> &visitor,
+                         std::vector<std::pair<uint64_t, uint64_t>> &lost);
+
+    /**
+     * @brief 读取并校验指定偏移处的记录
+     * @param[in] segment 段文件
+     * @param[in] position 记录在段内的偏移
+     * @param[in] fileSize 段的长度
+     * @param[in,out] buffer 记录的缓冲区，record中的数据指向其中
+     * @param[out] record 记录
+     * @return 记录头校验通过返回true，否则返回false
+     */
+    bool LoadRecord(const std::shared_ptr<Segment> &segment, uint64_t position,
+                    uint64_t fileSize, std::vector<char> &buffer, Record &record);
+
+    /**
+     * @brief 从指定偏移开始查找下一个校验通过的记录
+     * @param[in] segment 段文件
+     * @param[in] position 开始查找的偏移
+     * @param[in] fileSize 段的长度
+     * @param[in,out] buffer 记录的缓冲区，record中的数据指向其中
+     * @param[out] record 找到的记录
+     * @return 找到的记录的偏移，找不到返回fileSize
+     */
+    uint64_t FindRecord(const std::shared_ptr<Segment> &segment, uint64_t position,
+                        uint64_t fileSize, std::vector<char> &buffer, Record &record);
+
+    /**
+     * @brief 将段中的记录应用到索引，用于打开时恢复
+     * @details 只截断最新的段末尾不完整的记录，封存段中无法解析的范围记录错误并保留段文件
+     * @param[in] segment 段文件
+     * @param[in,out] tombstones 已删除或损坏的键及其序号，损坏的键同时记入damaged
+     * @param[in] newest 是否为上次关闭前的活动段
+     * @return 恢复成功返回true，失败返回false
+     */
+    bool Recover(const std::shared_ptr<Segment> &segment,
+                 std::map<std::string, uint64_t> &tombstones, bool newest);
+
+    /**
+     * @brief 压缩单个段
+     * @details 段中有无法读取的范围时保留段文件，索引仍指向其中的键改为损坏
+     * @param[in] segment 待压缩的封存段
+     * @param[in] oldest 是否为最早的段，最早的段中的墓碑不再遮挡之后的段中的记录时可以直接丢弃
+     * @return 压缩成功返回true，失败返回false
+     */
+    bool CompactSegment(const std::shared_ptr<Segment> &segment, bool oldest);
+
+    /**
+     * @brief 保留有无法读取的范围的段，索引仍指向这些范围的键以同一序号的墓碑代替并记入damaged
+     * @param[in] segment 段文件
+     * @param[in] lost 无法读取的范围
+     * @return 总是返回false，段未被回收
+     */
+    bool RetainSegment(const std::shared_ptr<Segment> &segment,
+                       const std::vector<std::pair<uint64_t, uint64_t>> &lost);
+
+    /**
+     * @brief 后台压缩线程主循环
+     */
+    void CompactionLoop();
+
+    /**
+     * @brief 提交线程主循环，每次取出所有等待的提交，落盘活动段后依次回调
+     */
+    void CommitLoop();
+
+    /**
+     * @brief 解析记录头
+     * @param[in] header 记录头数据
+     * @param[out] head 解析结果
+     * @return 魔数、校验算法和块大小合法返回true，否则返回false
+     */
+    static bool ParseHead(const char *header, RecordHead &head);
+
+    /**
+     * @brief 生成段文件路径
+     * @param[in] id 段编号
+     * @return 段文件路径
+     */
+    std::string SegmentPath(uint32_t id) const;
+};
+} // namespace Fleet::DataManager::Storage
+#endif // FLEET_DATA_MANAGER_STORAGE_LOG_STRUCTURED_STORE_H
@@ -0,0 +1,200 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#include "ProfileTable.h"
+#include "ErasureCode.h"
+#include "InternTable.h"
+#include <mutex>
+
+namespace Fleet::DataManager::Storage {
+namespace {
+/// 哈希表的最小槽位数
+constexpr size_t MinimumSlots = 8;
+} // namespace
+
+ProfileTable::ProfileTable() : slots(MinimumSlots) {
+}
+
+void ProfileTable::SetStrategy(const std::shared_ptr<const Strategy> &strategy) {
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    this->strategies[strategy->GetName()] = strategy;
+    this->Rebuild();
+}
+
+bool ProfileTable::RemoveStrategy(const std::string &name) {
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    if (this->strategies.erase(name) == 0) {
+        return false;
+    }
+    this->Rebuild();
+    return true;
+}
+
+void ProfileTable::SetDefaultStrategy(const std::string &name) {
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    this->defaultStrategyName = name;
+    this->Rebuild();
+}
+
+void ProfileTable::SetProfile(const std::string &application, const std::string &dataType,
+                              const std::string &strategyName) {
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    this->profiles[std::make_pair(application, dataType)] = strategyName;
+    this->Rebuild();
+}
+
+bool ProfileTable::RemoveProfile(const std::string &application, const std::string &dataType) {
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    if (this->profiles.erase(std::make_pair(application, dataType)) == 0) {
+        return false;
+    }
+    this->Rebuild();
+    return true;
+}
+
+void ProfileTable::SetProfileForApplication(const std::string &application,
+                                            const std::string &strategyName) {
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    this->applicationProfiles[application] = strategyName;
+    this->Rebuild();
+}
+
+bool ProfileTable::RemoveProfileForApplication(const std::string &application) {
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    if (this->applicationProfiles.erase(application) == 0) {
+        return false;
+    }
+    this->Rebuild();
+    return true;
+}
+
+void ProfileTable::SetProfileForDataType(const std::string &dataType,
+                                         const std::string &strategyName) {
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    this->dataTypeProfiles[dataType] = strategyName;
+    this->Rebuild();
+}
+
+bool ProfileTable::RemoveProfileForDataType(const std::string &dataType) {
+    std::unique_lock<std::shared_mutex> lock(this->mutex);
+    if (this->dataTypeProfiles.erase(dataType) == 0) {
+        return false;
+    }
+    this->Rebuild();
+    return true;
+}
+
+std::shared_ptr<const ProfileResolution> ProfileTable::Find(const std::string &application,
+                                                            const std::string &dataType) const {
+    static const std::string empty;
+    std::shared_lock<std::shared_mutex> lock(this->mutex);
+    const auto *resolution = this->Probe(ProfileKind::Specific, application, dataType);
+    if (resolution == nullptr) {
+        resolution = this->Probe(ProfileKind::Application, application, empty);
+    }
+    if (resolution == nullptr) {
+        resolution = this->Probe(ProfileKind::DataType, empty, dataType);
+    }
+    return resolution != nullptr ? *resolution : this->defaultResolution;
+}
+
+PlacementPlan ProfileTable::MakePlan(const Strategy &strategy) {
+    PlacementPlan ret;
+    ret.devices.reserve(strategy.GetLocations().size());
+    for (const auto &location : strategy.GetLocations()) {
+        ret.devices.push_back(location.GetDeviceName());
+    }
+    if (!ErasureCode::Parse(strategy.GetErrorCorrectingAlgorithm(), ret.dataFragments,
+                            ret.parityFragments)) {
+        ret.dataFragments = 0;
+        ret.parityFragments = 0;
+    }
+    if (!IntegrityCheck::Parse(strategy.GetIntegrityCheckAlgorithm(), ret.integrityAlgorithm)) {
+        ret.integrityAlgorithm = IntegrityAlgorithm::None;
+    }
+    ret.lifeTimeInSecond = strategy.GetLifeTimeInSecond();
+    return ret;
+}
+
+void ProfileTable::Rebuild() {
+    // 每个被引用的策略名称只解析一次，使用同一策略的配置共享解析结果
+    std::map<std::string, std::shared_ptr<const ProfileResolution>> resolutions;
+    auto resolve = [this, &resolutions](const std::string &strategyName) {
+        auto &resolution = resolutions[strategyName];
+        if (resolution == nullptr) {
+            auto created = std::make_shared<ProfileResolution>();
+            created->strategyName = strategyName;
+            auto iterator = this->strategies.find(strategyName);
+            if (iterator != this->strategies.end()) {
+                created->strategy = iterator->second;
+                created->plan = MakePlan(*iterator->second);
+            }
+            resolution = created;
+        }
+        return resolution;
+    };
+
+    size_t count =
+        this->profiles.size() + this->applicationProfiles.size() + this->dataTypeProfiles.size();
+    size_t capacity = MinimumSlots;
+    while (capacity < count * 2) {
+        capacity *= 2;
+    }
+    std::vector<Slot> rebuilt(capacity);
+    auto insert = [&rebuilt, capacity](ProfileKind kind, const std::string &application,
+                                       const std::string &dataType,
+                                       const std::shared_ptr<const ProfileResolution> &value) {
+        uint64_t hash = Hash(kind, application, dataType);
+        size_t index = hash & (capacity - 1);
+        while (rebuilt[index].resolution != nullptr) {
+            index = (index + 1) & (capacity - 1);
+        }
+        auto &slot = rebuilt[index];
+        slot.hash = hash;
+        slot.kind = kind;
+        slot.application = application;
+        slot.dataType = dataType;
+        slot.resolution = value;
+    };
+    for (const auto &[key, strategyName] : this->profiles) {
+        insert(ProfileKind::Specific, key.first, key.second, resolve(strategyName));
+    }
+    for (const auto &[application, strategyName] : this->applicationProfiles) {
+        insert(ProfileKind::Application, application, std::string(), resolve(strategyName));
+    }
+    for (const auto &[dataType, strategyName] : this->dataTypeProfiles) {
+        insert(ProfileKind::DataType, std::string(), dataType, resolve(strategyName));
+    }
+    this->slots.swap(rebuilt);
+    this->defaultResolution =
+        this->defaultStrategyName.empty() ? nullptr : resolve(this->defaultStrategyName);
+}
+
+const std::shared_ptr<const ProfileResolution> *
+ProfileTable::Probe(ProfileKind kind, const std::string &application,
+                    const std::string &dataType) const {
+    uint64_t hash = Hash(kind, application, dataType);
+    size_t mask = this->slots.size() - 1;
+    for (size_t index = hash & mask;; index = (index + 1) & mask) {
+        const auto &slot = this->slots[index];
+        if (slot.resolution == nullptr) {
+            return nullptr;
+        }
+        if (slot.hash == hash && slot.kind == kind && slot.application == application &&
+            slot.dataType == dataType) {
+            return &slot.resolution;
+        }
+    }
+}
+
+uint64_t ProfileTable::Hash(ProfileKind kind, const std::string &application,
+                            const std::string &dataType) {
+    uint64_t ret = Core::InternTable::Hash(application);
+    // 组合两个名称的哈希值，再混合高位，使低位足以定位槽位
+    ret = (ret ^ (uint64_t) kind) * 0x9E3779B97F4A7C15ull ^ Core::InternTable::Hash(dataType);
+    ret ^= ret >> 31;
+    ret *= 0xBF58476D1CE4E5B9ull;
+    return ret ^ (ret >> 29);
+}
+} // namespace Fleet::DataManager::Storage
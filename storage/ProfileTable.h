@@ -0,0 +1,242 @@
+/**
+ * @file ProfileTable.h
+ * @brief 存储配置解析表
+ * @details 将（应用名称，数据类型）预先解析为存储策略及其放置计划，写入路径上查找配置只需一次哈希探测
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_PROFILE_TABLE_H
+#define FLEET_DATA_MANAGER_STORAGE_PROFILE_TABLE_H
+
+#include "IntegrityCheck.h"
+#include "Strategy.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief 放置计划，由存储策略预先解析得到
+ */
+struct PlacementPlan {
+    /// 保存数据的设备名称，与策略的位置一一对应
+    std::vector<std::string> devices;
+    /// 纠删码的数据分片数，多副本策略为0
+    uint32_t dataFragments = 0;
+    /// 纠删码的校验分片数，多副本策略为0
+    uint32_t parityFragments = 0;
+    /// 完整性校验算法，策略的算法名称不合法时为None
+    IntegrityAlgorithm integrityAlgorithm = IntegrityAlgorithm::None;
+    /// 数据的生存时间，单位秒，为0时不过期
+    uint32_t lifeTimeInSecond = 0;
+};
+
+/**
+ * @brief 配置的解析结果
+ */
+struct ProfileResolution {
+    /// 配置指定的策略名称
+    std::string strategyName;
+    /// 策略，配置指定的策略不存在时为nullptr
+    std::shared_ptr<const Strategy> strategy;
+    /// 放置计划，策略不存在时为空
+    PlacementPlan plan;
+};
+
+/**
+ * @brief 存储配置解析表类
+ * @details 配置和策略保存在有序映射中，每次修改后重建一张开放寻址、线性探测的扁平哈希表，
+ * 以（配置种类，应用名称，数据类型）为键，值为解析结果。使用同一策略的配置共享同一解析结果。
+ * 查找依次探测具体配置、应用配置和数据类型配置，均未命中时返回默认策略的解析结果。
+ * 哈希值由两个名称的FNV-1a哈希组合而成，查找不构造键，也不分配内存
+ * @note 线程安全，查找只持有共享锁，修改持有独占锁
+ */
+class ProfileTable {
+  public:
+    /**
+     * @brief 构造空的解析表
+     */
+    ProfileTable();
+
+    /**
+     * @brief 析构函数
+     */
+    virtual ~ProfileTable() = default;
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    ProfileTable(const ProfileTable &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    ProfileTable &operator=(const ProfileTable &) = delete;
+
+    /**
+     * @brief 添加或更新策略，引用该策略的配置随之更新
+     * @param[in] strategy 策略
+     */
+    void SetStrategy(const std::shared_ptr<const Strategy> &strategy);
+
+    /**
+     * @brief 删除策略，引用该策略的配置保留策略名称，解析结果中的策略为nullptr
+     * @param[in] name 策略名称
+     * @return 策略存在返回true，否则返回false
+     */
+    bool RemoveStrategy(const std::string &name);
+
+    /**
+     * @brief 设置默认策略
+     * @param[in] name 策略名称，为空字符串时没有默认策略
+     */
+    void SetDefaultStrategy(const std::string &name);
+
+    /**
+     * @brief 添加或更新指定应用和数据类型的配置
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] strategyName 策略名称
+     */
+    void SetProfile(const std::string &application, const std::string &dataType,
+                    const std::string &strategyName);
+
+    /**
+     * @brief 删除指定应用和数据类型的配置
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @return 配置存在返回true，否则返回false
+     */
+    bool RemoveProfile(const std::string &application, const std::string &dataType);
+
+    /**
+     * @brief 添加或更新应用的配置
+     * @param[in] application 应用名称
+     * @param[in] strategyName 策略名称
+     */
+    void SetProfileForApplication(const std::string &application,
+                                  const std::string &strategyName);
+
+    /**
+     * @brief 删除应用的配置
+     * @param[in] application 应用名称
+     * @return 配置存在返回true，否则返回false
+     */
+    bool RemoveProfileForApplication(const std::string &application);
+
+    /**
+     * @brief 添加或更新数据类型的配置
+     * @param[in] dataType 数据类型
+     * @param[in] strategyName 策略名称
+     */
+    void SetProfileForDataType(const std::string &dataType, const std::string &strategyName);
+
+    /**
+     * @brief 删除数据类型的配置
+     * @param[in] dataType 数据类型
+     * @return 配置存在返回true，否则返回false
+     */
+    bool RemoveProfileForDataType(const std::string &dataType);
+
+    /**
+     * @brief 查找应用和数据类型适用的配置
+     * @details 优先级依次为具体配置、应用配置、数据类型配置和默认策略，不分配内存
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @return 解析结果，没有适用的配置且没有默认策略时返回nullptr
+     */
+    std::shared_ptr<const ProfileResolution> Find(const std::string &application,
+                                                  const std::string &dataType) const;
+
+    /**
+     * @brief 由策略生成放置计划
+     * @param[in] strategy 策略
+     * @return 放置计划
+     */
+    static PlacementPlan MakePlan(const Strategy &strategy);
+
+  private:
+    /**
+     * @brief 配置种类
+     */
+    enum class ProfileKind : uint8_t {
+        /// 指定应用和数据类型的配置
+        Specific = 0,
+        /// 应用的配置
+        Application = 1,
+        /// 数据类型的配置
+        DataType = 2,
+    };
+
+    /**
+     * @brief 哈希表的槽位
+     */
+    struct Slot {
+        /// 键的哈希值
+        uint64_t hash = 0;
+        /// 配置种类
+        ProfileKind kind = ProfileKind::Specific;
+        /// 应用名称，数据类型配置为空字符串
+        std::string application;
+        /// 数据类型，应用配置为空字符串
+        std::string dataType;
+        /// 解析结果，空槽位为nullptr
+        std::shared_ptr<const ProfileResolution> resolution;
+    };
+
+    /// 读写锁，保护以下成员
+    mutable std::shared_mutex mutex;
+
+    /// 策略名称到策略的映射
+    std::map<std::string, std::shared_ptr<const Strategy>> strategies;
+
+    /// 默认策略名称
+    std::string defaultStrategyName;
+
+    /// 具体配置，（应用名称，数据类型）到策略名称的映射
+    std::map<std::pair<std::string, std::string>, std::string> profiles;
+
+    /// 应用名称到策略名称的映射
+    std::map<std::string, std::string> applicationProfiles;
+
+    /// 数据类型到策略名称的映射
+    std::map<std::string, std::string> dataTypeProfiles;
+
+    /// 哈希表，槽位数为2的幂，装载率不超过1/2
+    std::vector<Slot> slots;
+
+    /// 默认策略的解析结果
+    std::shared_ptr<const ProfileResolution> defaultResolution;
+
+    /**
+     * @brief 由配置和策略重建哈希表，调用者持有独占锁
+     */
+    void Rebuild();
+
+    /**
+     * @brief 在哈希表中查找，调用者持有锁
+     * @param[in] kind 配置种类
+     * @param[in] application 应用名称，数据类型配置传空字符串
+     * @param[in] dataType 数据类型，应用配置传空字符串
+     * @return 解析结果，未找到返回nullptr
+     */
+    const std::shared_ptr<const ProfileResolution> *
+    Probe(ProfileKind kind, const std::string &application, const std::string &dataType) const;
+
+    /**
+     * @brief 计算键的哈希值
+     * @param[in] kind 配置种类
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @return 哈希值
+     */
+    static uint64_t Hash(ProfileKind kind, const std::string &application,
+                         const std::string &dataType);
+};
+} // namespace Fleet::DataManager::Storage
+#endif // FLEET_DATA_MANAGER_STORAGE_PROFILE_TABLE_H
@@ -0,0 +1,273 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#include "Scrubber.h"
+#include "IoBackend.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Fleet::DataManager::Storage {
+Scrubber::Scrubber(const std::shared_ptr<Core::PluginContext> &pluginContext,
+                   StorageEngine &engine, StrategyResolver resolver,
+                   const ScrubberOptions &options)
+    : pluginContext(pluginContext), engine(engine), resolver(std::move(resolver)),
+      options(options), stopping(false) {
+    this->pluginContext->LogTrace(SOURCE_LOCATION, "调用");
+    this->pluginContext->LogTrace(SOURCE_LOCATION, "返回");
+}
+
+Scrubber::~Scrubber() {
+    this->pluginContext->LogTrace(SOURCE_LOCATION, "调用");
+    this->Stop();
+    this->pluginContext->LogTrace(SOURCE_LOCATION, "返回");
+}
+
+bool Scrubber::Start() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->thread.joinable()) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "巡检已经启动");
+        return false;
+    }
+    this->stopping = false;
+    this->thread = std::thread([this]() { this->Run(); });
+    return true;
+}
+
+void Scrubber::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->condition.notify_all();
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+}
+
+bool Scrubber::ScrubBatch() {
+    std::lock_guard<std::mutex> scrubLock(this->scrubMutex);
+    bool progressed = false;
+    for (const auto &deviceName : this->engine.GetDeviceNames()) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (this->stopping) {
+                return true;
+            }
+        }
+        if (this->finished.count(deviceName) > 0) {
+            continue;
+        }
+        if (this->ScrubDevice(deviceName)) {
+            progressed = true;
+        } else {
+            this->finished.insert(deviceName);
+        }
+    }
+    if (progressed) {
+        return true;
+    }
+
+    // 所有设备均已扫描完一轮，重试写入时记录的待修复数据并核对用量计数
+    uint32_t repaired = this->engine.RepairPending();
+    this->engine.ReconcileUsage();
+    this->finished.clear();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->statistics.repairedKeys += repaired;
+    ++this->statistics.completedPasses;
+    this->pluginContext->LogInfo(SOURCE_LOCATION,
+                                 "完成第 {} 轮巡检, 已校验 {} 个副本和分片, 修复 {} 个数据",
+                                 this->statistics.completedPasses, this->statistics.scannedKeys,
+                                 this->statistics.repairedKeys);
+    return false;
+}
+
+ScrubStatistics Scrubber::GetStatistics() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->statistics;
+}
+
+void Scrubber::Run() {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (this->stopping) {
+                return;
+            }
+        }
+        if (this->ScrubBatch()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->condition.wait_for(lock, std::chrono::seconds(this->options.passIntervalSeconds),
+                                 [this]() { return this->stopping; });
+    }
+}
+
+bool Scrubber::ScrubDevice(const std::string &deviceName) {
+    auto iter = this->cursors.find(deviceName);
+    if (iter == this->cursors.end()) {
+        iter = this->cursors.emplace(deviceName, this->LoadCursor(deviceName)).first;
+    }
+    std::string &cursor = iter->second;
+    std::vector<std::string> keys;
+    // 打开或压缩时发现的损坏记录已移出索引，扫描不到，先行修复
+    this->engine.TakeDamagedKeys(deviceName, keys);
+    for (const auto &key : keys) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            ++this->statistics.corruptedKeys;
+        }
+        this->Repair(key);
+    }
+    if (!this->engine.ListKeys(deviceName, cursor, this->options.batchSize, keys)) {
+        // 设备已卸载，游标文件留在设备上，重新挂载后再次加载
+        this->cursors.erase(iter);
+        return false;
+    }
+    if (keys.empty()) {
+        cursor.clear();
+        this->SaveCursor(deviceName, cursor);
+        return false;
+    }
+
+    for (const auto &key : keys) {
+        uint64_t size = 0;
+        bool valid = this->engine.VerifyKey(deviceName, key, this->buffer, size);
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            ++this->statistics.scannedKeys;
+            this->statistics.scannedBytes += size;
+            if (!valid) {
+                ++this->statistics.corruptedKeys;
+            }
+        }
+        if (!valid) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "巡检发现设备 {} 上的数据损坏",
+                                          deviceName);
+            this->Repair(key);
+        }
+        cursor = key;
+        if (!this->Throttle(size)) {
+            break;
+        }
+    }
+    this->SaveCursor(deviceName, cursor);
+    return true;
+}
+
+void Scrubber::Repair(const std::string &encodedKey) {
+    std::string application;
+    std::string dataType;
+    std::string name;
+    std::string version;
+    bool repaired = false;
+    if (ChunkStore::IsChunkKey(encodedKey)) {
+        // 分块不属于任何数据，从其他设备上内容相符的分块修复
+        repaired = this->engine.RepairChunk(encodedKey);
+        if (!repaired) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "修复分块失败");
+        }
+    } else if (!StorageEngine::DecodeKey(encodedKey, application, dataType, name, version)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "无法解析数据键, 未修复");
+    } else {
+        DataKey key(application, dataType, name, version);
+        auto strategy = this->resolver ? this->resolver(key) : nullptr;
+        if (strategy == nullptr) {
+            this->pluginContext->LogError(SOURCE_LOCATION,
+                                          "无法确定数据 {}/{}/{}/{} 的存储策略, 未修复",
+                                          application, dataType, name, version);
+        } else if (!this->engine.RepairData(*strategy, key)) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "修复数据 {}/{}/{}/{} 失败",
+                                          application, dataType, name, version);
+        } else {
+            this->pluginContext->LogInfo(SOURCE_LOCATION, "已修复数据 {}/{}/{}/{}", application,
+                                         dataType, name, version);
+            repaired = true;
+        }
+    }
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (repaired) {
+        ++this->statistics.repairedKeys;
+    } else {
+        ++this->statistics.unrepairedKeys;
+    }
+}
+
+bool Scrubber::Throttle(uint64_t bytes) {
+    double seconds = 0;
+    if (this->options.bytesPerSecond > 0) {
+        seconds = std::max(seconds, (double) bytes / (double) this->options.bytesPerSecond);
+    }
+    if (this->options.operationsPerSecond > 0) {
+        seconds = std::max(seconds, 1.0 / this->options.operationsPerSecond);
+    }
+    auto now = std::chrono::steady_clock::now();
+    this->nextRead = std::max(this->nextRead, now) +
+                     std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double>(seconds));
+    std::unique_lock<std::mutex> lock(this->mutex);
+    return !this->condition.wait_until(lock, this->nextRead, [this]() { return this->stopping; });
+}
+
+std::string Scrubber::LoadCursor(const std::string &deviceName) {
+    std::string directory = this->engine.GetStoreDirectory(deviceName);
+    if (directory.empty()) {
+        return std::string();
+    }
+    std::string path = (std::filesystem::path(directory) / this->options.cursorFileName).string();
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::string();
+    }
+    std::string ret;
+    char chunk[4096];
+    ssize_t length = 0;
+    while ((length = read(fd, chunk, sizeof(chunk))) > 0) {
+        ret.append(chunk, (size_t) length);
+    }
+    if (length < 0) {
+        this->pluginContext->LogWarn(SOURCE_LOCATION, "读取游标文件 {} 失败 ({}), 从头开始巡检",
+                                     path, strerror(errno));
+        ret.clear();
+    }
+    close(fd);
+    return ret;
+}
+
+bool Scrubber::SaveCursor(const std::string &deviceName, const std::string &cursor) {
+    std::string directory = this->engine.GetStoreDirectory(deviceName);
+    if (directory.empty()) {
+        return false;
+    }
+    std::string path = (std::filesystem::path(directory) / this->options.cursorFileName).string();
+    std::string temporary = path + ".tmp";
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "无法创建游标文件 {} ({})", temporary,
+                                      strerror(errno));
+        return false;
+    }
+    bool success = write(fd, cursor.data(), cursor.size()) == (ssize_t) cursor.size() &&
+                   fdatasync(fd) == 0;
+    close(fd);
+    if (!success || rename(temporary.c_str(), path.c_str()) != 0) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "保存游标文件 {} 失败 ({})", path,
+                                      strerror(errno));
+        unlink(temporary.c_str());
+        return false;
+    }
+    // 重命名落盘之前掉电, 重启后仍读到旧的游标
+    if (!IoBackend::SyncDirectory(directory)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "目录 {} 落盘失败 ({})", directory,
+                                      strerror(errno));
+        return false;
+    }
+    return true;
+}
+} // namespace Fleet::DataManager::Storage
@@ -0,0 +1,213 @@
+/**
+ * @file Scrubber.h
+ * @brief 后台数据巡检
+ * @details 逐设备增量扫描已存储的副本和分片，校验数据摘要并自动修复损坏的数据
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_SCRUBBER_H
+#define FLEET_DATA_MANAGER_STORAGE_SCRUBBER_H
+
+#include "DataKey.h"
+#include "PluginContext.h"
+#include "StorageEngine.h"
+#include "Strategy.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief 巡检配置
+ */
+struct ScrubberOptions {
+    /// 每秒最多读取的字节数，为0时不限制
+    uint64_t bytesPerSecond = 32ull * 1024 * 1024;
+    /// 每秒最多的读操作数，为0时不限制
+    uint32_t operationsPerSecond = 200;
+    /// 每批从索引中取出的键数，每批结束后保存一次游标
+    uint32_t batchSize = 256;
+    /// 所有设备扫描一轮后到下一轮开始的间隔，单位秒
+    uint32_t passIntervalSeconds = 24 * 3600;
+    /// 游标文件名，位于各设备存储的段文件目录下
+    std::string cursorFileName = "scrub-cursor";
+};
+
+/**
+ * @brief 巡检统计信息
+ */
+struct ScrubStatistics {
+    /// 已校验的副本和分片数
+    uint64_t scannedKeys = 0;
+    /// 已校验的字节数
+    uint64_t scannedBytes = 0;
+    /// 校验失败的副本和分片数
+    uint64_t corruptedKeys = 0;
+    /// 已修复的数据数
+    uint64_t repairedKeys = 0;
+    /// 无法修复的数据数
+    uint64_t unrepairedKeys = 0;
+    /// 已完成的扫描轮数
+    uint64_t completedPasses = 0;
+};
+
+/**
+ * @brief 巡检类
+ * @details 后台线程轮流从每个设备取出一批键，逐个读取并校验完整性摘要，
+ * 校验失败时按存储策略从其他副本或分片修复，分块从其他设备上哈希相符的分块修复，
+ * 存储在打开或压缩时移出索引的损坏键也在扫描设备时修复。
+ * 每个设备的游标是最后校验的编码键，每批结束后写入设备存储目录下的游标文件，重启后从游标处继续。
+ * 所有设备扫描完一轮后重试写入时记录的待修复数据并核对各设备的用量计数，再等待下一轮。
+ * 读取按字节数和操作数限速，每次读取后推迟下一次读取的时间，不会在空闲后突发读取
+ * @note 存储中不保存存储策略，修复前通过策略解析函数获取数据所属的策略
+ */
+class Scrubber {
+  public:
+    /// 策略解析函数类型，返回数据所属的存储策略，无法确定时返回nullptr
+    using StrategyResolver = std::function<std::shared_ptr<Strategy>(const DataKey &)>;
+
+    /**
+     * @brief 构造巡检
+     * @param[in] pluginContext 插件上下文，用于日志记录
+     * @param[in] engine 存储引擎，生存期必须长于巡检
+     * @param[in] resolver 策略解析函数
+     * @param[in] options 巡检配置
+     */
+    Scrubber(const std::shared_ptr<Core::PluginContext> &pluginContext, StorageEngine &engine,
+             StrategyResolver resolver, const ScrubberOptions &options = ScrubberOptions());
+
+    /**
+     * @brief 析构函数，停止后台线程
+     */
+    virtual ~Scrubber();
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    Scrubber(const Scrubber &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    Scrubber &operator=(const Scrubber &) = delete;
+
+    /**
+     * @brief 启动后台线程
+     * @return 启动成功返回true，已经启动返回false
+     */
+    bool Start();
+
+    /**
+     * @brief 停止后台线程，正在校验的键完成后返回
+     */
+    void Stop();
+
+    /**
+     * @brief 立即扫描一批键
+     * @details 后台线程未启动时可用于手动推进巡检，同样受限速约束
+     * @return 本批还有键被校验返回true，所有设备均已扫描完一轮返回false
+     */
+    bool ScrubBatch();
+
+    /**
+     * @brief 获取统计信息
+     * @return 统计信息
+     */
+    ScrubStatistics GetStatistics();
+
+  private:
+    /// 插件上下文
+    std::shared_ptr<Core::PluginContext> pluginContext;
+
+    /// 存储引擎
+    StorageEngine &engine;
+
+    /// 策略解析函数
+    StrategyResolver resolver;
+
+    /// 巡检配置
+    ScrubberOptions options;
+
+    /// 后台线程
+    std::thread thread;
+
+    /// 互斥锁，保护停止标志和统计信息
+    std::mutex mutex;
+
+    /// 停止时唤醒后台线程
+    std::condition_variable condition;
+
+    /// 停止标志
+    bool stopping;
+
+    /// 统计信息
+    ScrubStatistics statistics;
+
+    /// 扫描锁，串行化后台线程和手动调用的ScrubBatch，保护以下的扫描状态
+    std::mutex scrubMutex;
+
+    /// 设备名称到游标的映射，设备首次被扫描时从游标文件加载
+    std::map<std::string, std::string> cursors;
+
+    /// 本轮已扫描完的设备
+    std::set<std::string> finished;
+
+    /// 限速允许下一次读取的最早时间
+    std::chrono::steady_clock::time_point nextRead;
+
+    /// 读取缓冲区
+    std::vector<char> buffer;
+
+    /**
+     * @brief 后台线程主循环
+     */
+    void Run();
+
+    /**
+     * @brief 扫描设备上的一批键
+     * @param[in] deviceName 设备名称
+     * @return 本批有键被校验返回true，设备已扫描完一轮返回false
+     */
+    bool ScrubDevice(const std::string &deviceName);
+
+    /**
+     * @brief 修复校验失败的数据
+     * @param[in] encodedKey 编码后的数据键
+     */
+    void Repair(const std::string &encodedKey);
+
+    /**
+     * @brief 按限速等待
+     * @details 每个键计一次读操作，等待时间取字节数和操作数两个限制中较长的一个
+     * @param[in] bytes 刚读取的字节数
+     * @return 等待结束返回true，等待期间被停止返回false
+     */
+    bool Throttle(uint64_t bytes);
+
+    /**
+     * @brief 加载设备的游标
+     * @param[in] deviceName 设备名称
+     * @return 游标，没有游标文件时为空字符串
+     */
+    std::string LoadCursor(const std::string &deviceName);
+
+    /**
+     * @brief 保存设备的游标
+     * @details 先写入临时文件再重命名，崩溃后游标文件要么是旧值要么是新值
+     * @param[in] deviceName 设备名称
+     * @param[in] cursor 游标
+     * @return 保存成功返回true，否则返回false
+     */
+    bool SaveCursor(const std::string &deviceName, const std::string &cursor);
+};
+} // namespace Fleet::DataManager::Storage
+#endif // FLEET_DATA_MANAGER_STORAGE_SCRUBBER_H
@@ -0,0 +1,1517 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#include "StorageEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <future>
+#include <random>
+#include <set>
+#include <sys/statvfs.h>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+namespace {
+/// 分片魔数
+constexpr uint32_t FragmentMagic = 0x47415246;
+/// 分片头长度：魔数4字节，k、m、分片序号和保留字段各1字节，原始数据大小8字节，写入标识8字节
+constexpr uint64_t FragmentHeaderSize = 24;
+
+void WriteFragmentHeader(char *record, const ErasureCode &code, uint32_t index, uint64_t size,
+                         uint64_t writeId) {
+    uint8_t header[4] = {(uint8_t) code.GetDataFragments(), (uint8_t) code.GetParityFragments(),
+                         (uint8_t) index, 0};
+    memcpy(record, &FragmentMagic, sizeof(FragmentMagic));
+    memcpy(record + 4, header, sizeof(header));
+    memcpy(record + 8, &size, sizeof(size));
+    memcpy(record + 16, &writeId, sizeof(writeId));
+}
+
+/**
+ * @brief 生成写入标识，同一次写入的所有副本和分片相同，之后的写入总是更大
+ * @details 以纳秒时间戳为基础，重启后仍大于之前的标识
+ */
+uint64_t NextWriteId() {
+    static std::atomic<uint64_t> last{0};
+    auto now = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+                   .count();
+    uint64_t previous = last.load();
+    uint64_t ret = 0;
+    do {
+        ret = std::max(now, previous + 1);
+    } while (!last.compare_exchange_weak(previous, ret));
+    return ret;
+}
+
+/**
+ * @brief 计算编码键中“应用、数据类型”分组前缀的长度
+ */
+size_t GetUsageGroupSize(const std::string &encodedKey) {
+    size_t position = encodedKey.find('\0');
+    if (position != std::string::npos) {
+        position = encodedKey.find('\0', position + 1);
+    }
+    return position == std::string::npos ? encodedKey.size() : position;
+}
+
+/**
+ * @brief 选择位置时的候选设备
+ */
+struct PlacementCandidate {
+    /// 策略中的位置
+    const Location *location;
+    /// 写入后的剩余空间，单位字节
+    uint64_t available;
+    /// 近期平均读取延迟，单位纳秒
+    uint64_t latency;
+    /// 写队列中未完成的写入数
+    uint32_t queueDepth;
+};
+
+/**
+ * @brief 从前count个候选中按剩余空间加权随机抽取一个
+ */
+size_t SampleCandidate(const std::vector<PlacementCandidate> &candidates, size_t count) {
+    thread_local std::mt19937_64 random(std::random_device{}());
+    double total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += (double) candidates[i].available;
+    }
+    double point = std::uniform_real_distribution<double>(0, total)(random);
+    for (size_t i = 0; i + 1 < count; ++i) {
+        point -= (double) candidates[i].available;
+        if (point < 0) {
+            return i;
+        }
+    }
+    return count - 1;
+}
+
+/**
+ * @brief 比较两个候选的负载，负载为未完成的写入数加1与平均延迟之积，相同时比较剩余空间
+ */
+bool IsLessLoaded(const PlacementCandidate &a, const PlacementCandidate &b) {
+    double loadA = (double) (a.queueDepth + 1) * (double) a.latency;
+    double loadB = (double) (b.queueDepth + 1) * (double) b.latency;
+    return loadA != loadB ? loadA < loadB : a.available > b.available;
+}
+} // namespace
+
+StorageEngine::StorageEngine(const std::shared_ptr<Core::PluginContext> &pluginContext,
+                             const StorageEngineOptions &options)
+    : pluginContext(pluginContext), options(options),
+      chunker(options.chunkMinimumSize, options.chunkAverageSize, options.chunkMaximumSize),
+      cache(options.cacheCapacity, options.cacheShards),
+      readers(std::make_unique<Core::Executor>((int) options.readerThreads)),
+      spaceLimit(options.spaceLimit), usedSpace(std::make_shared<std::atomic<uint64_t>>(0)) {
+    this->pluginContext->LogTrace(SOURCE_LOCATION, "调用");
+    this->pluginContext->LogTrace(SOURCE_LOCATION, "返回");
+}
+
+StorageEngine::~StorageEngine() {
+    this->pluginContext->LogTrace(SOURCE_LOCATION, "调用");
+    // 被取消的对冲读取可能仍在进行，先等待其结束
+    this->readers.reset();
+    std::map<std::string, std::shared_ptr<Core::Executor>> writers;
+    {
+        std::unique_lock<std::shared_mutex> lock(this->storesMutex);
+        writers.swap(this->writers);
+    }
+    // 写队列析构时执行完剩余的写入，之后才能关闭存储
+    writers.clear();
+    std::unique_lock<std::shared_mutex> lock(this->storesMutex);
+    for (const auto &elem : this->stores) {
+        elem.second->Close();
+    }
+    this->stores.clear();
+    this->chunkStores.clear();
+    this->pluginContext->LogTrace(SOURCE_LOCATION, "返回");
+}
+
+bool StorageEngine::AddDevice(const std::shared_ptr<Device> &device) {
+    std::unique_lock<std::shared_mutex> lock(this->storesMutex);
+    if (this->stores.find(device->GetName()) != this->stores.end()) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "设备 {} 已挂载", device->GetName());
+        return false;
+    }
+    std::string directory =
+        (std::filesystem::path(device->GetDirectory()) / this->options.subdirectory).string();
+    LogStructuredStoreOptions storeOptions = this->options.storeOptions;
+    auto threshold = this->options.directWriteThresholds.find(device->GetName());
+    if (threshold != this->options.directWriteThresholds.end()) {
+        storeOptions.directWriteThreshold = threshold->second;
+    }
+    auto store =
+        std::make_shared<LogStructuredStore>(this->pluginContext, directory, storeOptions);
+    auto chunkStore = std::make_shared<ChunkStore>(this->pluginContext, store);
+    // 过期删除的分块清单不再引用其分块，过期删除的数据可能仍在缓存中
+    std::weak_ptr<ChunkStore> weakChunkStore = chunkStore;
+    store->SetExpiryListener([this, weakChunkStore](const std::vector<std::string> &keys) {
+        auto chunkStore = weakChunkStore.lock();
+        if (chunkStore != nullptr) {
+            chunkStore->Release(keys);
+        }
+        std::string application;
+        std::string dataType;
+        std::string name;
+        std::string version;
+        for (const auto &encodedKey : keys) {
+            if (DecodeKey(encodedKey, application, dataType, name, version)) {
+                this->InvalidateCache(encodedKey, EncodePrefix(application, dataType, name));
+            }
+        }
+    });
+    store->SetUsageGroup(GetUsageGroupSize);
+    store->SetUsageCounter(this->usedSpace);
+    if (!store->Open()) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "无法打开设备 {} 上的存储",
+                                      device->GetName());
+        return false;
+    }
+    chunkStore->Open();
+    this->stores[device->GetName()] = store;
+    this->chunkStores[device->GetName()] = chunkStore;
+    this->writers[device->GetName()] = std::make_shared<Core::Executor>(1);
+    return true;
+}
+
+bool StorageEngine::RemoveDevice(const std::string &name) {
+    std::shared_ptr<LogStructuredStore> store;
+    std::shared_ptr<ChunkStore> chunkStore;
+    std::shared_ptr<Core::Executor> writer;
+    {
+        std::unique_lock<std::shared_mutex> lock(this->storesMutex);
+        auto iter = this->stores.find(name);
+        if (iter == this->stores.end()) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "设备 {} 未挂载", name);
+            return false;
+        }
+        store = iter->second;
+        this->stores.erase(iter);
+        chunkStore = this->chunkStores[name];
+        this->chunkStores.erase(name);
+        auto writerIter = this->writers.find(name);
+        if (writerIter != this->writers.end()) {
+            writer = writerIter->second;
+            this->writers.erase(writerIter);
+        }
+    }
+    // 等待已提交的写入结束后再关闭存储
+    writer.reset();
+    store->Close();
+    this->cache.Clear();
+    return true;
+}
+
+bool StorageEngine::WriteData(const Strategy &strategy, const DataKey &key,
+                              const std::shared_ptr<DataBlock> &dataBlock) {
+    return this->WriteData(strategy, key, dataBlock, nullptr);
+}
+
+bool StorageEngine::WriteData(const Strategy &strategy, const DataKey &key,
+                              const std::shared_ptr<DataBlock> &dataBlock,
+                              const std::shared_ptr<Core::CancellationToken> &token) {
+    if (Core::IsCancelled(token)) {
+        return false;
+    }
+    std::string encodedKey =
+        EncodeKey(key.GetApplication(), key.GetDataType(), key.GetName(), key.GetVersion());
+    uint32_t dataFragments = 0;
+    uint32_t parityFragments = 0;
+    if (ErasureCode::Parse(strategy.GetErrorCorrectingAlgorithm(), dataFragments,
+                           parityFragments)) {
+        ErasureCode code(dataFragments, parityFragments);
+        uint64_t recordSize = FragmentHeaderSize + code.GetFragmentSize(dataBlock->GetSize());
+        if (!this->CheckSpaceLimit(key, recordSize * (dataFragments + parityFragments))) {
+            return false;
+        }
+        bool success = this->WriteFragments(strategy, key, encodedKey, dataBlock, code, token);
+        this->InvalidateCache(encodedKey, EncodePrefix(key.GetApplication(), key.GetDataType(),
+                                                       key.GetName()));
+        return success;
+    }
+    if (!this->CheckSpaceLimit(key, dataBlock->GetSize() * strategy.GetLocations().size())) {
+        return false;
+    }
+    // 分块和哈希只计算一次，所有副本共用
+    auto chunks = this->SplitChunks(dataBlock->GetData(), dataBlock->GetSize());
+    std::vector<ReplicaWrite> writes;
+    writes.reserve(strategy.GetLocations().size());
+    for (const auto &location : strategy.GetLocations()) {
+        writes.push_back(
+            ReplicaWrite{location.GetDeviceName(), dataBlock->GetData(), dataBlock->GetSize()});
+    }
+    bool success =
+        !writes.empty() &&
+        this->FanOutWrites(strategy, key, encodedKey, writes, dataBlock, chunks,
+                           this->GetWriteQuorum(strategy, (uint32_t) writes.size()),
+                           NextWriteId(), token);
+    this->InvalidateCache(encodedKey,
+                          EncodePrefix(key.GetApplication(), key.GetDataType(), key.GetName()));
+    return success;
+}
+
+std::shared_ptr<Strategy> StorageEngine::PlaceData(const Strategy &strategy, uint32_t replicas,
+                                                   uint64_t size) {
+    // 候选设备：策略中已挂载且剩余空间足够的不同设备
+    std::vector<PlacementCandidate> candidates;
+    std::set<std::string> seen;
+    for (const auto &location : strategy.GetLocations()) {
+        const auto &deviceName = location.GetDeviceName();
+        if (!seen.insert(deviceName).second) {
+            continue;
+        }
+        std::string directory = this->GetStoreDirectory(deviceName);
+        struct statvfs status {};
+        if (directory.empty() || statvfs(directory.c_str(), &status) != 0) {
+            continue;
+        }
+        uint64_t available = (uint64_t) status.f_bavail * status.f_frsize;
+        if (available <= size) {
+            continue;
+        }
+        // 延迟只在读取时更新，过小的差异若参与比较，偶然变慢的设备会长期不被选中而无法更新延迟
+        uint64_t latency = std::max(this->latency.GetAverage(deviceName),
+                                    this->options.placementLatencyFloor * 1000);
+        candidates.push_back(PlacementCandidate{&location, available - size, latency, 0});
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->pendingMutex);
+        for (auto &candidate : candidates) {
+            auto iter = this->queueDepths.find(candidate.location->GetDeviceName());
+            candidate.queueDepth = iter == this->queueDepths.end() ? 0 : iter->second;
+        }
+    }
+
+    uint32_t dataFragments = 0;
+    uint32_t parityFragments = 0;
+    uint32_t count = (uint32_t) candidates.size();
+    if (ErasureCode::Parse(strategy.GetErrorCorrectingAlgorithm(), dataFragments,
+                           parityFragments)) {
+        count = dataFragments + parityFragments;
+    } else if (replicas != 0) {
+        count = replicas;
+    }
+    if (count == 0 || candidates.size() < count) {
+        this->pluginContext->LogError(SOURCE_LOCATION,
+                                      "存储策略 {} 需要 {} 个设备存放 {} 字节, 只有 {} 个可用",
+                                      strategy.GetName(), count, size, candidates.size());
+        return nullptr;
+    }
+
+    // 按剩余空间加权随机抽取两个候选，保留负载较低的一个
+    std::vector<Location> chosen;
+    chosen.reserve(count);
+    while (chosen.size() < count) {
+        size_t first = SampleCandidate(candidates, candidates.size());
+        size_t best = first;
+        if (candidates.size() > 1) {
+            std::swap(candidates[first], candidates.back());
+            size_t second = SampleCandidate(candidates, candidates.size() - 1);
+            first = candidates.size() - 1;
+            best = IsLessLoaded(candidates[second], candidates[first]) ? second : first;
+        }
+        chosen.push_back(*candidates[best].location);
+        candidates.erase(candidates.begin() + (ptrdiff_t) best);
+    }
+    return std::make_shared<Strategy>(strategy.GetName(), strategy.GetDescription(), chosen,
+                                      strategy.GetErrorCorrectingAlgorithm(),
+                                      strategy.GetIntegrityCheckAlgorithm(),
+                                      strategy.GetLifeTimeInSecond());
+}
+
+bool StorageEngine::WritePlaced(const Strategy &strategy, const DataKey &key,
+                                const std::shared_ptr<DataBlock> &dataBlock, uint32_t replicas,
+                                std::vector<std::string> &locations) {
+    locations.clear();
+    auto placed = this->PlaceData(strategy, replicas, dataBlock->GetSize());
+    if (placed == nullptr) {
+        return false;
+    }
+    if (!this->WriteData(*placed, key, dataBlock)) {
+        return false;
+    }
+    locations.reserve(placed->GetLocations().size());
+    for (const auto &location : placed->GetLocations()) {
+        locations.push_back(location.GetDeviceName());
+    }
+    return true;
+}
+
+std::shared_ptr<Strategy> StorageEngine::LocateData(const Strategy &strategy,
+                                                    const std::vector<std::string> &locations) {
+    std::vector<Location> located;
+    located.reserve(locations.size());
+    for (const auto &deviceName : locations) {
+        auto iter = std::find_if(
+            strategy.GetLocations().begin(), strategy.GetLocations().end(),
+            [&deviceName](const Location &location) {
+                return location.GetDeviceName() == deviceName;
+            });
+        located.emplace_back(deviceName, iter == strategy.GetLocations().end()
+                                             ? std::string()
+                                             : iter->GetRelativePath());
+    }
+    return std::make_shared<Strategy>(strategy.GetName(), strategy.GetDescription(), located,
+                                      strategy.GetErrorCorrectingAlgorithm(),
+                                      strategy.GetIntegrityCheckAlgorithm(),
+                                      strategy.GetLifeTimeInSecond());
+}
+
+std::shared_ptr<DataBlock> StorageEngine::ReadData(const Strategy &strategy, const DataKey &key) {
+    return this->ReadData(strategy, key, nullptr);
+}
+
+std::shared_ptr<DataBlock>
+StorageEngine::ReadData(const Strategy &strategy, const DataKey &key,
+                        const std::shared_ptr<Core::CancellationToken> &token) {
+    std::string encodedKey =
+        EncodeKey(key.GetApplication(), key.GetDataType(), key.GetName(), key.GetVersion());
+    uint64_t ticket = 0;
+    auto cached = this->cache.Get(encodedKey, &ticket);
+    if (cached != nullptr) {
+        return cached;
+    }
+    auto dataBlock = this->ReadEncodedKey(strategy, encodedKey, token);
+    if (dataBlock != nullptr) {
+        this->cache.Put(encodedKey, dataBlock, ticket);
+    }
+    return dataBlock;
+}
+
+std::shared_ptr<DataBlock> StorageEngine::ReadLatest(const Strategy &strategy,
+                                                     const std::string &application,
+                                                     const std::string &dataType,
+                                                     const std::string &name) {
+    return this->ReadLatest(strategy, application, dataType, name, nullptr);
+}
+
+std::shared_ptr<DataBlock>
+StorageEngine::ReadLatest(const Strategy &strategy, const std::string &application,
+                          const std::string &dataType, const std::string &name,
+                          const std::shared_ptr<Core::CancellationToken> &token) {
+    std::string prefix = EncodePrefix(application, dataType, name);
+    std::string cacheKey = prefix;
+    cacheKey.push_back('\0');
+    uint64_t ticket = 0;
+    auto cached = this->cache.Get(cacheKey, &ticket);
+    if (cached != nullptr) {
+        return cached;
+    }
+    std::set<std::string> tried;
+    for (const auto &location : strategy.GetLocations()) {
+        if (Core::IsCancelled(token)) {
+            return nullptr;
+        }
+        auto store = this->GetStore(location.GetDeviceName());
+        if (store == nullptr || this->HasPendingWrites(location.GetDeviceName(), prefix)) {
+            continue;
+        }
+        std::string latest;
+        if (!store->FindLatest(prefix, latest) || !tried.insert(latest).second) {
+            continue;
+        }
+        auto dataBlock = this->ReadEncodedKey(strategy, latest, token);
+        if (dataBlock != nullptr) {
+            this->cache.Put(cacheKey, dataBlock, ticket);
+            return dataBlock;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<DataBlock> StorageEngine::ReadDataMapped(const Strategy &strategy,
+                                                         const DataKey &key, MapAdvice advice) {
+    if (IsErasureCoded(strategy)) {
+        // 分片需要解码拼接，无法直接映射
+        return this->ReadData(strategy, key);
+    }
+    std::string encodedKey =
+        EncodeKey(key.GetApplication(), key.GetDataType(), key.GetName(), key.GetVersion());
+    for (const auto &location : strategy.GetLocations()) {
+        auto store = this->GetChunkStore(location.GetDeviceName());
+        if (store == nullptr || this->HasPendingWrites(location.GetDeviceName(), encodedKey) ||
+            this->IsRepairPending(location.GetDeviceName(), encodedKey)) {
+            continue;
+        }
+        auto dataBlock = store->GetMapped(encodedKey, advice);
+        if (dataBlock != nullptr) {
+            return dataBlock;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<DataBlock> StorageEngine::ReadLatestMapped(const Strategy &strategy,
+                                                           const std::string &application,
+                                                           const std::string &dataType,
+                                                           const std::string &name,
+                                                           MapAdvice advice) {
+    if (IsErasureCoded(strategy)) {
+        return this->ReadLatest(strategy, application, dataType, name);
+    }
+    std::string prefix = EncodePrefix(application, dataType, name);
+    for (const auto &location : strategy.GetLocations()) {
+        auto store = this->GetChunkStore(location.GetDeviceName());
+        if (store == nullptr || this->HasPendingWrites(location.GetDeviceName(), prefix)) {
+            continue;
+        }
+        std::string latest;
+        if (!store->GetStore().FindLatest(prefix, latest) ||
+            this->IsRepairPending(location.GetDeviceName(), latest)) {
+            continue;
+        }
+        auto dataBlock = store->GetMapped(latest, advice);
+        if (dataBlock != nullptr) {
+            return dataBlock;
+        }
+    }
+    return nullptr;
+}
+
+bool StorageEngine::RemoveData(const Strategy &strategy, const DataKey &key) {
+    std::string encodedKey =
+        EncodeKey(key.GetApplication(), key.GetDataType(), key.GetName(), key.GetVersion());
+    bool removed = false;
+    for (const auto &location : strategy.GetLocations()) {
+        if (this->Mutate(location.GetDeviceName(), [&encodedKey](ChunkStore &store) {
+                return store.Remove(encodedKey);
+            })) {
+            removed = true;
+        }
+    }
+    this->InvalidateCache(encodedKey,
+                          EncodePrefix(key.GetApplication(), key.GetDataType(), key.GetName()));
+    return removed;
+}
+
+bool StorageEngine::RemoveAllVersions(const Strategy &strategy, const std::string &application,
+                                      const std::string &dataType, const std::string &name) {
+    std::string prefix = EncodePrefix(application, dataType, name);
+    bool removed = false;
+    for (const auto &location : strategy.GetLocations()) {
+        std::vector<std::string> keys;
+        // 扫描和删除在同一个写队列任务中执行，不会遗漏之前提交的版本
+        this->Mutate(location.GetDeviceName(), [&](ChunkStore &store) {
+            store.GetStore().Scan(prefix, [&keys](const std::string &key, uint64_t) {
+                keys.push_back(key);
+                return true;
+            });
+            for (const auto &key : keys) {
+                if (store.Remove(key)) {
+                    removed = true;
+                }
+            }
+            return true;
+        });
+        for (const auto &key : keys) {
+            this->InvalidateCache(key, prefix);
+        }
+    }
+    return removed;
+}
+
+bool StorageEngine::RepairData(const Strategy &strategy, const DataKey &key) {
+    std::string encodedKey =
+        EncodeKey(key.GetApplication(), key.GetDataType(), key.GetName(), key.GetVersion());
+    uint32_t dataFragments = 0;
+    uint32_t parityFragments = 0;
+    if (ErasureCode::Parse(strategy.GetErrorCorrectingAlgorithm(), dataFragments,
+                           parityFragments)) {
+        ErasureCode code(dataFragments, parityFragments);
+        bool repaired = false;
+        bool success = this->RepairFragments(strategy, encodedKey, code, repaired);
+        if (repaired) {
+            this->InvalidateCache(encodedKey, EncodePrefix(key.GetApplication(),
+                                                           key.GetDataType(), key.GetName()));
+        }
+        return success;
+    }
+    return this->RepairReplicas(strategy, key, encodedKey, {});
+}
+
+uint32_t StorageEngine::RepairPending() {
+    std::vector<std::pair<std::string, RepairRecord>> records;
+    {
+        std::lock_guard<std::mutex> lock(this->repairsMutex);
+        records.assign(this->repairs.begin(), this->repairs.end());
+    }
+    uint32_t ret = 0;
+    for (const auto &elem : records) {
+        const RepairRecord &record = elem.second;
+        bool success = IsErasureCoded(*record.strategy)
+                           ? this->RepairData(*record.strategy, record.key)
+                           : this->RepairReplicas(*record.strategy, record.key, elem.first,
+                                                  record.failedDevices);
+        if (!success) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(this->repairsMutex);
+        auto iter = this->repairs.find(elem.first);
+        // 修复期间同一数据再次写入失败时保留新的记录
+        if (iter != this->repairs.end() && iter->second.writeId == record.writeId &&
+            iter->second.failedDevices == record.failedDevices) {
+            this->repairs.erase(iter);
+            this->repairCount.fetch_sub(1);
+        }
+        ++ret;
+    }
+    return ret;
+}
+
+size_t StorageEngine::GetPendingRepairCount() {
+    std::lock_guard<std::mutex> lock(this->repairsMutex);
+    return this->repairs.size();
+}
+
+void StorageEngine::SetCacheCapacity(uint64_t capacity) {
+    this->cache.SetCapacity(capacity);
+}
+
+ReadCacheStatistics StorageEngine::GetCacheStatistics() {
+    return this->cache.GetStatistics();
+}
+
+uint64_t StorageEngine::GetReadLatency(const std::string &deviceName) {
+    return this->latency.GetAverage(deviceName);
+}
+
+void StorageEngine::SetSpaceLimit(uint64_t limit) {
+    this->spaceLimit.store(limit);
+}
+
+uint64_t StorageEngine::GetSpaceLimit() const {
+    return this->spaceLimit.load();
+}
+
+uint64_t StorageEngine::GetUsedSpace() {
+    return this->usedSpace->load(std::memory_order_relaxed);
+}
+
+void StorageEngine::GetDeviceUsage(std::map<std::string, uint64_t> &usage) {
+    usage.clear();
+    std::shared_lock<std::shared_mutex> lock(this->storesMutex);
+    for (const auto &elem : this->stores) {
+        usage[elem.first] = elem.second->GetLiveBytes();
+    }
+}
+
+void StorageEngine::GetApplicationUsage(
+    std::map<std::string, std::map<std::string, uint64_t>> &usage) {
+    usage.clear();
+    std::vector<std::shared_ptr<LogStructuredStore>> stores;
+    {
+        std::shared_lock<std::shared_mutex> lock(this->storesMutex);
+        for (const auto &elem : this->stores) {
+            stores.push_back(elem.second);
+        }
+    }
+    std::map<std::string, uint64_t> groups;
+    for (const auto &store : stores) {
+        store->GetUsage(groups);
+        for (const auto &elem : groups) {
+            size_t separator = elem.first.find('\0');
+            if (separator == std::string::npos) {
+                continue;
+            }
+            usage[elem.first.substr(0, separator)][elem.first.substr(separator + 1)] +=
+                elem.second;
+        }
+    }
+}
+
+bool StorageEngine::ReconcileUsage() {
+    bool ret = true;
+    for (const auto &deviceName : this->GetDeviceNames()) {
+        auto store = this->GetStore(deviceName);
+        if (store != nullptr && !store->ReconcileUsage()) {
+            ret = false;
+        }
+    }
+    return ret;
+}
+
+ChunkStatistics StorageEngine::GetChunkStatistics() {
+    std::shared_lock<std::shared_mutex> lock(this->storesMutex);
+    ChunkStatistics ret;
+    for (const auto &elem : this->chunkStores) {
+        ChunkStatistics statistics = elem.second->GetStatistics();
+        ret.manifests += statistics.manifests;
+        ret.chunks += statistics.chunks;
+        ret.storedBytes += statistics.storedBytes;
+        ret.referencedBytes += statistics.referencedBytes;
+    }
+    return ret;
+}
+
+bool StorageEngine::RepairChunk(const std::string &chunkKey) {
+    std::vector<std::string> damaged;
+    std::shared_ptr<DataBlock> dataBlock;
+    for (const auto &deviceName : this->GetDeviceNames()) {
+        auto store = this->GetChunkStore(deviceName);
+        if (store == nullptr) {
+            continue;
+        }
+        // 分块按内容寻址，任何设备上哈希相符的分块都可以作为修复来源
+        auto chunk = store->GetChunk(chunkKey);
+        if (chunk == nullptr) {
+            damaged.push_back(deviceName);
+        } else if (dataBlock == nullptr) {
+            dataBlock = chunk;
+        }
+    }
+    if (dataBlock == nullptr) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "分块在所有设备上均缺失或损坏");
+        return false;
+    }
+    bool success = true;
+    for (const auto &deviceName : damaged) {
+        if (!this->Mutate(deviceName, [&](ChunkStore &store) {
+                return store.RepairChunk(chunkKey, dataBlock,
+                                         this->options.storeOptions.integrityAlgorithm);
+            })) {
+            success = false;
+        }
+    }
+    return success;
+}
+
+bool StorageEngine::CheckSpaceLimit(const DataKey &key, uint64_t size) {
+    uint64_t limit = this->spaceLimit.load();
+    if (limit == 0) {
+        return true;
+    }
+    uint64_t used = this->GetUsedSpace();
+    if (used + size <= limit) {
+        return true;
+    }
+    this->pluginContext->LogError(SOURCE_LOCATION,
+                                  "写入数据 {}/{}/{}/{} 需要 {} 字节, 已用 {} 字节, 超过配额 {} 字节",
+                                  key.GetApplication(), key.GetDataType(), key.GetName(),
+                                  key.GetVersion(), size, used, limit);
+    return false;
+}
+
+std::vector<std::string> StorageEngine::GetDeviceNames() {
+    std::shared_lock<std::shared_mutex> lock(this->storesMutex);
+    std::vector<std::string> ret;
+    ret.reserve(this->stores.size());
+    for (const auto &elem : this->stores) {
+        ret.push_back(elem.first);
+    }
+    return ret;
+}
+
+bool StorageEngine::TakeDamagedKeys(const std::string &deviceName,
+                                    std::vector<std::string> &keys) {
+    keys.clear();
+    auto store = this->GetStore(deviceName);
+    if (store == nullptr) {
+        return false;
+    }
+    store->TakeDamagedKeys(keys);
+    return true;
+}
+
+std::string StorageEngine::GetStoreDirectory(const std::string &deviceName) {
+    auto store = this->GetStore(deviceName);
+    return store == nullptr ? std::string() : store->GetDirectory();
+}
+
+bool StorageEngine::ListKeys(const std::string &deviceName, const std::string &after,
+                             size_t limit, std::vector<std::string> &keys) {
+    keys.clear();
+    auto store = this->GetStore(deviceName);
+    if (store == nullptr) {
+        return false;
+    }
+    store->ListKeys(after, limit, keys);
+    return true;
+}
+
+bool StorageEngine::VerifyKey(const std::string &deviceName, const std::string &encodedKey,
+                              std::vector<char> &buffer, uint64_t &size) {
+    size = 0;
+    auto store = this->GetStore(deviceName);
+    return store == nullptr || store->Verify(encodedKey, buffer, size);
+}
+
+std::string StorageEngine::EncodeKey(const std::string &application, const std::string &dataType,
+                                     const std::string &name, const std::string &version) {
+    std::string ret = EncodePrefix(application, dataType, name);
+    ret.append(version);
+    return ret;
+}
+
+std::string StorageEngine::EncodePrefix(const std::string &application,
+                                        const std::string &dataType, const std::string &name) {
+    std::string ret;
+    ret.reserve(application.size() + dataType.size() + name.size() + 3);
+    ret.append(application);
+    ret.push_back('\0');
+    ret.append(dataType);
+    ret.push_back('\0');
+    ret.append(name);
+    ret.push_back('\0');
+    return ret;
+}
+
+bool StorageEngine::DecodeKey(const std::string &encodedKey, std::string &application,
+                              std::string &dataType, std::string &name, std::string &version) {
+    std::string *fields[] = {&application, &dataType, &name};
+    size_t position = 0;
+    for (auto *field : fields) {
+        size_t end = encodedKey.find('\0', position);
+        if (end == std::string::npos) {
+            return false;
+        }
+        field->assign(encodedKey, position, end - position);
+        position = end + 1;
+    }
+    version.assign(encodedKey, position, std::string::npos);
+    return true;
+}
+
+bool StorageEngine::IsErasureCoded(const Strategy &strategy) {
+    uint32_t dataFragments = 0;
+    uint32_t parityFragments = 0;
+    return ErasureCode::Parse(strategy.GetErrorCorrectingAlgorithm(), dataFragments,
+                              parityFragments);
+}
+
+IntegrityAlgorithm StorageEngine::GetIntegrityAlgorithm(const Strategy &strategy) const {
+    IntegrityAlgorithm ret = IntegrityAlgorithm::None;
+    if (!IntegrityCheck::Parse(strategy.GetIntegrityCheckAlgorithm(), ret)) {
+        ret = this->options.storeOptions.integrityAlgorithm;
+        this->pluginContext->LogWarn(SOURCE_LOCATION,
+                                     "存储策略 {} 的完整性校验算法 {} 不受支持, 使用 {}",
+                                     strategy.GetName(), strategy.GetIntegrityCheckAlgorithm(),
+                                     IntegrityCheck::GetName(ret));
+    }
+    return ret;
+}
+
+Durability StorageEngine::GetDurability(const Strategy &strategy) const {
+    auto iter = this->options.durabilities.find(strategy.GetName());
+    return iter == this->options.durabilities.end() ? this->options.storeOptions.durability
+                                                    : iter->second;
+}
+
+uint32_t StorageEngine::GetWriteQuorum(const Strategy &strategy, uint32_t replicas) const {
+    auto iter = this->options.writeQuorums.find(strategy.GetName());
+    uint32_t ret = iter == this->options.writeQuorums.end() ? this->options.writeQuorum
+                                                             : iter->second;
+    if (ret == 0 || ret > replicas) {
+        ret = replicas;
+    }
+    return ret;
+}
+
+bool StorageEngine::FanOutWrites(const Strategy &strategy, const DataKey &key,
+                                 const std::string &encodedKey,
+                                 const std::vector<ReplicaWrite> &writes,
+                                 const std::shared_ptr<void> &owner,
+                                 const std::shared_ptr<const std::vector<ChunkReference>> &chunks,
+                                 uint32_t quorum, uint64_t writeId,
+                                 const std::shared_ptr<Core::CancellationToken> &token) {
+    IntegrityAlgorithm algorithm = this->GetIntegrityAlgorithm(strategy);
+    Durability durability = this->GetDurability(strategy);
+    uint64_t lifetime = strategy.GetLifeTimeInSecond();
+    uint64_t expiry = lifetime > 0 ? (uint64_t) time(nullptr) + lifetime : 0;
+    auto fanOut = std::make_shared<FanOut>(key);
+    fanOut->total = (uint32_t) writes.size();
+    fanOut->writeId = writeId;
+    fanOut->strategy = std::make_shared<Strategy>(
+        strategy.GetName(), strategy.GetDescription(), strategy.GetLocations(),
+        strategy.GetErrorCorrectingAlgorithm(), strategy.GetIntegrityCheckAlgorithm(),
+        strategy.GetLifeTimeInSecond());
+    fanOut->encodedKey = encodedKey;
+    fanOut->owner = owner;
+    for (const auto &write : writes) {
+        std::shared_ptr<ChunkStore> store;
+        std::shared_ptr<Core::Executor> writer;
+        {
+            std::shared_lock<std::shared_mutex> lock(this->storesMutex);
+            auto iter = this->chunkStores.find(write.deviceName);
+            auto writerIter = this->writers.find(write.deviceName);
+            if (iter != this->chunkStores.end() && writerIter != this->writers.end()) {
+                store = iter->second;
+                writer = writerIter->second;
+            }
+        }
+        if (store == nullptr) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "存储策略 {} 引用的设备 {} 未挂载",
+                                          strategy.GetName(), write.deviceName);
+            this->CompleteWrite(fanOut, write.deviceName, false);
+            continue;
+        }
+        this->BeginPendingWrite(write.deviceName, encodedKey);
+        bool posted = writer->Post([this, fanOut, store, write, chunks, algorithm, expiry,
+                                    durability, token]() {
+            // 在写队列中等待时令牌已取消，放弃写入，该设备与其他副本一样登记修复
+            if (Core::IsCancelled(token)) {
+                this->pluginContext->LogWarn(SOURCE_LOCATION, "设备 {} 上的写入已取消",
+                                             write.deviceName);
+                this->EndPendingWrite(write.deviceName, fanOut->encodedKey);
+                this->CompleteWrite(fanOut, write.deviceName, false);
+                return;
+            }
+            // 批量落盘的写入不在写队列中等待, 追加后交给存储的提交线程, 后续写入可以并入同一次提交
+            Durability immediate = durability == Durability::Batch ? Durability::None : durability;
+            bool success = chunks == nullptr
+                               ? store->Put(fanOut->encodedKey, write.data, write.size, algorithm,
+                                            expiry, immediate, fanOut->writeId)
+                               : store->PutChunked(fanOut->encodedKey, write.data, *chunks,
+                                                   algorithm, expiry, immediate, fanOut->writeId);
+            if (!success) {
+                this->pluginContext->LogError(SOURCE_LOCATION, "写入设备 {} 失败",
+                                              write.deviceName);
+            }
+            this->EndPendingWrite(write.deviceName, fanOut->encodedKey);
+            if (!success || durability != Durability::Batch) {
+                this->CompleteWrite(fanOut, write.deviceName, success);
+                return;
+            }
+            store->GetStore().Commit([this, fanOut, write](bool durable) {
+                if (!durable) {
+                    this->pluginContext->LogError(SOURCE_LOCATION, "设备 {} 落盘失败",
+                                                  write.deviceName);
+                }
+                this->CompleteWrite(fanOut, write.deviceName, durable);
+            });
+        });
+        if (!posted) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "设备 {} 的写队列已停止",
+                                          write.deviceName);
+            this->EndPendingWrite(write.deviceName, encodedKey);
+            this->CompleteWrite(fanOut, write.deviceName, false);
+        }
+    }
+    auto settled = [&fanOut, &token, quorum]() {
+        return fanOut->acknowledged >= quorum ||
+               fanOut->acknowledged + (fanOut->total - fanOut->finished) < quorum ||
+               Core::IsCancelled(token);
+    };
+    if (token == nullptr) {
+        std::unique_lock<std::mutex> lock(fanOut->mutex);
+        fanOut->condition.wait(lock, settled);
+        return fanOut->acknowledged >= quorum;
+    }
+    // 令牌被主动取消时唤醒等待，注册时已取消会立即执行回调，因此在加锁前注册
+    uint64_t callbackId = token->RegisterCallback([fanOut]() {
+        std::lock_guard<std::mutex> lock(fanOut->mutex);
+        fanOut->condition.notify_all();
+    });
+    bool ret = false;
+    {
+        std::unique_lock<std::mutex> lock(fanOut->mutex);
+        if (token->HasDeadline()) {
+            fanOut->condition.wait_until(lock, token->GetDeadline(), settled);
+        } else {
+            fanOut->condition.wait(lock, settled);
+        }
+        ret = fanOut->acknowledged >= quorum;
+    }
+    token->UnregisterCallback(callbackId);
+    return ret;
+}
+
+void StorageEngine::CompleteWrite(const std::shared_ptr<FanOut> &fanOut,
+                                  const std::string &deviceName, bool success) {
+    bool last = false;
+    {
+        std::lock_guard<std::mutex> lock(fanOut->mutex);
+        if (success) {
+            ++fanOut->acknowledged;
+        } else {
+            fanOut->failedDevices.push_back(deviceName);
+        }
+        ++fanOut->finished;
+        last = fanOut->finished == fanOut->total;
+    }
+    fanOut->condition.notify_all();
+    if (!last) {
+        return;
+    }
+
+    // 所有写入已结束，failedDevices不会再被修改
+    std::lock_guard<std::mutex> lock(this->repairsMutex);
+    auto iter = this->repairs.find(fanOut->encodedKey);
+    if (fanOut->failedDevices.empty()) {
+        // 同一数据更新的写入成功后，之前的修复记录已经过时，较早的写入晚结束时不影响较新的记录
+        if (iter != this->repairs.end() && iter->second.writeId <= fanOut->writeId) {
+            this->repairs.erase(iter);
+            this->repairCount.fetch_sub(1);
+        }
+        return;
+    }
+    if (iter == this->repairs.end()) {
+        this->repairs.emplace(fanOut->encodedKey,
+                              RepairRecord{fanOut->strategy, fanOut->key, fanOut->failedDevices,
+                                           fanOut->writeId});
+        this->repairCount.fetch_add(1);
+    } else if (iter->second.writeId <= fanOut->writeId) {
+        // 较新的写入成功的设备已持有新数据，只需修复这次写入失败的设备
+        iter->second = RepairRecord{fanOut->strategy, fanOut->key, fanOut->failedDevices,
+                                    fanOut->writeId};
+    } else {
+        // 较早的写入晚于较新的写入结束，其失败的设备并入较新的记录，修复时从最新的副本重写
+        for (const auto &device : fanOut->failedDevices) {
+            auto &failed = iter->second.failedDevices;
+            if (std::find(failed.begin(), failed.end(), device) == failed.end()) {
+                failed.push_back(device);
+            }
+        }
+    }
+    for (const auto &device : fanOut->failedDevices) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "数据 {}/{}/{}/{} 在设备 {} 上写入失败, 已记录待修复",
+                                      fanOut->key.GetApplication(), fanOut->key.GetDataType(),
+                                      fanOut->key.GetName(), fanOut->key.GetVersion(), device);
+    }
+}
+
+void StorageEngine::BeginPendingWrite(const std::string &deviceName,
+                                      const std::string &encodedKey) {
+    std::lock_guard<std::mutex> lock(this->pendingMutex);
+    ++this->pendingWrites[std::make_pair(deviceName, encodedKey)];
+    ++this->queueDepths[deviceName];
+    this->pendingCount.fetch_add(1);
+}
+
+void StorageEngine::EndPendingWrite(const std::string &deviceName,
+                                    const std::string &encodedKey) {
+    std::lock_guard<std::mutex> lock(this->pendingMutex);
+    auto iter = this->pendingWrites.find(std::make_pair(deviceName, encodedKey));
+    if (iter == this->pendingWrites.end()) {
+        return;
+    }
+    if (--iter->second == 0) {
+        this->pendingWrites.erase(iter);
+    }
+    auto depth = this->queueDepths.find(deviceName);
+    if (depth != this->queueDepths.end() && --depth->second == 0) {
+        this->queueDepths.erase(depth);
+    }
+    this->pendingCount.fetch_sub(1);
+}
+
+bool StorageEngine::HasPendingWrites(const std::string &deviceName, const std::string &prefix) {
+    if (this->pendingCount.load() == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(this->pendingMutex);
+    auto iter = this->pendingWrites.lower_bound(std::make_pair(deviceName, prefix));
+    return iter != this->pendingWrites.end() && iter->first.first == deviceName &&
+           iter->first.second.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool StorageEngine::IsRepairPending(const std::string &deviceName,
+                                    const std::string &encodedKey) {
+    if (this->repairCount.load() == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(this->repairsMutex);
+    auto iter = this->repairs.find(encodedKey);
+    if (iter == this->repairs.end()) {
+        return false;
+    }
+    const auto &failed = iter->second.failedDevices;
+    return std::find(failed.begin(), failed.end(), deviceName) != failed.end();
+}
+
+bool StorageEngine::RepairReplicas(const Strategy &strategy, const DataKey &key,
+                                   const std::string &encodedKey,
+                                   const std::vector<std::string> &failedDevices) {
+    std::shared_ptr<DataBlock> dataBlock;
+    uint64_t writeId = 0;
+    uint64_t expiry = 0;
+    std::vector<std::string> damaged;
+    // 可以读出的副本所在的设备及其写入标识
+    std::vector<std::pair<std::string, uint64_t>> readable;
+    bool success = true;
+    for (const auto &location : strategy.GetLocations()) {
+        const std::string &deviceName = location.GetDeviceName();
+        auto store = this->GetChunkStore(deviceName);
+        if (store == nullptr) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "存储策略 {} 引用的设备 {} 未挂载",
+                                          strategy.GetName(), deviceName);
+            success = false;
+            continue;
+        }
+        if (this->HasPendingWrites(deviceName, encodedKey)) {
+            continue;
+        }
+        auto replica = store->Get(encodedKey, nullptr);
+        if (replica == nullptr ||
+            std::find(failedDevices.begin(), failedDevices.end(), deviceName) !=
+                failedDevices.end()) {
+            damaged.push_back(deviceName);
+            continue;
+        }
+        uint64_t replicaWriteId = store->GetStore().GetWriteId(encodedKey);
+        readable.emplace_back(deviceName, replicaWriteId);
+        if (dataBlock == nullptr || replicaWriteId > writeId) {
+            dataBlock = replica;
+            writeId = replicaWriteId;
+            expiry = store->GetStore().GetExpiry(encodedKey);
+        }
+    }
+    if (dataBlock == nullptr) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "数据 {}/{}/{}/{} 没有可用的副本",
+                                      key.GetApplication(), key.GetDataType(), key.GetName(),
+                                      key.GetVersion());
+        return false;
+    }
+    // 写入标识较小的副本是覆盖前的旧数据
+    for (const auto &replica : readable) {
+        if (replica.second < writeId) {
+            damaged.push_back(replica.first);
+        }
+    }
+    IntegrityAlgorithm algorithm = this->GetIntegrityAlgorithm(strategy);
+    Durability durability = this->GetDurability(strategy);
+    auto chunks = damaged.empty() ? nullptr
+                                  : this->SplitChunks(dataBlock->GetData(), dataBlock->GetSize());
+    for (const auto &deviceName : damaged) {
+        if (!this->Mutate(deviceName, [&](ChunkStore &store) {
+                if (chunks != nullptr) {
+                    return store.PutChunked(encodedKey, dataBlock->GetData(), *chunks, algorithm,
+                                            expiry, durability, writeId);
+                }
+                return store.Put(encodedKey, dataBlock->GetData(), dataBlock->GetSize(),
+                                 algorithm, expiry, durability, writeId);
+            })) {
+            success = false;
+        }
+    }
+    if (!damaged.empty()) {
+        this->InvalidateCache(encodedKey,
+                              EncodePrefix(key.GetApplication(), key.GetDataType(), key.GetName()));
+    }
+    return success;
+}
+
+bool StorageEngine::Mutate(const std::string &deviceName,
+                           const std::function<bool(ChunkStore &)> &mutation) {
+    std::shared_ptr<ChunkStore> store;
+    std::shared_ptr<Core::Executor> writer;
+    {
+        std::shared_lock<std::shared_mutex> lock(this->storesMutex);
+        auto iter = this->chunkStores.find(deviceName);
+        auto writerIter = this->writers.find(deviceName);
+        if (iter == this->chunkStores.end() || writerIter == this->writers.end()) {
+            return false;
+        }
+        store = iter->second;
+        writer = writerIter->second;
+    }
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto future = promise->get_future();
+    if (!writer->Post([store, &mutation, promise]() { promise->set_value(mutation(*store)); })) {
+        return false;
+    }
+    return future.get();
+}
+
+std::shared_ptr<DataBlock>
+StorageEngine::ReadEncodedKey(const Strategy &strategy, const std::string &encodedKey,
+                              const std::shared_ptr<Core::CancellationToken> &token) {
+    uint32_t dataFragments = 0;
+    uint32_t parityFragments = 0;
+    if (ErasureCode::Parse(strategy.GetErrorCorrectingAlgorithm(), dataFragments,
+                           parityFragments)) {
+        ErasureCode code(dataFragments, parityFragments);
+        return this->ReadFragments(strategy, encodedKey, code, token);
+    }
+    std::vector<Replica> replicas;
+    replicas.reserve(strategy.GetLocations().size());
+    for (const auto &location : strategy.GetLocations()) {
+        auto store = this->GetChunkStore(location.GetDeviceName());
+        if (store == nullptr || this->HasPendingWrites(location.GetDeviceName(), encodedKey) ||
+            this->IsRepairPending(location.GetDeviceName(), encodedKey)) {
+            continue;
+        }
+        replicas.push_back(Replica{location.GetDeviceName(), store,
+                                   this->latency.GetAverage(location.GetDeviceName())});
+    }
+    // 没有样本的设备延迟为0，排在前面以便尽快获得样本
+    std::stable_sort(replicas.begin(), replicas.end(),
+                     [](const Replica &a, const Replica &b) { return a.latency < b.latency; });
+    return this->ReadHedged(replicas, encodedKey, token);
+}
+
+std::shared_ptr<DataBlock>
+StorageEngine::ReadHedged(const std::vector<Replica> &replicas, const std::string &encodedKey,
+                          const std::shared_ptr<Core::CancellationToken> &token) {
+    if (!this->options.hedgedReads || replicas.size() < 2) {
+        for (const auto &replica : replicas) {
+            if (Core::IsCancelled(token)) {
+                return nullptr;
+            }
+            auto dataBlock = this->ReadReplica(replica, encodedKey, token);
+            if (dataBlock != nullptr) {
+                return dataBlock;
+            }
+        }
+        return nullptr;
+    }
+    if (Core::IsCancelled(token)) {
+        return nullptr;
+    }
+
+    auto state = std::make_shared<HedgedRead>();
+    size_t next = 0;
+    auto issue = [this, &replicas, &encodedKey, &token, &state, &next]() {
+        const Replica &replica = replicas[next++];
+        // 调用方的令牌取消时各读取随之取消
+        auto child = token == nullptr ? Core::CancellationToken::Create() : token->CreateChild();
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->tokens.push_back(child);
+            ++state->issued;
+        }
+        std::function<void()> task = [this, state, replica, encodedKey, child]() {
+            auto dataBlock = this->ReadReplica(replica, encodedKey, child);
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                ++state->finished;
+                if (dataBlock != nullptr && state->result == nullptr) {
+                    state->result = dataBlock;
+                }
+            }
+            state->condition.notify_all();
+        };
+        if (!this->readers->Post(task)) {
+            task();
+        }
+    };
+    auto settled = [&state]() {
+        return state->result != nullptr || state->finished == state->issued;
+    };
+
+    issue();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (true) {
+        auto delay = std::chrono::nanoseconds(this->GetHedgeDelay(replicas[next - 1].deviceName));
+        state->condition.wait_for(lock, delay, settled);
+        if (state->result != nullptr || Core::IsCancelled(token)) {
+            break;
+        }
+        if (next == replicas.size()) {
+            state->condition.wait(lock, settled);
+            break;
+        }
+        // 已发出的读取超时或均未命中，向下一个副本发出读取
+        lock.unlock();
+        issue();
+        lock.lock();
+    }
+    // 被取消的读取在下一批数据读完后停止
+    for (const auto &child : state->tokens) {
+        child->Cancel();
+    }
+    return state->result;
+}
+
+std::shared_ptr<DataBlock>
+StorageEngine::ReadReplica(const Replica &replica, const std::string &encodedKey,
+                           const std::shared_ptr<Core::CancellationToken> &token) {
+    auto start = std::chrono::steady_clock::now();
+    auto dataBlock = replica.store->Get(encodedKey, token);
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    // 未命中的读取只查询了索引，不能反映设备的延迟；被取消的读取至少耗时这么久
+    if (dataBlock != nullptr || Core::IsCancelled(token)) {
+        this->latency.Record(replica.deviceName, (uint64_t) elapsed.count());
+    }
+    return dataBlock;
+}
+
+uint64_t StorageEngine::GetHedgeDelay(const std::string &deviceName) {
+    uint64_t delay = this->latency.GetPercentile(deviceName, this->options.hedgePercentile);
+    return std::max(delay, this->options.hedgeMinimumDelay * 1000);
+}
+
+bool StorageEngine::GetFragmentStores(const Strategy &strategy, const ErasureCode &code,
+                                      std::vector<std::shared_ptr<LogStructuredStore>> &stores) {
+    uint32_t total = code.GetDataFragments() + code.GetParityFragments();
+    const auto &locations = strategy.GetLocations();
+    if (locations.size() < total) {
+        this->pluginContext->LogError(SOURCE_LOCATION,
+                                      "存储策略 {} 使用 {} 需要 {} 个位置，只配置了 {} 个",
+                                      strategy.GetName(), strategy.GetErrorCorrectingAlgorithm(),
+                                      total, locations.size());
+        return false;
+    }
+    std::set<std::string> devices;
+    stores.assign(total, nullptr);
+    for (uint32_t i = 0; i < total; ++i) {
+        if (!devices.insert(locations[i].GetDeviceName()).second) {
+            this->pluginContext->LogError(SOURCE_LOCATION,
+                                          "存储策略 {} 的前 {} 个位置必须位于不同的设备",
+                                          strategy.GetName(), total);
+            return false;
+        }
+        stores[i] = this->GetStore(locations[i].GetDeviceName());
+    }
+    return true;
+}
+
+bool StorageEngine::WriteFragments(const Strategy &strategy, const DataKey &key,
+                                   const std::string &encodedKey,
+                                   const std::shared_ptr<DataBlock> &dataBlock,
+                                   const ErasureCode &code,
+                                   const std::shared_ptr<Core::CancellationToken> &token) {
+    std::vector<std::shared_ptr<LogStructuredStore>> stores;
+    if (!this->GetFragmentStores(strategy, code, stores)) {
+        return false;
+    }
+    uint32_t total = code.GetDataFragments() + code.GetParityFragments();
+    uint64_t size = dataBlock->GetSize();
+    uint64_t recordSize = FragmentHeaderSize + code.GetFragmentSize(size);
+    auto buffer = std::make_shared<std::vector<char>>(recordSize * total);
+    std::vector<char *> fragments(total);
+    std::vector<ReplicaWrite> writes;
+    writes.reserve(total);
+    uint64_t writeId = NextWriteId();
+    for (uint32_t i = 0; i < total; ++i) {
+        char *record = buffer->data() + recordSize * i;
+        WriteFragmentHeader(record, code, i, size, writeId);
+        fragments[i] = record + FragmentHeaderSize;
+        writes.push_back(
+            ReplicaWrite{strategy.GetLocations()[i].GetDeviceName(), record, recordSize});
+    }
+    code.Encode(dataBlock->GetData(), size, fragments);
+    // 分片互不相同，需要全部写入成功
+    return this->FanOutWrites(strategy, key, encodedKey, writes, buffer, nullptr, total,
+                              writeId, token);
+}
+
+uint32_t StorageEngine::LoadFragments(const std::vector<std::shared_ptr<LogStructuredStore>> &stores,
+                                      const std::string &encodedKey, const ErasureCode &code,
+                                      bool loadAll,
+                                      std::vector<std::shared_ptr<DataBlock>> &blocks,
+                                      uint64_t &size, uint64_t &writeId,
+                                      const std::shared_ptr<Core::CancellationToken> &token) {
+    uint32_t total = code.GetDataFragments() + code.GetParityFragments();
+    std::vector<std::shared_ptr<DataBlock>> loaded(total);
+    std::vector<uint64_t> writeIds(total, 0);
+    // 写入标识到（分片数量，原始数据大小）的映射
+    std::map<uint64_t, std::pair<uint32_t, uint64_t>> writes;
+    bool complete = false;
+    for (uint32_t i = 0; i < total && (loadAll || !complete); ++i) {
+        if (Core::IsCancelled(token)) {
+            break;
+        }
+        if (stores[i] == nullptr) {
+            continue;
+        }
+        auto block = stores[i]->Get(encodedKey, token);
+        if (block == nullptr || block->GetSize() < FragmentHeaderSize) {
+            continue;
+        }
+        uint32_t magic = 0;
+        uint8_t header[4] = {0};
+        uint64_t originalSize = 0;
+        uint64_t id = 0;
+        memcpy(&magic, block->GetData(), sizeof(magic));
+        memcpy(header, block->GetData() + 4, sizeof(header));
+        memcpy(&originalSize, block->GetData() + 8, sizeof(originalSize));
+        memcpy(&id, block->GetData() + 16, sizeof(id));
+        auto iter = writes.find(id);
+        if (magic != FragmentMagic || header[0] != code.GetDataFragments() ||
+            header[1] != code.GetParityFragments() || header[2] != i ||
+            block->GetSize() != FragmentHeaderSize + code.GetFragmentSize(originalSize) ||
+            (iter != writes.end() && iter->second.second != originalSize)) {
+            this->pluginContext->LogError(SOURCE_LOCATION, "第 {} 个分片与编码参数不符", i);
+            continue;
+        }
+        loaded[i] = block;
+        writeIds[i] = id;
+        auto &write = writes[id];
+        write.second = originalSize;
+        complete = ++write.first >= code.GetDataFragments();
+    }
+
+    // 选择分片足够解码的最新一次写入，都不够时选择分片最多的一次，其他写入的分片视为缺失
+    auto chosen = writes.end();
+    for (auto iter = writes.begin(); iter != writes.end(); ++iter) {
+        if (chosen == writes.end() || iter->second.first >= code.GetDataFragments() ||
+            (chosen->second.first < code.GetDataFragments() &&
+             iter->second.first >= chosen->second.first)) {
+            chosen = iter;
+        }
+    }
+    blocks.assign(total, nullptr);
+    if (chosen == writes.end()) {
+        return 0;
+    }
+    if (writes.size() > 1) {
+        this->pluginContext->LogWarn(SOURCE_LOCATION, "分片来自 {} 次不同的写入, 只使用其中 {} 个",
+                                     writes.size(), chosen->second.first);
+    }
+    writeId = chosen->first;
+    size = chosen->second.second;
+    for (uint32_t i = 0; i < total; ++i) {
+        if (loaded[i] != nullptr && writeIds[i] == writeId) {
+            blocks[i] = loaded[i];
+        }
+    }
+    return chosen->second.first;
+}
+
+std::shared_ptr<DataBlock>
+StorageEngine::DecodeFragments(const std::vector<std::shared_ptr<DataBlock>> &blocks,
+                               const ErasureCode &code, uint64_t size) {
+    std::vector<const char *> fragments(blocks.size(), nullptr);
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (blocks[i] != nullptr) {
+            fragments[i] = blocks[i]->GetData() + FragmentHeaderSize;
+        }
+    }
+    auto ret = std::make_shared<DataBlock>(size);
+    if (!code.Decode(fragments, code.GetFragmentSize(size), ret->GetMutableData(), size)) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "分片解码失败");
+        return nullptr;
+    }
+    return ret;
+}
+
+std::shared_ptr<DataBlock>
+StorageEngine::ReadFragments(const Strategy &strategy, const std::string &encodedKey,
+                             const ErasureCode &code,
+                             const std::shared_ptr<Core::CancellationToken> &token) {
+    std::vector<std::shared_ptr<LogStructuredStore>> stores;
+    if (!this->GetFragmentStores(strategy, code, stores)) {
+        return nullptr;
+    }
+    // 与多副本读取一致, 不读取正在写入的设备上的分片
+    for (size_t i = 0; i < stores.size(); ++i) {
+        if (this->HasPendingWrites(strategy.GetLocations()[i].GetDeviceName(), encodedKey)) {
+            stores[i] = nullptr;
+        }
+    }
+    std::vector<std::shared_ptr<DataBlock>> blocks;
+    uint64_t size = 0;
+    uint64_t writeId = 0;
+    if (this->LoadFragments(stores, encodedKey, code, false, blocks, size, writeId, token) <
+        code.GetDataFragments()) {
+        return nullptr;
+    }
+    return this->DecodeFragments(blocks, code, size);
+}
+
+bool StorageEngine::RepairFragments(const Strategy &strategy, const std::string &encodedKey,
+                                    const ErasureCode &code, bool &repaired) {
+    repaired = false;
+    std::vector<std::shared_ptr<LogStructuredStore>> stores;
+    if (!this->GetFragmentStores(strategy, code, stores)) {
+        return false;
+    }
+    for (size_t i = 0; i < stores.size(); ++i) {
+        if (this->HasPendingWrites(strategy.GetLocations()[i].GetDeviceName(), encodedKey)) {
+            // 正在进行的写入会覆盖所有分片, 不必修复
+            return true;
+        }
+    }
+    std::vector<std::shared_ptr<DataBlock>> blocks;
+    uint64_t size = 0;
+    uint64_t writeId = 0;
+    uint32_t available =
+        this->LoadFragments(stores, encodedKey, code, true, blocks, size, writeId, nullptr);
+    if (available == blocks.size()) {
+        return true;
+    }
+    if (available < code.GetDataFragments()) {
+        this->pluginContext->LogError(SOURCE_LOCATION, "可用分片 {} 个，少于恢复所需的 {} 个",
+                                      available, code.GetDataFragments());
+        return false;
+    }
+
+    // 解码出原始数据后重新编码，以同一写入标识补写缺失、损坏或属于其他写入的分片
+    auto dataBlock = this->DecodeFragments(blocks, code, size);
+    if (dataBlock == nullptr) {
+        return false;
+    }
+    uint64_t recordSize = FragmentHeaderSize + code.GetFragmentSize(size);
+    std::vector<char> buffer(recordSize * blocks.size());
+    std::vector<char *> fragments(blocks.size());
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        fragments[i] = buffer.data() + recordSize * i + FragmentHeaderSize;
+    }
+    code.Encode(dataBlock->GetData(), size, fragments);
+    // 补写的分片沿用完好分片的过期时间
+    uint64_t expiry = 0;
+    for (size_t i = 0; i < blocks.size() && expiry == 0; ++i) {
+        if (blocks[i] != nullptr) {
+            expiry = stores[i]->GetExpiry(encodedKey);
+        }
+    }
+    bool success = true;
+    IntegrityAlgorithm algorithm = this->GetIntegrityAlgorithm(strategy);
+    Durability durability = this->GetDurability(strategy);
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (blocks[i] != nullptr) {
+            continue;
+        }
+        if (stores[i] == nullptr) {
+            success = false;
+            continue;
+        }
+        char *record = buffer.data() + recordSize * i;
+        WriteFragmentHeader(record, code, (uint32_t) i, size, writeId);
+        if (this->Mutate(strategy.GetLocations()[i].GetDeviceName(),
+                         [&](ChunkStore &store) {
+                             return store.Put(encodedKey, record, recordSize, algorithm,
+                                              expiry, durability, writeId);
+                         })) {
+            repaired = true;
+        } else {
+            success = false;
+        }
+    }
+    return success;
+}
+
+void StorageEngine::InvalidateCache(const std::string &encodedKey, const std::string &prefix) {
+    this->cache.Invalidate(encodedKey);
+    std::string latestKey = prefix;
+    latestKey.push_back('\0');
+    this->cache.Invalidate(latestKey);
+}
+
+std::shared_ptr<LogStructuredStore> StorageEngine::GetStore(const std::string &deviceName) {
+    std::shared_lock<std::shared_mutex> lock(this->storesMutex);
+    auto iter = this->stores.find(deviceName);
+    if (iter == this->stores.end()) {
+        return nullptr;
+    }
+    return iter->second;
+}
+
+std::shared_ptr<ChunkStore> StorageEngine::GetChunkStore(const std::string &deviceName) {
+    std::shared_lock<std::shared_mutex> lock(this->storesMutex);
+    auto iter = this->chunkStores.find(deviceName);
+    if (iter == this->chunkStores.end()) {
+        return nullptr;
+    }
+    return iter->second;
+}
+
+std::shared_ptr<const std::vector<ChunkReference>> StorageEngine::SplitChunks(const char *data,
+                                                                              uint64_t size) {
+    bool chunked = this->options.chunkingThreshold > 0 && size >= this->options.chunkingThreshold;
+    if (!chunked && !ChunkStore::IsManifest(data, size)) {
+        return nullptr;
+    }
+    auto ret = std::make_shared<std::vector<ChunkReference>>();
+    ChunkStore::Split(this->chunker, data, size, *ret);
+    return ret;
+}
+} // namespace Fleet::DataManager::Storage
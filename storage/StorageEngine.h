@@ -0,0 +1,881 @@
+/**
+ * @file StorageEngine.h
+ * @brief 存储引擎
+ * @details 按存储策略将版本化数据写入各设备上的日志结构存储，为存储插件提供数据读写后端
+ * @author 唐震 <tangzhen12@otcaix.iscas.ac.cn>
+ * @date 2025-07-02
+ */
+
+#ifndef FLEET_DATA_MANAGER_STORAGE_STORAGE_ENGINE_H
+#define FLEET_DATA_MANAGER_STORAGE_STORAGE_ENGINE_H
+
+#include "CancellationToken.h"
+#include "ChunkStore.h"
+#include "Chunker.h"
+#include "DataBlock.h"
+#include "DataKey.h"
+#include "Device.h"
+#include "ErasureCode.h"
+#include "Executor.h"
+#include "LatencyTracker.h"
+#include "LogStructuredStore.h"
+#include "PluginContext.h"
+#include "ReadCache.h"
+#include "Strategy.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Fleet::DataManager::Storage {
+/**
+ * @brief 存储引擎配置
+ */
+struct StorageEngineOptions {
+    /// 段文件在设备目录下的子目录名
+    std::string subdirectory = "log";
+    /// 各设备日志结构存储的配置
+    LogStructuredStoreOptions storeOptions;
+    /// 按设备名覆盖storeOptions中的直接写入阈值，用于只在承载大批量数据的设备上绕过页缓存
+    std::map<std::string, uint64_t> directWriteThresholds;
+    /// 按存储策略名指定写入的持久化级别，未指定的策略使用storeOptions中的级别
+    std::map<std::string, Durability> durabilities;
+    /// 读缓存容量，单位字节，为0时不缓存
+    uint64_t cacheCapacity = 256ull * 1024 * 1024;
+    /// 读缓存分片数量
+    uint32_t cacheShards = 16;
+    /// 完整复制时写入返回前需要确认的副本数，为0时等待所有副本
+    uint32_t writeQuorum = 0;
+    /// 按存储策略名指定完整复制的写入确认数，未指定的策略使用writeQuorum，为0时等待所有副本
+    std::map<std::string, uint32_t> writeQuorums;
+    /// 完整复制时是否启用对冲读取
+    bool hedgedReads = true;
+    /// 对冲读取的等待时间取首选副本所在设备近期读取延迟的该百分位
+    double hedgePercentile = 95;
+    /// 对冲读取的最短等待时间，单位微秒，设备没有延迟样本时使用该值
+    uint64_t hedgeMinimumDelay = 2000;
+    /// 执行对冲读取的线程数
+    uint32_t readerThreads = 8;
+    /// 所有设备上存活数据的总字节数上限，为0时不限制
+    uint64_t spaceLimit = 0;
+    /// 完整复制时达到该大小的数据分块去重保存，单位字节，为0时不分块
+    uint64_t chunkingThreshold = 0;
+    /// 最小分块大小，单位字节
+    uint32_t chunkMinimumSize = 16 * 1024;
+    /// 平均分块大小，单位字节，向下取2的幂
+    uint32_t chunkAverageSize = 64 * 1024;
+    /// 最大分块大小，单位字节
+    uint32_t chunkMaximumSize = 256 * 1024;
+    /// 选择位置时读取延迟的下限，单位微秒，低于该值的延迟差异视为噪声，没有延迟样本的设备也取该值
+    uint64_t placementLatencyFloor = 1000;
+};
+
+/**
+ * @brief 存储引擎类
+ * @details 每个设备对应一个日志结构存储，段文件位于设备目录的子目录下。
+ * 每个设备有一个单线程的写队列，副本和分片并发写入各设备，同一设备上的修改按提交顺序执行。
+ * 数据键编码为“应用、数据类型、数据名称、版本”以0分隔的字符串，同一数据的所有版本在索引中相邻，
+ * 最新版本为最后写入的版本
+ * @note 线程安全，位置中的相对路径仅用于文件布局，日志结构存储不使用
+ */
+class StorageEngine {
+  public:
+    /**
+     * @brief 构造存储引擎
+     * @param[in] pluginContext 插件上下文，用于日志记录
+     * @param[in] options 存储引擎配置
+     */
+    StorageEngine(const std::shared_ptr<Core::PluginContext> &pluginContext,
+                  const StorageEngineOptions &options);
+
+    /**
+     * @brief 析构函数，关闭所有设备上的存储
+     */
+    virtual ~StorageEngine();
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    StorageEngine(const StorageEngine &) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    StorageEngine &operator=(const StorageEngine &) = delete;
+
+    /**
+     * @brief 挂载设备并打开其上的存储
+     * @param[in] device 设备对象
+     * @return 挂载成功返回true，设备已挂载或打开失败返回false
+     */
+    bool AddDevice(const std::shared_ptr<Device> &device);
+
+    /**
+     * @brief 卸载设备并关闭其上的存储
+     * @param[in] name 设备名称
+     * @return 卸载成功返回true，设备未挂载返回false
+     */
+    bool RemoveDevice(const std::string &name);
+
+    /**
+     * @brief 按存储策略写入数据
+     * @details 配置了写入确认数N的策略完整复制，N个副本写入成功即返回，其余副本在后台完成，
+     * 写入失败的副本和分片记录为待修复。
+     * 容错纠错算法为rs-k-m的策略不做完整复制，而是将数据编码为k个数据分片和m个校验分片，
+     * 依次写入前k + m个位置，存储开销为(k + m) / k倍。
+     * 生存期不为0的策略写入的副本和分片带有过期时间，过期后不可读取，由各设备的存储在后台删除。
+     * 批量持久化的副本追加后交给设备存储的提交线程，写队列继续执行后续写入，
+     * 副本在合并的一次落盘完成后才计入写入确认数
+     * @param[in] strategy 存储策略
+     * @param[in] key 数据键
+     * @param[in] dataBlock 数据块对象
+     * @return 成功写入的副本数达到写入确认数，或所有分片均写入成功返回true，否则返回false
+     */
+    bool WriteData(const Strategy &strategy, const DataKey &key,
+                   const std::shared_ptr<DataBlock> &dataBlock);
+
+    /**
+     * @brief 在截止时间内按存储策略写入数据
+     * @details 写队列中尚未执行的副本或分片写入在令牌取消后放弃，记为写入失败并登记修复；
+     * 令牌取消后不再等待写入确认，已提交的写入在后台继续
+     * @param[in] strategy 存储策略
+     * @param[in] key 数据键
+     * @param[in] dataBlock 数据块对象
+     * @param[in] token 取消令牌，允许为nullptr
+     * @return 在令牌取消前成功的副本数达到写入确认数，或所有分片均写入成功返回true，否则返回false
+     */
+    bool WriteData(const Strategy &strategy, const DataKey &key,
+                   const std::shared_ptr<DataBlock> &dataBlock,
+                   const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 按设备负载和剩余空间为新数据选择位置
+     * @details 存储策略的位置列表作为候选设备组，纠删码策略选择k + m个设备，完整复制选择replicas个设备。
+     * 每个位置从剩余候选中按剩余空间加权随机抽取两个设备，保留负载较低的一个，
+     * 负载为写队列中未完成的写入数加1与近期平均读取延迟之积，延迟不低于placementLatencyFloor，
+     * 负载相同时保留剩余空间较多的一个。
+     * 未挂载的设备和剩余空间不足以容纳数据的设备不参与选择
+     * @param[in] strategy 存储策略
+     * @param[in] replicas 完整复制的副本数，为0时选择所有可用的设备
+     * @param[in] size 数据大小，单位字节
+     * @return 位置依次为所选设备的存储策略，名称和算法与原策略相同，可用设备不足时返回nullptr
+     */
+    std::shared_ptr<Strategy> PlaceData(const Strategy &strategy, uint32_t replicas,
+                                        uint64_t size);
+
+    /**
+     * @brief 选择位置后写入数据
+     * @param[in] strategy 存储策略
+     * @param[in] key 数据键
+     * @param[in] dataBlock 数据块对象
+     * @param[in] replicas 完整复制的副本数，为0时写入所有可用的设备
+     * @param[out] locations 所选设备名称，依次对应副本或分片，应记录在数据元信息的位置列表中
+     * @return 选择位置成功且写入成功返回true，否则返回false
+     */
+    bool WritePlaced(const Strategy &strategy, const DataKey &key,
+                     const std::shared_ptr<DataBlock> &dataBlock, uint32_t replicas,
+                     std::vector<std::string> &locations);
+
+    /**
+     * @brief 由数据元信息记录的位置还原写入时的存储策略
+     * @details 用于读取、删除和修复按位置选择写入的数据，只访问记录的设备
+     * @param[in] strategy 写入时的存储策略，提供算法和各设备的相对路径
+     * @param[in] locations 数据元信息的位置列表
+     * @return 位置依次为记录的设备的存储策略
+     */
+    static std::shared_ptr<Strategy> LocateData(const Strategy &strategy,
+                                                const std::vector<std::string> &locations);
+
+    /**
+     * @brief 按存储策略读取数据的指定版本
+     * @details 完整复制时优先选择近期平均延迟最低的副本，首选副本在其设备延迟的高百分位时间内没有返回时，
+     * 向下一个副本发出对冲读取，先返回的结果胜出，其余读取被取消。
+     * 写入未完成和写入失败待修复的副本被跳过，完整性校验失败的副本或分片视为缺失，
+     * 纠删码数据读取任意k个分片即可恢复
+     * @param[in] strategy 存储策略
+     * @param[in] key 数据键
+     * @return 数据块对象指针，所有位置均未找到返回nullptr
+     */
+    std::shared_ptr<DataBlock> ReadData(const Strategy &strategy, const DataKey &key);
+
+    /**
+     * @brief 在截止时间内按存储策略读取数据的指定版本
+     * @details 读取每个副本或分片前检查令牌，令牌取消后放弃剩余的位置
+     * @param[in] strategy 存储策略
+     * @param[in] key 数据键
+     * @param[in] token 取消令牌，允许为nullptr
+     * @return 数据块对象指针，所有位置均未找到或已取消返回nullptr
+     */
+    std::shared_ptr<DataBlock> ReadData(const Strategy &strategy, const DataKey &key,
+                                        const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 按存储策略读取数据的最新版本
+     * @param[in] strategy 存储策略
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @return 数据块对象指针，所有位置均未找到返回nullptr
+     */
+    std::shared_ptr<DataBlock> ReadLatest(const Strategy &strategy, const std::string &application,
+                                          const std::string &dataType, const std::string &name);
+
+    /**
+     * @brief 在截止时间内按存储策略读取数据的最新版本
+     * @details 查找每个位置的最新版本前检查令牌，令牌取消后放弃剩余的位置
+     * @param[in] strategy 存储策略
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @param[in] token 取消令牌，允许为nullptr
+     * @return 数据块对象指针，所有位置均未找到或已取消返回nullptr
+     */
+    std::shared_ptr<DataBlock> ReadLatest(const Strategy &strategy, const std::string &application,
+                                          const std::string &dataType, const std::string &name,
+                                          const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 按存储策略以内存映射方式读取数据的指定版本
+     * @param[in] strategy 存储策略
+     * @param[in] key 数据键
+     * @param[in] advice 访问模式提示
+     * @return 映射数据块，所有位置均未找到返回nullptr
+     */
+    std::shared_ptr<DataBlock> ReadDataMapped(const Strategy &strategy, const DataKey &key,
+                                              MapAdvice advice);
+
+    /**
+     * @brief 按存储策略以内存映射方式读取数据的最新版本
+     * @param[in] strategy 存储策略
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @param[in] advice 访问模式提示
+     * @return 映射数据块，所有位置均未找到返回nullptr
+     */
+    std::shared_ptr<DataBlock> ReadLatestMapped(const Strategy &strategy,
+                                                const std::string &application,
+                                                const std::string &dataType,
+                                                const std::string &name, MapAdvice advice);
+
+    /**
+     * @brief 按存储策略删除数据的指定版本
+     * @param[in] strategy 存储策略
+     * @param[in] key 数据键
+     * @return 至少在一个位置删除成功返回true，否则返回false
+     */
+    bool RemoveData(const Strategy &strategy, const DataKey &key);
+
+    /**
+     * @brief 按存储策略删除数据的所有版本
+     * @param[in] strategy 存储策略
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @return 至少删除了一个版本返回true，否则返回false
+     */
+    bool RemoveAllVersions(const Strategy &strategy, const std::string &application,
+                           const std::string &dataType, const std::string &name);
+
+    /**
+     * @brief 按存储策略修复数据的指定版本
+     * @details 从写入标识最大且可以完整读出的副本读取数据，写入读取失败或写入标识较小的其余位置，
+     * 修复的副本沿用来源副本的写入标识和过期时间
+     * @param[in] strategy 存储策略
+     * @param[in] key 数据键
+     * @return 所有位置均持有完整副本返回true，没有可用副本或写入失败返回false
+     */
+    bool RepairData(const Strategy &strategy, const DataKey &key);
+
+    /**
+     * @brief 修复写入时记录的失败副本和分片
+     * @details 对每条修复记录按写入时的存储策略执行RepairData，
+     * 写入失败的设备上的副本可能仍是覆盖前的旧数据，不作为修复来源且总是重写，修复成功的记录被删除
+     * @return 修复成功的记录数量
+     */
+    uint32_t RepairPending();
+
+    /**
+     * @brief 获取待修复记录的数量
+     * @return 待修复记录的数量
+     */
+    size_t GetPendingRepairCount();
+
+    /**
+     * @brief 设置读缓存容量
+     * @details 非映射读取的结果进入按字节数限定容量的读缓存，写入、删除和修复使相应的条目失效
+     * @param[in] capacity 容量，单位字节，为0时清空并停止缓存
+     */
+    void SetCacheCapacity(uint64_t capacity);
+
+    /**
+     * @brief 获取读缓存统计信息
+     * @return 读缓存统计信息
+     */
+    ReadCacheStatistics GetCacheStatistics();
+
+    /**
+     * @brief 获取设备的平均读取延迟
+     * @param[in] deviceName 设备名称
+     * @return 移动平均延迟，单位纳秒，没有样本时返回0
+     */
+    uint64_t GetReadLatency(const std::string &deviceName);
+
+    /**
+     * @brief 设置空间配额
+     * @details 写入前估算本次写入占用的字节数，与已用空间之和超过配额时拒绝写入。
+     * 并发的写入各自检查，已用空间可能略微超过配额，分块去重的数据按未去重的大小估算
+     * @param[in] limit 所有设备上存活数据的总字节数上限，为0时不限制
+     */
+    void SetSpaceLimit(uint64_t limit);
+
+    /**
+     * @brief 获取空间配额
+     * @return 所有设备上存活数据的总字节数上限，为0时不限制
+     */
+    uint64_t GetSpaceLimit() const;
+
+    /**
+     * @brief 获取已用空间
+     * @details 读取各设备上的存储共同累加的计数，不加锁
+     * @return 所有设备上索引引用的记录总字节数
+     */
+    uint64_t GetUsedSpace();
+
+    /**
+     * @brief 获取各设备的已用空间
+     * @param[out] usage 设备名称到已用字节数的映射
+     */
+    void GetDeviceUsage(std::map<std::string, uint64_t> &usage);
+
+    /**
+     * @brief 获取各应用和数据类型的已用空间
+     * @details 副本和分片分别计入，结果为所有设备之和
+     * @param[out] usage 应用名称到数据类型和已用字节数映射的映射
+     */
+    void GetApplicationUsage(std::map<std::string, std::map<std::string, uint64_t>> &usage);
+
+    /**
+     * @brief 按索引核对所有设备的用量计数
+     * @details 各设备的存储随索引维护存活字节数，并按“应用、数据类型”分组，
+     * 计数在打开时随索引从段文件重建，巡检每轮调用一次
+     * @return 所有设备的计数均与索引一致返回true，存在偏差并已纠正返回false
+     */
+    bool ReconcileUsage();
+
+    /**
+     * @brief 获取所有设备的分块统计信息
+     * @details 配置了分块阈值时，完整复制的大数据按内容定义分块，副本保存为分块清单，
+     * 同一设备上各版本和各数据共有的分块只保存一份，删除版本时释放引用并回收不再被引用的分块。
+     * 去重以设备为单位，分块不计入任何应用的用量
+     * @return 各设备统计信息之和
+     */
+    ChunkStatistics GetChunkStatistics();
+
+    /**
+     * @brief 从其他设备复制内容相符的分块，补写到引用该分块但分块缺失或损坏的设备
+     * @param[in] chunkKey 分块的键
+     * @return 引用该分块的设备均持有完好的分块返回true，否则返回false
+     */
+    bool RepairChunk(const std::string &chunkKey);
+
+    /**
+     * @brief 获取已挂载的设备名称
+     * @return 设备名称列表
+     */
+    std::vector<std::string> GetDeviceNames();
+
+    /**
+     * @brief 获取设备上存储的段文件目录
+     * @param[in] deviceName 设备名称
+     * @return 目录路径，设备未挂载返回空字符串
+     */
+    std::string GetStoreDirectory(const std::string &deviceName);
+
+    /**
+     * @brief 按顺序列出设备上指定键之后的编码键
+     * @param[in] deviceName 设备名称
+     * @param[in] after 起始键，不包含在结果中，为空时从第一个键开始
+     * @param[in] limit 最多列出的键数
+     * @param[out] keys 编码后的数据键，为空表示已经到达末尾
+     * @return 设备已挂载返回true，否则返回false
+     */
+    bool ListKeys(const std::string &deviceName, const std::string &after, size_t limit,
+                  std::vector<std::string> &keys);
+
+    /**
+     * @brief 校验设备上的一个副本或分片
+     * @param[in] deviceName 设备名称
+     * @param[in] encodedKey 编码后的数据键
+     * @param[in,out] buffer 读取缓冲区，可在多次调用之间复用
+     * @param[out] size 已校验的数据大小
+     * @return 校验通过、键不存在或设备未挂载返回true，读取或校验失败返回false
+     */
+    bool VerifyKey(const std::string &deviceName, const std::string &encodedKey,
+                   std::vector<char> &buffer, uint64_t &size);
+
+    /**
+     * @brief 取出设备上数据损坏而被移出索引的编码键
+     * @param[in] deviceName 设备名称
+     * @param[out] keys 编码后的数据键
+     * @return 设备已挂载返回true，否则返回false
+     */
+    bool TakeDamagedKeys(const std::string &deviceName, std::vector<std::string> &keys);
+
+    /**
+     * @brief 编码数据键
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @param[in] version 版本信息
+     * @return 存储使用的键
+     */
+    static std::string EncodeKey(const std::string &application, const std::string &dataType,
+                                 const std::string &name, const std::string &version);
+
+    /**
+     * @brief 编码数据所有版本共同的键前缀
+     * @param[in] application 应用名称
+     * @param[in] dataType 数据类型
+     * @param[in] name 数据名称
+     * @return 键前缀
+     */
+    static std::string EncodePrefix(const std::string &application, const std::string &dataType,
+                                    const std::string &name);
+
+    /**
+     * @brief 解码数据键
+     * @param[in] encodedKey 编码后的数据键
+     * @param[out] application 应用名称
+     * @param[out] dataType 数据类型
+     * @param[out] name 数据名称
+     * @param[out] version 版本号
+     * @return 编码格式正确返回true，否则返回false
+     */
+    static bool DecodeKey(const std::string &encodedKey, std::string &application,
+                          std::string &dataType, std::string &name, std::string &version);
+
+  protected:
+    /// 插件上下文
+    std::shared_ptr<Core::PluginContext> pluginContext;
+
+    /// 存储引擎配置
+    StorageEngineOptions options;
+
+    /// 设备表读写锁
+    std::shared_mutex storesMutex;
+
+    /// 设备名称到设备上存储的映射
+    std::map<std::string, std::shared_ptr<LogStructuredStore>> stores;
+
+    /// 设备名称到设备上分块去重存储的映射，受storesMutex保护
+    std::map<std::string, std::shared_ptr<ChunkStore>> chunkStores;
+
+    /// 分块器
+    Chunker chunker;
+
+    /// 读缓存，键为编码后的数据键，最新版本以键前缀后再加一个0作为键
+    ReadCache cache;
+
+    /// 设备名称到设备写队列的映射，受storesMutex保护
+    std::map<std::string, std::shared_ptr<Core::Executor>> writers;
+
+    /// 未完成写入表的互斥锁
+    std::mutex pendingMutex;
+
+    /// 设备名称和编码后的数据键到未完成写入数量的映射
+    std::map<std::pair<std::string, std::string>, uint32_t> pendingWrites;
+
+    /// 未完成写入的总数，为0时读取不必查询未完成写入表
+    std::atomic<uint64_t> pendingCount{0};
+
+    /// 设备名称到写队列中未完成写入数量的映射，受pendingMutex保护，用于选择位置
+    std::map<std::string, uint32_t> queueDepths;
+
+    /// 待修复记录表的互斥锁
+    std::mutex repairsMutex;
+
+    /**
+     * @brief 单个副本或分片的写入
+     */
+    struct ReplicaWrite {
+        /// 设备名称
+        std::string deviceName;
+        /// 数据内容
+        const char *data;
+        /// 数据大小
+        uint64_t size;
+    };
+
+    /**
+     * @brief 一次并发写入的进度，由写入线程和所有写队列任务共享
+     */
+    struct FanOut {
+        /**
+         * @brief 构造写入进度
+         * @param[in] key 数据键
+         */
+        explicit FanOut(const DataKey &key) : key(key) {
+        }
+
+        /// 互斥锁
+        std::mutex mutex;
+        /// 进度变化时通知写入线程
+        std::condition_variable condition;
+        /// 写入总数
+        uint32_t total = 0;
+        /// 已成功的写入数
+        uint32_t acknowledged = 0;
+        /// 已结束的写入数
+        uint32_t finished = 0;
+        /// 写入失败的设备
+        std::vector<std::string> failedDevices;
+        /// 写入标识，同一次写入的所有副本和分片相同
+        uint64_t writeId = 0;
+        /// 存储策略的副本，写入返回后仍可能用于记录修复
+        std::shared_ptr<Strategy> strategy;
+        /// 数据键
+        DataKey key;
+        /// 编码后的数据键
+        std::string encodedKey;
+        /// 持有写入数据所在的缓冲区，直到所有写入结束
+        std::shared_ptr<void> owner;
+    };
+
+    /**
+     * @brief 待修复记录
+     */
+    struct RepairRecord {
+        /// 写入时的存储策略
+        std::shared_ptr<Strategy> strategy;
+        /// 数据键
+        DataKey key;
+        /// 写入失败的设备
+        std::vector<std::string> failedDevices;
+        /// 产生记录的写入的写入标识
+        uint64_t writeId;
+    };
+
+    /// 编码后的数据键到待修复记录的映射，受repairsMutex保护
+    std::map<std::string, RepairRecord> repairs;
+
+    /// 待修复记录的数量，为0时读取不必查询待修复记录表
+    std::atomic<uint64_t> repairCount{0};
+
+    /// 各设备的读取延迟统计
+    LatencyTracker latency;
+
+    /// 执行对冲读取的线程池，析构时先于存储关闭
+    std::unique_ptr<Core::Executor> readers;
+
+    /// 空间配额，为0时不限制
+    std::atomic<uint64_t> spaceLimit;
+
+    /// 所有已挂载设备的存活字节数，由各存储在索引变化时更新，写入前检查配额时无需遍历存储
+    std::shared_ptr<std::atomic<uint64_t>> usedSpace;
+
+    /**
+     * @brief 可供读取的副本
+     */
+    struct Replica {
+        /// 设备名称
+        std::string deviceName;
+        /// 设备上的存储
+        std::shared_ptr<ChunkStore> store;
+        /// 设备的平均读取延迟，单位纳秒
+        uint64_t latency;
+    };
+
+    /**
+     * @brief 一次对冲读取的进度，由读取线程和所有读取任务共享
+     */
+    struct HedgedRead {
+        /// 互斥锁
+        std::mutex mutex;
+        /// 有读取结束时通知读取线程
+        std::condition_variable condition;
+        /// 第一个命中的结果
+        std::shared_ptr<DataBlock> result;
+        /// 已发出的读取数
+        uint32_t issued = 0;
+        /// 已结束的读取数
+        uint32_t finished = 0;
+        /// 各读取的取消令牌
+        std::vector<std::shared_ptr<Core::CancellationToken>> tokens;
+    };
+
+    /**
+     * @brief 判断存储策略是否使用纠删码
+     * @param[in] strategy 存储策略
+     * @return 使用纠删码返回true，完整复制返回false
+     */
+    static bool IsErasureCoded(const Strategy &strategy);
+
+    /**
+     * @brief 获取存储策略的完整性校验算法
+     * @param[in] strategy 存储策略
+     * @return 校验算法，策略未指定合法的算法时使用存储配置的默认算法
+     */
+    IntegrityAlgorithm GetIntegrityAlgorithm(const Strategy &strategy) const;
+
+    /**
+     * @brief 获取存储策略的持久化级别
+     * @param[in] strategy 存储策略
+     * @return 持久化级别，策略未指定时使用存储配置的默认级别
+     */
+    Durability GetDurability(const Strategy &strategy) const;
+
+    /**
+     * @brief 获取完整复制时的写入确认数
+     * @details 按策略名查找writeQuorums，未指定时使用writeQuorum
+     * @param[in] strategy 存储策略
+     * @param[in] replicas 副本数量
+     * @return 写入返回前需要成功的副本数，介于1和replicas之间
+     */
+    uint32_t GetWriteQuorum(const Strategy &strategy, uint32_t replicas) const;
+
+    /**
+     * @brief 将多个写入并发提交到各设备的写队列，等待足够的写入成功
+     * @param[in] strategy 存储策略
+     * @param[in] key 数据键
+     * @param[in] encodedKey 编码后的数据键
+     * @param[in] writes 各副本或分片的写入
+     * @param[in] owner 写入数据所在的缓冲区，在所有写入结束前保持有效
+     * @param[in] chunks 分块清单，为nullptr时直接写入
+     * @param[in] quorum 需要成功的写入数
+     * @param[in] writeId 写入标识，随每个副本或分片保存
+     * @param[in] token 取消令牌，允许为nullptr，取消后写队列中尚未执行的写入记为失败
+     * @return 成功的写入数达到quorum返回true，已无法达到或令牌已取消时返回false
+     */
+    bool FanOutWrites(const Strategy &strategy, const DataKey &key, const std::string &encodedKey,
+                      const std::vector<ReplicaWrite> &writes, const std::shared_ptr<void> &owner,
+                      const std::shared_ptr<const std::vector<ChunkReference>> &chunks,
+                      uint32_t quorum, uint64_t writeId,
+                      const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 记录单个写入的结果，最后一个写入结束时为失败的设备记录修复
+     * @details 较新的写入结束后替换同一数据较早的修复记录，写入成功的设备已持有新数据
+     * @param[in] fanOut 并发写入的进度
+     * @param[in] deviceName 设备名称
+     * @param[in] success 是否写入成功
+     */
+    void CompleteWrite(const std::shared_ptr<FanOut> &fanOut, const std::string &deviceName,
+                       bool success);
+
+    /**
+     * @brief 登记一个提交到写队列的写入
+     * @param[in] deviceName 设备名称
+     * @param[in] encodedKey 编码后的数据键
+     */
+    void BeginPendingWrite(const std::string &deviceName, const std::string &encodedKey);
+
+    /**
+     * @brief 注销一个已结束的写入
+     * @param[in] deviceName 设备名称
+     * @param[in] encodedKey 编码后的数据键
+     */
+    void EndPendingWrite(const std::string &deviceName, const std::string &encodedKey);
+
+    /**
+     * @brief 判断设备上是否有指定前缀的键尚未完成写入
+     * @param[in] deviceName 设备名称
+     * @param[in] prefix 编码后的数据键或键前缀
+     * @return 有未完成的写入返回true，否则返回false
+     */
+    bool HasPendingWrites(const std::string &deviceName, const std::string &prefix);
+
+    /**
+     * @brief 判断设备上的副本是否在最近一次写入时失败而等待修复
+     * @details 这样的副本可能仍是覆盖前的旧数据，读取时跳过
+     * @param[in] deviceName 设备名称
+     * @param[in] encodedKey 编码后的数据键
+     * @return 等待修复返回true，否则返回false
+     */
+    bool IsRepairPending(const std::string &deviceName, const std::string &encodedKey);
+
+    /**
+     * @brief 修复完整复制的数据
+     * @param[in] strategy 存储策略
+     * @param[in] key 数据键
+     * @param[in] encodedKey 编码后的数据键
+     * @param[in] failedDevices 写入失败的设备，其上的副本不作为修复来源且总是重写
+     * @return 所有位置均持有最新的完整副本返回true，没有可用副本或写入失败返回false
+     */
+    bool RepairReplicas(const Strategy &strategy, const DataKey &key,
+                        const std::string &encodedKey,
+                        const std::vector<std::string> &failedDevices);
+
+    /**
+     * @brief 在设备的写队列中执行修改并等待完成
+     * @details 删除和修复经由写队列执行，不会被之前提交的写入覆盖
+     * @param[in] deviceName 设备名称
+     * @param[in] mutation 修改操作
+     * @return 修改操作的返回值，设备未挂载时返回false
+     */
+    bool Mutate(const std::string &deviceName, const std::function<bool(ChunkStore &)> &mutation);
+
+    /**
+     * @brief 按存储策略读取编码后的键
+     * @param[in] strategy 存储策略
+     * @param[in] encodedKey 编码后的数据键
+     * @param[in] token 取消令牌，允许为nullptr
+     * @return 数据块对象指针，未找到或已取消返回nullptr
+     */
+    std::shared_ptr<DataBlock>
+    ReadEncodedKey(const Strategy &strategy, const std::string &encodedKey,
+                   const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 按延迟顺序读取副本，首选副本过慢时发出对冲读取
+     * @param[in] replicas 按平均延迟升序排列的副本
+     * @param[in] encodedKey 编码后的数据键
+     * @param[in] token 取消令牌，允许为nullptr，取消后不再发出读取，已发出的读取随之取消
+     * @return 最先命中的数据块，所有副本均未命中或已取消返回nullptr
+     */
+    std::shared_ptr<DataBlock> ReadHedged(const std::vector<Replica> &replicas,
+                                          const std::string &encodedKey,
+                                          const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 读取单个副本并记录设备的读取延迟
+     * @param[in] replica 副本
+     * @param[in] encodedKey 编码后的数据键
+     * @param[in] token 取消令牌，允许为nullptr
+     * @return 数据块对象指针，未找到、校验失败或已取消返回nullptr
+     */
+    std::shared_ptr<DataBlock> ReadReplica(const Replica &replica, const std::string &encodedKey,
+                                           const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 计算对冲读取前的等待时间
+     * @param[in] deviceName 首选副本所在的设备名称
+     * @return 等待时间，单位纳秒
+     */
+    uint64_t GetHedgeDelay(const std::string &deviceName);
+
+    /**
+     * @brief 获取各分片所在的存储
+     * @param[in] strategy 存储策略
+     * @param[in] code 纠删码
+     * @param[out] stores 第i个元素为第i个分片所在的存储，设备未挂载时为nullptr
+     * @return 位置数量足够且前k + m个位置位于不同设备返回true，否则返回false
+     */
+    bool GetFragmentStores(const Strategy &strategy, const ErasureCode &code,
+                           std::vector<std::shared_ptr<LogStructuredStore>> &stores);
+
+    /**
+     * @brief 编码并写入所有分片
+     * @param[in] strategy 存储策略
+     * @param[in] key 数据键
+     * @param[in] encodedKey 编码后的数据键
+     * @param[in] dataBlock 数据块对象
+     * @param[in] code 纠删码
+     * @param[in] token 取消令牌，允许为nullptr
+     * @return 所有分片均写入成功返回true，否则返回false
+     */
+    bool WriteFragments(const Strategy &strategy, const DataKey &key, const std::string &encodedKey,
+                        const std::shared_ptr<DataBlock> &dataBlock, const ErasureCode &code,
+                        const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 读取并校验分片
+     * @details 分片头中记录写入标识，只使用同一次写入的分片，在已读取的分片中优先选择足够解码的最新一次写入
+     * @param[in] stores 各分片所在的存储，为nullptr的跳过
+     * @param[in] encodedKey 编码后的数据键
+     * @param[in] code 纠删码
+     * @param[in] loadAll 为false时同一次写入的分片读到k个即停止
+     * @param[out] blocks 第i个元素为第i个分片，缺失、损坏或属于其他写入时为nullptr
+     * @param[out] size 原始数据大小
+     * @param[out] writeId 所选写入的标识
+     * @param[in] token 取消令牌，允许为nullptr，取消后不再读取剩余的分片
+     * @return 所选写入的可用分片数量
+     */
+    uint32_t LoadFragments(const std::vector<std::shared_ptr<LogStructuredStore>> &stores,
+                           const std::string &encodedKey, const ErasureCode &code, bool loadAll,
+                           std::vector<std::shared_ptr<DataBlock>> &blocks, uint64_t &size,
+                           uint64_t &writeId,
+                           const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 由LoadFragments读取的分片解码出原始数据
+     * @param[in] blocks 各分片，缺失时为nullptr
+     * @param[in] code 纠删码
+     * @param[in] size 原始数据大小
+     * @return 数据块对象指针，解码失败返回nullptr
+     */
+    std::shared_ptr<DataBlock>
+    DecodeFragments(const std::vector<std::shared_ptr<DataBlock>> &blocks, const ErasureCode &code,
+                    uint64_t size);
+
+    /**
+     * @brief 读取分片并解码，跳过有正在进行的写入的设备
+     * @param[in] strategy 存储策略
+     * @param[in] encodedKey 编码后的数据键
+     * @param[in] code 纠删码
+     * @param[in] token 取消令牌，允许为nullptr
+     * @return 数据块对象指针，可用分片少于k个或已取消返回nullptr
+     */
+    std::shared_ptr<DataBlock> ReadFragments(const Strategy &strategy,
+                                             const std::string &encodedKey,
+                                             const ErasureCode &code,
+                                             const std::shared_ptr<Core::CancellationToken> &token);
+
+    /**
+     * @brief 补写缺失或损坏的分片
+     * @param[in] strategy 存储策略
+     * @param[in] encodedKey 编码后的数据键
+     * @param[in] code 纠删码
+     * @param[out] repaired 是否补写了至少一个分片
+     * @return 所有分片均完整返回true，否则返回false
+     */
+    bool RepairFragments(const Strategy &strategy, const std::string &encodedKey,
+                         const ErasureCode &code, bool &repaired);
+
+    /**
+     * @brief 使数据键及其所属数据的最新版本在读缓存中的条目失效
+     * @param[in] encodedKey 编码后的数据键
+     * @param[in] prefix 数据所有版本共同的键前缀
+     */
+    void InvalidateCache(const std::string &encodedKey, const std::string &prefix);
+
+    /**
+     * @brief 获取设备上的存储
+     * @param[in] deviceName 设备名称
+     * @return 存储对象指针，设备未挂载返回nullptr
+     */
+    std::shared_ptr<LogStructuredStore> GetStore(const std::string &deviceName);
+
+    /**
+     * @brief 获取设备上的分块去重存储
+     * @param[in] deviceName 设备名称
+     * @return 分块去重存储对象指针，设备未挂载返回nullptr
+     */
+    std::shared_ptr<ChunkStore> GetChunkStore(const std::string &deviceName);
+
+    /**
+     * @brief 按配置决定是否分块并切分数据
+     * @details 直接写入会被误认为分块清单的数据无论大小都分块保存
+     * @param[in] data 数据
+     * @param[in] size 数据大小
+     * @return 分块清单，不分块时返回nullptr
+     */
+    std::shared_ptr<const std::vector<ChunkReference>> SplitChunks(const char *data,
+                                                                   uint64_t size);
+
+    /**
+     * @brief 检查写入后是否超过空间配额
+     * @param[in] key 数据键
+     * @param[in] size 本次写入占用的字节数
+     * @return 未设置配额或不会超过配额返回true，否则返回false
+     */
+    bool CheckSpaceLimit(const DataKey &key, uint64_t size);
+};
+} // namespace Fleet::DataManager::Storage
+#endif // FLEET_DATA_MANAGER_STORAGE_STORAGE_ENGINE_H
@@ -0,0 +1,209 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+// Reed-Solomon纠删码的已知答案测试。
+// 校验分片与按位实现的GF(2^8)参考编码比较，并在CPU支持的每种乘加实现上
+// 解码所有不超过m个分片缺失的组合
+
+#include "ErasureCode.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+using Fleet::DataManager::Storage::ErasureCode;
+
+/// 检查失败次数
+int failures = 0;
+
+/**
+ * @brief 检查条件，失败时记录并输出位置
+ */
+#define CHECK(condition)                                                                           \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            failures++;                                                                            \
+            std::fprintf(stderr, "%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #condition);        \
+        }                                                                                          \
+    } while (0)
+
+/**
+ * @brief 按位计算GF(2^8)乘法，本原多项式为0x11D
+ * @param[in] a 乘数
+ * @param[in] b 乘数
+ * @return 乘积
+ */
+uint8_t Multiply(uint8_t a, uint8_t b) {
+    unsigned product = 0;
+    unsigned value = a;
+    for (; b != 0; b >>= 1) {
+        if (b & 1) {
+            product ^= value;
+        }
+        value <<= 1;
+        if (value & 0x100) {
+            value ^= 0x11D;
+        }
+    }
+    return (uint8_t) product;
+}
+
+/**
+ * @brief 穷举求GF(2^8)的乘法逆元
+ * @param[in] a 非零元素
+ * @return 逆元
+ */
+uint8_t Inverse(uint8_t a) {
+    for (unsigned b = 1; b < 256; ++b) {
+        if (Multiply(a, (uint8_t) b) == 1) {
+            return (uint8_t) b;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 参考编码，校验行i第j列的系数为(k + i) ^ j的逆元
+ * @param[in] data 原始数据
+ * @param[in] k 数据分片数量
+ * @param[in] m 校验分片数量
+ * @param[in] fragmentSize 分片大小
+ * @return 全部k + m个分片
+ */
+std::vector<std::vector<char>> ReferenceEncode(const std::vector<char> &data, uint32_t k,
+                                               uint32_t m, uint64_t fragmentSize) {
+    std::vector<std::vector<char>> ret(k + m, std::vector<char>(fragmentSize, 0));
+    for (uint64_t i = 0; i < data.size(); ++i) {
+        ret[i / fragmentSize][i % fragmentSize] = data[i];
+    }
+    for (uint32_t i = 0; i < m; ++i) {
+        for (uint32_t j = 0; j < k; ++j) {
+            uint8_t coefficient = Inverse((uint8_t) ((k + i) ^ j));
+            for (uint64_t b = 0; b < fragmentSize; ++b) {
+                ret[k + i][b] ^= (char) Multiply(coefficient, (uint8_t) ret[j][b]);
+            }
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief 将分片转换为十六进制字符串
+ * @param[in] data 分片
+ * @return 十六进制字符串
+ */
+std::string ToHex(const std::vector<char> &data) {
+    static const char Digits[] = "0123456789abcdef";
+    std::string ret;
+    for (char c : data) {
+        ret.push_back(Digits[(uint8_t) c >> 4]);
+        ret.push_back(Digits[(uint8_t) c & 0xF]);
+    }
+    return ret;
+}
+
+/**
+ * @brief 编码并与参考结果比较
+ * @param[in] code 纠删码
+ * @param[in] data 原始数据
+ * @return 编码得到的分片
+ */
+std::vector<std::vector<char>> EncodeAndCompare(const ErasureCode &code,
+                                                const std::vector<char> &data) {
+    uint32_t k = code.GetDataFragments();
+    uint32_t m = code.GetParityFragments();
+    uint64_t fragmentSize = code.GetFragmentSize(data.size());
+    std::vector<std::vector<char>> fragments(k + m, std::vector<char>(fragmentSize));
+    std::vector<char *> pointers;
+    for (auto &fragment : fragments) {
+        pointers.push_back(fragment.data());
+    }
+    CHECK(code.Encode(data.data(), data.size(), pointers));
+    CHECK(fragments == ReferenceEncode(data, k, m, fragmentSize));
+    return fragments;
+}
+
+/**
+ * @brief 检查固定输入的校验分片
+ */
+void CheckKnownParity() {
+    ErasureCode code(4, 2);
+    std::vector<char> data(30);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (char) ((i * 7 + 3) & 0xFF);
+    }
+    auto fragments = EncodeAndCompare(code, data);
+    CHECK(fragments.size() == 6 && fragments[0].size() == 8);
+    CHECK(ToHex(fragments[4]) == "110a5bd434f6e6d4");
+    CHECK(ToHex(fragments[5]) == "b96bfb21c168b615");
+}
+
+/**
+ * @brief 编码随机数据并解码所有不超过m个分片缺失的组合
+ * @param[in] k 数据分片数量
+ * @param[in] m 校验分片数量
+ * @param[in] size 原始数据大小
+ */
+void CheckDecode(uint32_t k, uint32_t m, uint64_t size) {
+    ErasureCode code(k, m);
+    std::mt19937 random(k * 131 + m);
+    std::vector<char> data(size);
+    for (auto &c : data) {
+        c = (char) random();
+    }
+    auto fragments = EncodeAndCompare(code, data);
+    uint64_t fragmentSize = code.GetFragmentSize(size);
+    uint32_t n = k + m;
+    int patterns = 0;
+    for (uint32_t lost = 0; lost < (1u << n); ++lost) {
+        if (__builtin_popcount(lost) > (int) m) {
+            continue;
+        }
+        std::vector<const char *> available;
+        for (uint32_t i = 0; i < n; ++i) {
+            available.push_back((lost & (1u << i)) ? nullptr : fragments[i].data());
+        }
+        std::vector<char> output(size);
+        CHECK(code.Decode(available, fragmentSize, output.data(), size));
+        CHECK(output == data);
+        patterns++;
+    }
+    // 缺失超过m个分片时无法解码
+    std::vector<const char *> available(n, nullptr);
+    for (uint32_t i = 0; i + 1 < k; ++i) {
+        available[i] = fragments[i].data();
+    }
+    std::vector<char> output(size);
+    CHECK(!code.Decode(available, fragmentSize, output.data(), size));
+    std::printf("  rs-%u-%u: %d 种缺失组合\n", k, m, patterns);
+}
+} // namespace
+
+int main() {
+    std::string automatic = ErasureCode::GetKernelName();
+    int kernels = 0;
+    for (const char *kernel : {"avx2", "ssse3", "neon", "scalar"}) {
+        if (!ErasureCode::SetKernel(kernel)) {
+            continue;
+        }
+        kernels++;
+        std::printf("%s%s\n", kernel, automatic == kernel ? " (默认)" : "");
+        CheckKnownParity();
+        CheckDecode(4, 2, 30);
+        CheckDecode(4, 2, 100003);
+        CheckDecode(6, 3, 65536 * 6 + 5);
+        CheckDecode(10, 4, 4099);
+    }
+    CHECK(kernels > 0);
+    CHECK(ErasureCode::SetKernel(automatic));
+    if (failures != 0) {
+        std::fprintf(stderr, "%d 项检查失败\n", failures);
+        return 1;
+    }
+    std::printf("全部检查通过\n");
+    return 0;
+}
@@ -0,0 +1,219 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+// 完整性校验算法的已知答案测试。
+// 参考值由xxhash和blake3的官方Python实现及按位计算的CRC32C生成，输入的第i个字节为i % 251，
+// 长度覆盖各算法的分支边界。同时检查逐块计算、边复制边计算和逐块校验的结果一致
+
+#include "IntegrityCheck.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+using Fleet::DataManager::Storage::IntegrityAlgorithm;
+using Fleet::DataManager::Storage::IntegrityCheck;
+
+/// 检查失败次数
+int failures = 0;
+
+/**
+ * @brief 检查条件，失败时记录并输出位置
+ */
+#define CHECK(condition)                                                                           \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            failures++;                                                                            \
+            std::fprintf(stderr, "%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #condition);        \
+        }                                                                                          \
+    } while (0)
+
+/**
+ * @brief 已知答案
+ */
+struct KnownAnswer {
+    /// 输入长度
+    uint64_t size;
+    /// CRC32C
+    uint32_t crc32c;
+    /// XXH3 64位
+    uint64_t xxh3;
+    /// BLAKE3的十六进制表示
+    const char *blake3;
+};
+
+/// 输入第i个字节为i % 251时的参考值
+const KnownAnswer KnownAnswers[] = {
+    {0, 0x00000000u, 0x2d06800538d394c2ull,
+     "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262"},
+    {1, 0x527d5351u, 0xc44bdff4074eecdbull,
+     "2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213"},
+    {3, 0x92fd4bfau, 0x5f4299fc161c9cbbull,
+     "e1be4d7a8ab5560aa4199eea339849ba8e293d55ca0a81006726d184519e647f"},
+    {4, 0xd9331aa3u, 0x60dab036a58211f2ull,
+     "f30f5ab28fe047904037f77b6da4fea1e27241c5d132638d8bedce9d40494f32"},
+    {8, 0x8a2cbc3bu, 0x3a1c2d7c85af88f8ull,
+     "2351207d04fc16ade43ccab08600939c7c1fa70a5c0aaca76063d04c3228eaeb"},
+    {9, 0x7144c5a8u, 0xe9612598145bb9dcull,
+     "a0fc27e5d7318b723207637bdeeba4f7dcb22f7f9ec3e8b6f3588ddcd4fdf861"},
+    {16, 0xd9c908ebu, 0x8355e3a6f61770dbull,
+     "a6a492965517a830cb75fdb713465aa465f2f098233896fea44c1d98268bf9e3"},
+    {17, 0x38435e17u, 0x9ef341a99de37328ull,
+     "8462aa7be93b09fda7b93cf9f9cddb703f6dd2cc0c8edd5f9eee092edf8abf0c"},
+    {128, 0x30d9c515u, 0x85c6174c7ff4c46bull,
+     "f17e570564b26578c33bb7f44643f539624b05df1a76c81f30acd548c44b45ef"},
+    {129, 0xf514629fu, 0xec7642b431ba3e5aull,
+     "683aaae9f3c5ba37eaaf072aed0f9e30bac0865137bae68b1fde4ca2aebdcb12"},
+    {240, 0x9f4f71d6u, 0x375a384d957fe865ull,
+     "45e1a0dc23dbe51733d7269a3c0f519c2a63b0718835b2b537677eba734db0d8"},
+    {241, 0x54fe7516u, 0x02e8cd95421c6d02ull,
+     "749b36ae651c22e8567db692a6876e0ca4fd3daeb7aa8fa3ab2f642ccc69a8f6"},
+    {1023, 0x39a4911au, 0xd3d91d80ac495685ull,
+     "10108970eeda3eb932baac1428c7a2163b0e924c9a9e25b35bba72b28f70bd11"},
+    {1024, 0x2af62c0cu, 0xe5d78bafa45b2aa5ull,
+     "42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7"},
+    {1025, 0xc8d03addu, 0xe95c42288f28186eull,
+     "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444"},
+    {2048, 0x9f7e33f0u, 0x25339063db861586ull,
+     "e776b6028c7cd22a4d0ba182a8bf62205d2ef576467e838ed6f2529b85fba24a"},
+    {2049, 0x0be89406u, 0x6c9600c0e506e2aeull,
+     "5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030"},
+    {4096, 0x719077fcu, 0x7135ffa504f1bc71ull,
+     "015094013f57a5277b59d8475c0501042c0b642e531b0a1c8f58d2163229e969"},
+    {8191, 0x0a0cbf6eu, 0x3658dfee9bcaa74eull,
+     "bae8dc916e8643c6cf024097237cde1cba35c05b5d84c02834cb6b886edb76d9"},
+    {16384, 0xeafca51du, 0x168f7fb4781d0831ull,
+     "f875d6646de28985646f34ee13be9a576fd515f76b5b0a26bb324735041ddde4"},
+    {31744, 0xe1a4cb23u, 0x5162bbaf8b257803ull,
+     "62b6960e1a44bcc1eb1a611a8d6235b6b4b78f32e7abc4fb4c6cdcce94895c47"},
+    {65536, 0x0daafcdeu, 0xaaae63800707a868ull,
+     "68d647e619a930e7b1082f74f334b0c65a315725569bdc123f0ee11881717bfe"},
+    {100000, 0x7247f66bu, 0x42c23aeead96750dull,
+     "d93c23eedaf165a7e0be908ba86f1a7a520d568d2d13cde787c8580c5c72cc54"},
+    {1048583, 0x523a5681u, 0x1210bb95264f25e7ull,
+     "89541f1047f7a56806fe16efda4c2cdc45f141c838e413019f0124189fa55232"},
+};
+
+/**
+ * @brief 将摘要转换为十六进制字符串
+ * @param[in] digest 摘要
+ * @param[in] size 摘要长度
+ * @return 十六进制字符串
+ */
+std::string ToHex(const uint8_t *digest, size_t size) {
+    static const char Digits[] = "0123456789abcdef";
+    std::string ret;
+    for (size_t i = 0; i < size; ++i) {
+        ret.push_back(Digits[digest[i] >> 4]);
+        ret.push_back(Digits[digest[i] & 0xF]);
+    }
+    return ret;
+}
+
+/**
+ * @brief 生成测试输入
+ * @param[in] size 输入长度
+ * @return 第i个字节为i % 251的数据
+ */
+std::vector<char> MakeInput(uint64_t size) {
+    std::vector<char> ret(size);
+    for (uint64_t i = 0; i < size; ++i) {
+        ret[i] = (char) (i % 251);
+    }
+    return ret;
+}
+
+/**
+ * @brief 检查三种算法的单块结果与参考值一致
+ */
+void CheckKnownAnswers() {
+    const char *check = "123456789";
+    CHECK(IntegrityCheck::Crc32c(0, check, 9) == 0xE3069283u);
+    // 分段计算与一次计算结果相同
+    CHECK(IntegrityCheck::Crc32c(IntegrityCheck::Crc32c(0, check, 4), check + 4, 5) ==
+          0xE3069283u);
+
+    for (const auto &answer : KnownAnswers) {
+        auto input = MakeInput(answer.size);
+        uint32_t crc = IntegrityCheck::Crc32c(0, input.data(), answer.size);
+        uint64_t xxh3 = IntegrityCheck::Xxh3(input.data(), answer.size);
+        uint8_t blake3[32];
+        IntegrityCheck::Blake3(input.data(), answer.size, blake3);
+        if (crc != answer.crc32c || xxh3 != answer.xxh3 || ToHex(blake3, 32) != answer.blake3) {
+            failures++;
+            std::fprintf(stderr, "长度 %llu: crc32c %08x xxh3 %016llx blake3 %s\n",
+                         (unsigned long long) answer.size, crc, (unsigned long long) xxh3,
+                         ToHex(blake3, 32).c_str());
+        }
+
+        uint8_t digest[32];
+        IntegrityCheck::Compute(IntegrityAlgorithm::Crc32c, input.data(), answer.size, digest);
+        CHECK(memcmp(digest, &answer.crc32c, sizeof(answer.crc32c)) == 0);
+        IntegrityCheck::Compute(IntegrityAlgorithm::Xxh3, input.data(), answer.size, digest);
+        CHECK(memcmp(digest, &answer.xxh3, sizeof(answer.xxh3)) == 0);
+        IntegrityCheck::Compute(IntegrityAlgorithm::Blake3, input.data(), answer.size, digest);
+        CHECK(ToHex(digest, 32) == answer.blake3);
+    }
+}
+
+/**
+ * @brief 检查边复制边计算与逐块计算一致，并能定位被修改的块
+ * @param[in] algorithm 校验算法
+ */
+void CheckBlocks(IntegrityAlgorithm algorithm) {
+    const uint64_t size = 1048583;
+    const uint64_t blockSize = 4096;
+    auto input = MakeInput(size);
+    uint32_t digestSize = IntegrityCheck::GetDigestSize(algorithm);
+    uint64_t blocks = IntegrityCheck::GetBlockCount(size, blockSize);
+    std::vector<char> copy(size);
+    std::vector<uint8_t> digests(blocks * digestSize);
+    IntegrityCheck::CopyAndCompute(algorithm, copy.data(), input.data(), size, blockSize,
+                                   digests.data());
+    CHECK(copy == input);
+
+    std::vector<uint8_t> expected(digestSize);
+    for (uint64_t i = 0; i < blocks; ++i) {
+        uint64_t offset = i * blockSize;
+        uint64_t length = std::min(blockSize, size - offset);
+        IntegrityCheck::Compute(algorithm, input.data() + offset, length, expected.data());
+        CHECK(memcmp(expected.data(), &digests[i * digestSize], digestSize) == 0);
+    }
+
+    uint64_t badBlock = 0;
+    CHECK(IntegrityCheck::Verify(algorithm, copy.data(), size, blockSize, digests.data(),
+                                 badBlock));
+    copy[size - 2] ^= 0x40;
+    CHECK(!IntegrityCheck::Verify(algorithm, copy.data(), size, blockSize, digests.data(),
+                                  badBlock));
+    CHECK(badBlock == blocks - 1);
+    copy[size - 2] ^= 0x40;
+    copy[5 * blockSize + 17] ^= 0x01;
+    CHECK(!IntegrityCheck::Verify(algorithm, copy.data(), size, blockSize, digests.data(),
+                                  badBlock));
+    CHECK(badBlock == 5);
+}
+} // namespace
+
+int main() {
+    for (auto algorithm :
+         {IntegrityAlgorithm::Crc32c, IntegrityAlgorithm::Xxh3, IntegrityAlgorithm::Blake3}) {
+        std::printf("%s: %s\n", IntegrityCheck::GetName(algorithm),
+                    IntegrityCheck::GetKernelName(algorithm).c_str());
+    }
+    CheckKnownAnswers();
+    for (auto algorithm :
+         {IntegrityAlgorithm::Crc32c, IntegrityAlgorithm::Xxh3, IntegrityAlgorithm::Blake3}) {
+        CheckBlocks(algorithm);
+    }
+    if (failures != 0) {
+        std::fprintf(stderr, "%d 项检查失败\n", failures);
+        return 1;
+    }
+    std::printf("全部检查通过\n");
+    return 0;
+}
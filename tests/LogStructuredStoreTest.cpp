@@ -0,0 +1,203 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+// 日志结构存储的过期删除和批量落盘测试。
+// 过期记录不可读取，按过期时间删除后不再出现，过期时间和写入标识在重新打开和压缩后保留；
+// 多个线程的批量落盘写入均成功，重新打开后全部可读
+
+#include "bench/BenchContext.h"
+#include "LogStructuredStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+using Fleet::DataManager::Bench::BenchContext;
+using Fleet::DataManager::Bench::MakeBenchDirectory;
+using Fleet::DataManager::Storage::Durability;
+using Fleet::DataManager::Storage::IntegrityAlgorithm;
+using Fleet::DataManager::Storage::LogStructuredStore;
+using Fleet::DataManager::Storage::LogStructuredStoreOptions;
+
+/// 检查失败次数
+int failures = 0;
+
+/**
+ * @brief 检查条件，失败时记录并输出位置
+ */
+#define CHECK(condition)                                                                           \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            failures++;                                                                            \
+            std::fprintf(stderr, "%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #condition);        \
+        }                                                                                          \
+    } while (0)
+
+/**
+ * @brief 读取字符串，未找到时返回空字符串
+ */
+std::string Read(LogStructuredStore &store, const std::string &key) {
+    auto dataBlock = store.Get(key);
+    return dataBlock == nullptr ? "" : std::string(dataBlock->GetData(), dataBlock->GetSize());
+}
+
+/**
+ * @brief 写入带过期时间和写入标识的字符串
+ */
+bool Write(LogStructuredStore &store, const std::string &key, const std::string &value,
+           uint64_t expiry, uint64_t writeId) {
+    return store.Put(key, value.data(), value.size(), IntegrityAlgorithm::Crc32c, expiry,
+                     Durability::None, writeId);
+}
+
+/**
+ * @brief 过期记录的读取、删除，以及过期时间和写入标识的保留
+ */
+void CheckExpiry(const std::shared_ptr<BenchContext> &context, const std::string &directory) {
+    LogStructuredStoreOptions options;
+    // 不让后台线程删除过期记录，由测试显式调用RemoveExpired
+    options.compactionIntervalMs = 3600 * 1000;
+    options.segmentSize = 4096;
+    uint64_t now = (uint64_t) time(nullptr);
+    {
+        LogStructuredStore store(context, directory + "/expiry", options);
+        CHECK(store.Open());
+        CHECK(Write(store, "expired", "old", now - 10, 0));
+        CHECK(Write(store, "live", "value", now + 3600, 7));
+        CHECK(Write(store, "plain", "value", 0, 0));
+        CHECK(Read(store, "expired").empty());
+        CHECK(!store.Contains("expired"));
+        CHECK(Read(store, "live") == "value");
+        CHECK(store.GetExpiry("live") == now + 3600);
+        CHECK(store.GetExpiry("plain") == 0);
+
+        std::vector<std::string> keys;
+        CHECK(store.RemoveExpired(now, 10, keys));
+        CHECK(keys == std::vector<std::string>{"expired"});
+        CHECK(store.RemoveExpired(now, 10, keys));
+        CHECK(keys.empty());
+        // 过期时间晚于当前时间的记录到期后同样被删除
+        CHECK(store.RemoveExpired(now + 3600, 10, keys));
+        CHECK(keys == std::vector<std::string>{"live"});
+        CHECK(Write(store, "live", "value", now + 3600, 7));
+
+        // 写满若干个段，使过期时间和写入标识所在的段可以被压缩
+        std::string filler(1024, 'f');
+        for (int i = 0; i < 16; i++) {
+            CHECK(Write(store, "filler", filler, 0, 0));
+        }
+        store.Compact();
+        CHECK(store.GetExpiry("live") == now + 3600);
+        CHECK(store.GetWriteId("live") == 7);
+    }
+    LogStructuredStore store(context, directory + "/expiry", options);
+    CHECK(store.Open());
+    CHECK(!store.Contains("expired"));
+    CHECK(Read(store, "live") == "value");
+    CHECK(store.GetExpiry("live") == now + 3600);
+    CHECK(store.GetWriteId("live") == 7);
+    CHECK(store.GetWriteId("plain") == 0);
+}
+
+/**
+ * @brief 后台线程删除过期记录并通知回调
+ */
+void CheckBackgroundExpiry(const std::shared_ptr<BenchContext> &context,
+                           const std::string &directory) {
+    LogStructuredStoreOptions options;
+    options.compactionIntervalMs = 20;
+    LogStructuredStore store(context, directory + "/background", options);
+    std::mutex mutex;
+    std::vector<std::string> removed;
+    store.SetExpiryListener([&mutex, &removed](const std::vector<std::string> &keys) {
+        std::lock_guard<std::mutex> lock(mutex);
+        removed.insert(removed.end(), keys.begin(), keys.end());
+    });
+    CHECK(store.Open());
+    CHECK(Write(store, "expired", "old", (uint64_t) time(nullptr) - 1, 0));
+    bool notified = false;
+    for (int i = 0; i < 500 && !notified; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::lock_guard<std::mutex> lock(mutex);
+        notified = std::find(removed.begin(), removed.end(), "expired") != removed.end();
+    }
+    CHECK(notified);
+    CHECK(store.GetLiveBytes() == 0);
+}
+
+/**
+ * @brief 多个线程并发的批量落盘写入
+ */
+void CheckGroupCommit(const std::shared_ptr<BenchContext> &context,
+                      const std::string &directory) {
+    constexpr int Threads = 8;
+    constexpr int PerThread = 50;
+    LogStructuredStoreOptions options;
+    options.durability = Durability::Batch;
+    {
+        LogStructuredStore store(context, directory + "/batch", options);
+        CHECK(store.Open());
+        std::vector<std::thread> workers;
+        std::vector<int> succeeded(Threads, 0);
+        for (int t = 0; t < Threads; t++) {
+            workers.emplace_back([&store, &succeeded, t]() {
+                for (int i = 0; i < PerThread; i++) {
+                    std::string key = "key-" + std::to_string(t * PerThread + i);
+                    if (store.Put(key, key.data(), key.size())) {
+                        succeeded[t]++;
+                    }
+                }
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        for (int t = 0; t < Threads; t++) {
+            CHECK(succeeded[t] == PerThread);
+        }
+        // 不落盘的写入之后的提交覆盖此前追加的所有记录
+        CHECK(store.Put("unsynced", "value", 5, IntegrityAlgorithm::Crc32c, 0, Durability::None));
+        std::promise<bool> committed;
+        store.Commit([&committed](bool durable) { committed.set_value(durable); });
+        CHECK(committed.get_future().get());
+        CHECK(store.Commit());
+        CHECK(store.Put("sync", "value", 5, IntegrityAlgorithm::Crc32c, 0, Durability::Sync));
+    }
+    LogStructuredStore store(context, directory + "/batch", options);
+    CHECK(store.Open());
+    for (int i = 0; i < Threads * PerThread; i++) {
+        std::string key = "key-" + std::to_string(i);
+        CHECK(Read(store, key) == key);
+    }
+    CHECK(Read(store, "unsynced") == "value");
+    CHECK(Read(store, "sync") == "value");
+    store.Close();
+    // 关闭后的提交立即以失败回调
+    bool called = false;
+    store.Commit([&called](bool durable) { called = !durable; });
+    CHECK(called);
+}
+} // namespace
+
+int main() {
+    std::string directory = MakeBenchDirectory("log-structured-test");
+    auto context = std::make_shared<BenchContext>(directory);
+    CheckExpiry(context, directory);
+    CheckBackgroundExpiry(context, directory);
+    CheckGroupCommit(context, directory);
+    std::filesystem::remove_all(directory);
+    if (failures != 0) {
+        std::fprintf(stderr, "%d 项检查失败\n", failures);
+        return 1;
+    }
+    std::printf("全部检查通过\n");
+    return 0;
+}
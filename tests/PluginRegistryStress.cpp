@@ -0,0 +1,256 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+// 服务查找与插件加载、卸载、热重载并发执行的压力测试。
+// 读线程反复获取服务句柄并在持有期间访问插件实例，写线程循环重载、卸载、加载同一插件，
+// 检查句柄存活期间插件实例不会被销毁，注册表快照和旧实例最终全部回收。
+// 配合 -DFLEET_SANITIZER=address 或 thread 构建运行
+
+#include "PluginBase.h"
+#include "PluginContext.h"
+#include "StaticPluginBase.h"
+#include "StaticPluginManager.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <uuid/uuid.h>
+#include <vector>
+
+namespace {
+using Fleet::DataManager::Core::PluginBase;
+using Fleet::DataManager::Core::PluginContext;
+using Fleet::DataManager::Core::RegisterStaticPlugin;
+using Fleet::DataManager::Core::ServiceHandle;
+using Fleet::DataManager::Core::StaticPluginManager;
+
+/// 存活实例的标记值
+constexpr unsigned AliveMagic = 0xC0FFEE;
+
+/// 已销毁实例的标记值
+constexpr unsigned DeadMagic = 0xDEAD;
+
+/// 存活的插件实例数量
+std::atomic<int> liveInstances(0);
+
+/// 检查失败次数
+std::atomic<int> failures(0);
+
+/**
+ * @brief 检查条件，失败时记录并输出位置
+ */
+#define CHECK(condition)                                                                           \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            failures++;                                                                            \
+            std::fprintf(stderr, "%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #condition);        \
+        }                                                                                          \
+    } while (0)
+
+/**
+ * @brief 测试用插件，实例销毁时清除标记
+ */
+class EchoPlugin : public PluginBase {
+  public:
+    EchoPlugin() : magic(AliveMagic) {
+        liveInstances++;
+    }
+
+    ~EchoPlugin() override {
+        this->magic.store(DeadMagic);
+        liveInstances--;
+    }
+
+    bool Initialize(const std::shared_ptr<PluginContext> &context,
+                    const std::map<std::string, std::string> &parameters) override {
+        (void) context;
+        (void) parameters;
+        return true;
+    }
+
+    void *GetService() override {
+        return this;
+    }
+
+    /**
+     * @brief 判断实例是否仍然存活
+     * @return 存活返回true，否则返回false
+     */
+    bool IsAlive() const {
+        return this->magic.load() == AliveMagic;
+    }
+
+  private:
+    /// 实例标记
+    std::atomic<unsigned> magic;
+};
+
+void *NewEchoPlugin() {
+    return new EchoPlugin();
+}
+
+void DeleteEchoPlugin(void *plugin) {
+    delete (EchoPlugin *) plugin;
+}
+
+RegisterStaticPlugin registerEcho("Echo", "1.0.0", "压力测试插件", NewEchoPlugin,
+                                  DeleteEchoPlugin, {}, {});
+
+/**
+ * @brief 等待存活实例数量达到期望值，旧实例可能由后台回收线程销毁
+ * @param[in] expected 期望的存活实例数量
+ * @return 在超时前达到返回true，否则返回false
+ */
+bool WaitForLiveInstances(int expected) {
+    for (int i = 0; i < 1000 && liveInstances.load() != expected; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return liveInstances.load() == expected;
+}
+
+/**
+ * @brief 在持有句柄的线程上重载和卸载插件，不能阻塞
+ * @param[in] manager 插件管理器
+ */
+void CheckSelfPinnedReload(StaticPluginManager &manager) {
+    {
+        auto handle = manager.AcquireService("Echo");
+        auto *previous = (EchoPlugin *) handle.Get();
+        CHECK(previous != nullptr);
+        CHECK(manager.LoadPlugin("Echo"));
+        CHECK(previous->IsAlive());
+        auto current = manager.AcquireService("Echo");
+        CHECK(current.Get() != nullptr && current.Get() != previous);
+    }
+    CHECK(WaitForLiveInstances(1));
+
+    auto handle = manager.AcquireService("Echo");
+    CHECK(manager.UnloadPlugin("Echo"));
+    CHECK(((EchoPlugin *) handle.Get())->IsAlive());
+    // 句柄可以在其他线程释放
+    std::thread releaser(
+        [moved = std::move(handle)]() mutable { ServiceHandle last(std::move(moved)); });
+    releaser.join();
+    CHECK(WaitForLiveInstances(0));
+    CHECK(manager.LoadPlugin("Echo"));
+}
+
+/**
+ * @brief 同一线程持有的句柄超过线程记录的槽数时，重载仍不能阻塞
+ * @param[in] manager 插件管理器
+ */
+void CheckManyPins(StaticPluginManager &manager) {
+    {
+        std::vector<ServiceHandle> handles;
+        for (int i = 0; i < 40; i++) {
+            handles.push_back(manager.AcquireService("Echo"));
+        }
+        auto *previous = (EchoPlugin *) handles.back().Get();
+        CHECK(previous != nullptr);
+        CHECK(manager.LoadPlugin("Echo"));
+        CHECK(previous->IsAlive());
+        // 一半句柄在其他线程释放
+        std::vector<ServiceHandle> moved(std::make_move_iterator(handles.begin() + 20),
+                                         std::make_move_iterator(handles.end()));
+        handles.resize(20);
+        std::thread releaser([moved = std::move(moved)]() mutable { moved.clear(); });
+        releaser.join();
+        CHECK(previous->IsAlive());
+    }
+    CHECK(WaitForLiveInstances(1));
+}
+
+/**
+ * @brief 读线程获取服务的同时循环重载、卸载和加载插件
+ * @param[in] manager 插件管理器
+ * @param[in] duration 持续时间
+ */
+void RunStress(StaticPluginManager &manager, std::chrono::milliseconds duration) {
+    std::atomic<bool> stopping(false);
+    std::atomic<long> calls(0);
+    std::vector<std::thread> readers;
+    int readerCount = std::max(4, (int) std::thread::hardware_concurrency());
+    for (int i = 0; i < readerCount; i++) {
+        readers.emplace_back([&manager, &stopping, &calls]() {
+            while (!stopping.load()) {
+                auto handle = manager.AcquireService("Echo");
+                auto *plugin = (EchoPlugin *) handle.Get();
+                if (plugin == nullptr) {
+                    // 卸载与加载之间插件不存在
+                    continue;
+                }
+                for (int j = 0; j < 16; j++) {
+                    CHECK(plugin->IsAlive());
+                }
+                calls++;
+            }
+        });
+    }
+
+    long operations = 0;
+    auto deadline = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < deadline) {
+        switch (operations++ % 3) {
+        case 0:
+            CHECK(manager.LoadPlugin("Echo"));
+            break;
+        case 1:
+            CHECK(manager.UnloadPlugin("Echo"));
+            break;
+        default:
+            CHECK(manager.LoadPlugin("Echo"));
+            break;
+        }
+    }
+    stopping.store(true);
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    std::printf("写端操作 %ld 次, 读端调用 %ld 次\n", operations, calls.load());
+    CHECK(calls.load() > 0);
+}
+
+/**
+ * @brief 以指定加载模式运行全部检查
+ * @param[in] lazyLoad 是否启用延迟加载
+ * @param[in] duration 压力测试持续时间
+ */
+void RunAll(bool lazyLoad, std::chrono::milliseconds duration) {
+    std::printf("延迟加载: %s\n", lazyLoad ? "是" : "否");
+    char directory[] = "/tmp/fleet-registry-stress-XXXXXX";
+    CHECK(mkdtemp(directory) != nullptr);
+    uuid_t nodeId;
+    uuid_generate(nodeId);
+    {
+        StaticPluginManager manager(nodeId, directory);
+        manager.SetParameter("core.lazyLoad", lazyLoad ? "true" : "false");
+        CHECK(manager.LoadPlugin("Echo"));
+        CheckSelfPinnedReload(manager);
+        CheckManyPins(manager);
+        RunStress(manager, duration);
+        CHECK(manager.UnloadAllPlugins());
+    }
+    CHECK(liveInstances.load() == 0);
+    std::filesystem::remove_all(directory);
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::chrono::milliseconds duration(argc > 1 ? std::atol(argv[1]) : 2000);
+    RunAll(false, duration);
+    RunAll(true, duration);
+    if (failures.load() != 0) {
+        std::fprintf(stderr, "%d 项检查失败\n", failures.load());
+        return 1;
+    }
+    std::printf("全部检查通过\n");
+    return 0;
+}
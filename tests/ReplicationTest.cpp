@@ -0,0 +1,184 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+// 完整复制的写入确认、修复记录和对冲读取测试。
+// 设备卸载期间的写入在该设备上失败，重新挂载后其上留有覆盖前的旧副本，
+// 读取应跳过该副本，修复应以确认了写入的副本重写它
+
+#include "bench/BenchContext.h"
+#include "StorageEngine.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+using Fleet::DataManager::Bench::BenchContext;
+using Fleet::DataManager::Bench::MakeBenchDirectory;
+using Fleet::DataManager::Storage::DataBlock;
+using Fleet::DataManager::Storage::DataKey;
+using Fleet::DataManager::Storage::Device;
+using Fleet::DataManager::Storage::Location;
+using Fleet::DataManager::Storage::StorageEngine;
+using Fleet::DataManager::Storage::StorageEngineOptions;
+using Fleet::DataManager::Storage::Strategy;
+
+/// 检查失败次数
+int failures = 0;
+
+/**
+ * @brief 检查条件，失败时记录并输出位置
+ */
+#define CHECK(condition)                                                                           \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            failures++;                                                                            \
+            std::fprintf(stderr, "%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #condition);        \
+        }                                                                                          \
+    } while (0)
+
+/**
+ * @brief 构造位置依次为给定设备的存储策略
+ * @param[in] name 策略名称
+ * @param[in] devices 设备名称
+ * @return 存储策略
+ */
+Strategy MakeStrategy(const std::string &name, const std::vector<std::string> &devices) {
+    std::vector<Location> locations;
+    for (const auto &device : devices) {
+        locations.emplace_back(device, "");
+    }
+    return Strategy(name, "", locations, "replica", "crc32c", 0);
+}
+
+/**
+ * @brief 写入字符串
+ */
+bool Write(StorageEngine &engine, const Strategy &strategy, const DataKey &key,
+           const std::string &value) {
+    return engine.WriteData(strategy, key, std::make_shared<DataBlock>(value.size(), value.data()));
+}
+
+/**
+ * @brief 读取字符串，未找到时返回空字符串
+ */
+std::string Read(StorageEngine &engine, const Strategy &strategy, const DataKey &key) {
+    auto dataBlock = engine.ReadData(strategy, key);
+    return dataBlock == nullptr ? "" : std::string(dataBlock->GetData(), dataBlock->GetSize());
+}
+
+/**
+ * @brief 挂载设备
+ */
+bool Mount(StorageEngine &engine, const std::string &directory, const std::string &name) {
+    return engine.AddDevice(std::make_shared<Device>(name, "", "", directory + "/" + name));
+}
+
+/**
+ * @brief 等待待修复记录达到指定数量
+ * @details 写入在达到或无法达到确认数时即返回，修复记录在最后一个副本写入结束后才登记
+ * @return 在5秒内达到返回true，否则返回false
+ */
+bool WaitForRepairs(StorageEngine &engine, size_t count) {
+    for (int i = 0; i < 500; i++) {
+        if (engine.GetPendingRepairCount() == count) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+/**
+ * @brief 写入确认数、写入失败的修复记录和旧副本的修复
+ */
+void CheckQuorumAndRepair(const std::shared_ptr<BenchContext> &context,
+                          const std::string &directory) {
+    StorageEngineOptions options;
+    options.cacheCapacity = 0;
+    options.hedgedReads = false;
+    options.writeQuorums["quorum"] = 2;
+    StorageEngine engine(context, options);
+    for (const char *device : {"a", "b", "c"}) {
+        CHECK(Mount(engine, directory, device));
+    }
+    // 将要落后的设备排在第一位，读取和修复若不区分新旧副本会首先选中它
+    Strategy quorum = MakeStrategy("quorum", {"c", "a", "b"});
+    Strategy all = MakeStrategy("all", {"c", "a", "b"});
+    DataKey key("test", "replication", "object", "1");
+    CHECK(Write(engine, quorum, key, "old"));
+    CHECK(engine.GetPendingRepairCount() == 0);
+
+    CHECK(engine.RemoveDevice("c"));
+    // 未指定确认数的策略等待所有副本，一个设备失败即写入失败
+    CHECK(!Write(engine, all, DataKey("test", "replication", "other", "1"), "value"));
+    CHECK(WaitForRepairs(engine, 1));
+    // 两个副本确认即成功，失败的设备记录为待修复
+    CHECK(Write(engine, quorum, key, "new"));
+    CHECK(WaitForRepairs(engine, 2));
+
+    CHECK(Mount(engine, directory, "c"));
+    Strategy onlyC = MakeStrategy("quorum", {"c"});
+    // 设备c上仍是旧副本，按完整策略读取时被跳过
+    CHECK(Read(engine, quorum, key) == "new");
+    CHECK(Read(engine, onlyC, key).empty());
+
+    CHECK(engine.RepairPending() == 2);
+    CHECK(engine.GetPendingRepairCount() == 0);
+    CHECK(Read(engine, onlyC, key) == "new");
+    CHECK(Read(engine, onlyC, DataKey("test", "replication", "other", "1")) == "value");
+
+    // 只写入设备b和c，没有修复记录，按写入标识识别设备a上的旧副本
+    CHECK(Write(engine, MakeStrategy("quorum", {"b", "c"}), key, "newer"));
+    CHECK(engine.GetPendingRepairCount() == 0);
+    CHECK(engine.RepairData(quorum, key));
+    CHECK(Read(engine, MakeStrategy("quorum", {"a"}), key) == "newer");
+}
+
+/**
+ * @brief 对冲读取在首选副本缺失时从其余副本返回，并记录设备延迟
+ */
+void CheckHedgedReads(const std::shared_ptr<BenchContext> &context,
+                      const std::string &directory) {
+    StorageEngineOptions options;
+    options.cacheCapacity = 0;
+    options.hedgedReads = true;
+    options.hedgeMinimumDelay = 100;
+    StorageEngine engine(context, options);
+    for (const char *device : {"d", "e", "f"}) {
+        CHECK(Mount(engine, directory, device));
+    }
+    Strategy strategy = MakeStrategy("hedged", {"d", "e", "f"});
+    std::string value(256 * 1024, 'h');
+    for (int i = 0; i < 20; i++) {
+        CHECK(Write(engine, strategy, DataKey("test", "hedged", std::to_string(i), "1"), value));
+    }
+    for (int i = 0; i < 20; i++) {
+        CHECK(Read(engine, strategy, DataKey("test", "hedged", std::to_string(i), "1")) == value);
+    }
+    CHECK(engine.GetReadLatency("d") + engine.GetReadLatency("e") + engine.GetReadLatency("f") >
+          0);
+    // 只有最后一个位置持有的数据
+    DataKey lonely("test", "hedged", "lonely", "1");
+    CHECK(Write(engine, MakeStrategy("hedged", {"f"}), lonely, "only-f"));
+    CHECK(Read(engine, strategy, lonely) == "only-f");
+    CHECK(Read(engine, strategy, DataKey("test", "hedged", "missing", "1")).empty());
+}
+} // namespace
+
+int main() {
+    std::string directory = MakeBenchDirectory("replication-test");
+    auto context = std::make_shared<BenchContext>(directory);
+    CheckQuorumAndRepair(context, directory);
+    CheckHedgedReads(context, directory);
+    std::filesystem::remove_all(directory);
+    if (failures != 0) {
+        std::fprintf(stderr, "%d 项检查失败\n", failures);
+        return 1;
+    }
+    std::printf("全部检查通过\n");
+    return 0;
+}
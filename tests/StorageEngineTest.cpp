@@ -0,0 +1,374 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+// 存储引擎的空间配额、分块去重、位置选择和巡检测试。
+// 配额按各设备的存活字节数检查，卸载和重新挂载设备后总用量随之增减；
+// 分块保存的版本共用分块，删除后回收不再被引用的分块；
+// 位置选择只选择已挂载的不同设备；巡检按批推进并保存游标，重启后从游标处继续，并修复损坏的副本
+
+#include "bench/BenchContext.h"
+#include "Scrubber.h"
+#include "StorageEngine.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+using Fleet::DataManager::Bench::BenchContext;
+using Fleet::DataManager::Bench::MakeBenchDirectory;
+using Fleet::DataManager::Storage::ChunkStatistics;
+using Fleet::DataManager::Storage::DataBlock;
+using Fleet::DataManager::Storage::DataKey;
+using Fleet::DataManager::Storage::Device;
+using Fleet::DataManager::Storage::Location;
+using Fleet::DataManager::Storage::Scrubber;
+using Fleet::DataManager::Storage::ScrubberOptions;
+using Fleet::DataManager::Storage::ScrubStatistics;
+using Fleet::DataManager::Storage::StorageEngine;
+using Fleet::DataManager::Storage::StorageEngineOptions;
+using Fleet::DataManager::Storage::Strategy;
+
+/// 检查失败次数
+int failures = 0;
+
+/**
+ * @brief 检查条件，失败时记录并输出位置
+ */
+#define CHECK(condition)                                                                           \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            failures++;                                                                            \
+            std::fprintf(stderr, "%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #condition);        \
+        }                                                                                          \
+    } while (0)
+
+/**
+ * @brief 构造位置依次为给定设备的存储策略
+ * @param[in] devices 设备名称
+ * @param[in] algorithm 容错纠错算法
+ * @return 存储策略
+ */
+std::shared_ptr<Strategy> MakeStrategy(const std::vector<std::string> &devices,
+                                       const std::string &algorithm = "replica") {
+    std::vector<Location> locations;
+    for (const auto &device : devices) {
+        locations.emplace_back(device, "");
+    }
+    return std::make_shared<Strategy>("test", "", locations, algorithm, "crc32c", 0);
+}
+
+/**
+ * @brief 写入字符串
+ */
+bool Write(StorageEngine &engine, const Strategy &strategy, const DataKey &key,
+           const std::string &value) {
+    return engine.WriteData(strategy, key, std::make_shared<DataBlock>(value.size(), value.data()));
+}
+
+/**
+ * @brief 读取字符串，未找到时返回空字符串
+ */
+std::string Read(StorageEngine &engine, const Strategy &strategy, const DataKey &key) {
+    auto dataBlock = engine.ReadData(strategy, key);
+    return dataBlock == nullptr ? "" : std::string(dataBlock->GetData(), dataBlock->GetSize());
+}
+
+/**
+ * @brief 挂载设备
+ */
+bool Mount(StorageEngine &engine, const std::string &directory, const std::string &name) {
+    return engine.AddDevice(std::make_shared<Device>(name, "", "", directory + "/" + name));
+}
+
+/**
+ * @brief 构造伪随机内容
+ * @param[in] size 大小
+ * @param[in] seed 随机数种子
+ * @return 内容
+ */
+std::string MakeRandom(size_t size, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::string ret(size, '\0');
+    for (auto &c : ret) {
+        c = (char) random();
+    }
+    return ret;
+}
+
+/**
+ * @brief 空间配额和用量计数
+ */
+void CheckQuota(const std::shared_ptr<BenchContext> &context, const std::string &directory) {
+    StorageEngineOptions options;
+    options.cacheCapacity = 0;
+    StorageEngine engine(context, options);
+    CHECK(Mount(engine, directory, "a"));
+    CHECK(Mount(engine, directory, "b"));
+    auto strategy = MakeStrategy({"a", "b"});
+    CHECK(engine.GetUsedSpace() == 0);
+    CHECK(Write(engine, *strategy, DataKey("quota", "small", "first", "1"),
+                std::string(1000, 'q')));
+    uint64_t used = engine.GetUsedSpace();
+    CHECK(used > 2000);
+
+    // 两个副本各1000字节，估算2000字节，超过剩余的1500字节
+    engine.SetSpaceLimit(used + 1500);
+    CHECK(!Write(engine, *strategy, DataKey("quota", "small", "second", "1"),
+                 std::string(1000, 'q')));
+    CHECK(engine.GetUsedSpace() == used);
+    CHECK(Write(engine, *strategy, DataKey("quota", "small", "third", "1"),
+                std::string(500, 'q')));
+    CHECK(engine.GetUsedSpace() > used + 1000);
+    engine.SetSpaceLimit(0);
+    CHECK(Write(engine, *strategy, DataKey("quota", "large", "fourth", "1"),
+                std::string(100000, 'q')));
+
+    used = engine.GetUsedSpace();
+    std::map<std::string, uint64_t> devices;
+    engine.GetDeviceUsage(devices);
+    CHECK(devices.size() == 2);
+    CHECK(devices["a"] + devices["b"] == used);
+    std::map<std::string, std::map<std::string, uint64_t>> applications;
+    engine.GetApplicationUsage(applications);
+    CHECK(applications["quota"]["small"] + applications["quota"]["large"] == used);
+    CHECK(applications["quota"]["large"] > applications["quota"]["small"]);
+
+    // 卸载的设备不再计入，重新挂载后从段文件重建
+    uint64_t deviceB = devices["b"];
+    CHECK(engine.RemoveDevice("b"));
+    CHECK(engine.GetUsedSpace() == used - deviceB);
+    CHECK(Mount(engine, directory, "b"));
+    CHECK(engine.GetUsedSpace() == used);
+    CHECK(engine.ReconcileUsage());
+    CHECK(engine.RemoveData(*strategy, DataKey("quota", "large", "fourth", "1")));
+    engine.GetApplicationUsage(applications);
+    CHECK(applications["quota"].count("large") == 0);
+    CHECK(engine.GetUsedSpace() == applications["quota"]["small"]);
+}
+
+/**
+ * @brief 分块去重和不再被引用的分块的回收
+ */
+void CheckChunking(const std::shared_ptr<BenchContext> &context, const std::string &directory) {
+    StorageEngineOptions options;
+    options.cacheCapacity = 0;
+    options.chunkingThreshold = 16 * 1024;
+    options.chunkMinimumSize = 2 * 1024;
+    options.chunkAverageSize = 8 * 1024;
+    options.chunkMaximumSize = 32 * 1024;
+    StorageEngine engine(context, options);
+    CHECK(Mount(engine, directory, "chunks"));
+    auto strategy = MakeStrategy({"chunks"});
+    constexpr size_t Size = 256 * 1024;
+    std::string first = MakeRandom(Size, 1);
+    std::string second = first;
+    // 只改动中间的少量字节，其余分块与第一个版本相同
+    for (size_t i = 0; i < 100; i++) {
+        second[Size / 2 + i] = (char) ~second[Size / 2 + i];
+    }
+    DataKey firstKey("chunk", "blob", "object", "1");
+    DataKey secondKey("chunk", "blob", "object", "2");
+    CHECK(Write(engine, *strategy, firstKey, first));
+    CHECK(Write(engine, *strategy, secondKey, second));
+    // 小于阈值的数据直接保存
+    CHECK(Write(engine, *strategy, DataKey("chunk", "blob", "small", "1"), "small"));
+
+    ChunkStatistics statistics = engine.GetChunkStatistics();
+    CHECK(statistics.manifests == 2);
+    CHECK(statistics.referencedBytes == 2 * Size);
+    CHECK(statistics.storedBytes > Size);
+    CHECK(statistics.storedBytes < Size + Size / 4);
+    CHECK(Read(engine, *strategy, firstKey) == first);
+    CHECK(Read(engine, *strategy, secondKey) == second);
+
+    // 引用计数在重新挂载时由分块清单重建
+    CHECK(engine.RemoveDevice("chunks"));
+    CHECK(Mount(engine, directory, "chunks"));
+    ChunkStatistics reopened = engine.GetChunkStatistics();
+    CHECK(reopened.manifests == statistics.manifests);
+    CHECK(reopened.chunks == statistics.chunks);
+    CHECK(reopened.storedBytes == statistics.storedBytes);
+    CHECK(Read(engine, *strategy, secondKey) == second);
+
+    // 删除一个版本后只保留另一个版本引用的分块，两个版本都删除后不再有分块
+    CHECK(engine.RemoveData(*strategy, firstKey));
+    statistics = engine.GetChunkStatistics();
+    CHECK(statistics.manifests == 1);
+    CHECK(statistics.referencedBytes == Size);
+    CHECK(statistics.storedBytes == Size);
+    CHECK(Read(engine, *strategy, firstKey).empty());
+    CHECK(Read(engine, *strategy, secondKey) == second);
+    CHECK(engine.RemoveData(*strategy, secondKey));
+    statistics = engine.GetChunkStatistics();
+    CHECK(statistics.manifests == 0);
+    CHECK(statistics.chunks == 0);
+    CHECK(statistics.storedBytes == 0);
+    CHECK(engine.RemoveData(*strategy, DataKey("chunk", "blob", "small", "1")));
+    CHECK(engine.GetUsedSpace() == 0);
+}
+
+/**
+ * @brief 按设备负载和剩余空间选择位置
+ */
+void CheckPlacement(const std::shared_ptr<BenchContext> &context, const std::string &directory) {
+    StorageEngineOptions options;
+    options.cacheCapacity = 0;
+    StorageEngine engine(context, options);
+    for (const char *device : {"p", "q", "r"}) {
+        CHECK(Mount(engine, directory, device));
+    }
+    // 设备s未挂载，不参与选择
+    auto strategy = MakeStrategy({"p", "q", "r", "s"});
+    std::map<std::string, int> chosen;
+    for (int i = 0; i < 60; i++) {
+        auto placed = engine.PlaceData(*strategy, 2, 1024);
+        CHECK(placed != nullptr);
+        if (placed == nullptr) {
+            continue;
+        }
+        const auto &locations = placed->GetLocations();
+        CHECK(locations.size() == 2);
+        std::set<std::string> devices;
+        for (const auto &location : locations) {
+            devices.insert(location.GetDeviceName());
+            chosen[location.GetDeviceName()]++;
+        }
+        CHECK(devices.size() == locations.size());
+        CHECK(devices.count("s") == 0);
+        CHECK(placed->GetName() == strategy->GetName());
+    }
+    CHECK(chosen.size() == 3);
+    auto all = engine.PlaceData(*strategy, 0, 1024);
+    CHECK(all != nullptr && all->GetLocations().size() == 3);
+    CHECK(engine.PlaceData(*strategy, 4, 1024) == nullptr);
+    CHECK(engine.PlaceData(*strategy, 1, UINT64_MAX / 2) == nullptr);
+    auto coded = engine.PlaceData(*MakeStrategy({"p", "q", "r", "s"}, "rs-2-1"), 0, 1024);
+    CHECK(coded != nullptr && coded->GetLocations().size() == 3);
+
+    // 记录的位置还原出写入时的策略，只读取所选的设备
+    DataKey key("placement", "blob", "object", "1");
+    std::string value = MakeRandom(4096, 2);
+    std::vector<std::string> locations;
+    CHECK(engine.WritePlaced(*strategy, key,
+                             std::make_shared<DataBlock>(value.size(), value.data()), 2,
+                             locations));
+    CHECK(locations.size() == 2);
+    auto located = StorageEngine::LocateData(*strategy, locations);
+    CHECK(located->GetLocations().size() == 2);
+    CHECK(Read(engine, *located, key) == value);
+    for (const char *device : {"p", "q", "r"}) {
+        bool selected = std::find(locations.begin(), locations.end(), device) != locations.end();
+        CHECK(Read(engine, *MakeStrategy({device}), key).empty() == !selected);
+    }
+}
+
+/**
+ * @brief 读取文件内容
+ */
+std::string ReadFile(const std::filesystem::path &path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief 翻转设备段文件中指定内容的一个字节
+ * @return 找到并修改返回true，否则返回false
+ */
+bool Corrupt(const std::string &directory, const std::string &pattern) {
+    for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.path().filename().string().rfind("segment-", 0) != 0) {
+            continue;
+        }
+        std::string content = ReadFile(entry.path());
+        size_t position = content.find(pattern);
+        if (position == std::string::npos) {
+            continue;
+        }
+        std::fstream file(entry.path(), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp((std::streamoff) (position + pattern.size() / 2));
+        char c = (char) ~pattern[pattern.size() / 2];
+        file.write(&c, 1);
+        return file.good();
+    }
+    return false;
+}
+
+/**
+ * @brief 巡检的游标保存、重启后继续和损坏副本的修复
+ */
+void CheckScrubber(const std::shared_ptr<BenchContext> &context, const std::string &directory) {
+    constexpr int Keys = 10;
+    StorageEngineOptions engineOptions;
+    engineOptions.cacheCapacity = 0;
+    StorageEngine engine(context, engineOptions);
+    CHECK(Mount(engine, directory, "x"));
+    CHECK(Mount(engine, directory, "y"));
+    auto strategy = MakeStrategy({"x", "y"});
+    for (int i = 0; i < Keys; i++) {
+        CHECK(Write(engine, *strategy, DataKey("scrub", "blob", "object-" + std::to_string(i), "1"),
+                    std::string(4096, (char) ('A' + i))));
+    }
+    ScrubberOptions options;
+    options.bytesPerSecond = 0;
+    options.operationsPerSecond = 0;
+    options.batchSize = 4;
+    auto resolver = [&strategy](const DataKey &) { return strategy; };
+    std::string cursorPath =
+        (std::filesystem::path(engine.GetStoreDirectory("x")) / options.cursorFileName).string();
+    {
+        Scrubber scrubber(context, engine, resolver, options);
+        CHECK(scrubber.ScrubBatch());
+        CHECK(scrubber.GetStatistics().scannedKeys == 8);
+        CHECK(ReadFile(cursorPath) == StorageEngine::EncodeKey("scrub", "blob", "object-3", "1"));
+    }
+    {
+        // 新的巡检从游标处继续，每个设备只校验剩余的键
+        Scrubber scrubber(context, engine, resolver, options);
+        while (scrubber.ScrubBatch()) {
+        }
+        ScrubStatistics statistics = scrubber.GetStatistics();
+        CHECK(statistics.scannedKeys == 2 * (Keys - 4));
+        CHECK(statistics.completedPasses == 1);
+        CHECK(statistics.corruptedKeys == 0);
+        CHECK(ReadFile(cursorPath).empty());
+    }
+
+    CHECK(Corrupt(engine.GetStoreDirectory("x"), std::string(64, 'A')));
+    DataKey damaged("scrub", "blob", "object-0", "1");
+    CHECK(Read(engine, *MakeStrategy({"x"}), damaged).empty());
+    Scrubber scrubber(context, engine, resolver, options);
+    while (scrubber.ScrubBatch()) {
+    }
+    ScrubStatistics statistics = scrubber.GetStatistics();
+    CHECK(statistics.scannedKeys == 2 * Keys);
+    CHECK(statistics.corruptedKeys == 1);
+    CHECK(statistics.repairedKeys == 1);
+    CHECK(statistics.unrepairedKeys == 0);
+    CHECK(Read(engine, *MakeStrategy({"x"}), damaged) == std::string(4096, 'A'));
+}
+} // namespace
+
+int main() {
+    std::string directory = MakeBenchDirectory("storage-engine-test");
+    auto context = std::make_shared<BenchContext>(directory);
+    CheckQuota(context, directory);
+    CheckChunking(context, directory);
+    CheckPlacement(context, directory);
+    CheckScrubber(context, directory);
+    std::filesystem::remove_all(directory);
+    if (failures != 0) {
+        std::fprintf(stderr, "%d 项检查失败\n", failures);
+        return 1;
+    }
+    std::printf("全部检查通过\n");
+    return 0;
+}
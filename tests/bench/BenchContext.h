@@ -0,0 +1,117 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+#ifndef FLEET_DATA_MANAGER_TESTS_BENCH_CONTEXT_H
+#define FLEET_DATA_MANAGER_TESTS_BENCH_CONTEXT_H
+
+#include "PluginContext.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace Fleet::DataManager::Bench {
+/**
+ * @brief 基准测试使用的插件上下文
+ * @details 不加载插件，目录均指向测试数据目录，日志输出到控制台
+ */
+class BenchContext : public Core::PluginContext {
+  public:
+    /**
+     * @brief 构造基准测试上下文
+     * @param[in] directory 测试数据目录
+     */
+    explicit BenchContext(const std::string &directory) : nodeId("bench"), directory(directory) {
+        this->logger = std::make_shared<Core::Logger>();
+    }
+
+    /**
+     * @brief 析构函数
+     */
+    ~BenchContext() override = default;
+
+    /**
+     * @brief 删除的复制构造函数
+     */
+    BenchContext(const BenchContext &) = delete;
+
+    /**
+     * @brief 删除的赋值运算符
+     */
+    BenchContext &operator=(const BenchContext &) = delete;
+
+    const std::string &GetNodeId() override {
+        return this->nodeId;
+    }
+
+    void *GetService(const std::string &name) override {
+        (void) name;
+        return nullptr;
+    }
+
+    Core::ServiceHandle AcquireService(const std::string &name) override {
+        (void) name;
+        return Core::ServiceHandle();
+    }
+
+    const std::string &GetBaseDirectory() override {
+        return this->directory;
+    }
+
+    const std::string &GetDataDirectory() override {
+        return this->directory;
+    }
+
+    const std::string &GetLogDirectory() override {
+        return this->directory;
+    }
+
+    const std::string &GetDatabaseDirectory() override {
+        return this->directory;
+    }
+
+    Core::MemoryPool &GetMemoryPool() override {
+        return Core::MemoryPool::Global();
+    }
+
+    Core::Executor &GetExecutor() override {
+        return Core::Executor::Global();
+    }
+
+  private:
+    /// 节点ID
+    std::string nodeId;
+
+    /// 测试数据目录
+    std::string directory;
+};
+
+/**
+ * @brief 创建空的测试数据目录
+ * @details 位于环境变量FLEET_BENCH_DIR指定的目录下，未指定时位于/tmp，
+ * 测试磁盘性能时应指向被测设备上的目录
+ * @param[in] name 子目录名称
+ * @return 测试数据目录
+ */
+inline std::string MakeBenchDirectory(const std::string &name) {
+    const char *root = std::getenv("FLEET_BENCH_DIR");
+    std::filesystem::path path(root != nullptr ? root : "/tmp");
+    path /= "fleet-bench-" + name;
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+    return path.string();
+}
+
+/**
+ * @brief 获取从某一时刻起经过的秒数
+ * @param[in] start 起始时刻
+ * @return 经过的秒数
+ */
+inline double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace Fleet::DataManager::Bench
+#endif // FLEET_DATA_MANAGER_TESTS_BENCH_CONTEXT_H
@@ -0,0 +1,153 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+// 大记录直接写入基准。
+// 写入若干条约16MiB的随机记录，同时另一个线程反复读取2000条4000字节的热点记录，
+// 比较经页缓存写入与超过阈值后直接写入的吞吐量、写后留在页缓存中的段数据量和热点读取延迟。
+// 用法: DirectWriteBench [大记录数量=48] [重复次数=2]
+
+#include "BenchContext.h"
+#include "LogStructuredStore.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+using Fleet::DataManager::Bench::BenchContext;
+using Fleet::DataManager::Bench::MakeBenchDirectory;
+using Fleet::DataManager::Bench::SecondsSince;
+using Fleet::DataManager::Storage::LogStructuredStore;
+using Fleet::DataManager::Storage::LogStructuredStoreOptions;
+
+/// 热点记录数量
+constexpr int HotRecords = 2000;
+
+/// 热点记录大小
+constexpr size_t HotSize = 4000;
+
+/**
+ * @brief 统计目录下文件留在页缓存中的字节数
+ * @param[in] directory 目录
+ * @return 页缓存中的字节数
+ */
+uint64_t GetCachedBytes(const std::string &directory) {
+    uint64_t ret = 0;
+    long pageSize = sysconf(_SC_PAGESIZE);
+    for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+        int fd = open(entry.path().c_str(), O_RDONLY);
+        if (fd < 0) {
+            continue;
+        }
+        struct stat status {};
+        if (fstat(fd, &status) == 0 && status.st_size > 0) {
+            void *address = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (address != MAP_FAILED) {
+                std::vector<unsigned char> pages((status.st_size + pageSize - 1) / pageSize);
+                if (mincore(address, status.st_size, pages.data()) == 0) {
+                    for (auto page : pages) {
+                        ret += (page & 1) * pageSize;
+                    }
+                }
+                munmap(address, status.st_size);
+            }
+        }
+        close(fd);
+    }
+    return ret;
+}
+
+/**
+ * @brief 运行一轮写入
+ * @param[in] context 插件上下文
+ * @param[in] directory 段文件目录
+ * @param[in] label 模式名称
+ * @param[in] threshold 直接写入阈值，为0时不使用直接I/O
+ * @param[in] count 大记录数量
+ * @return 成功返回true，否则返回false
+ */
+bool Run(const std::shared_ptr<BenchContext> &context, const std::string &directory,
+         const char *label, uint64_t threshold, int count) {
+    std::filesystem::remove_all(directory);
+    LogStructuredStoreOptions options;
+    options.directWriteThreshold = threshold;
+    LogStructuredStore store(context, directory, options);
+    if (!store.Open()) {
+        std::fprintf(stderr, "打开日志结构存储失败\n");
+        return false;
+    }
+    std::string small(HotSize, 's');
+    for (int i = 0; i < HotRecords; i++) {
+        if (!store.Put("hot" + std::to_string(i), small.data(), small.size())) {
+            return false;
+        }
+    }
+
+    std::atomic<bool> stopping(false);
+    std::atomic<bool> readFailed(false);
+    std::vector<double> latencies;
+    std::thread reader([&]() {
+        std::mt19937_64 random(1);
+        while (!stopping.load()) {
+            auto start = std::chrono::steady_clock::now();
+            auto block = store.Get("hot" + std::to_string(random() % HotRecords));
+            latencies.push_back(SecondsSince(start) * 1e6);
+            if (block == nullptr || block->GetSize() != HotSize) {
+                readFailed.store(true);
+            }
+        }
+    });
+
+    std::mt19937_64 random(9);
+    uint64_t total = 0;
+    bool ret = true;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count && ret; i++) {
+        std::string value((16 << 20) + random() % 100000, 0);
+        for (size_t k = 0; k < value.size(); k += 8) {
+            uint64_t word = random();
+            memcpy(&value[k], &word, std::min<size_t>(8, value.size() - k));
+        }
+        ret = store.Put("bulk" + std::to_string(i), value.data(), value.size());
+        total += value.size();
+        // 大记录之间穿插未对齐的小记录
+        ret = ret && store.Put("x" + std::to_string(i), "abc", 3);
+    }
+    double seconds = SecondsSince(start);
+    stopping.store(true);
+    reader.join();
+    if (!ret || readFailed.load() || latencies.empty()) {
+        std::fprintf(stderr, "%s: 读写失败\n", label);
+        return false;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("%-9s 写入 %6.0f MB/s  页缓存 %7.1f MB  热点读取 %zu 次 p50 %.1f us p99 %.1f us\n",
+                label, total / 1e6 / seconds, GetCachedBytes(directory) / 1e6, latencies.size(),
+                latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100]);
+    return true;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 48;
+    int runs = argc > 2 ? std::atoi(argv[2]) : 2;
+    std::string directory = MakeBenchDirectory("direct-write");
+    auto context = std::make_shared<BenchContext>(directory);
+    bool ret = true;
+    for (int run = 0; run < runs && ret; run++) {
+        ret = Run(context, directory + "/lss", "buffered", 0, count) &&
+              Run(context, directory + "/lss", "direct", 1024 * 1024, count);
+    }
+    std::filesystem::remove_all(directory);
+    return ret ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+// I/O后端基准。
+// 每种后端先以1MiB顺序写入测试文件，再按批提交4KiB随机读，单线程执行。
+// 文件小于内存时读取命中页缓存，结果反映提交开销而不是设备性能。
+// 用法: IoBackendBench [文件大小MiB=1024] [批深度=8] [重复次数=3]
+
+#include "BenchContext.h"
+#include "IoBackend.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+using Fleet::DataManager::Bench::BenchContext;
+using Fleet::DataManager::Bench::MakeBenchDirectory;
+using Fleet::DataManager::Bench::SecondsSince;
+using Fleet::DataManager::Storage::IoBackend;
+using Fleet::DataManager::Storage::IoBackendType;
+using Fleet::DataManager::Storage::IoRequest;
+
+/// 顺序写入的块大小
+constexpr uint64_t WriteSize = 1024 * 1024;
+
+/// 随机读取的块大小
+constexpr uint64_t ReadSize = 4096;
+
+/// 每轮随机读取的次数
+constexpr uint64_t ReadCount = 200000;
+
+/**
+ * @brief 运行一轮顺序写入和随机读取
+ * @param[in] backend I/O后端
+ * @param[in] path 测试文件路径
+ * @param[in] megabytes 文件大小，单位MiB
+ * @param[in] depth 每批读取数
+ * @return 成功返回true，否则返回false
+ */
+bool RunOnce(IoBackend &backend, const std::string &path, uint64_t megabytes, uint32_t depth) {
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    backend.RegisterFile(fd);
+    std::vector<char> block(WriteSize, 'x');
+    bool ret = true;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < megabytes && ret; i++) {
+        ret = backend.Write(fd, block.data(), WriteSize, i * WriteSize, false);
+    }
+    double write = SecondsSince(start);
+
+    std::mt19937_64 random(1);
+    std::vector<std::vector<char>> buffers(depth, std::vector<char>(ReadSize));
+    std::vector<IoRequest> requests(depth);
+    uint64_t pages = megabytes * WriteSize / ReadSize;
+    start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < ReadCount / depth && ret; i++) {
+        for (uint32_t j = 0; j < depth; j++) {
+            requests[j] = IoRequest{fd, buffers[j].data(), ReadSize, random() % pages * ReadSize};
+        }
+        ret = backend.ReadBatch(requests);
+    }
+    double read = SecondsSince(start);
+    std::printf("%-9s 顺序写入 %6.0f MiB/s  4K随机读取(批深度 %u) %7.0f IOPS\n", backend.GetName(),
+                megabytes / write, depth, ReadCount / depth * depth / read);
+    backend.UnregisterFile(fd);
+    close(fd);
+    return ret;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    uint64_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+    uint32_t depth = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 8;
+    int runs = argc > 3 ? std::atoi(argv[3]) : 3;
+    if (megabytes == 0 || depth == 0) {
+        std::fprintf(stderr, "文件大小和批深度必须大于0\n");
+        return 1;
+    }
+    std::string directory = MakeBenchDirectory("io-backend");
+    auto context = std::make_shared<BenchContext>(directory);
+    bool ret = true;
+    for (int run = 0; run < runs && ret; run++) {
+        for (auto type : {IoBackendType::Blocking, IoBackendType::Uring}) {
+            auto backend = IoBackend::Create(type, context);
+            ret = ret && RunOnce(*backend, directory + "/data", megabytes, depth);
+        }
+    }
+    std::filesystem::remove_all(directory);
+    return ret ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+// 纠删码和完整性校验的单线程吞吐量基准。
+// 纠删码在CPU支持的每种乘加实现上编码一个对象，并在缺失m个数据分片时解码；
+// 完整性校验按64KiB的块边复制边计算摘要，再逐块校验。
+// 用法: KernelBench [对象大小MiB=64] [纠删码=rs-6-3] [重复次数=5]
+
+#include "BenchContext.h"
+#include "ErasureCode.h"
+#include "IntegrityCheck.h"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+using Fleet::DataManager::Bench::SecondsSince;
+using Fleet::DataManager::Storage::ErasureCode;
+using Fleet::DataManager::Storage::IntegrityAlgorithm;
+using Fleet::DataManager::Storage::IntegrityCheck;
+
+/// 完整性校验的块大小
+constexpr uint64_t BlockSize = 64 * 1024;
+
+/**
+ * @brief 测试纠删码编码和解码吞吐量
+ * @param[in] code 纠删码
+ * @param[in] data 原始数据
+ * @param[in] runs 重复次数
+ * @return 解码结果正确返回true，否则返回false
+ */
+bool RunErasureCode(const ErasureCode &code, const std::vector<char> &data, int runs) {
+    uint32_t k = code.GetDataFragments();
+    uint32_t m = code.GetParityFragments();
+    uint64_t fragmentSize = code.GetFragmentSize(data.size());
+    std::vector<std::vector<char>> fragments(k + m, std::vector<char>(fragmentSize));
+    std::vector<char *> outputs;
+    for (auto &fragment : fragments) {
+        outputs.push_back(fragment.data());
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+        code.Encode(data.data(), data.size(), outputs);
+    }
+    double encode = SecondsSince(start);
+
+    // 前m个数据分片缺失，解码需要求逆并恢复
+    std::vector<const char *> inputs;
+    for (uint32_t i = 0; i < k + m; i++) {
+        inputs.push_back(i < m ? nullptr : fragments[i].data());
+    }
+    std::vector<char> output(data.size());
+    bool ret = true;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+        ret = code.Decode(inputs, fragmentSize, output.data(), output.size()) && ret;
+    }
+    double decode = SecondsSince(start);
+    double megabytes = data.size() / 1e6 * runs;
+    std::printf("  %-7s 编码 %7.0f MB/s  缺失 %u 个分片解码 %7.0f MB/s\n",
+                ErasureCode::GetKernelName().c_str(), megabytes / encode, m, megabytes / decode);
+    return ret && output == data;
+}
+
+/**
+ * @brief 测试完整性校验吞吐量
+ * @param[in] algorithm 校验算法
+ * @param[in] data 数据
+ * @param[in] runs 重复次数
+ * @return 校验通过返回true，否则返回false
+ */
+bool RunIntegrity(IntegrityAlgorithm algorithm, const std::vector<char> &data, int runs) {
+    uint64_t blocks = IntegrityCheck::GetBlockCount(data.size(), BlockSize);
+    std::vector<uint8_t> digests(blocks * IntegrityCheck::GetDigestSize(algorithm));
+    std::vector<char> copy(data.size());
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+        IntegrityCheck::CopyAndCompute(algorithm, copy.data(), data.data(), data.size(),
+                                       BlockSize, digests.data());
+    }
+    double compute = SecondsSince(start);
+    bool ret = true;
+    uint64_t badBlock = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+        ret = IntegrityCheck::Verify(algorithm, copy.data(), copy.size(), BlockSize,
+                                     digests.data(), badBlock) &&
+              ret;
+    }
+    double verify = SecondsSince(start);
+    double megabytes = data.size() / 1e6 * runs;
+    std::printf("  %-7s %-7s 复制并计算 %7.0f MB/s  校验 %7.0f MB/s\n",
+                IntegrityCheck::GetName(algorithm),
+                IntegrityCheck::GetKernelName(algorithm).c_str(), megabytes / compute,
+                megabytes / verify);
+    return ret;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    uint64_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    std::string algorithm = argc > 2 ? argv[2] : "rs-6-3";
+    int runs = argc > 3 ? std::atoi(argv[3]) : 5;
+    uint32_t dataFragments = 0;
+    uint32_t parityFragments = 0;
+    if (!ErasureCode::Parse(algorithm, dataFragments, parityFragments) || parityFragments == 0) {
+        std::fprintf(stderr, "无法解析纠删码 %s\n", algorithm.c_str());
+        return 1;
+    }
+    std::vector<char> data(megabytes * 1024 * 1024);
+    std::mt19937_64 random(1);
+    for (auto &c : data) {
+        c = (char) random();
+    }
+
+    bool ret = true;
+    ErasureCode code(dataFragments, parityFragments);
+    std::string automatic = ErasureCode::GetKernelName();
+    std::printf("%s, %llu MiB\n", algorithm.c_str(), (unsigned long long) megabytes);
+    for (const char *kernel : {"scalar", "ssse3", "avx2", "neon"}) {
+        if (ErasureCode::SetKernel(kernel)) {
+            ret = RunErasureCode(code, data, runs) && ret;
+        }
+    }
+    ErasureCode::SetKernel(automatic);
+
+    std::printf("完整性校验, 块大小 %llu KiB\n", (unsigned long long) BlockSize / 1024);
+    for (auto integrity :
+         {IntegrityAlgorithm::Crc32c, IntegrityAlgorithm::Xxh3, IntegrityAlgorithm::Blake3}) {
+        ret = RunIntegrity(integrity, data, runs) && ret;
+    }
+    return ret ? 0 : 1;
+}
@@ -0,0 +1,271 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+// 日志结构存储与每个对象一个文件的布局的对比基准。
+// 第一部分以不落盘的方式单线程写入、随机读取和删除小对象，
+// 第二部分比较三种持久化级别在1个和16个写线程下的写入速率。
+// 用法: LogStructuredBench [对象数量=100000] [对象大小=1024] [持久化写入数量=5000]
+
+#include "BenchContext.h"
+#include "LogStructuredStore.h"
+#include <atomic>
+#include <cstdio>
+#include <fcntl.h>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+using Fleet::DataManager::Bench::BenchContext;
+using Fleet::DataManager::Bench::MakeBenchDirectory;
+using Fleet::DataManager::Bench::SecondsSince;
+using Fleet::DataManager::Storage::Durability;
+using Fleet::DataManager::Storage::LogStructuredStore;
+using Fleet::DataManager::Storage::LogStructuredStoreOptions;
+
+/**
+ * @brief 被测的存储布局
+ */
+class Layout {
+  public:
+    virtual ~Layout() = default;
+    virtual bool Put(const std::string &key, const char *data, uint64_t size) = 0;
+    virtual bool Get(const std::string &key, std::vector<char> &buffer) = 0;
+    virtual bool Remove(const std::string &key) = 0;
+};
+
+/**
+ * @brief 每个对象一个文件的布局，键即相对路径，按应用、类型、名称和版本分层
+ */
+class FilePerObjectLayout : public Layout {
+  public:
+    FilePerObjectLayout(const std::string &directory, bool sync)
+        : directory(directory), sync(sync) {
+    }
+
+    bool Put(const std::string &key, const char *data, uint64_t size) override {
+        std::filesystem::path path = this->directory + "/" + key;
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        bool ret = write(fd, data, size) == (ssize_t) size && (!this->sync || fdatasync(fd) == 0);
+        close(fd);
+        return ret;
+    }
+
+    bool Get(const std::string &key, std::vector<char> &buffer) override {
+        int fd = open((this->directory + "/" + key).c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat status {};
+        bool ret = fstat(fd, &status) == 0;
+        if (ret) {
+            buffer.resize(status.st_size);
+            ret = read(fd, buffer.data(), buffer.size()) == (ssize_t) buffer.size();
+        }
+        close(fd);
+        return ret;
+    }
+
+    bool Remove(const std::string &key) override {
+        return unlink((this->directory + "/" + key).c_str()) == 0;
+    }
+
+  private:
+    /// 根目录
+    std::string directory;
+
+    /// 每次写入后是否fdatasync
+    bool sync;
+};
+
+/**
+ * @brief 日志结构存储布局
+ */
+class LogStructuredLayout : public Layout {
+  public:
+    LogStructuredLayout(const std::shared_ptr<BenchContext> &context, const std::string &directory,
+                        Durability durability) {
+        LogStructuredStoreOptions options;
+        options.durability = durability;
+        this->store = std::make_unique<LogStructuredStore>(context, directory, options);
+        this->opened = this->store->Open();
+    }
+
+    bool IsOpened() const {
+        return this->opened;
+    }
+
+    bool Put(const std::string &key, const char *data, uint64_t size) override {
+        return this->store->Put(key, data, size);
+    }
+
+    bool Get(const std::string &key, std::vector<char> &buffer) override {
+        auto block = this->store->Get(key);
+        if (block == nullptr) {
+            return false;
+        }
+        buffer.assign(block->GetData(), block->GetData() + block->GetSize());
+        return true;
+    }
+
+    bool Remove(const std::string &key) override {
+        return this->store->Remove(key);
+    }
+
+  private:
+    /// 日志结构存储
+    std::unique_ptr<LogStructuredStore> store;
+
+    /// 是否打开成功
+    bool opened = false;
+};
+
+/**
+ * @brief 生成第i个对象的键
+ * @param[in] index 对象序号
+ * @return 应用/类型/名称/版本形式的键
+ */
+std::string MakeKey(uint64_t index) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "object-%08llu", (unsigned long long) index);
+    return std::string("bench/blob/") + name + "/1";
+}
+
+/**
+ * @brief 多个线程分摊执行操作，返回每秒操作数
+ * @param[in] threads 线程数量
+ * @param[in] count 操作总数
+ * @param[in] operation 操作，参数为线程序号和操作序号，失败返回false
+ * @param[out] failed 失败的操作数
+ * @return 每秒操作数
+ */
+double RunThreads(int threads, uint64_t count,
+                  const std::function<bool(int, uint64_t)> &operation, uint64_t &failed) {
+    std::atomic<uint64_t> failures(0);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([t, threads, count, &operation, &failures]() {
+            for (uint64_t i = t; i < count; i += threads) {
+                if (!operation(t, i)) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    failed = failures.load();
+    return count / SecondsSince(start);
+}
+
+/**
+ * @brief 单线程写入、随机读取和删除
+ * @param[in] name 布局名称
+ * @param[in] layout 被测布局
+ * @param[in] count 对象数量
+ * @param[in] value 对象内容
+ */
+void RunLayout(const char *name, Layout &layout, uint64_t count, const std::string &value) {
+    uint64_t failed = 0;
+    uint64_t totalFailed = 0;
+    double put = RunThreads(
+        1, count,
+        [&](int, uint64_t i) { return layout.Put(MakeKey(i), value.data(), value.size()); },
+        failed);
+    totalFailed += failed;
+    std::mt19937_64 random(1);
+    std::vector<char> buffer;
+    double get = RunThreads(
+        1, count,
+        [&](int, uint64_t) {
+            return layout.Get(MakeKey(random() % count), buffer) && buffer.size() == value.size();
+        },
+        failed);
+    totalFailed += failed;
+    double remove = RunThreads(1, count, [&](int, uint64_t i) { return layout.Remove(MakeKey(i)); },
+                               failed);
+    totalFailed += failed;
+    std::printf("%-16s 写入 %9.0f/s  随机读取 %9.0f/s  删除 %9.0f/s  失败 %llu\n", name, put, get,
+                remove, (unsigned long long) totalFailed);
+}
+
+/**
+ * @brief 多线程写入速率
+ * @param[in] name 布局名称
+ * @param[in] layout 被测布局
+ * @param[in] threads 写线程数量
+ * @param[in] count 写入数量
+ * @param[in] value 对象内容
+ */
+void RunDurable(const char *name, Layout &layout, int threads, uint64_t count,
+                const std::string &value) {
+    uint64_t failed = 0;
+    double put = RunThreads(
+        threads, count,
+        [&](int, uint64_t i) { return layout.Put(MakeKey(i), value.data(), value.size()); },
+        failed);
+    std::printf("%-16s %2d 线程 写入 %9.0f/s  失败 %llu\n", name, threads, put,
+                (unsigned long long) failed);
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    uint64_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    uint64_t size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+    uint64_t durableCount = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 5000;
+    std::string value(size, 'v');
+    std::string directory = MakeBenchDirectory("log-structured");
+    auto context = std::make_shared<BenchContext>(directory);
+
+    std::printf("%llu 个 %llu 字节对象，不落盘\n", (unsigned long long) count,
+                (unsigned long long) size);
+    {
+        FilePerObjectLayout files(directory + "/files", false);
+        RunLayout("file-per-object", files, count, value);
+    }
+    {
+        LogStructuredLayout store(context, directory + "/lss", Durability::None);
+        if (!store.IsOpened()) {
+            std::fprintf(stderr, "打开日志结构存储失败\n");
+            return 1;
+        }
+        RunLayout("log-structured", store, count, value);
+    }
+
+    std::printf("%llu 次 %llu 字节写入，按持久化级别\n", (unsigned long long) durableCount,
+                (unsigned long long) size);
+    const std::pair<const char *, Durability> levels[] = {
+        {"lss none", Durability::None},
+        {"lss batch", Durability::Batch},
+        {"lss sync", Durability::Sync},
+    };
+    for (int threads : {1, 16}) {
+        for (const auto &level : levels) {
+            std::filesystem::remove_all(directory + "/durable");
+            LogStructuredLayout store(context, directory + "/durable", level.second);
+            if (!store.IsOpened()) {
+                std::fprintf(stderr, "打开日志结构存储失败\n");
+                return 1;
+            }
+            RunDurable(level.first, store, threads, durableCount, value);
+        }
+        std::filesystem::remove_all(directory + "/durable");
+        FilePerObjectLayout files(directory + "/durable", true);
+        RunDurable("file fdatasync", files, threads, durableCount, value);
+    }
+    std::filesystem::remove_all(directory);
+    return 0;
+}
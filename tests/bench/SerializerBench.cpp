@@ -0,0 +1,141 @@
+// Copyright (c) 2025 Institute of Software, Chinese Academy of Sciences
+// Author: Zhen Tang <tangzhen12@otcaix.iscas.ac.cn>
+// Affiliation: Institute of Software, Chinese Academy of Sciences
+
+// 数据键、存储位置和位置列表序列化的单线程基准。
+// 比较写入调用方缓冲区的SerializeTo与返回std::string的Serialize，
+// 反序列化复用同一个对象，并统计每次操作的内存分配次数，缓冲区路径应为0。
+// 用法: SerializerBench [重复次数=1000000] [位置数量=3]
+
+#include "BenchContext.h"
+#include "DataKey.h"
+#include "Location.h"
+#include "Strategy.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+/// 进程内的内存分配次数
+std::atomic<uint64_t> allocations(0);
+} // namespace
+
+// 替换全局的operator new和operator delete以统计分配次数，
+// 不内联，避免编译器在调用处把malloc与operator delete误判为不匹配
+__attribute__((noinline)) void *operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void *ret = std::malloc(size == 0 ? 1 : size);
+    if (ret == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ret;
+}
+
+__attribute__((noinline)) void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+__attribute__((noinline)) void operator delete(void *pointer, size_t size) noexcept {
+    (void) size;
+    std::free(pointer);
+}
+
+namespace {
+using Fleet::DataManager::Bench::SecondsSince;
+using Fleet::DataManager::Core::BufferReader;
+using Fleet::DataManager::Core::BufferWriter;
+using Fleet::DataManager::Storage::DataKey;
+using Fleet::DataManager::Storage::Location;
+using Fleet::DataManager::Storage::Strategy;
+
+/// 栈上序列化缓冲区的大小
+constexpr size_t BufferSize = 4096;
+
+/**
+ * @brief 预热后重复执行操作，输出每次操作的耗时和分配次数
+ * @param[in] label 操作名称
+ * @param[in] runs 重复次数
+ * @param[in] operation 操作，失败返回false
+ * @param[in] allocationFree 操作是否应不分配内存
+ * @return 操作全部成功且分配次数符合预期返回true，否则返回false
+ */
+bool Run(const char *label, uint64_t runs, const std::function<bool()> &operation,
+         bool allocationFree) {
+    // 预热一次，复用的对象在此时为较长的字段分配容量，不计入统计
+    bool ret = operation();
+    uint64_t before = allocations.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < runs; i++) {
+        ret = operation() && ret;
+    }
+    double seconds = SecondsSince(start);
+    double perRun = double(allocations.load(std::memory_order_relaxed) - before) / runs;
+    std::printf("  %-28s %7.1f ns/次  分配 %.2f 次/次\n", label, seconds * 1e9 / runs, perRun);
+    return ret && (!allocationFree || perRun == 0);
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    uint64_t runs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    uint32_t locationCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 3;
+    if (runs == 0) {
+        std::fprintf(stderr, "重复次数必须大于0\n");
+        return 1;
+    }
+    DataKey key("bench-application", "sensor-frame", "vehicle-0001/camera-front/000123", "17");
+    Location location("nvme-device-0", "bench-application/sensor-frame/object-000123");
+    std::vector<Location> locations;
+    for (uint32_t i = 0; i < locationCount; i++) {
+        locations.emplace_back("nvme-device-" + std::to_string(i),
+                               "bench-application/sensor-frame/object-000123");
+    }
+    Strategy strategy("bench", "serializer bench", locations, "replica-3", "crc32c", 0);
+    char buffer[BufferSize];
+
+    bool ret = true;
+    std::printf("%llu 次，位置列表 %u 项\n", (unsigned long long) runs, locationCount);
+    std::printf("数据键\n");
+    ret = Run("SerializeTo", runs, [&]() {
+        BufferWriter writer(buffer, sizeof(buffer));
+        return key.SerializeTo(writer);
+    }, true) && ret;
+    ret = Run("Serialize", runs, [&]() { return key.Serialize().size() != 0; }, false) && ret;
+    uint32_t keySize = key.GetSerializedSize();
+    DataKey parsedKey("", "", "", "");
+    ret = Run("Deserialize", runs, [&]() {
+        BufferReader reader(buffer, keySize);
+        return parsedKey.Deserialize(reader);
+    }, true) && ret;
+    ret = ret && parsedKey == key;
+
+    std::printf("存储位置\n");
+    ret = Run("SerializeTo", runs, [&]() {
+        BufferWriter writer(buffer, sizeof(buffer));
+        return location.SerializeTo(writer);
+    }, true) && ret;
+    ret = Run("Serialize", runs, [&]() { return location.Serialize().size() != 0; }, false) &&
+          ret;
+    uint32_t locationSize = location.GetSerializedSize();
+    Location parsedLocation(location);
+    ret = Run("Deserialize", runs, [&]() {
+        BufferReader reader(buffer, locationSize);
+        return parsedLocation.Deserialize(reader);
+    }, true) && ret;
+
+    std::printf("位置列表\n");
+    ret = Run("SerializeLocationsTo", runs, [&]() {
+        BufferWriter writer(buffer, sizeof(buffer));
+        return strategy.SerializeLocationsTo(writer);
+    }, true) && ret;
+    ret = Run("SerializeLocations", runs,
+              [&]() { return strategy.SerializeLocations().size() != 0; }, false) &&
+          ret;
+    if (!ret) {
+        std::fprintf(stderr, "序列化失败或缓冲区路径分配了内存\n");
+    }
+    return ret ? 0 : 1;
+}